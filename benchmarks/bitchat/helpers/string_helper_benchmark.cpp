@@ -0,0 +1,95 @@
+#include "bitchat/helpers/string_helper.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <span>
+#include <spdlog/fmt/fmt.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace bitchat;
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int ITERATIONS = 200000;
+constexpr size_t INPUT_SIZES[] = {8, 64, 512}; // peer ID and payload sized
+
+// Previous stream based implementations, the baseline of the codec
+std::string referenceToHex(std::span<const uint8_t> data)
+{
+    std::stringstream ss;
+
+    for (uint8_t byte : data)
+    {
+        ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
+    }
+
+    return ss.str();
+}
+
+std::vector<uint8_t> referenceStringToVector(const std::string &str)
+{
+    std::vector<uint8_t> result;
+
+    for (size_t i = 0; i + 1 < str.length(); i += 2)
+    {
+        result.push_back(static_cast<uint8_t>(std::stoi(str.substr(i, 2), nullptr, 16)));
+    }
+
+    return result;
+}
+
+// Time ITERATIONS calls of function, adding the size of each result to checksum
+template <typename Function>
+double measure(Function function, size_t &checksum)
+{
+    auto start = Clock::now();
+
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        checksum += function().size();
+    }
+
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void run(size_t size)
+{
+    std::vector<uint8_t> data(size, 0x5A);
+    std::string hex = StringHelper::toHex(data);
+    size_t checksum = 0;
+
+    // clang-format off
+    double referenceEncode = measure([&] { return referenceToHex(data); }, checksum);
+    double encode = measure([&] { return StringHelper::toHex(data); }, checksum);
+    double referenceDecode = measure([&] { return referenceStringToVector(hex); }, checksum);
+    double decode = measure([&] { return StringHelper::stringToVector(hex); }, checksum);
+    // clang-format on
+
+    // Keeps the calls from being optimized away and checks both agree on the sizes
+    if (checksum != static_cast<size_t>(ITERATIONS) * size * 6)
+    {
+        fmt::print("Unexpected output size at {} bytes\n", size);
+        std::exit(EXIT_FAILURE);
+    }
+
+    fmt::print("{:>6} bytes: toHex {:>8.1f} -> {:>6.1f} ms, stringToVector {:>8.1f} -> {:>6.1f} ms\n", size, referenceEncode, encode, referenceDecode, decode);
+}
+
+} // namespace
+
+int main()
+{
+    fmt::print("Hex codec vs streams ({} calls each):\n", ITERATIONS);
+
+    for (size_t size : INPUT_SIZES)
+    {
+        run(size);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+#include "bitchat/noise/noise_session_default.h"
+#include <chrono>
+#include <cstdlib>
+#include <openssl/rand.h>
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
+#include <vector>
+
+using namespace bitchat;
+
+namespace
+{
+
+constexpr std::chrono::milliseconds RUN_TIME(1000);
+constexpr size_t MESSAGE_SIZES[] = {64, 256, 1024, 4096};
+
+NoisePrivateKey randomKey()
+{
+    NoisePrivateKey key{};
+    RAND_bytes(key.data(), static_cast<int>(key.size()));
+
+    return key;
+}
+
+bool handshake(NoiseSessionDefault &initiator, NoiseSessionDefault &responder)
+{
+    auto message1 = initiator.startHandshake();
+    auto message2 = message1 ? responder.processHandshakeMessage(*message1) : std::nullopt;
+    auto message3 = message2 ? initiator.processHandshakeMessage(*message2) : std::nullopt;
+
+    if (message3)
+    {
+        responder.processHandshakeMessage(*message3);
+    }
+
+    return initiator.isSessionEstablished() && responder.isSessionEstablished();
+}
+
+// Encrypt on one side and decrypt on the other for RUN_TIME, single thread
+void run(NoiseSessionDefault &sender, NoiseSessionDefault &receiver, size_t size)
+{
+    std::vector<uint8_t> buffer(size + NoiseSession::TAG_SIZE, 0x42);
+    uint64_t messages = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::duration::zero();
+
+    while (elapsed < RUN_TIME)
+    {
+        // Checked every batch so the clock stays out of the measurement
+        for (int i = 0; i < 1000; i++)
+        {
+            if (!sender.encryptInPlace(buffer, size) || !receiver.decryptInPlace(buffer))
+            {
+                fmt::print("Round trip failed at {} bytes\n", size);
+                std::exit(EXIT_FAILURE);
+            }
+        }
+
+        messages += 1000;
+        elapsed = std::chrono::steady_clock::now() - start;
+    }
+
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    double perSecond = static_cast<double>(messages) / seconds;
+
+    fmt::print("{:>6} bytes: {:>10.0f} messages/s per core, {:>8.1f} MB/s\n", size, perSecond, perSecond * static_cast<double>(size) / 1e6);
+}
+
+} // namespace
+
+int main()
+{
+    spdlog::set_level(spdlog::level::warn);
+
+    NoiseSessionDefault initiator("responder", NoiseRole::Initiator, randomKey());
+    NoiseSessionDefault responder("initiator", NoiseRole::Responder, randomKey());
+
+    if (!handshake(initiator, responder))
+    {
+        fmt::print("Handshake failed\n");
+        return EXIT_FAILURE;
+    }
+
+    fmt::print("Noise transport (encrypt + decrypt in place):\n");
+
+    for (size_t size : MESSAGE_SIZES)
+    {
+        run(initiator, responder, size);
+    }
+
+    return EXIT_SUCCESS;
+}
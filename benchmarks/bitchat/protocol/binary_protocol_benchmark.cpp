@@ -0,0 +1,126 @@
+#include "bitchat/protocol/binary_protocol.h"
+#include "bitchat/protocol/packet_serializer.h"
+#include <chrono>
+#include <cstdlib>
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <vector>
+
+using namespace bitchat;
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int ITERATIONS = 100000;
+constexpr size_t CONTENT_SIZE = 200;
+
+double toMilliseconds(Clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void report(const char *name, Clock::duration build, Clock::duration parse, size_t bytes)
+{
+    fmt::print("{:>16}: build {:>8.1f} ms, parse {:>8.1f} ms, {:>9} bytes\n", name, toMilliseconds(build), toMilliseconds(parse), bytes);
+}
+
+// BinaryProtocol: build into one buffer, then stream it through the parser
+void runBinaryProtocol(const std::string &content)
+{
+    protocol::BitchatChatMessage message;
+    message.version = protocol::BinaryProtocolConstants::currentVersion;
+    message.type = protocol::BitchatMessageType::Message;
+    message.peerID = "0102030405060708";
+    message.timestamp = std::chrono::system_clock::time_point(std::chrono::milliseconds(1700000000000LL));
+    message.nickname = "alice";
+    message.channel = "#general";
+    message.content = content;
+    message.isEncrypted = false;
+
+    protocol::BinaryProtocolBuilder builder;
+    std::vector<uint8_t> stream;
+
+    auto start = Clock::now();
+
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        builder.buildPacket(message, stream);
+    }
+
+    auto built = Clock::now();
+    protocol::BinaryProtocolParser parser;
+    size_t parsed = parser.parseData(stream).size();
+    auto end = Clock::now();
+
+    if (parsed != static_cast<size_t>(ITERATIONS))
+    {
+        fmt::print("BinaryProtocol parsed {} of {} messages\n", parsed, ITERATIONS);
+        std::exit(EXIT_FAILURE);
+    }
+
+    report("BinaryProtocol", built - start, end - built, stream.size());
+}
+
+// PacketSerializer: message payload inside a padded packet
+void runPacketSerializer(const std::string &content)
+{
+    PacketSerializer serializer;
+    BitchatMessage chat;
+    chat.setId("id");
+    chat.setSender("alice");
+    chat.setContent(content);
+    chat.setChannel("#general");
+
+    OutputBuffer output;
+    size_t totalBytes = 0;
+
+    auto start = Clock::now();
+
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        BitchatPacket packet(PKT_TYPE_MESSAGE, serializer.makeMessagePayload(chat));
+        packet.setTimestamp(1700000000000ULL);
+        packet.setSenderID(std::vector<uint8_t>(8, 0x01));
+        serializer.serializeInto(packet, output);
+        totalBytes += output.size();
+    }
+
+    auto built = Clock::now();
+    std::vector<uint8_t> frame(output.getData().begin(), output.getData().end());
+
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        auto view = serializer.parsePacketView(frame);
+
+        if (!view)
+        {
+            fmt::print("PacketSerializer failed to parse its own frame\n");
+            std::exit(EXIT_FAILURE);
+        }
+
+        serializer.parseMessagePayload(view->toPacket().getPayload());
+    }
+
+    auto end = Clock::now();
+
+    report("PacketSerializer", built - start, end - built, totalBytes);
+}
+
+} // namespace
+
+int main()
+{
+    spdlog::set_level(spdlog::level::warn);
+
+    const std::string content(CONTENT_SIZE, 'x');
+
+    fmt::print("Chat message round trip ({} messages of {} bytes):\n", ITERATIONS, CONTENT_SIZE);
+
+    runBinaryProtocol(content);
+    runPacketSerializer(content);
+
+    return EXIT_SUCCESS;
+}
@@ -1,7 +1,14 @@
 #pragma once
 
+#include "bitchat/core/message_history.h"
+#include "bitchat/core/peer_table.h"
+#include "bitchat/core/private_conversations.h"
+#include "bitchat/core/search_index.h"
+#include "bitchat/protocol/dedup_filter.h"
 #include "bitchat/protocol/packet.h"
+#include "bitchat/storage/message_store.h"
 #include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -13,6 +20,19 @@
 namespace bitchat
 {
 
+// LocalIdentity: Immutable snapshot of who we are on the mesh
+// A new snapshot is published whenever one of the fields changes, so a handle
+// taken at the start of a packet stays consistent until the packet is done.
+struct LocalIdentity
+{
+    PeerId peerId;
+    std::string peerIdHex;
+    std::string nickname;
+    std::string currentChannel;
+};
+
+using LocalIdentityPtr = std::shared_ptr<const LocalIdentity>;
+
 // BitchatData: Centralized data storage for shared state across services
 class BitchatData
 {
@@ -28,9 +48,13 @@ public:
 
     // Identity and Basic Info
 
-    // Local peer ID
+    // Current identity snapshot, lock-free, hold it instead of calling the getters below repeatedly
+    LocalIdentityPtr getLocalIdentity() const;
+
+    // Local peer ID (hex form for display, PeerId for packets and lookups)
     void setPeerID(const std::string &peerID);
     std::string getPeerID() const;
+    PeerId getLocalPeerId() const;
 
     // Nickname
     void setNickname(const std::string &nickname);
@@ -47,27 +71,48 @@ public:
     // Peers list
     void setPeers(const std::vector<BitchatPeer> &peers);
     std::vector<BitchatPeer> getPeers() const;
+
+    // Published peer table, lock-free and without copying peers
+    PeerTable::Snapshot getPeersSnapshot() const;
     void addPeer(const BitchatPeer &peer);
-    void removePeer(const std::string &peerID);
+    void removePeer(PeerId peerID);
     void updatePeer(const BitchatPeer &peer);
     size_t getPeersCount() const;
-    bool isPeerOnline(const std::string &peerID) const;
-    std::optional<BitchatPeer> getPeerInfo(const std::string &peerID) const;
+    bool isPeerOnline(PeerId peerID) const;
+    std::optional<BitchatPeer> getPeerInfo(PeerId peerID) const;
 
     // Message History
 
-    // Message history by channel
+    // Message history by channel (empty channel means the current one)
     void addMessageToHistory(const BitchatMessage &message, const std::string &channel);
     std::vector<BitchatMessage> getMessageHistory(const std::string &channel) const;
+
+    // Private messages by conversation (peer ID hex of the other side), incoming ones count as unread
+    void addPrivateMessage(const std::string &conversation, const BitchatMessage &message, bool incoming);
+    std::vector<BitchatMessage> getPrivateMessages(const std::string &conversation, size_t count) const;
+    std::vector<ConversationSummary> getPrivateConversations() const;
+    size_t getUnreadPrivateCount(const std::string &conversation) const;
+    size_t getTotalUnreadPrivateCount() const;
+    void markPrivateConversationRead(const std::string &conversation);
+
+    // Shares the history segments instead of copying, read it without holding any lock
+    MessageHistory::Snapshot getMessageHistorySnapshot(const std::string &channel) const;
     void clearMessageHistory(const std::string &channel);
     void clearAllMessageHistory();
 
-    // Processed Messages Tracking
+    // On-disk message log, history is appended to it and restored from it (nullptr keeps history in memory only)
+    void setMessageStore(std::shared_ptr<MessageStore> store);
+    std::shared_ptr<MessageStore> getMessageStore() const;
 
-    // Track processed messages to avoid duplicates
-    bool wasMessageProcessed(const std::string &messageID) const;
-    void markMessageProcessed(const std::string &messageID);
-    void clearProcessedMessages();
+    // Search a channel's history (empty channel means the current one), newest first.
+    // Covers the message store when one is set, the in-memory history otherwise.
+    // A private conversation is searched as PRIVATE_CONVERSATION_PREFIX + its key.
+    std::vector<BitchatMessage> searchMessages(const std::string &channel, const SearchQuery &query) const;
+
+    // Track processed packets to avoid duplicates (keys from DedupFilter::makeKey)
+    bool wasPacketProcessed(uint64_t key) const;
+    bool markPacketProcessed(uint64_t key); // false if it was already processed
+    void clearProcessedPackets();
 
     // Generate unique message ID
     std::string generateMessageID() const;
@@ -75,36 +120,41 @@ public:
     // Cleanup stale data
     void cleanupStalePeers();
     void cleanupOldMessages(size_t maxHistorySize);
-    void cleanupOldProcessedMessages(size_t maxProcessedSize);
+    void cleanupSearchIndex(); // drops messages no longer in the store or in memory
 
 private:
     // Private constructor for singleton
     BitchatData();
 
-    // Static instance
-    static std::shared_ptr<BitchatData> instance;
-    static std::mutex instanceMutex;
+    // Copy the identity, apply update and publish the result
+    void updateLocalIdentity(const std::function<void(LocalIdentity &)> &update);
 
-    // Identity and Basic Info
-    mutable std::mutex identityMutex;
-    std::string peerID;
-    std::string nickname;
+    // Append to the store (if any) and index under the store sequence, or under ordinal without a store
+    void persistMessage(const std::shared_ptr<MessageStore> &store, const std::string &conversation, uint64_t ordinal, const BitchatMessage &message);
 
-    // Channel Management
-    mutable std::mutex currentChannelMutex;
-    std::string currentChannel;
+    // Identity and Channel (readers use std::atomic_load, writers serialize on identityMutex)
+    std::mutex identityMutex;
+    LocalIdentityPtr localIdentity;
 
-    // Peer Management
-    mutable std::mutex peersMutex;
-    std::vector<BitchatPeer> peers;
+    // Peer Management (locks internally)
+    PeerTable peers;
 
     // Message History
     mutable std::mutex messageHistoryMutex;
-    std::map<std::string, std::vector<BitchatMessage>> messageHistory;
+    std::map<std::string, MessageHistory> messageHistory;
+
+    // Private Conversations (locks internally)
+    PrivateConversations privateConversations;
+
+    // Message Store (std::atomic_load/store, the store locks internally)
+    std::shared_ptr<MessageStore> messageStore;
+
+    // Search Index (locks internally, indexMutex keeps ordinals in order across store appends)
+    std::mutex indexMutex;
+    SearchIndex searchIndex;
 
-    // Processed Messages Tracking
-    mutable std::mutex processedMessagesMutex;
-    std::set<std::string> processedMessages;
+    // Processed Packets Tracking (sharded, locks internally)
+    mutable DedupFilter processedPackets;
 };
 
 } // namespace bitchat
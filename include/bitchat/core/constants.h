@@ -27,6 +27,11 @@ const double BLE_CONNECTION_TIMEOUT_SECONDS = 10.0;
 const size_t BLE_MIN_PACKET_SIZE_BYTES = 21;
 const size_t BLE_MAX_PACKET_SIZE_BYTES = 512;
 
+// Send Queue Constants (frames per peer are coalesced into one writev)
+const std::chrono::microseconds BLE_SEND_FLUSH_DEADLINE{2000};
+const size_t BLE_SEND_FLUSH_BYTE_BUDGET = 16 * 1024;
+const size_t BLE_SEND_QUEUE_MAX_BYTES = 256 * 1024;
+
 // Peer ID Generation Constants (8 bytes = 16 hex characters)
 const size_t BLE_PEER_ID_LENGTH_CHARS = 16;
 
@@ -44,10 +49,44 @@ const uint32_t BLE_CHARACTERISTIC_PERMISSIONS =
 
 // Data Management Constants
 const size_t MAX_HISTORY_SIZE = 1000;
-const size_t MAX_PROCESSED_MESSAGES = 1000;
+const size_t HISTORY_SEGMENT_SIZE = 64; // messages per history segment
+const size_t HISTORY_HOT_SIZE = 128;    // newest messages kept decoded, older ones are compressed
+const size_t MAX_PRIVATE_HISTORY_SIZE = 500; // per private conversation
+const size_t MAX_PRIVATE_CONVERSATIONS = 256;
+const std::string PRIVATE_CONVERSATION_PREFIX = "private:"; // message store and search name of a conversation
 const int PEER_TIMEOUT_SECONDS = 180;
 const int ANNOUNCE_INTERVAL_SECONDS = 15;
 
+// Duplicate Packet Filter Constants
+const size_t DEDUP_CAPACITY = 8192;
+const double DEDUP_FALSE_POSITIVE_RATE = 0.0001;
+const std::chrono::seconds DEDUP_WINDOW{300};
+const size_t DEDUP_GENERATIONS = 4;
+const size_t DEDUP_SHARDS = 16;
+
+// Message Store Constants (on-disk history, relative to the working directory)
+const std::string MESSAGE_STORE_DIRECTORY = "messages";
+const size_t MESSAGE_STORE_SEGMENT_BYTES = 4 * 1024 * 1024;
+const std::chrono::hours MESSAGE_STORE_SEGMENT_DURATION{24};
+const std::chrono::hours MESSAGE_STORE_RETENTION{24 * 90};
+const size_t MESSAGE_STORE_MAX_CONVERSATION_BYTES = 256 * 1024 * 1024;
+const size_t MESSAGE_STORE_INDEX_INTERVAL = 64; // records per sparse index entry
+
+// Fragmentation Constants
+const size_t FRAGMENT_MAX_FRAGMENTS = 256;
+const size_t FRAGMENT_MAX_BYTES_PER_SENDER = 256 * 1024;
+const size_t FRAGMENT_MAX_ASSEMBLIES_PER_SENDER = 8;
+const size_t FRAGMENT_MAX_TOTAL_BYTES = 2 * 1024 * 1024;
+const std::chrono::seconds FRAGMENT_TIMEOUT{30};
+
+// Signature Verification Constants
+const size_t SIGNATURE_VERIFY_THREADS = 2;
+const size_t SIGNATURE_VERIFY_BATCH_SIZE = 32;
+const size_t SIGNATURE_VERIFY_QUEUE_SIZE = 1024;
+const size_t SIGNATURE_CACHE_SIZE = 4096;
+const size_t SIGNATURE_MAX_KEYS = 1024;
+const std::chrono::minutes SIGNATURE_KEY_IDLE_TIME{30};
+
 // Noise Protocol Constants
 const size_t NOISE_MAX_MESSAGE_SIZE = 65535;
 const size_t NOISE_MAX_HANDSHAKE_MESSAGE_SIZE = 2048;
@@ -57,9 +96,20 @@ const std::chrono::seconds NOISE_HANDSHAKE_TIMEOUT{60};
 const size_t NOISE_MAX_SESSIONS_PER_PEER = 3;
 const size_t NOISE_MAX_HANDSHAKES_PER_MINUTE = 10;
 const size_t NOISE_MAX_MESSAGES_PER_SECOND = 100;
+const size_t NOISE_MAX_LINK_HANDSHAKES_PER_MINUTE = 20;
+const size_t NOISE_MAX_LINK_MESSAGES_PER_SECOND = 250;
 const size_t NOISE_MAX_GLOBAL_HANDSHAKES_PER_MINUTE = 30;
 const size_t NOISE_MAX_GLOBAL_MESSAGES_PER_SECOND = 500;
 
+// Rate Limiter Constants (table of per-peer and per-link buckets for the limits above)
+const size_t RATE_LIMIT_SHARDS = 16;
+const size_t RATE_LIMIT_SLOTS_PER_SHARD = 64;
+
+// Sender Key Constants
+const size_t SENDER_KEY_MAX_SENDERS = 256;
+const uint32_t SENDER_KEY_MAX_SKIP = 256;
+const uint32_t SENDER_KEY_ROTATION_MESSAGES = 10'000;
+
 } // namespace constants
 
 } // namespace bitchat
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "bitchat/protocol/packet.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace bitchat
+{
+
+// HistoryBlock: LZ4-compressed columnar block of history messages
+// Each field is stored as its own column so similar values sit next to each
+// other. Senders, channels, recipients and mentions share a string dictionary,
+// contents have their own dictionary (repeated messages are stored once) and
+// timestamps are delta encoded. The columns are then compressed as one buffer.
+class HistoryBlock
+{
+public:
+    // Pack messages, the first skip of them are stored as empty messages, nullptr on failure
+    static std::shared_ptr<const HistoryBlock> pack(std::span<const BitchatMessage> messages, size_t skip = 0);
+
+    // Decode all messages, empty on failure
+    std::vector<BitchatMessage> unpack() const;
+
+    size_t size() const { return count; }
+    size_t getMemoryUsage() const { return sizeof(*this) + compressed.capacity(); }
+
+private:
+    HistoryBlock() = default;
+
+    std::vector<uint8_t> compressed;
+    size_t originalSize = 0;
+    size_t count = 0;
+};
+
+} // namespace bitchat
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "bitchat/core/constants.h"
+#include "bitchat/core/history_block.h"
+#include "bitchat/protocol/packet.h"
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace bitchat
+{
+
+// MessageHistory: Bounded message history of one channel
+// Messages live in fixed-size segments shared with snapshots. Appending writes
+// the next free slot of the newest segment and evicting only moves the head,
+// both O(1). A snapshot holds references to the segments it covers and never
+// reads slots written after it was taken, so it can be read without any lock.
+// Only the newest segments (hot tier, about hotCapacity messages) stay decoded,
+// older full segments are packed into compressed HistoryBlocks (cold tier) and
+// decoded again only when a snapshot reads them.
+// Not thread safe by itself, callers serialize append, trim and snapshot.
+class MessageHistory
+{
+private:
+    struct Segment
+    {
+        std::array<BitchatMessage, constants::HISTORY_SEGMENT_SIZE> messages;
+    };
+
+    // Exactly one of hot and cold is set
+    struct Chunk
+    {
+        std::shared_ptr<const Segment> hot;
+        std::shared_ptr<const HistoryBlock> cold;
+    };
+
+public:
+    // Snapshot: Immutable view of the history at the time it was taken
+    class Snapshot
+    {
+    public:
+        // Page: Contiguous runs of messages, valid as long as the page is
+        class Page
+        {
+        public:
+            size_t size() const { return runs.size(); }
+            bool empty() const { return runs.empty(); }
+            const std::span<const BitchatMessage> &operator[](size_t index) const { return runs[index]; }
+            const std::span<const BitchatMessage> &back() const { return runs.back(); }
+            auto begin() const { return runs.begin(); }
+            auto end() const { return runs.end(); }
+
+        private:
+            friend class Snapshot;
+
+            std::vector<std::shared_ptr<const Segment>> segments; // keeps decoded cold segments alive
+            std::vector<std::span<const BitchatMessage>> runs;
+        };
+
+        Snapshot() = default;
+
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+
+        // Index 0 is the oldest message, a cold message decodes its whole block
+        BitchatMessage operator[](size_t index) const;
+
+        // Up to limit messages starting at offset, hot runs are not copied, each cold block is decoded once
+        Page getPage(size_t offset, size_t limit) const;
+
+        // Copy of all messages, oldest first
+        std::vector<BitchatMessage> toVector() const;
+
+        // Ordinal of index 0, ordinals count every message ever appended
+        uint64_t getFirstOrdinal() const { return firstOrdinal; }
+
+    private:
+        friend class MessageHistory;
+
+        std::shared_ptr<const Segment> loadSegment(size_t index) const;
+
+        std::vector<Chunk> chunks;
+        size_t headOffset = 0; // first message in the front chunk
+        size_t count = 0;
+        uint64_t firstOrdinal = 0;
+    };
+
+    explicit MessageHistory(size_t capacity = constants::MAX_HISTORY_SIZE, size_t hotCapacity = constants::HISTORY_HOT_SIZE);
+
+    // Append a message, evicting the oldest one at capacity
+    void append(BitchatMessage message);
+
+    // Evict the oldest messages until at most maxSize remain
+    void trim(size_t maxSize);
+
+    void clear();
+
+    size_t size() const { return count; }
+    size_t getCapacity() const { return capacity; }
+
+    // Ordinal the next appended message gets, clearing does not reset it
+    uint64_t getEndOrdinal() const { return endOrdinal; }
+
+    // Approximate bytes held by messages of both tiers
+    size_t getMemoryUsage() const;
+
+    Snapshot snapshot() const;
+
+private:
+    void evictOldest();
+    void compressOldestHot();
+
+    std::deque<std::shared_ptr<const HistoryBlock>> blocks; // cold tier, oldest first
+    std::deque<std::shared_ptr<Segment>> segments;          // hot tier, after the blocks
+    size_t headOffset = 0;                                  // first message in the front chunk
+    size_t tailCount = 0;                                   // used slots in the back segment
+    size_t count = 0;
+    uint64_t endOrdinal = 0;
+    size_t capacity;
+    size_t hotSegments;
+};
+
+} // namespace bitchat
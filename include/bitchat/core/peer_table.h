@@ -0,0 +1,87 @@
+#pragma once
+
+#include "bitchat/protocol/packet.h"
+#include "bitchat/protocol/peer_id.h"
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace bitchat
+{
+
+using PeerPtr = std::shared_ptr<const BitchatPeer>;
+
+// PeerTable: Peers indexed by peer ID and by peripheral ID
+// The table is published as an immutable version. Writers serialize on a
+// mutex, copy the current version (peer pointers and indexes, not the peers)
+// and swap the new one in. Readers load the current version without locking
+// and can iterate it for as long as they keep the snapshot.
+class PeerTable
+{
+private:
+    struct State
+    {
+        std::vector<PeerPtr> peers; // insertion order
+        std::unordered_map<PeerId, size_t> byId;
+        std::unordered_multimap<std::string, size_t> byPeripheral;
+    };
+
+public:
+    // Snapshot: One published version of the table
+    class Snapshot
+    {
+    public:
+        Snapshot();
+
+        size_t size() const { return state->peers.size(); }
+        bool empty() const { return state->peers.empty(); }
+
+        // All peers, in the order they were added
+        std::span<const PeerPtr> getPeers() const { return state->peers; }
+
+        // nullptr if not found
+        PeerPtr find(PeerId peerID) const;
+
+        // Peers reached through a peripheral
+        std::vector<PeerPtr> findByPeripheral(const std::string &peripheralID) const;
+
+        // Copy of all peers
+        std::vector<BitchatPeer> toVector() const;
+
+    private:
+        friend class PeerTable;
+
+        explicit Snapshot(std::shared_ptr<const State> state);
+
+        std::shared_ptr<const State> state;
+    };
+
+    PeerTable();
+
+    // Current version, never blocks
+    Snapshot snapshot() const;
+
+    // Add the peer, or replace the one with the same ID
+    void upsert(const BitchatPeer &peer);
+
+    // False if the peer was not in the table
+    bool remove(PeerId peerID);
+
+    // Remove peers not seen within timeout seconds, returns how many were removed
+    size_t removeStale(time_t timeout);
+
+    void assign(const std::vector<BitchatPeer> &peers);
+
+private:
+    static void rebuildIndexes(State &state);
+
+    // Readers go through std::atomic_load, writers hold writeMutex and std::atomic_store
+    std::shared_ptr<const State> current;
+    std::mutex writeMutex;
+};
+
+} // namespace bitchat
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "bitchat/core/constants.h"
+#include "bitchat/core/message_history.h"
+#include "bitchat/protocol/packet.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace bitchat
+{
+
+// Overview of one private conversation
+struct ConversationSummary
+{
+    std::string key;      // peer ID (hex) of the other side, "@nickname" while it is unknown
+    std::string nickname; // latest nickname seen for the other side
+    uint64_t lastTimestamp = 0;
+    size_t messageCount = 0;
+    size_t unreadCount = 0;
+};
+
+// PrivateConversations: Private messages indexed by conversation
+// Every conversation has its own bounded history and unread counter, found in
+// O(1) by key. Conversations are kept in most recently active order; past
+// maxConversations the least recently active one is dropped. The total unread
+// count is maintained with every change instead of being summed up.
+// Thread safe.
+class PrivateConversations
+{
+public:
+    explicit PrivateConversations(size_t maxConversations = constants::MAX_PRIVATE_CONVERSATIONS, size_t maxMessages = constants::MAX_PRIVATE_HISTORY_SIZE);
+
+    struct AddResult
+    {
+        uint64_t ordinal;                   // position of the message in its conversation
+        std::optional<std::string> evicted; // conversation dropped to make room
+    };
+
+    // Add a message, incoming messages count as unread
+    AddResult add(const std::string &key, const BitchatMessage &message, bool incoming);
+
+    // Latest count messages of a conversation, oldest first
+    std::vector<BitchatMessage> getLatest(const std::string &key, size_t count) const;
+    MessageHistory::Snapshot getSnapshot(const std::string &key) const;
+
+    // Conversations, most recently active first
+    std::vector<ConversationSummary> getConversations() const;
+
+    size_t getUnreadCount(const std::string &key) const;
+    size_t getTotalUnreadCount() const;
+    void markRead(const std::string &key);
+
+    bool remove(const std::string &key);
+    void clear();
+
+    size_t size() const;
+
+private:
+    struct Conversation
+    {
+        std::string key;
+        std::string nickname;
+        MessageHistory history;
+        uint64_t lastTimestamp = 0;
+        size_t unread = 0;
+    };
+
+    using ConversationList = std::list<Conversation>;
+
+    void eraseConversation(ConversationList::iterator it);
+
+    size_t maxConversations;
+    size_t maxMessages;
+    size_t totalUnread = 0;
+    ConversationList conversations; // most recently active first
+    std::unordered_map<std::string, ConversationList::iterator> byKey;
+    mutable std::mutex mutex;
+};
+
+} // namespace bitchat
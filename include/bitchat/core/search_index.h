@@ -0,0 +1,83 @@
+#pragma once
+
+#include "bitchat/protocol/packet.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace bitchat
+{
+
+// Search criteria, all given criteria must match
+struct SearchQuery
+{
+    std::vector<std::string> keywords; // every keyword must appear in the content
+    std::string sender;                // nickname, case insensitive
+    uint64_t from = 0;                 // message timestamps in milliseconds, inclusive
+    uint64_t to = std::numeric_limits<uint64_t>::max();
+    size_t limit = 20;
+
+    // Parse "word from:nick since:30m until:2h" (units s, m, h, d, relative to now)
+    static SearchQuery parse(std::string_view text, uint64_t now);
+};
+
+// SearchIndex: Incrementally maintained message index per channel
+// Messages are identified by ordinals the caller assigns in increasing order
+// (the message store sequence, or the position in memory). Each channel keeps
+// posting lists of ordinals per content token and per sender, and the ordinals
+// sorted by timestamp. Posting lists are sorted, so queries intersect them
+// starting from the shortest list and stop as soon as enough matches are found.
+// Thread safe.
+class SearchIndex
+{
+public:
+    SearchIndex() = default;
+
+    // Index a message, ordinals must increase per channel
+    void add(const std::string &channel, uint64_t ordinal, const BitchatMessage &message);
+
+    // Ordinals of matching messages, newest first
+    std::vector<uint64_t> search(const std::string &channel, const SearchQuery &query) const;
+
+    // Forget ordinals below first, after the messages themselves are gone
+    void removeBefore(const std::string &channel, uint64_t first);
+
+    void clear(const std::string &channel);
+    void clearAll();
+
+    size_t size(const std::string &channel) const;
+
+    // Lowercase words of letters and digits, bytes of multi-byte characters count as letters
+    static std::vector<std::string> tokenize(std::string_view text);
+
+private:
+    using PostingList = std::vector<uint64_t>;
+
+    struct ChannelIndex
+    {
+        std::unordered_map<std::string, PostingList> tokens;
+        std::unordered_map<std::string, PostingList> senders;
+        std::multimap<uint64_t, uint64_t> byTime; // timestamp to ordinal, equal timestamps by ordinal
+        std::deque<uint64_t> timestamps;          // by ordinal, starting at firstOrdinal
+        uint64_t firstOrdinal = 0;
+        size_t count = 0;
+    };
+
+    static std::vector<uint64_t> searchTimeRange(const ChannelIndex &index, const SearchQuery &query);
+    static std::vector<uint64_t> intersect(const ChannelIndex &index, std::vector<const PostingList *> lists, const SearchQuery &query);
+    static bool isInTimeRange(const ChannelIndex &index, uint64_t ordinal, const SearchQuery &query);
+    static void trimPostings(std::unordered_map<std::string, PostingList> &postings, uint64_t first);
+
+    mutable std::mutex mutex;
+    std::map<std::string, ChannelIndex> channels;
+};
+
+} // namespace bitchat
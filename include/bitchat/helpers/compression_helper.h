@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <span>
 #include <vector>
 
 namespace bitchat
@@ -14,17 +15,33 @@ public:
     // Compress data
     static std::vector<uint8_t> compressData(const std::vector<uint8_t> &data);
 
+    // Compress data into a caller-owned buffer, returns the compressed size (0 on failure)
+    static size_t compressInto(std::span<const uint8_t> data, uint8_t *output, size_t outputCapacity);
+
+    // Compress data against a shared dictionary into a caller-owned buffer (0 on failure)
+    static size_t compressInto(std::span<const uint8_t> data, uint8_t *output, size_t outputCapacity, std::span<const uint8_t> dictionary);
+
     // Decompress data
-    static std::vector<uint8_t> decompressData(const std::vector<uint8_t> &compressedData, size_t originalSize);
+    static std::vector<uint8_t> decompressData(std::span<const uint8_t> compressedData, size_t originalSize);
+
+    // Decompress data that was compressed against dictionary
+    static std::vector<uint8_t> decompressData(std::span<const uint8_t> compressedData, size_t originalSize, std::span<const uint8_t> dictionary);
+
+    // Check if data should be compressed (size threshold, then entropy probe)
+    // A dictionary lets much shorter payloads shrink, so it lowers the threshold
+    static bool shouldCompress(std::span<const uint8_t> data, bool withDictionary = false);
 
-    // Check if data should be compressed
-    static bool shouldCompress(const std::vector<uint8_t> &data);
+    // Estimate Shannon entropy in bits per byte from a sample of the data
+    static double estimateEntropy(std::span<const uint8_t> data);
 
     // Calculate compression bound for given data size
     static int calculateCompressionBound(size_t dataSize);
 
 private:
-    static constexpr size_t COMPRESSION_THRESHOLD = 100; // bytes
+    static constexpr size_t COMPRESSION_THRESHOLD = 100;           // bytes
+    static constexpr size_t DICTIONARY_COMPRESSION_THRESHOLD = 16; // bytes
+    static constexpr size_t ENTROPY_SAMPLE_SIZE = 1024;            // bytes
+    static constexpr double ENTROPY_MAX_BITS = 7.0;                // bits per byte
 
     CompressionHelper() = delete;
 };
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace bitchat
@@ -11,11 +13,19 @@ namespace bitchat
 class StringHelper
 {
 public:
-    // Hex conversion utilities
-    static std::string toHex(const std::vector<uint8_t> &data);
+    // Hex conversion utilities (lowercase output, either case accepted on input)
+    static std::string toHex(std::span<const uint8_t> data);
 
-    // String/vector conversion utilities
-    static std::vector<uint8_t> stringToVector(const std::string &str);
+    // Writes 2 * data.size() characters, returns false if output is too small
+    static bool toHex(std::span<const uint8_t> data, std::span<char> output);
+    static void appendHex(std::string &output, std::span<const uint8_t> data);
+
+    // Decodes exactly str.size() / 2 bytes, returns false on odd length, a non-hex character or a size mismatch
+    static bool fromHex(std::string_view str, std::span<uint8_t> output);
+    static bool isHex(std::string_view str); // Even length and only hex digits
+
+    // String/vector conversion utilities (stringToVector returns empty on invalid hex)
+    static std::vector<uint8_t> stringToVector(std::string_view str);
     static std::string vectorToString(const std::vector<uint8_t> &vec);
 
     // Peer ID utilities
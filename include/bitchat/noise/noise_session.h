@@ -4,6 +4,7 @@
 #include <chrono>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -13,12 +14,22 @@ namespace bitchat
 class NoiseSession
 {
 public:
+    // Authentication tag appended to every transport message
+    static constexpr size_t TAG_SIZE = 16;
+
     virtual ~NoiseSession() = default;
 
     // Core encryption/decryption
     virtual std::vector<uint8_t> encrypt(const std::vector<uint8_t> &plaintext) = 0;
     virtual std::vector<uint8_t> decrypt(const std::vector<uint8_t> &ciphertext) = 0;
 
+    // In place: encrypt the first length bytes of buffer, which needs TAG_SIZE
+    // bytes of headroom after them. Returns the ciphertext length.
+    virtual std::optional<size_t> encryptInPlace(std::span<uint8_t> buffer, size_t length) = 0;
+
+    // In place: decrypt the whole buffer, returns the plaintext length (std::nullopt if it fails authentication)
+    virtual std::optional<size_t> decryptInPlace(std::span<uint8_t> buffer) = 0;
+
     // Session state
     virtual bool isSessionEstablished() const = 0;
     virtual std::string getPeerID() const = 0;
@@ -13,14 +13,24 @@
 namespace bitchat
 {
 
+// NoiseSessionDefault: Noise_XX_25519_ChaChaPoly_SHA256 session backed by noise-c
+// The handshake state lives until the three XX messages are exchanged, then it
+// is split into one cipher state per direction and freed. The cipher states
+// are kept for the lifetime of the session and transport messages are
+// encrypted in place, so no memory is allocated per message.
 class NoiseSessionDefault : public NoiseSession
 {
 public:
     NoiseSessionDefault(const std::string &peerID, NoiseRole role, const NoisePrivateKey &localStaticKey);
-    ~NoiseSessionDefault() override = default;
+    ~NoiseSessionDefault() override;
+
+    NoiseSessionDefault(const NoiseSessionDefault &) = delete;
+    NoiseSessionDefault &operator=(const NoiseSessionDefault &) = delete;
 
     std::vector<uint8_t> encrypt(const std::vector<uint8_t> &plaintext) override;
     std::vector<uint8_t> decrypt(const std::vector<uint8_t> &ciphertext) override;
+    std::optional<size_t> encryptInPlace(std::span<uint8_t> buffer, size_t length) override;
+    std::optional<size_t> decryptInPlace(std::span<uint8_t> buffer) override;
     bool isSessionEstablished() const override;
     std::string getPeerID() const override;
     std::optional<NoisePublicKey> getRemoteStaticPublicKey() const override;
@@ -30,14 +40,27 @@ public:
     uint64_t getMessageCount() const override;
     std::chrono::system_clock::time_point getLastActivityTime() const override;
     bool handshakeInProgress() const override;
-    std::optional<std::vector<uint8_t>> processHandshakeMessage([[maybe_unused]] const std::vector<uint8_t> &message) override;
+
+    // Returns the next handshake message to send, std::nullopt when there is none
+    // (handshake complete or message rejected)
+    std::optional<std::vector<uint8_t>> processHandshakeMessage(const std::vector<uint8_t> &message) override;
 
 private:
+    // Call with sessionMutex held
+    void resetHandshake();
+    bool readHandshakeMessage(const std::vector<uint8_t> &message);
+    std::optional<std::vector<uint8_t>> writeHandshakeMessage();
+    void completeHandshakeIfReady();
+    void freeStates();
+
     std::string peerID;
     NoiseRole role;
     NoisePrivateKey localStaticKey;
     std::optional<NoisePublicKey> remoteStaticKey;
     std::optional<std::vector<uint8_t>> handshakeHash;
+    void *handshakeState; // NoiseHandshakeState*
+    void *sendCipher;     // NoiseCipherState*
+    void *receiveCipher;  // NoiseCipherState*
     bool sessionEstablished;
     uint64_t messageCount;
     std::chrono::system_clock::time_point lastActivityTime;
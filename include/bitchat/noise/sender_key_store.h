@@ -0,0 +1,108 @@
+#pragma once
+
+#include "bitchat/protocol/peer_id.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace bitchat
+{
+
+// SenderKeyStore: sender keys for channel broadcasts
+// Each member owns a symmetric chain key and hands it once to every peer over
+// the pairwise Noise session (the distribution message). A broadcast is then
+// encrypted once with a message key derived from the chain, and the chain is
+// stepped forward with HKDF, so the cost per message does not depend on how
+// many peers read the channel. Receivers keep the chain of each sender and
+// the message keys of a few skipped iterations, so relayed copies arriving
+// out of order still decrypt while replays do not.
+// Thread safe.
+class SenderKeyStore
+{
+public:
+    static constexpr size_t KEY_SIZE = 32;
+    static constexpr size_t HEADER_SIZE = 8; // key ID and iteration
+    static constexpr size_t TAG_SIZE = 16;
+    static constexpr size_t DISTRIBUTION_SIZE = HEADER_SIZE + KEY_SIZE;
+
+    struct Config
+    {
+        size_t maxSenders;    // sender chains kept, oldest learned are dropped first
+        uint32_t maxSkip;     // iterations a message may jump ahead, and skipped keys kept per sender
+        uint32_t rotateAfter; // messages sent before the local chain should be replaced
+    };
+
+    // Uses the SENDER_KEY_* constants
+    SenderKeyStore();
+    explicit SenderKeyStore(const Config &config);
+    ~SenderKeyStore();
+
+    SenderKeyStore(const SenderKeyStore &) = delete;
+    SenderKeyStore &operator=(const SenderKeyStore &) = delete;
+
+    // Current state of the local chain, to send to a peer over its pairwise session
+    std::vector<uint8_t> getDistributionMessage() const;
+
+    // Learn the chain of a sender, false if the message is malformed. Only a new
+    // key ID replaces a known chain, the one in use is never rewound
+    bool processDistributionMessage(PeerId sender, std::span<const uint8_t> message);
+    bool hasSenderKey(PeerId sender) const;
+    void removeSenderKey(PeerId sender);
+
+    // Replace the local chain, peers need the new distribution message
+    void rotate();
+    bool needsRotation() const;
+
+    // Encrypt a broadcast from the local chain: header, ciphertext and tag
+    // (std::nullopt if encryption fails)
+    std::optional<std::vector<uint8_t>> encrypt(PeerId localPeerID, std::span<const uint8_t> plaintext);
+
+    // Decrypt a broadcast from sender, std::nullopt if its chain is unknown,
+    // the message is too old or replayed, or it fails authentication
+    std::optional<std::vector<uint8_t>> decrypt(PeerId sender, std::span<const uint8_t> message);
+
+private:
+    using Key = std::array<uint8_t, KEY_SIZE>;
+    using AssociatedData = std::array<uint8_t, PeerId::SIZE + HEADER_SIZE>;
+
+    struct Chain
+    {
+        uint32_t keyID = 0;
+        uint32_t iteration = 0;
+        Key chainKey{};
+    };
+
+    struct SenderChain
+    {
+        Chain chain;
+        std::deque<std::pair<uint32_t, Key>> skipped; // message keys of iterations not seen yet, oldest first
+    };
+
+    // Call with mutex held
+    bool step(Key &chainKey, Key &messageKey);
+    bool seal(PeerId sender, const Key &messageKey, std::span<const uint8_t> header, std::span<uint8_t> buffer, size_t length);
+    std::optional<size_t> open(PeerId sender, const Key &messageKey, std::span<const uint8_t> header, std::span<uint8_t> buffer);
+    void newLocalChain();
+
+    static AssociatedData makeAssociatedData(PeerId sender, std::span<const uint8_t> header);
+    static void writeHeader(uint8_t *output, uint32_t keyID, uint32_t iteration);
+    static void readHeader(const uint8_t *input, uint32_t &keyID, uint32_t &iteration);
+
+    Config config;
+
+    mutable std::mutex mutex;
+    Chain localChain;
+    std::unordered_map<PeerId, SenderChain> senders;
+    std::deque<PeerId> senderOrder;
+
+    void *hashState;   // NoiseHashState*
+    void *cipherState; // NoiseCipherState*
+};
+
+} // namespace bitchat
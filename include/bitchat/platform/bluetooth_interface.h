@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -11,13 +12,18 @@ namespace bitchat
 // Forward declarations
 class BitchatPacket;
 class BitchatMessage;
+class PacketView;
 
 // Callback types for Bluetooth transport events
 using PeerConnectedCallback = std::function<void(const std::string &peripheralID)>;
 using PeerDisconnectedCallback = std::function<void(const std::string &peripheralID)>;
-using PacketReceivedCallback = std::function<void(const BitchatPacket &packet, const std::string &peripheralID)>;
+// The packet view points into the transport receive buffer and is only valid during the callback
+using PacketReceivedCallback = std::function<void(const PacketView &packet, const std::string &peripheralID)>;
 using PeripheralDiscoveredCallback = std::function<void(const std::string &peripheralID)>;
 
+// Immutable serialized frame shared between per-peer writes
+using SharedFrame = std::shared_ptr<const std::vector<uint8_t>>;
+
 // Abstract Bluetooth network interface that platforms must implement
 // This interface handles only BLE transport, all business logic is in BitchatManager
 class IBluetoothNetwork
@@ -43,6 +49,9 @@ public:
     // Send packet to specific peripheral by peripheralID
     virtual bool sendPacketToPeripheral(const BitchatPacket &packet, const std::string &peripheralID) = 0;
 
+    // Send an already serialized frame to specific peer as-is
+    virtual bool sendFrameToPeer(const SharedFrame &frame, const std::string &peerID) = 0;
+
     // Check if Bluetooth is ready
     virtual bool isReady() const = 0;
 
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "bitchat_protocol.h"
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -33,9 +35,10 @@ struct BinaryPacketHeader
     uint16_t checksum;
 
     bool isValid() const;
-    uint16_t computeChecksum(const std::vector<uint8_t> &payload) const;
+    uint16_t computeChecksum(std::span<const uint8_t> payload) const;
     std::vector<uint8_t> serialize() const;
-    static BinaryPacketHeader deserialize(const std::vector<uint8_t> &data);
+    void serializeInto(uint8_t *output) const; // writes headerSize bytes
+    static BinaryPacketHeader deserialize(std::span<const uint8_t> data);
 };
 
 // Binary Protocol
@@ -49,66 +52,66 @@ public:
     static std::vector<uint8_t> serializeMessage(const BitchatMessage &message);
 
     /// Deserialize a message from binary format
-    static std::shared_ptr<BitchatMessage> deserializeMessage(const std::vector<uint8_t> &data);
+    static std::shared_ptr<BitchatMessage> deserializeMessage(std::span<const uint8_t> data);
 
     /// Serialize handshake message
     static std::vector<uint8_t> serializeHandshakeMessage(const BitchatHandshakeMessage &message);
 
     /// Deserialize handshake message
-    static std::shared_ptr<BitchatHandshakeMessage> deserializeHandshakeMessage(const std::vector<uint8_t> &data);
+    static std::shared_ptr<BitchatHandshakeMessage> deserializeHandshakeMessage(std::span<const uint8_t> data);
 
     /// Serialize handshake response message
     static std::vector<uint8_t> serializeHandshakeResponseMessage(const BitchatHandshakeResponseMessage &message);
 
     /// Deserialize handshake response message
-    static std::shared_ptr<BitchatHandshakeResponseMessage> deserializeHandshakeResponseMessage(const std::vector<uint8_t> &data);
+    static std::shared_ptr<BitchatHandshakeResponseMessage> deserializeHandshakeResponseMessage(std::span<const uint8_t> data);
 
     /// Serialize chat message
     static std::vector<uint8_t> serializeChatMessage(const BitchatChatMessage &message);
 
     /// Deserialize chat message
-    static std::shared_ptr<BitchatChatMessage> deserializeChatMessage(const std::vector<uint8_t> &data);
+    static std::shared_ptr<BitchatChatMessage> deserializeChatMessage(std::span<const uint8_t> data);
 
     /// Serialize channel join message
     static std::vector<uint8_t> serializeChannelJoinMessage(const BitchatChannelJoinMessage &message);
 
     /// Deserialize channel join message
-    static std::shared_ptr<BitchatChannelJoinMessage> deserializeChannelJoinMessage(const std::vector<uint8_t> &data);
+    static std::shared_ptr<BitchatChannelJoinMessage> deserializeChannelJoinMessage(std::span<const uint8_t> data);
 
     /// Serialize channel leave message
     static std::vector<uint8_t> serializeChannelLeaveMessage(const BitchatChannelLeaveMessage &message);
 
     /// Deserialize channel leave message
-    static std::shared_ptr<BitchatChannelLeaveMessage> deserializeChannelLeaveMessage(const std::vector<uint8_t> &data);
+    static std::shared_ptr<BitchatChannelLeaveMessage> deserializeChannelLeaveMessage(std::span<const uint8_t> data);
 
     /// Serialize peer info message
     static std::vector<uint8_t> serializePeerInfoMessage(const BitchatPeerInfoMessage &message);
 
     /// Deserialize peer info message
-    static std::shared_ptr<BitchatPeerInfoMessage> deserializePeerInfoMessage(const std::vector<uint8_t> &data);
+    static std::shared_ptr<BitchatPeerInfoMessage> deserializePeerInfoMessage(std::span<const uint8_t> data);
 
     /// Serialize channel key share message
     static std::vector<uint8_t> serializeChannelKeyShareMessage(const BitchatChannelKeyShareMessage &message);
 
     /// Deserialize channel key share message
-    static std::shared_ptr<BitchatChannelKeyShareMessage> deserializeChannelKeyShareMessage(const std::vector<uint8_t> &data);
+    static std::shared_ptr<BitchatChannelKeyShareMessage> deserializeChannelKeyShareMessage(std::span<const uint8_t> data);
 
     /// Serialize keep alive message
     static std::vector<uint8_t> serializeKeepAliveMessage(const BitchatKeepAliveMessage &message);
 
     /// Deserialize keep alive message
-    static std::shared_ptr<BitchatKeepAliveMessage> deserializeKeepAliveMessage(const std::vector<uint8_t> &data);
+    static std::shared_ptr<BitchatKeepAliveMessage> deserializeKeepAliveMessage(std::span<const uint8_t> data);
 
     /// Serialize error message
     static std::vector<uint8_t> serializeErrorMessage(const BitchatErrorMessage &message);
 
     /// Deserialize error message
-    static std::shared_ptr<BitchatErrorMessage> deserializeErrorMessage(const std::vector<uint8_t> &data);
+    static std::shared_ptr<BitchatErrorMessage> deserializeErrorMessage(std::span<const uint8_t> data);
 
     // Validation
 
     /// Validate binary packet
-    static bool validatePacket(const std::vector<uint8_t> &data);
+    static bool validatePacket(std::span<const uint8_t> data);
 
     /// Validate packet header
     static bool validateHeader(const BinaryPacketHeader &header);
@@ -117,47 +120,61 @@ public:
     static bool validatePayloadSize(size_t payloadSize);
 
     /// Validate checksum
-    static bool validateChecksum(const BinaryPacketHeader &header, const std::vector<uint8_t> &payload);
+    static bool validateChecksum(const BinaryPacketHeader &header, std::span<const uint8_t> payload);
 
     // Utility
 
     /// Get message type from binary data
-    static BitchatMessageType getMessageType(const std::vector<uint8_t> &data);
+    static BitchatMessageType getMessageType(std::span<const uint8_t> data);
 
     /// Get payload from binary data
-    static std::vector<uint8_t> getPayload(const std::vector<uint8_t> &data);
+    static std::vector<uint8_t> getPayload(std::span<const uint8_t> data);
 
     /// Create error packet
     static std::vector<uint8_t> createErrorPacket(BitchatErrorCode errorCode, const std::string &errorMessage);
 
 private:
-    // Internal Serialization Helpers
+    friend struct BinaryPacketHeader;
+    friend class BinaryProtocolParser;
+    friend class BinaryProtocolBuilder;
 
-    static std::vector<uint8_t> serializeString(const std::string &str);
-    static std::string deserializeString(const std::vector<uint8_t> &data, size_t &offset);
+    // Packet Framing
 
-    static std::vector<uint8_t> serializeTimestamp(const std::chrono::system_clock::time_point &timestamp);
-    static std::chrono::system_clock::time_point deserializeTimestamp(const std::vector<uint8_t> &data, size_t &offset);
+    // Append header and payload in one pass, the header is patched once the payload size is known
+    static bool writePacket(std::vector<uint8_t> &output, const BitchatMessage &message);
+    static bool writePayload(std::vector<uint8_t> &output, const BitchatMessage &message);
 
-    static std::vector<uint8_t> serializeBytes(const std::vector<uint8_t> &bytes);
-    static std::vector<uint8_t> deserializeBytes(const std::vector<uint8_t> &data, size_t &offset);
+    // Decode a complete packet in place (nullptr if malformed)
+    static std::shared_ptr<BitchatMessage> readPacket(std::span<const uint8_t> packet);
+    static std::shared_ptr<BitchatMessage> readPayload(const BinaryPacketHeader &header, std::span<const uint8_t> payload);
 
-    static std::vector<uint8_t> serializeUint16(uint16_t value);
-    static uint16_t deserializeUint16(const std::vector<uint8_t> &data, size_t &offset);
+    // Internal Serialization Helpers (readers throw std::out_of_range on truncated data)
 
-    static std::vector<uint8_t> serializeUint8(uint8_t value);
-    static uint8_t deserializeUint8(const std::vector<uint8_t> &data, size_t &offset);
+    static void serializeString(std::vector<uint8_t> &output, const std::string &str);
+    static std::string deserializeString(std::span<const uint8_t> data, size_t &offset);
 
-    static std::vector<uint8_t> serializeInt32(int32_t value);
-    static int32_t deserializeInt32(const std::vector<uint8_t> &data, size_t &offset);
+    static void serializeTimestamp(std::vector<uint8_t> &output, const std::chrono::system_clock::time_point &timestamp);
+    static std::chrono::system_clock::time_point deserializeTimestamp(std::span<const uint8_t> data, size_t &offset);
 
-    static std::vector<uint8_t> serializeBool(bool value);
-    static bool deserializeBool(const std::vector<uint8_t> &data, size_t &offset);
+    static void serializeBytes(std::vector<uint8_t> &output, const std::vector<uint8_t> &bytes);
+    static std::vector<uint8_t> deserializeBytes(std::span<const uint8_t> data, size_t &offset);
+
+    static void serializeUint16(std::vector<uint8_t> &output, uint16_t value);
+    static uint16_t deserializeUint16(std::span<const uint8_t> data, size_t &offset);
+
+    static void serializeUint8(std::vector<uint8_t> &output, uint8_t value);
+    static uint8_t deserializeUint8(std::span<const uint8_t> data, size_t &offset);
+
+    static void serializeInt32(std::vector<uint8_t> &output, int32_t value);
+    static int32_t deserializeInt32(std::span<const uint8_t> data, size_t &offset);
+
+    static void serializeBool(std::vector<uint8_t> &output, bool value);
+    static bool deserializeBool(std::span<const uint8_t> data, size_t &offset);
 
     // Checksum
 
-    static uint16_t computeChecksum(const std::vector<uint8_t> &data);
-    static uint16_t computeFletcher16(const std::vector<uint8_t> &data);
+    static uint16_t computeChecksum(std::span<const uint8_t> data);
+    static uint16_t computeFletcher16(std::span<const uint8_t> data);
 };
 
 // Binary Protocol Parser
@@ -168,7 +185,7 @@ public:
     BinaryProtocolParser();
 
     /// Parse binary data into messages
-    std::vector<std::shared_ptr<BitchatMessage>> parseData(const std::vector<uint8_t> &data);
+    std::vector<std::shared_ptr<BitchatMessage>> parseData(std::span<const uint8_t> data);
 
     /// Get remaining incomplete data
     std::vector<uint8_t> getRemainingData() const;
@@ -180,11 +197,17 @@ public:
     bool hasIncompleteData() const;
 
 private:
+    // Unconsumed bytes are buffer_[readOffset_, end). Packets are decoded in
+    // place and the consumed prefix is only compacted once it dominates the
+    // buffer, so every packet stays contiguous and nothing is copied per message.
     std::vector<uint8_t> buffer_;
+    size_t readOffset_ = 0;
 
     std::shared_ptr<BitchatMessage> parseNextMessage();
     bool hasCompleteMessage() const;
     size_t getNextMessageSize() const;
+    bool resynchronize();
+    void compact();
 };
 
 // Binary Protocol Builder
@@ -197,6 +220,9 @@ public:
     /// Build a complete packet
     std::vector<uint8_t> buildPacket(const BitchatMessage &message);
 
+    /// Append a complete packet to output (returns false and leaves output unchanged on failure)
+    bool buildPacket(const BitchatMessage &message, std::vector<uint8_t> &output);
+
     /// Build packet header
     BinaryPacketHeader buildHeader(BitchatMessageType messageType, size_t payloadSize);
 
@@ -204,10 +230,7 @@ public:
     std::vector<uint8_t> buildPayload(const BitchatMessage &message);
 
     /// Finalize packet with checksum
-    std::vector<uint8_t> finalizePacket(const BinaryPacketHeader &header, const std::vector<uint8_t> &payload);
-
-private:
-    std::vector<uint8_t> buildBasePayload(const BitchatMessage &message);
+    std::vector<uint8_t> finalizePacket(const BinaryPacketHeader &header, std::span<const uint8_t> payload);
 };
 
 } // namespace protocol
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace bitchat
+{
+
+// Shared LZ4 dictionary for short payloads
+// Both ends must hold identical bytes, so any change to the contents needs a
+// new capability name. Peers advertise support in their version hello.
+struct CompressionDictionary
+{
+    // Capability advertised in the version hello
+    static const std::string CAPABILITY;
+
+    // Dictionary contents
+    static std::span<const uint8_t> get();
+};
+
+} // namespace bitchat
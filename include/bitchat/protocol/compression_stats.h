@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace bitchat
+{
+
+// Snapshot of the compression counters for one packet type
+struct CompressionTypeStats
+{
+    uint64_t packets = 0;    // payloads seen by the compression stage
+    uint64_t compressed = 0; // payloads sent compressed
+    uint64_t skipped = 0;    // payloads not tried (type, size or entropy)
+    uint64_t bytesIn = 0;    // payload bytes that went through LZ4
+    uint64_t bytesOut = 0;   // LZ4 output bytes for those payloads
+    uint64_t nanoseconds = 0;
+
+    // Compressed size relative to the input (1.0 if nothing was tried)
+    double getRatio() const { return bytesIn > 0 ? static_cast<double>(bytesOut) / bytesIn : 1.0; }
+};
+
+// CompressionStats: Process-wide, lock-free compression counters per packet type
+class CompressionStats
+{
+public:
+    static CompressionStats &shared();
+
+    // Record a payload that went through LZ4 (compressed is false if it did not shrink)
+    void recordAttempt(uint8_t type, size_t bytesIn, size_t bytesOut, bool compressed, std::chrono::nanoseconds elapsed);
+
+    // Record a payload that was sent without trying LZ4
+    void recordSkipped(uint8_t type);
+
+    CompressionTypeStats getStats(uint8_t type) const;
+    void reset();
+
+private:
+    CompressionStats() = default;
+
+    struct Counters
+    {
+        std::atomic<uint64_t> packets{0};
+        std::atomic<uint64_t> compressed{0};
+        std::atomic<uint64_t> skipped{0};
+        std::atomic<uint64_t> bytesIn{0};
+        std::atomic<uint64_t> bytesOut{0};
+        std::atomic<uint64_t> nanoseconds{0};
+    };
+
+    std::array<Counters, 256> counters;
+};
+
+} // namespace bitchat
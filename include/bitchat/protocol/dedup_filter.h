@@ -0,0 +1,85 @@
+#pragma once
+
+#include "bitchat/protocol/peer_id.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace bitchat
+{
+
+// DedupFilter: Fixed-memory filter of recently seen packet keys
+// A rotating Bloom filter: each shard keeps a few generations and inserts into
+// the newest one. When the newest generation is full or older than its time
+// span, the oldest generation is cleared and reused. A key is remembered for
+// at least the configured window unless the traffic exceeds the capacity, in
+// which case the window shrinks instead of everything being forgotten at once.
+// Shards are selected by key and locked independently.
+class DedupFilter
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Config
+    {
+        size_t capacity;                  // keys expected within one window
+        double falsePositiveRate;         // over all generations
+        std::chrono::milliseconds window; // minimum time a key is remembered
+        size_t generations;               // at least 2
+        size_t shards;                    // at least 1
+    };
+
+    // Uses the DEDUP_* constants
+    DedupFilter();
+    explicit DedupFilter(const Config &config);
+
+    // Records key, returns false if it was (probably) already seen within the window
+    bool insert(uint64_t key);
+    bool insert(uint64_t key, Clock::time_point now);
+
+    // Check without recording
+    bool contains(uint64_t key);
+    bool contains(uint64_t key, Clock::time_point now);
+
+    // Forget all keys
+    void clear();
+
+    // Sizing, as derived from the config
+    size_t getBitsPerGeneration() const { return bitsPerGeneration; }
+    size_t getHashCount() const { return hashCount; }
+    size_t getMemoryUsage() const;
+
+    // 64-bit key for (sender, timestamp, type), discriminator tells apart packets that share those
+    static uint64_t makeKey(PeerId sender, uint64_t timestamp, uint8_t type, std::span<const uint8_t> discriminator = {});
+
+private:
+    struct alignas(64) Shard
+    {
+        std::mutex mutex;
+        std::vector<uint64_t> bits;       // generations * wordsPerGeneration
+        std::vector<size_t> counts;       // keys inserted per generation
+        size_t current = 0;               // generation receiving inserts
+        Clock::time_point currentStart{}; // when the current generation started
+    };
+
+    Shard &shardFor(uint64_t key);
+
+    // Rotate out generations older than the window, call with the shard locked
+    void advance(Shard &shard, Clock::time_point now);
+    void rotate(Shard &shard, Clock::time_point start);
+    bool testGeneration(const Shard &shard, size_t generation, uint64_t h1, uint64_t h2) const;
+
+    Config config;
+    size_t keysPerGeneration = 0;
+    size_t bitsPerGeneration = 0;
+    size_t wordsPerGeneration = 0;
+    size_t hashCount = 0;
+    Clock::duration generationSpan{};
+    std::unique_ptr<Shard[]> shards;
+};
+
+} // namespace bitchat
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "bitchat/core/constants.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace bitchat
+{
+
+// FragmentReassembler: Bounded table of in-flight fragmented frames
+// Assemblies are keyed by sender and fragment ID. Fragments may arrive in any
+// order, duplicates are ignored, and each sender has a memory and assembly
+// quota so a single peer cannot exhaust the table. Incomplete assemblies are
+// dropped after the timeout.
+class FragmentReassembler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    FragmentReassembler(size_t maxBytesPerSender = constants::FRAGMENT_MAX_BYTES_PER_SENDER, size_t maxAssembliesPerSender = constants::FRAGMENT_MAX_ASSEMBLIES_PER_SENDER, size_t maxTotalBytes = constants::FRAGMENT_MAX_TOTAL_BYTES, Clock::duration timeout = constants::FRAGMENT_TIMEOUT);
+
+    // Add a fragment payload, returns the reassembled frame once every fragment has arrived
+    std::optional<std::vector<uint8_t>> addFragment(std::span<const uint8_t> senderID, std::span<const uint8_t> payload, Clock::time_point now = Clock::now());
+
+    // Drop assemblies older than the timeout
+    void cleanupExpired(Clock::time_point now = Clock::now());
+
+    // Statistics
+    size_t getPendingCount() const;
+    size_t getBufferedBytes() const;
+
+private:
+    using Key = std::pair<uint64_t, uint64_t>; // senderID, fragmentID
+
+    struct Assembly
+    {
+        Clock::time_point startedAt;
+        uint8_t originalType = 0;
+        std::vector<std::vector<uint8_t>> chunks;
+        std::vector<bool> received;
+        size_t receivedCount = 0;
+        size_t bytes = 0;
+    };
+
+    struct SenderUsage
+    {
+        size_t bytes = 0;
+        size_t assemblies = 0;
+    };
+
+    size_t maxBytesPerSender;
+    size_t maxAssembliesPerSender;
+    size_t maxTotalBytes;
+    Clock::duration timeout;
+
+    std::map<Key, Assembly> assemblies;
+    std::map<uint64_t, SenderUsage> senderUsage;
+    size_t totalBytes = 0;
+    mutable std::mutex mutex;
+
+    void removeAssembly(std::map<Key, Assembly>::iterator it);
+    void cleanupExpiredLocked(Clock::time_point now);
+};
+
+} // namespace bitchat
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <vector>
 
 namespace bitchat
@@ -17,11 +19,26 @@ struct MessagePadding
     // Add PKCS#7-style padding to reach target size
     static std::vector<uint8_t> pad(const std::vector<uint8_t> &data, size_t targetSize);
 
+    // Pad data in place, growing into its reserved capacity (false if left unpadded)
+    static bool padInPlace(std::vector<uint8_t> &data, size_t targetSize);
+
+    // Fill padding bytes in place: random bytes from a per-thread CSPRNG pool followed by the padding length
+    static void fillPadding(std::span<uint8_t> padding);
+
     // Remove padding from data
     static std::vector<uint8_t> unpad(const std::vector<uint8_t> &data);
 
+    // Data without its padding, pointing into the same buffer (data itself if the padding is invalid)
+    static std::span<const uint8_t> unpadView(std::span<const uint8_t> data);
+
+    // Strip padding in place (false if the padding is invalid)
+    static bool unpadInPlace(std::vector<uint8_t> &data);
+
     // Find optimal block size for data
     static size_t optimalBlockSize(size_t dataSize);
+
+    // Size of data after pad() with its optimal block size (dataSize if it is left unpadded)
+    static size_t paddedSize(size_t dataSize);
 };
 
 } // namespace bitchat
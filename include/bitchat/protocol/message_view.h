@@ -0,0 +1,75 @@
+#pragma once
+
+#include "bitchat/protocol/packet.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace bitchat
+{
+
+// Message payload flags
+constexpr uint8_t MSG_FLAG_IS_RELAY = 0x01;
+constexpr uint8_t MSG_FLAG_IS_PRIVATE = 0x02;
+constexpr uint8_t MSG_FLAG_HAS_ORIGINAL_SENDER = 0x04;
+constexpr uint8_t MSG_FLAG_HAS_RECIPIENT_NICKNAME = 0x08;
+constexpr uint8_t MSG_FLAG_HAS_SENDER_PEER_ID = 0x10;
+constexpr uint8_t MSG_FLAG_HAS_MENTIONS = 0x20;
+constexpr uint8_t MSG_FLAG_HAS_CHANNEL = 0x40;
+constexpr uint8_t MSG_FLAG_IS_ENCRYPTED = 0x80;
+
+// BitchatMessageView: Non-owning, lazily decoded view of a message payload
+// Only the fixed part (flags, timestamp, id, sender, content) is located when
+// the view is created. Optional fields are found on demand, so routing checks
+// such as getChannel() never allocate. Like PacketView, the view is only
+// valid while the payload buffer is alive. Call toMessage() to keep it.
+class BitchatMessageView
+{
+public:
+    // Flags
+    uint8_t getFlags() const { return payload[0]; }
+    bool isRelay() const { return getFlags() & MSG_FLAG_IS_RELAY; }
+    bool isPrivate() const { return getFlags() & MSG_FLAG_IS_PRIVATE; }
+    bool isEncrypted() const { return getFlags() & MSG_FLAG_IS_ENCRYPTED; }
+
+    // Fixed fields
+    uint64_t getTimestamp() const;
+    std::string_view getId() const { return stringAt(idOffset, idLength); }
+    std::string_view getSender() const { return stringAt(senderOffset, senderLength); }
+    std::string_view getContent() const { return stringAt(contentOffset, contentLength); }
+
+    // Optional fields (empty when absent or truncated)
+    std::string_view getOriginalSender() const;
+    std::string_view getRecipientNickname() const;
+    std::string_view getSenderPeerID() const;
+    size_t getMentionCount() const;
+    std::string_view getMention(size_t index) const;
+    std::string_view getChannel() const;
+
+    // Materialize an owning message
+    BitchatMessage toMessage() const;
+
+private:
+    friend class PacketSerializer;
+
+    BitchatMessageView(std::span<const uint8_t> payload, size_t idOffset, size_t senderOffset, size_t contentOffset);
+
+    std::span<const uint8_t> payload;
+    size_t idOffset = 0;
+    size_t idLength = 0;
+    size_t senderOffset = 0;
+    size_t senderLength = 0;
+    size_t contentOffset = 0;
+    size_t contentLength = 0;
+
+    std::string_view stringAt(size_t offset, size_t length) const;
+
+    // String with a 1-byte length prefix at offset (empty if truncated)
+    std::string_view lengthPrefixedAt(size_t offset) const;
+
+    // Offset of the optional field selected by flag, walking the fields in wire order (npos if absent)
+    size_t locateOptionalField(uint8_t flag) const;
+};
+
+} // namespace bitchat
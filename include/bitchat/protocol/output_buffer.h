@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace bitchat
+{
+
+// OutputBuffer: Reusable byte buffer for outbound packets
+// Capacity is kept between uses so a buffer owned by a thread or connection
+// stops allocating once it has grown to the largest frame it has written.
+class OutputBuffer
+{
+public:
+    OutputBuffer() = default;
+    explicit OutputBuffer(size_t initialCapacity) { bytes.reserve(initialCapacity); }
+
+    // Resize to exactly size bytes and return a pointer to the start (contents are unspecified)
+    uint8_t *prepare(size_t size)
+    {
+        bytes.resize(size);
+        return bytes.data();
+    }
+
+    // Shrink the written size without releasing capacity
+    void truncate(size_t size)
+    {
+        if (size < bytes.size())
+        {
+            bytes.resize(size);
+        }
+    }
+
+    void clear() { bytes.clear(); }
+    void reserve(size_t size) { bytes.reserve(size); }
+
+    // Accessors
+    const uint8_t *data() const { return bytes.data(); }
+    uint8_t *data() { return bytes.data(); }
+    size_t size() const { return bytes.size(); }
+    size_t capacity() const { return bytes.capacity(); }
+    bool empty() const { return bytes.empty(); }
+    std::span<const uint8_t> getData() const { return bytes; }
+
+    // Move the written bytes out, leaving the buffer empty
+    std::vector<uint8_t> release() { return std::exchange(bytes, {}); }
+
+private:
+    std::vector<uint8_t> bytes;
+};
+
+} // namespace bitchat
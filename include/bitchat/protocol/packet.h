@@ -1,7 +1,11 @@
 #pragma once
 
+#include "bitchat/protocol/peer_id.h"
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace bitchat
@@ -30,6 +34,8 @@ constexpr uint8_t PKT_TYPE_CHANNEL_KEY_VERIFY_REQUEST = 0x14;
 constexpr uint8_t PKT_TYPE_CHANNEL_KEY_VERIFY_RESPONSE = 0x15;
 constexpr uint8_t PKT_TYPE_CHANNEL_PASSWORD_UPDATE = 0x16;
 constexpr uint8_t PKT_TYPE_CHANNEL_METADATA = 0x17;
+constexpr uint8_t PKT_TYPE_SENDER_KEY = 0x18;         // sender key, Noise encrypted for one peer
+constexpr uint8_t PKT_TYPE_SENDER_KEY_MESSAGE = 0x19; // channel message encrypted once with a sender key
 
 // Protocol version negotiation
 constexpr uint8_t PKT_TYPE_VERSION_HELLO = 0x20;
@@ -39,16 +45,25 @@ constexpr uint8_t PKT_TYPE_VERSION_ACK = 0x21;
 constexpr uint8_t FLAG_HAS_RECIPIENT = 0x01;
 constexpr uint8_t FLAG_HAS_SIGNATURE = 0x02;
 constexpr uint8_t FLAG_IS_COMPRESSED = 0x04;
+constexpr uint8_t FLAG_USES_DICTIONARY = 0x80; // compressed against CompressionDictionary
 
 // Default TTL
 constexpr uint8_t PKT_TTL = 7;
 
+// Wire layout sizes (header: version + type + ttl + timestamp + flags + payloadLength)
+constexpr size_t PKT_HEADER_SIZE = 14;
+constexpr size_t PKT_SENDER_ID_SIZE = 8;
+constexpr size_t PKT_RECIPIENT_ID_SIZE = 8;
+constexpr size_t PKT_SIGNATURE_SIZE = 64;
+constexpr size_t PKT_MIN_SIZE = PKT_HEADER_SIZE + PKT_SENDER_ID_SIZE;
+
 // BitchatPacket: Represents a protocol packet sent via Bluetooth
 class BitchatPacket
 {
 public:
     BitchatPacket() = default;
     BitchatPacket(uint8_t type, const std::vector<uint8_t> &payload);
+    BitchatPacket(uint8_t type, std::vector<uint8_t> &&payload);
 
     // Getters
     uint8_t getVersion() const { return version; }
@@ -61,6 +76,8 @@ public:
     const std::vector<uint8_t> &getRecipientID() const { return recipientID; }
     const std::vector<uint8_t> &getPayload() const { return payload; }
     const std::vector<uint8_t> &getSignature() const { return signature; }
+    PeerId getSenderPeerId() const { return PeerId::fromBytes(senderID); }
+    PeerId getRecipientPeerId() const { return PeerId::fromBytes(recipientID); }
 
     // Setters
     void setVersion(uint8_t v) { version = v; }
@@ -70,19 +87,31 @@ public:
     void setFlags(uint8_t f) { flags = f; }
     void setPayloadLength(uint16_t len) { payloadLength = len; }
     void setSenderID(const std::vector<uint8_t> &id) { senderID = id; }
+    void setSenderID(std::vector<uint8_t> &&id) { senderID = std::move(id); }
+    void setSenderID(PeerId id) { assignPeerId(senderID, id); }
     void setRecipientID(const std::vector<uint8_t> &id) { recipientID = id; }
+    void setRecipientID(std::vector<uint8_t> &&id) { recipientID = std::move(id); }
+    void setRecipientID(PeerId id) { assignPeerId(recipientID, id); }
     void setPayload(const std::vector<uint8_t> &p)
     {
         payload = p;
         payloadLength = static_cast<uint16_t>(p.size());
     }
+    void setPayload(std::vector<uint8_t> &&p)
+    {
+        payloadLength = static_cast<uint16_t>(p.size());
+        payload = std::move(p);
+    }
     void setSignature(const std::vector<uint8_t> &sig) { signature = sig; }
+    void setSignature(std::vector<uint8_t> &&sig) { signature = std::move(sig); }
 
     // Utility methods
     std::string getTypeString() const;
+    static std::string getTypeString(uint8_t type);
     bool hasRecipient() const { return flags & FLAG_HAS_RECIPIENT; }
     bool hasSignature() const { return flags & FLAG_HAS_SIGNATURE; }
     bool isCompressed() const { return flags & FLAG_IS_COMPRESSED; }
+    bool usesDictionary() const { return flags & FLAG_USES_DICTIONARY; }
     void setHasRecipient(bool has)
     {
         if (has)
@@ -117,11 +146,31 @@ public:
         }
     }
 
+    // Before serializing: allow dictionary compression (the receiver must support it)
+    void setUsesDictionary(bool uses)
+    {
+        if (uses)
+        {
+            flags |= FLAG_USES_DICTIONARY;
+        }
+        else
+        {
+            flags &= ~FLAG_USES_DICTIONARY;
+        }
+    }
+
     // Validation
     bool isValid() const;
     size_t getTotalSize() const;
 
 private:
+    // Reuses the existing capacity, so the per-packet sender ID does not allocate
+    static void assignPeerId(std::vector<uint8_t> &target, PeerId id)
+    {
+        std::array<uint8_t, PeerId::SIZE> bytes = id.toBytes();
+        target.assign(bytes.begin(), bytes.end());
+    }
+
     uint8_t version = PKT_VERSION;
     uint8_t type = 0;
     uint8_t ttl = PKT_TTL;
@@ -203,34 +252,44 @@ public:
     const std::string &getNickname() const { return nickname; }
     const std::string &getChannel() const { return channel; }
     const std::string &getPeerID() const { return peerID; }
+    PeerId getId() const { return id; }
     time_t getLastSeen() const { return lastSeen; }
     int getRSSI() const { return RSSI; }
     bool hasAnnounced() const { return hasAnnouncedFlag; }
     const std::string &getPeripheralID() const { return peripheralID; }
+    bool supportsCompressionDictionary() const { return compressionDictionaryFlag; }
 
     // Setters
     void setNickname(const std::string &n) { nickname = n; }
     void setChannel(const std::string &c) { channel = c; }
-    void setPeerID(const std::string &pid) { peerID = pid; }
+    void setPeerID(const std::string &pid)
+    {
+        peerID = pid;
+        id = PeerId::fromHex(pid).value_or(PeerId());
+    }
     void setLastSeen(time_t ls) { lastSeen = ls; }
     void setRSSI(int r) { RSSI = r; }
     void setHasAnnounced(bool announced) { hasAnnouncedFlag = announced; }
     void setPeripheralID(const std::string &peripheralID) { this->peripheralID = peripheralID; }
+    void setSupportsCompressionDictionary(bool supports) { compressionDictionaryFlag = supports; }
 
     // Utility methods
     void updateLastSeen();
     bool isStale(time_t timeout = 180) const;
     std::string getDisplayName() const;
     bool isPeerID(const std::string &pid) { return peerID == pid; }
+    bool isPeerID(PeerId pid) const { return id == pid; }
 
 private:
     std::string peerID;
+    PeerId id; // parsed peerID, used for lookups
     std::string peripheralID;
     std::string nickname;
     std::string channel;
     time_t lastSeen = 0;
     int RSSI = -100;
     bool hasAnnouncedFlag = false;
+    bool compressionDictionaryFlag = false;
 };
 
 } // namespace bitchat
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "bitchat/protocol/packet.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace bitchat
+{
+
+// Fragment payload layout:
+// fragmentID (8 bytes) + index (2 bytes) + total (2 bytes) + originalType (1 byte) + data
+struct FragmentHeader
+{
+    static constexpr size_t SIZE = 13;
+
+    uint64_t fragmentID = 0;
+    uint16_t index = 0;
+    uint16_t total = 0;
+    uint8_t originalType = 0;
+
+    // Parse the header at the start of a fragment payload (false if too short or inconsistent)
+    static bool parse(std::span<const uint8_t> payload, FragmentHeader &header);
+};
+
+// PacketFragmenter: Splits serialized frames that exceed the link MTU into fragment packets
+struct PacketFragmenter
+{
+    // Split the serialized frame of packet into FRAGMENT_START/CONTINUE/END packets
+    // whose serialized size does not exceed maxFrameSize
+    static std::vector<BitchatPacket> fragment(const BitchatPacket &packet, std::span<const uint8_t> frame, size_t maxFrameSize);
+
+    // Bytes of the original frame carried by each fragment for a given MTU
+    static size_t getFragmentDataSize(size_t maxFrameSize, bool hasRecipient);
+
+    // Check if a packet type is one of the fragment types
+    static bool isFragmentType(uint8_t type);
+};
+
+} // namespace bitchat
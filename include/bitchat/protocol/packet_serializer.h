@@ -1,6 +1,12 @@
 #pragma once
 
+#include "message_view.h"
+#include "output_buffer.h"
 #include "packet.h"
+#include "packet_view.h"
+#include <memory>
+#include <optional>
+#include <span>
 #include <vector>
 
 namespace bitchat
@@ -16,21 +22,42 @@ public:
     // Serialize packet to binary data
     std::vector<uint8_t> serializePacket(const BitchatPacket &packet);
 
+    // Serialize packet directly into a reusable buffer (no allocations once the buffer has grown)
+    void serializeInto(const BitchatPacket &packet, OutputBuffer &output);
+
     // Deserialize binary data to packet
     BitchatPacket deserializePacket(const std::vector<uint8_t> &data);
 
+    // Copy a received frame for relaying with only its TTL patched (padding is regenerated)
+    std::shared_ptr<const std::vector<uint8_t>> makeRelayFrame(const PacketView &packet, uint8_t ttl);
+
+    // Parse binary data into a view without copying (std::nullopt if incomplete or malformed)
+    std::optional<PacketView> parsePacketView(std::span<const uint8_t> data);
+
+    // Size of the unpadded frame described by the header at the start of data (0 if header is incomplete)
+    static size_t getFrameSize(std::span<const uint8_t> data);
+
     // Create message payload
     std::vector<uint8_t> makeMessagePayload(const BitchatMessage &message);
 
     // Parse message payload
     BitchatMessage parseMessagePayload(const std::vector<uint8_t> &payload);
 
+    // Parse message payload into a lazily decoded view (std::nullopt if malformed)
+    std::optional<BitchatMessageView> parseMessageView(std::span<const uint8_t> payload);
+
     // Create announce payload
     std::vector<uint8_t> makeAnnouncePayload(const std::string &nickname);
 
     // Parse announce payload
     void parseAnnouncePayload(const std::vector<uint8_t> &payload, std::string &nickname);
 
+    // Create Noise identity announce payload: peer ID (hex) followed by the raw Ed25519 signing key
+    std::vector<uint8_t> makeIdentityAnnouncePayload(const std::string &peerIdHex, const std::vector<uint8_t> &signingPublicKey);
+
+    // Parse Noise identity announce payload, the signing key is empty when the sender does not announce one
+    void parseIdentityAnnouncePayload(const std::vector<uint8_t> &payload, std::string &peerIdHex, std::vector<uint8_t> &signingPublicKey);
+
     // Create channel announce payload
     std::vector<uint8_t> makeChannelAnnouncePayload(const std::string &channel, bool joining);
 
@@ -59,12 +86,12 @@ private:
     void writeUint8(std::vector<uint8_t> &data, uint8_t value);
 
     // Helper functions for deserialization
-    uint64_t readUint64(const std::vector<uint8_t> &data, size_t &offset);
-    uint16_t readUint16(const std::vector<uint8_t> &data, size_t &offset);
-    uint8_t readUint8(const std::vector<uint8_t> &data, size_t &offset);
+    uint64_t readUint64(std::span<const uint8_t> data, size_t &offset);
+    uint16_t readUint16(std::span<const uint8_t> data, size_t &offset);
+    uint8_t readUint8(std::span<const uint8_t> data, size_t &offset);
 
     // Validate packet size
-    bool validatePacketSize(const std::vector<uint8_t> &data, size_t expectedSize);
+    bool validatePacketSize(std::span<const uint8_t> data, size_t expectedSize);
 };
 
 } // namespace bitchat
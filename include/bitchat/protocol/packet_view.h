@@ -0,0 +1,61 @@
+#pragma once
+
+#include "bitchat/protocol/packet.h"
+#include <cstdint>
+#include <span>
+
+namespace bitchat
+{
+
+// PacketView: Non-owning, read-only view of a serialized packet
+// All accessors point into the buffer the view was parsed from, so the view
+// is only valid while that buffer is alive and unchanged. Call toPacket() to
+// keep the packet beyond that.
+class PacketView
+{
+public:
+    // Header fields
+    uint8_t getVersion() const { return frame[0]; }
+    uint8_t getType() const { return frame[1]; }
+    uint8_t getTTL() const { return frame[2]; }
+    uint64_t getTimestamp() const;
+    uint8_t getFlags() const { return frame[11]; }
+    uint16_t getPayloadLength() const { return static_cast<uint16_t>((frame[12] << 8) | frame[13]); }
+
+    // Variable sections
+    std::span<const uint8_t> getSenderID() const { return frame.subspan(PKT_HEADER_SIZE, PKT_SENDER_ID_SIZE); }
+    std::span<const uint8_t> getRecipientID() const;
+    std::span<const uint8_t> getPayload() const { return frame.subspan(payloadOffset, payloadSize); }
+    std::span<const uint8_t> getSignature() const;
+    PeerId getSenderPeerId() const { return PeerId::fromBytes(getSenderID()); }
+    PeerId getRecipientPeerId() const { return PeerId::fromBytes(getRecipientID()); }
+
+    // Size of the payload before compression (same as payload size when not compressed)
+    uint16_t getOriginalPayloadSize() const { return originalPayloadSize; }
+
+    // Complete unpadded frame as it was received
+    std::span<const uint8_t> getFrame() const { return frame; }
+
+    // Utility methods
+    bool hasRecipient() const { return getFlags() & FLAG_HAS_RECIPIENT; }
+    bool hasSignature() const { return getFlags() & FLAG_HAS_SIGNATURE; }
+    bool isCompressed() const { return getFlags() & FLAG_IS_COMPRESSED; }
+    bool usesDictionary() const { return getFlags() & FLAG_USES_DICTIONARY; }
+    bool isValid() const;
+
+    // Materialize an owning packet (decompresses the payload if needed, the
+    // dictionary flag is cleared since it only applies to the link it came from)
+    BitchatPacket toPacket() const;
+
+private:
+    friend class PacketSerializer;
+
+    PacketView(std::span<const uint8_t> frame, size_t payloadOffset, size_t payloadSize, uint16_t originalPayloadSize);
+
+    std::span<const uint8_t> frame;
+    size_t payloadOffset = 0;
+    size_t payloadSize = 0;
+    uint16_t originalPayloadSize = 0;
+};
+
+} // namespace bitchat
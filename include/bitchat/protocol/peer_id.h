@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <spdlog/fmt/fmt.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bitchat
+{
+
+// PeerId: 8 byte peer identifier held by value
+// Stored as the big-endian integer of the wire bytes, so ordering matches the
+// lowercase hex form. Hex strings only appear at the UI and log edges.
+class PeerId
+{
+public:
+    static constexpr size_t SIZE = 8;
+    static constexpr size_t HEX_LENGTH = SIZE * 2;
+
+    constexpr PeerId() = default;
+    constexpr explicit PeerId(uint64_t value)
+        : value(value)
+    {
+        // Pass
+    }
+
+    // First SIZE bytes of data, zero filled when shorter
+    static PeerId fromBytes(std::span<const uint8_t> data);
+
+    // Exactly HEX_LENGTH hex digits, std::nullopt otherwise
+    static std::optional<PeerId> fromHex(std::string_view hex);
+
+    // Accessors
+    constexpr uint64_t getValue() const { return value; }
+    constexpr bool isEmpty() const { return value == 0; }
+
+    // Conversions
+    std::array<uint8_t, SIZE> toBytes() const;
+    std::vector<uint8_t> toVector() const;
+    std::string toHex() const;
+
+    // Writes HEX_LENGTH characters, no terminator
+    void writeHex(char *output) const;
+
+    constexpr auto operator<=>(const PeerId &) const = default;
+
+private:
+    uint64_t value = 0;
+};
+
+} // namespace bitchat
+
+template <>
+struct std::hash<bitchat::PeerId>
+{
+    size_t operator()(const bitchat::PeerId &id) const noexcept
+    {
+        // Peer IDs are random, one multiply spreads them across the buckets
+        return static_cast<size_t>((id.getValue() * 0x9E3779B97F4A7C15ULL) >> 16);
+    }
+};
+
+template <>
+struct fmt::formatter<bitchat::PeerId> : fmt::formatter<fmt::string_view>
+{
+    template <typename FormatContext>
+    auto format(const bitchat::PeerId &id, FormatContext &ctx) const
+    {
+        char hex[bitchat::PeerId::HEX_LENGTH];
+        id.writeHex(hex);
+        return fmt::formatter<fmt::string_view>::format(fmt::string_view(hex, sizeof(hex)), ctx);
+    }
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "bitchat/protocol/peer_id.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace bitchat
+{
+
+// RateLimiter: Token buckets for received handshakes and messages, per peer, per link and global
+// Each bucket holds up to count tokens and refills at count per period. It is
+// kept as the single time at which it would be full again (a token bucket in
+// virtual scheduling form), so taking a token is one compare-and-swap and no
+// lock is ever held. Sender IDs are claimed, not proven, so a peer is charged
+// on the link the packet arrived on: spoofing a peer's ID from another link
+// does not drain the buckets of its real packets. Each link also has a bucket
+// of its own, charged first, which caps what one link can send under any
+// number of sender IDs. Peer and link buckets live in two fixed tables split
+// into shards; a key probes a few slots of its shard and takes over a slot
+// whose buckets have refilled. Keys that find no slot share the shard's
+// overflow buckets, so spoofed IDs cannot grow the tables. The global buckets
+// are only charged once the peer bucket allows, so one flooding peer does not
+// drain them for everybody else.
+class RateLimiter
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Kind
+    {
+        Handshake,
+        Message,
+    };
+
+    struct Limit
+    {
+        size_t count;                     // tokens per period, also the burst, at least 1
+        std::chrono::milliseconds period; // refill time of count tokens
+    };
+
+    struct Config
+    {
+        Limit peerHandshakes;
+        Limit peerMessages;
+        Limit linkHandshakes;
+        Limit linkMessages;
+        Limit globalHandshakes;
+        Limit globalMessages;
+        size_t shards;        // of each table, at least 1
+        size_t slotsPerShard; // at least 1
+    };
+
+    struct Stats
+    {
+        uint64_t allowed = 0;
+        uint64_t limitedPeer = 0;
+        uint64_t limitedLink = 0;
+        uint64_t limitedGlobal = 0;
+    };
+
+    // Uses the NOISE_MAX_* and RATE_LIMIT_* constants
+    RateLimiter();
+    explicit RateLimiter(const Config &config);
+
+    RateLimiter(const RateLimiter &) = delete;
+    RateLimiter &operator=(const RateLimiter &) = delete;
+
+    // Takes a token from the link, peer and global buckets of kind, false if any is empty.
+    // linkID names the link the packet was received on.
+    bool allow(const std::string &linkID, PeerId peerID, Kind kind);
+    bool allow(const std::string &linkID, PeerId peerID, Kind kind, Clock::time_point now);
+
+    Stats getStats() const;
+
+private:
+    static constexpr size_t KINDS = 2;
+
+    // Time each bucket is full again, in nanoseconds of Clock (0 starts full)
+    using Buckets = std::array<std::atomic<int64_t>, KINDS>;
+
+    struct Slot
+    {
+        std::atomic<uint64_t> key{0}; // 0 while the slot is free
+        Buckets buckets{};
+    };
+
+    struct alignas(64) Shard
+    {
+        std::unique_ptr<Slot[]> slots;
+        Buckets overflow{};
+    };
+
+    struct Rate
+    {
+        int64_t interval; // nanoseconds per token
+        int64_t burst;    // nanoseconds the bucket may run ahead of now
+    };
+
+    static Rate makeRate(const Limit &limit);
+    static bool take(std::atomic<int64_t> &bucket, const Rate &rate, int64_t now);
+
+    static uint64_t makeLinkKey(const std::string &linkID);
+    static uint64_t makePeerKey(uint64_t linkKey, PeerId peerID);
+
+    std::unique_ptr<Shard[]> makeTable() const;
+    Buckets &bucketsFor(Shard *table, uint64_t key, int64_t now);
+    bool isIdle(const Buckets &buckets, int64_t now) const;
+
+    Config config;
+    std::array<Rate, KINDS> peerRates;
+    std::array<Rate, KINDS> linkRates;
+    std::array<Rate, KINDS> globalRates;
+    std::unique_ptr<Shard[]> peerTable;
+    std::unique_ptr<Shard[]> linkTable;
+
+    alignas(64) Buckets global{};
+
+    alignas(64) std::atomic<uint64_t> allowed{0};
+    std::atomic<uint64_t> limitedPeer{0};
+    std::atomic<uint64_t> limitedLink{0};
+    std::atomic<uint64_t> limitedGlobal{0};
+};
+
+} // namespace bitchat
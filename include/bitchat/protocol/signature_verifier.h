@@ -0,0 +1,154 @@
+#pragma once
+
+#include "bitchat/protocol/peer_id.h"
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace bitchat
+{
+
+// SignatureVerifier: Ed25519 verification of received packets off the receive path
+// Public keys are learned from identity announces and pinned on first use: a
+// different key announced later for the same peer is refused. A full key table
+// only makes room by dropping a key idle for keyIdleTime, so a flood of new
+// peer IDs cannot unpin the keys of peers in use. Submitted
+// signatures are queued and verified by a small worker pool; each worker takes
+// up to batchSize jobs per wakeup and verifies them with its own digest
+// context, so the queue lock and the context setup are paid once per batch.
+// Outcomes are cached by (sender, digest of signature and data): the same
+// signed packet arriving over several relay paths is verified once, and a copy
+// arriving while the first is still queued is reported as in flight.
+// Thread safe.
+class SignatureVerifier
+{
+public:
+    struct Config
+    {
+        size_t threads;                   // at least 1
+        size_t batchSize;                 // jobs taken per wakeup, at least 1
+        size_t queueCapacity;             // jobs waiting, beyond that submit reports QueueFull
+        size_t cacheSize;                 // outcomes remembered
+        size_t maxKeys;                   // public keys kept, beyond that new keys are refused
+        std::chrono::seconds keyIdleTime; // unused this long, a key may be dropped for a new one
+    };
+
+    enum class SubmitResult
+    {
+        Queued,     // callback runs on a worker once verified
+        Verified,   // verified before, callback not called
+        Rejected,   // failed verification before, callback not called
+        InFlight,   // an identical signature is being verified, callback not called
+        UnknownKey, // no public key learned for the sender
+        QueueFull,  // over capacity or stopped, a later copy may get through
+    };
+
+    struct Stats
+    {
+        uint64_t verified = 0;
+        uint64_t rejected = 0;
+        uint64_t cacheHits = 0;
+        uint64_t batches = 0;
+        uint64_t dropped = 0;
+    };
+
+    using Callback = std::function<void(bool valid)>;
+    using Clock = std::chrono::steady_clock;
+
+    // Uses the SIGNATURE_* constants
+    SignatureVerifier();
+    explicit SignatureVerifier(const Config &config);
+    ~SignatureVerifier();
+
+    SignatureVerifier(const SignatureVerifier &) = delete;
+    SignatureVerifier &operator=(const SignatureVerifier &) = delete;
+
+    // Learn the raw 32-byte Ed25519 public key of a peer, false if it is
+    // malformed, a different key is already pinned for the peer or the table
+    // is full of keys in use
+    bool setPublicKey(PeerId peerID, std::span<const uint8_t> publicKey);
+    bool setPublicKey(PeerId peerID, std::span<const uint8_t> publicKey, Clock::time_point now);
+    bool hasPublicKey(PeerId peerID) const;
+
+    // Queue data signed by sender for verification
+    SubmitResult submit(PeerId sender, std::vector<uint8_t> data, std::vector<uint8_t> signature, Callback callback);
+
+    // Verify on the calling thread, bypassing the queue and the cache
+    // (std::nullopt if the sender's key is unknown)
+    std::optional<bool> verify(PeerId sender, std::span<const uint8_t> data, std::span<const uint8_t> signature) const;
+
+    // Stop the workers, queued jobs are dropped without calling back
+    void stop();
+
+    Stats getStats() const;
+
+private:
+    using Digest = std::array<uint8_t, 32>;
+    using KeyPtr = std::shared_ptr<void>; // EVP_PKEY*
+
+    struct DigestHash
+    {
+        size_t operator()(const Digest &digest) const;
+    };
+
+    enum class Outcome
+    {
+        Pending,
+        Valid,
+        Invalid,
+    };
+
+    struct PinnedKey
+    {
+        KeyPtr key;
+        mutable Clock::time_point lastUsed; // announced again or used to verify
+    };
+
+    struct Job
+    {
+        KeyPtr key;
+        Digest digest;
+        std::vector<uint8_t> data;
+        std::vector<uint8_t> signature;
+        Callback callback;
+    };
+
+    void workerLoop();
+    KeyPtr findKey(PeerId peerID) const;
+
+    // Record an outcome, call with mutex held
+    void setOutcome(const Digest &digest, Outcome outcome);
+
+    static std::optional<Digest> makeDigest(PeerId sender, std::span<const uint8_t> data, std::span<const uint8_t> signature);
+    static bool verifyWith(void *context, void *key, std::span<const uint8_t> data, std::span<const uint8_t> signature);
+
+    Config config;
+
+    // Public keys, pinned until idle for keyIdleTime
+    mutable std::mutex keysMutex;
+    std::unordered_map<PeerId, PinnedKey> keys;
+
+    // Queue and outcome cache
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<Job> queue;
+    std::unordered_map<Digest, Outcome, DigestHash> outcomes;
+    std::deque<Digest> outcomeOrder; // settled outcomes, oldest first
+    Stats stats;
+    bool stopping = false;
+
+    std::vector<std::thread> workers;
+};
+
+} // namespace bitchat
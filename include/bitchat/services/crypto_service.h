@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -7,29 +10,55 @@
 namespace bitchat
 {
 
+// Snapshot of the signing counters
+struct SigningStats
+{
+    uint64_t signatures = 0;       // signatures produced
+    uint64_t failures = 0;         // signData calls that returned nothing
+    uint64_t contextsPrepared = 0; // per-thread contexts set up for a key
+    uint64_t nanoseconds = 0;      // time spent in signData
+
+    double getAverageMicroseconds() const { return signatures > 0 ? static_cast<double>(nanoseconds) / signatures / 1000.0 : 0.0; }
+};
+
+// CryptoService: Ed25519 identity key and hashing
+// The signing key is published as a shared pointer and signData runs without
+// the service lock: every thread prepares its own signing context once per key
+// and copies it for each signature, so concurrent senders sign in parallel.
 class CryptoService
 {
 public:
-    CryptoService();
+    explicit CryptoService(std::string keyFile = "bitchat-pk.pem");
     ~CryptoService();
 
-    bool initialize();
+    bool initialize(); // generates or loads the key pair in keyFile
     void cleanup();
     bool generateOrLoadKeyPair(const std::string &keyFile);
     std::vector<uint8_t> generateRandomBytes(size_t length);
     std::vector<uint8_t> sha256(const std::vector<uint8_t> &data);
     std::vector<uint8_t> sha256(const std::string &data);
     std::vector<uint8_t> signData(const std::vector<uint8_t> &data);
+    std::vector<uint8_t> getSigningPublicKey() const; // raw Ed25519 public key, announced to peers
     std::vector<uint8_t> getCurve25519PrivateKey() const;
 
+    // Lock-free signing counters, for all threads
+    SigningStats getSigningStats() const;
+
 private:
-    mutable std::mutex cryptoMutex;
-    void *signingPrivateKey; // EVP_PKEY*
+    std::string keyFile;
+    mutable std::mutex cryptoMutex;          // serializes key changes
+    std::shared_ptr<void> signingPrivateKey; // EVP_PKEY*, read with std::atomic_load
+    std::atomic<uint64_t> signatureCount{0};
+    std::atomic<uint64_t> signatureFailures{0};
+    std::atomic<uint64_t> signingContextsPrepared{0};
+    std::atomic<uint64_t> signingNanoseconds{0};
 
     // Private helper methods
     void *loadPrivateKey(const std::string &filename);
     void savePrivateKey(void *pkey, const std::string &filename);
     std::vector<uint8_t> getPublicKeyBytes(void *pkey) const;
+    std::shared_ptr<void> getSigningKey() const;
+    void setSigningKey(void *pkey);
 };
 
 } // namespace bitchat
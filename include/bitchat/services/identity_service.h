@@ -1,5 +1,6 @@
 #pragma once
 
+#include "bitchat/protocol/peer_id.h"
 #include <chrono>
 #include <memory>
 #include <mutex>
@@ -32,7 +33,7 @@ enum class HandshakeState
 
 struct EphemeralIdentity
 {
-    std::string peerID;
+    PeerId peerID;
     std::chrono::system_clock::time_point sessionStart;
     HandshakeState handshakeState;
     std::string fingerprint;   // Only set when handshake completed
@@ -99,7 +100,7 @@ public:
     static IdentityService &getInstance();
 
     // Identity Resolution
-    IdentityHint resolveIdentity(const std::string &peerID, const std::string &claimedNickname);
+    IdentityHint resolveIdentity(PeerId peerID, const std::string &claimedNickname);
 
     // Social Identity Management
     std::shared_ptr<SocialIdentity> getSocialIdentity(const std::string &fingerprint);
@@ -116,13 +117,13 @@ public:
     void setBlocked(const std::string &fingerprint, bool isBlocked);
 
     // Ephemeral Session Management
-    void registerEphemeralSession(const std::string &peerID, HandshakeState handshakeState = HandshakeState::NONE);
-    void updateHandshakeState(const std::string &peerID, HandshakeState state, const std::string &fingerprint = "", const std::string &failureReason = "");
-    HandshakeState getHandshakeState(const std::string &peerID);
+    void registerEphemeralSession(PeerId peerID, HandshakeState handshakeState = HandshakeState::NONE);
+    void updateHandshakeState(PeerId peerID, HandshakeState state, const std::string &fingerprint = "", const std::string &failureReason = "");
+    HandshakeState getHandshakeState(PeerId peerID);
 
     // Pending Actions
-    void setPendingAction(const std::string &peerID, const PendingActions &action);
-    void applyPendingActions(const std::string &peerID, const std::string &fingerprint);
+    void setPendingAction(PeerId peerID, const PendingActions &action);
+    void applyPendingActions(PeerId peerID, const std::string &fingerprint);
 
     // Verification
     void setVerified(const std::string &fingerprint, bool verified);
@@ -130,7 +131,7 @@ public:
 
     // Cleanup
     void clearAllIdentityData();
-    void removeEphemeralSession(const std::string &peerID);
+    void removeEphemeralSession(PeerId peerID);
 
     // Persistence
     bool loadIdentityCache();
@@ -143,10 +144,10 @@ private:
     IdentityService &operator=(const IdentityService &) = delete;
 
     // In-memory state
-    std::unordered_map<std::string, EphemeralIdentity> ephemeralSessions;
+    std::unordered_map<PeerId, EphemeralIdentity> ephemeralSessions;
     std::unordered_map<std::string, CryptographicIdentity> cryptographicIdentities;
     IdentityCache cache;
-    std::unordered_map<std::string, PendingActions> pendingActions;
+    std::unordered_map<PeerId, PendingActions> pendingActions;
 
     // Thread safety
     std::mutex mutex;
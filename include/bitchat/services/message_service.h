@@ -2,12 +2,17 @@
 
 #include "bitchat/core/bitchat_data.h"
 #include "bitchat/helpers/protocol_helper.h"
+#include "bitchat/protocol/fragment_reassembler.h"
 #include "bitchat/protocol/packet.h"
+#include "bitchat/protocol/packet_view.h"
+#include "bitchat/protocol/rate_limiter.h"
+#include "bitchat/protocol/signature_verifier.h"
 #include "bitchat/ui/ui_interface.h"
 #include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <set>
 #include <string>
 #include <vector>
@@ -42,6 +47,12 @@ public:
     // Leave current channel
     void leaveChannel();
 
+    // Search history, text as accepted by SearchQuery::parse (empty channel means the current one)
+    std::vector<BitchatMessage> searchMessages(const std::string &text, const std::string &channel = "");
+
+    // Private conversation key of a peer, its peer ID when it is known
+    static std::string getConversationKey(const std::string &nickname);
+
     // Start identity announce
     void startIdentityAnnounce();
 
@@ -58,7 +69,12 @@ public:
     void peerDisconnected(const std::string &peripheralID);
 
     // Centralized packet processing - main entry point for all packets
-    void processPacket(const BitchatPacket &packet, const std::string &peripheralID);
+    // Returns false for invalid, already processed and rate limited packets,
+    // which are then not relayed
+    bool processPacket(const BitchatPacket &packet, const std::string &peripheralID);
+
+    // Process a received packet view, duplicates are dropped before the packet is materialized
+    bool processPacket(const PacketView &packet, const std::string &peripheralID);
 
     // Utility methods
     BitchatPacket createMessagePacket(const BitchatMessage &message);
@@ -68,7 +84,11 @@ public:
 
     // Version negotiation
     void sendVersionHello(const std::string &peripheralID);
-    void sendVersionAck(const VersionAck &ack, const std::string &peerID);
+    void sendVersionAck(const VersionAck &ack, PeerId peerID);
+
+    // Counters of the receive path
+    SignatureVerifier::Stats getSignatureStats() const;
+    RateLimiter::Stats getRateLimitStats() const;
 
     // Set callbacks for message events
     using MessageReceivedCallback = std::function<void(const BitchatMessage &)>;
@@ -102,11 +122,21 @@ private:
     PeerConnectedCallback peerConnectedCallback;
     PeerDisconnectedCallback peerDisconnectedCallback;
 
+    // Fragments of large packets waiting for reassembly
+    FragmentReassembler fragmentReassembler;
+
+    // Handshake and message budgets of each link and each sender on it, checked before any decoding
+    RateLimiter rateLimiter;
+
+    // Verifies signed messages on its own workers, declared last so it stops
+    // before the members its callbacks use are destroyed
+    std::unique_ptr<SignatureVerifier> signatureVerifier;
+
     // Version hello packet processing
     void processVersionHelloPacket(const BitchatPacket &packet);
     void processVersionAckPacket(const BitchatPacket &packet);
-    void handleVersionHello(const std::string &peerID, const std::vector<uint8_t> &data);
-    void handleVersionAck(const std::string &peerID, const std::vector<uint8_t> &data);
+    void handleVersionHello(PeerId peerID, const std::vector<uint8_t> &data);
+    void handleVersionAck(PeerId peerID, const std::vector<uint8_t> &data);
 
     // Message packet processing
     void processMessagePacket(const BitchatPacket &packet);
@@ -115,19 +145,43 @@ private:
     // Network-related packet processing
     void processAnnouncePacket(const BitchatPacket &packet, const std::string &peripheralID);
     void processLeavePacket(const BitchatPacket &packet);
+    void processFragmentPacket(const BitchatPacket &packet, const std::string &peripheralID);
 
     // Noise protocol packet processing
     void processNoiseHandshakeInitPacket(const BitchatPacket &packet);
     void processNoiseHandshakeRespPacket(const BitchatPacket &packet);
     void processNoiseEncryptedPacket(const BitchatPacket &packet);
     void processNoiseIdentityAnnouncePacket(const BitchatPacket &packet);
+    void sendHandshakePacket(uint8_t type, const std::vector<uint8_t> &data, PeerId peerID, PeerId localPeerID);
+
+    // Sender key packet processing
+    void processSenderKeyPacket(const BitchatPacket &packet);
+    void processSenderKeyMessagePacket(const BitchatPacket &packet);
+    void distributeSenderKey(PeerId peerID);
+    void rotateSenderKey(); // and send the new key to every peer with a session
 
     // Utility methods
     std::string generateMessageID() const;
+    static bool isAddressedTo(const BitchatPacket &packet, PeerId peerID);
+
+    // Route a validated, deduplicated packet to its processor
+    void routePacket(const BitchatPacket &packet, const std::string &peripheralID);
+
+    // Signed messages are verified before they count as processed, so a forged
+    // copy cannot shadow the genuine one in the duplicate filter. Messages from
+    // a sender whose signing key is pinned must be signed, whatever the flag says.
+    bool mustVerifySignature(uint8_t type, bool hasSignature, PeerId senderID) const;
+    bool verifyAndRoute(const BitchatPacket &packet, const std::string &peripheralID);
+
+    // Handshakes and messages that cost us crypto count against the budget of
+    // the sender on the link they arrived on, other packet types are not limited
+    static std::optional<RateLimiter::Kind> getRateLimitKind(uint8_t type);
+    bool isWithinRateLimit(uint8_t type, PeerId senderID, const std::string &peripheralID);
 
     // Helper methods
-    bool shouldProcessPacket(const BitchatPacket &packet) const;
-    void markPacketProcessed(const BitchatPacket &packet);
+    bool markPacketProcessed(const BitchatPacket &packet); // false if it was already processed
+    bool markPacketProcessed(const PacketView &packet);
+    static uint64_t makeProcessedKey(PeerId senderID, uint64_t timestamp, uint8_t type, std::span<const uint8_t> payload);
 };
 
 } // namespace bitchat
@@ -3,12 +3,14 @@
 #include "bitchat/core/bitchat_data.h"
 #include "bitchat/platform/bluetooth_interface.h"
 #include "bitchat/protocol/packet.h"
+#include "bitchat/protocol/packet_view.h"
 #include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <set>
+#include <span>
 #include <string>
 #include <thread>
 #include <vector>
@@ -41,13 +43,17 @@ public:
     bool sendPacket(const BitchatPacket &packet);
 
     // Send a packet to a specific peer
-    bool sendPacketToPeer(const BitchatPacket &packet, const std::string &peerID);
+    bool sendPacketToPeer(const BitchatPacket &packet, PeerId peerID);
 
     // Send a packet to a specific peripheral
     bool sendPacketToPeripheral(const BitchatPacket &packet, const std::string &peripheralID);
 
+    // Largest frame the link carries in one write, bigger packets are fragmented
+    void setMaxFrameSize(size_t size);
+    size_t getMaxFrameSize() const;
+
     // Set callbacks
-    using PacketReceivedCallback = std::function<void(const BitchatPacket &, const std::string &)>;
+    using PacketReceivedCallback = std::function<bool(const PacketView &, const std::string &)>; // false for invalid, duplicate or rate limited packets
     using PeerConnectedCallback = std::function<void(const std::string &)>;
     using PeerDisconnectedCallback = std::function<void(const std::string &)>;
 
@@ -66,6 +72,9 @@ private:
     std::shared_ptr<BluetoothAnnounceRunner> announceRunner;
     std::shared_ptr<CleanupRunner> cleanupRunner;
 
+    // Link MTU used for fragmentation
+    std::atomic<size_t> maxFrameSize;
+
     // Callbacks
     PacketReceivedCallback packetReceivedCallback;
     PeerConnectedCallback peerConnectedCallback;
@@ -74,9 +83,18 @@ private:
     // Internal methods
     void onPeerConnected(const std::string &peripheralID);
     void onPeerDisconnected(const std::string &peripheralID);
-    void onPacketReceived(const BitchatPacket &packet, const std::string &peripheralID);
+    void onPacketReceived(const PacketView &packet, const std::string &peripheralID);
     void onPeripheralDiscovered(const std::string &peripheralID);
-    void relayPacket(const BitchatPacket &packet);
+    void relayPacket(const PacketView &packet);
+
+    // Split packet into fragments if its serialized frame exceeds the MTU (empty if it fits).
+    // A dictionary packet is re-encoded without it first, which may then fit in one frame.
+    std::vector<BitchatPacket> makeFragments(const BitchatPacket &packet) const;
+
+    // Dictionary compression is only allowed when every receiver advertised the dictionary
+    static bool canUseDictionary(std::span<const PeerPtr> receivers);
+    bool canBroadcastDictionary() const;
+    static BitchatPacket withDictionary(const BitchatPacket &packet, bool useDictionary);
 };
 
 } // namespace bitchat
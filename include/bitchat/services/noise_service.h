@@ -4,12 +4,13 @@
 #include "bitchat/noise/noise_role.h"
 #include "bitchat/noise/noise_security_error.h"
 #include "bitchat/noise/noise_session.h"
+#include "bitchat/noise/sender_key_store.h"
+#include "bitchat/protocol/peer_id.h"
 #include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
-#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -20,6 +21,16 @@ namespace bitchat
 
 // NoiseService Interface
 
+// Outcome of one received handshake message
+struct NoiseHandshakeStep
+{
+    std::optional<std::vector<uint8_t>> response; // next handshake message to send, if any
+    bool established = false;                     // the handshake finished and its session is now in use
+};
+
+// A handshake with a peer that already has an established session runs in a
+// pending session. The established one keeps encrypting until the new
+// handshake finishes, so unauthenticated handshake packets cannot drop it.
 class NoiseService
 {
 public:
@@ -27,47 +38,65 @@ public:
     ~NoiseService() = default;
 
     // Session management
-    std::shared_ptr<NoiseSession> createSession(const std::string &peerID, NoiseRole role);
-    std::shared_ptr<NoiseSession> getSession(const std::string &peerID) const;
-    void removeSession(const std::string &peerID);
-    std::unordered_map<std::string, std::shared_ptr<NoiseSession>> getEstablishedSessions() const;
+    std::shared_ptr<NoiseSession> createSession(PeerId peerID, NoiseRole role);
+    std::shared_ptr<NoiseSession> getSession(PeerId peerID) const;
+    void removeSession(PeerId peerID);
+    std::unordered_map<PeerId, std::shared_ptr<NoiseSession>> getEstablishedSessions() const;
 
     // Handshake
-    std::vector<uint8_t> initiateHandshake(const std::string &peerID);
-    std::optional<std::vector<uint8_t>> handleIncomingHandshake(const std::string &peerID, const std::vector<uint8_t> &message, const std::string &localPeerID);
+    std::vector<uint8_t> initiateHandshake(PeerId peerID);
+    NoiseHandshakeStep handleHandshakeInit(PeerId peerID, const std::vector<uint8_t> &message); // always a fresh responder session
+    NoiseHandshakeStep handleIncomingHandshake(PeerId peerID, const std::vector<uint8_t> &message, PeerId localPeerID);
+    bool hasPendingHandshake(PeerId peerID) const;
 
     // Encryption/Decryption
-    std::vector<uint8_t> encrypt(const std::vector<uint8_t> &plaintext, const std::string &peerID);
-    std::vector<uint8_t> decrypt(const std::vector<uint8_t> &ciphertext, const std::string &peerID);
+    std::vector<uint8_t> encrypt(const std::vector<uint8_t> &plaintext, PeerId peerID);
+    std::vector<uint8_t> decrypt(const std::vector<uint8_t> &ciphertext, PeerId peerID);
+
+    // Sender keys: channel broadcasts are encrypted once with our sender key,
+    // which each peer receives over its own session
+    std::vector<uint8_t> encryptSenderKey(PeerId peerID);
+    bool handleSenderKey(PeerId peerID, const std::vector<uint8_t> &ciphertext);
+    std::optional<std::vector<uint8_t>> encryptBroadcast(const std::vector<uint8_t> &plaintext, PeerId localPeerID);
+    std::optional<std::vector<uint8_t>> decryptBroadcast(const std::vector<uint8_t> &ciphertext, PeerId senderID);
+    bool needsSenderKeyRotation() const;
+    void rotateSenderKey();
+    void removeSenderKey(PeerId peerID);
 
     // Session state
-    bool isSessionEstablished(const std::string &peerID) const;
-    bool hasEstablishedSession(const std::string &peerID) const;
-    std::vector<std::string> getEstablishedSessionIDs() const;
+    bool isSessionEstablished(PeerId peerID) const;
+    bool hasEstablishedSession(PeerId peerID) const;
+    std::vector<PeerId> getEstablishedSessionIDs() const;
 
     // Key management
-    std::optional<NoisePublicKey> getRemoteStaticKey(const std::string &peerID) const;
-    std::optional<std::vector<uint8_t>> getHandshakeHash(const std::string &peerID) const;
+    std::optional<NoisePublicKey> getRemoteStaticKey(PeerId peerID) const;
+    std::optional<std::vector<uint8_t>> getHandshakeHash(PeerId peerID) const;
 
     // Session rekeying
-    std::vector<std::pair<std::string, bool>> getSessionsNeedingRekey() const;
-    void initiateRekey(const std::string &peerID);
+    std::vector<std::pair<PeerId, bool>> getSessionsNeedingRekey() const;
+    void initiateRekey(PeerId peerID);
 
     // Callbacks
-    void setOnSessionEstablished(std::function<void(const std::string &, const NoisePublicKey &)> callback);
-    void setOnSessionFailed(std::function<void(const std::string &, const std::exception &)> callback);
+    void setOnSessionEstablished(std::function<void(PeerId, const NoisePublicKey &)> callback);
+    void setOnSessionFailed(std::function<void(PeerId, const std::exception &)> callback);
 
     // Utility methods
-    NoiseRole resolveRole(const std::string &localPeerID, const std::string &remotePeerID) const;
+    NoiseRole resolveRole(PeerId localPeerID, PeerId remotePeerID) const;
 
 private:
     NoisePrivateKey localStaticKey;
-    std::unordered_map<std::string, std::shared_ptr<NoiseSession>> sessions;
+    std::unordered_map<PeerId, std::shared_ptr<NoiseSession>> sessions;
+    std::unordered_map<PeerId, std::shared_ptr<NoiseSession>> pendingSessions; // handshakes replacing an established session
     mutable std::mutex sessionsMutex;
+    SenderKeyStore senderKeys;
 
     // Callbacks
-    std::function<void(const std::string &, const NoisePublicKey &)> onSessionEstablished;
-    std::function<void(const std::string &, const std::exception &)> onSessionFailed;
+    std::function<void(PeerId, const NoisePublicKey &)> onSessionEstablished;
+    std::function<void(PeerId, const std::exception &)> onSessionFailed;
+
+    // Starts a handshake session, pending if the peer has an established one
+    std::shared_ptr<NoiseSession> createHandshakeSession(PeerId peerID, NoiseRole role);
+    NoiseHandshakeStep processHandshake(PeerId peerID, const std::shared_ptr<NoiseSession> &session, const std::vector<uint8_t> &message);
 };
 
 } // namespace bitchat
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+
+namespace bitchat
+{
+
+// MappedFile: Read-only shared memory mapping of a file
+// The mapping stays valid after the file is renamed or removed, so readers can
+// keep scanning a segment that compaction has already replaced.
+class MappedFile
+{
+public:
+    // Maps the first length bytes, nullptr on failure
+    static std::shared_ptr<MappedFile> map(const std::filesystem::path &path, size_t length);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const uint8_t *data() const { return address; }
+    size_t size() const { return length; }
+    std::span<const uint8_t> getData() const { return {address, length}; }
+
+private:
+    MappedFile(const uint8_t *address, size_t length);
+
+    const uint8_t *address;
+    size_t length;
+};
+
+// SegmentFile: File written at explicit offsets, for the active log segment
+class SegmentFile
+{
+public:
+    // Opens or creates the file for reading and writing, nullptr on failure
+    static std::unique_ptr<SegmentFile> open(const std::filesystem::path &path);
+
+    ~SegmentFile();
+
+    SegmentFile(const SegmentFile &) = delete;
+    SegmentFile &operator=(const SegmentFile &) = delete;
+
+    bool write(size_t offset, std::span<const uint8_t> data);
+    bool resize(size_t size);
+    bool sync();
+    size_t getSize() const;
+
+private:
+    explicit SegmentFile(int descriptor);
+
+    int descriptor;
+};
+
+} // namespace bitchat
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "bitchat/core/constants.h"
+#include "bitchat/protocol/packet.h"
+#include "bitchat/storage/mapped_file.h"
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace bitchat
+{
+
+// One record of the message log
+struct StoredRecord
+{
+    uint64_t sequence;                // position in the conversation, starting at 0
+    uint64_t timestamp;               // append time in milliseconds, never decreasing within a conversation
+    std::span<const uint8_t> payload; // message payload (PacketSerializer format), valid during the callback
+};
+
+// MessageStore: Append-only on-disk message log per conversation
+// Each conversation is a directory of segment files named after the sequence
+// of their first record. Records go to the newest (active) segment, which is
+// preallocated and written at explicit offsets. All segments are read through
+// shared mappings, so scans walk the records in place and never block writers
+// for longer than it takes to find the start position in the sparse index.
+//
+// Record layout: length (4), CRC-32 of timestamp and payload (4), timestamp (8),
+// payload, all little-endian. On open every record is checked, the active
+// segment is cut back to the last valid record and the rest of it is zeroed.
+// compact() drops segments past the retention limits and merges small sealed
+// segments, it runs on the cleanup thread.
+class MessageStore
+{
+public:
+    struct Options
+    {
+        std::filesystem::path directory;
+        size_t segmentBytes = constants::MESSAGE_STORE_SEGMENT_BYTES;
+        std::chrono::milliseconds segmentDuration = constants::MESSAGE_STORE_SEGMENT_DURATION;
+        std::chrono::milliseconds retention = constants::MESSAGE_STORE_RETENTION;
+        size_t maxConversationBytes = constants::MESSAGE_STORE_MAX_CONVERSATION_BYTES;
+        size_t indexInterval = constants::MESSAGE_STORE_INDEX_INTERVAL;
+    };
+
+    // Return false to stop the scan
+    using RecordCallback = std::function<bool(const StoredRecord &record)>;
+
+    static constexpr uint64_t LATEST = std::numeric_limits<uint64_t>::max();
+
+    // Opens the store and recovers every conversation in it, nullptr on failure
+    static std::shared_ptr<MessageStore> open(const std::filesystem::path &directory);
+    static std::shared_ptr<MessageStore> open(const Options &options);
+
+    ~MessageStore();
+
+    MessageStore(const MessageStore &) = delete;
+    MessageStore &operator=(const MessageStore &) = delete;
+
+    // Append a message, timestamp 0 means now, returns its sequence (std::nullopt on failure)
+    std::optional<uint64_t> append(const std::string &conversation, const BitchatMessage &message, uint64_t timestamp = 0);
+    std::optional<uint64_t> appendPayload(const std::string &conversation, std::span<const uint8_t> payload, uint64_t timestamp = 0);
+
+    // Records with from <= timestamp <= to, oldest first, returns how many were visited
+    size_t scan(const std::string &conversation, uint64_t from, uint64_t to, const RecordCallback &callback) const;
+
+    // Records from sequence on, oldest first, returns how many were visited
+    size_t scanFrom(const std::string &conversation, uint64_t sequence, const RecordCallback &callback) const;
+
+    // Decoded messages, oldest first
+    std::vector<BitchatMessage> loadRange(const std::string &conversation, uint64_t from, uint64_t to = LATEST) const;
+    std::vector<BitchatMessage> loadLatest(const std::string &conversation, size_t count) const;
+
+    std::vector<std::string> getConversations() const;
+
+    // Sequence range of the stored records, [first, end)
+    uint64_t getFirstSequence(const std::string &conversation) const;
+    uint64_t getEndSequence(const std::string &conversation) const;
+    size_t getSegmentCount(const std::string &conversation) const;
+
+    // Make appended records durable
+    void flush();
+
+    // Apply retention and merge small sealed segments
+    void compact();
+
+private:
+    struct IndexEntry
+    {
+        uint64_t timestamp;
+        uint64_t sequence;
+        size_t offset;
+    };
+
+    struct Segment
+    {
+        std::filesystem::path path;
+        uint64_t baseSequence = 0;
+        uint64_t count = 0;
+        uint64_t firstTimestamp = 0;
+        uint64_t lastTimestamp = 0;
+        size_t size = 0; // bytes of valid records
+        std::shared_ptr<MappedFile> mapping;
+        std::vector<IndexEntry> index;
+        std::unique_ptr<SegmentFile> file; // only while the segment is active
+    };
+
+    struct Conversation
+    {
+        std::filesystem::path directory;
+        std::vector<std::unique_ptr<Segment>> segments;
+        uint64_t lastTimestamp = 0;
+    };
+
+    // Part of a segment to walk after the lock is released
+    struct ReadRange
+    {
+        std::shared_ptr<MappedFile> mapping;
+        size_t begin;
+        size_t end;
+        uint64_t sequence;
+    };
+
+    explicit MessageStore(const Options &options);
+
+    bool load();
+    bool loadConversation(const std::string &name, const std::filesystem::path &directory);
+    std::unique_ptr<Segment> recoverSegment(const std::filesystem::path &path, uint64_t baseSequence, bool active);
+    bool activateSegment(Segment &segment);
+    void sealSegment(Segment &segment);
+    Segment *prepareActiveSegment(Conversation &conversation, size_t recordSize, uint64_t timestamp);
+
+    Conversation *findConversation(const std::string &name);
+    const Conversation *findConversation(const std::string &name) const;
+    Conversation *createConversation(const std::string &name);
+
+    void applyRetention(Conversation &conversation, uint64_t now);
+    void mergeSegments(const std::string &name);
+
+    static size_t walk(const std::vector<ReadRange> &ranges, uint64_t sequence, uint64_t from, uint64_t to, const RecordCallback &callback);
+    static void addIndexEntry(Segment &segment, size_t interval, uint64_t timestamp, uint64_t sequence, size_t offset);
+    static std::string directoryName(const std::string &conversation);
+    static std::filesystem::path segmentPath(const std::filesystem::path &directory, uint64_t baseSequence);
+
+    Options options;
+    std::map<std::string, Conversation> conversations;
+    mutable std::mutex mutex;
+    std::mutex compactMutex;
+};
+
+} // namespace bitchat
@@ -37,6 +37,8 @@ public:
     void showHelp() override;
     void clearChat() override;
     void showWelcome() override;
+    void showSearchResults(const std::string &query);
+    void showStats();
 
     // Chat output methods
     void showChatMessage(const std::string &message) override;
@@ -90,6 +90,14 @@ public:
      */
     bool sendPacketToPeripheral(const BitchatPacket &packet, const std::string &peripheralID) override;
 
+    /**
+     * @brief Send an already serialized frame to a specific peer
+     * @param frame The serialized frame, shared with other per-peer sends
+     * @param peerID The target peer's identifier
+     * @return true if sent successfully, false otherwise
+     */
+    bool sendFrameToPeer(const SharedFrame &frame, const std::string &peerID) override;
+
     /**
      * @brief Check if Bluetooth system is ready for operations
      * @return true if ready, false otherwise
@@ -2,8 +2,12 @@
 
 #include "bitchat/platform/bluetooth_interface.h"
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -24,6 +28,7 @@ public:
     bool sendPacket(const BitchatPacket &packet) override;
     bool sendPacketToPeer(const BitchatPacket &packet, const std::string &peerID) override;
     bool sendPacketToPeripheral(const BitchatPacket &packet, const std::string &peripheralID) override;
+    bool sendFrameToPeer(const SharedFrame &frame, const std::string &peerID) override;
     bool isReady() const override;
 
     void setPeerConnectedCallback(PeerConnectedCallback callback) override;
@@ -32,10 +37,37 @@ public:
     void setPeripheralDiscoveredCallback(PeripheralDiscoveredCallback callback) override;
     size_t getConnectedPeersCount() const override;
 
+    // Send queue tuning: frames are held up to the flush deadline, or until the byte budget is queued
+    void setFlushDeadline(std::chrono::microseconds deadline);
+    void setFlushByteBudget(size_t bytes);
+
 private:
+    // Outbound frames for one socket, drained by its writer thread with one writev per batch
+    struct PeerSendQueue
+    {
+        int socket = -1;
+        std::deque<SharedFrame> frames;
+        size_t queuedBytes = 0;
+        std::chrono::steady_clock::time_point oldestEnqueueTime;
+        bool closing = false;
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::thread writer;
+    };
+
     void scanThreadFunc();
     void readerThreadFunc(const std::string &deviceID, int socket);
     void acceptThreadFunc();
+    void writerThreadFunc(const std::string &deviceID, std::shared_ptr<PeerSendQueue> queue);
+
+    // Call with socketsMutex held
+    void openSendQueue(const std::string &deviceID, int socket);
+    std::shared_ptr<PeerSendQueue> takeSendQueue(const std::string &deviceID);
+
+    // Flushes what is still queued and joins the writer
+    void closeSendQueue(const std::shared_ptr<PeerSendQueue> &queue);
+    bool enqueueFrame(PeerSendQueue &queue, const SharedFrame &frame);
+    static SharedFrame makeFrame(const BitchatPacket &packet);
 
     int deviceID;
     int hciSocket;
@@ -51,7 +83,11 @@ private:
     PeripheralDiscoveredCallback peripheralDiscoveredCallback;
 
     std::map<std::string, int> connectedSockets;
+    std::map<std::string, std::shared_ptr<PeerSendQueue>> sendQueues;
     std::mutex socketsMutex;
+
+    std::atomic<int64_t> flushDeadlineMicros;
+    std::atomic<size_t> flushByteBudget;
 };
 
 } // namespace bitchat
@@ -2,182 +2,152 @@
 #include "bitchat/core/constants.h"
 #include "bitchat/helpers/datetime_helper.h"
 #include "bitchat/helpers/string_helper.h"
-#include <algorithm>
+#include "bitchat/protocol/packet_serializer.h"
 #include <spdlog/spdlog.h>
 
 namespace bitchat
 {
 
-// Static instance initialization
-std::shared_ptr<BitchatData> BitchatData::instance = nullptr;
-std::mutex BitchatData::instanceMutex;
-
 std::shared_ptr<BitchatData> BitchatData::shared()
 {
-    std::lock_guard<std::mutex> lock(instanceMutex);
-
-    if (!instance)
-    {
-        instance = std::shared_ptr<BitchatData>(new BitchatData());
-    }
-
+    // Initialized once, thread safe and lock free afterwards
+    static std::shared_ptr<BitchatData> instance(new BitchatData());
     return instance;
 }
 
 BitchatData::BitchatData()
 {
     // Initialize with default values
-    nickname = StringHelper::randomNickname();
-    currentChannel = "";
+    auto identity = std::make_shared<LocalIdentity>();
+    identity->nickname = StringHelper::randomNickname();
+    localIdentity = std::move(identity);
 }
 
 // Identity and Basic Info
 
-void BitchatData::setPeerID(const std::string &peerID)
+LocalIdentityPtr BitchatData::getLocalIdentity() const
+{
+    return std::atomic_load_explicit(&localIdentity, std::memory_order_acquire);
+}
+
+void BitchatData::updateLocalIdentity(const std::function<void(LocalIdentity &)> &update)
 {
     std::lock_guard<std::mutex> lock(identityMutex);
-    this->peerID = peerID;
+
+    auto identity = std::make_shared<LocalIdentity>(*localIdentity);
+    update(*identity);
+
+    std::atomic_store_explicit(&localIdentity, LocalIdentityPtr(std::move(identity)), std::memory_order_release);
+}
+
+void BitchatData::setPeerID(const std::string &peerID)
+{
+    // clang-format off
+    updateLocalIdentity([&peerID](LocalIdentity &identity) {
+        identity.peerIdHex = peerID;
+        identity.peerId = PeerId::fromHex(peerID).value_or(PeerId());
+    });
+    // clang-format on
 }
 
 std::string BitchatData::getPeerID() const
 {
-    std::lock_guard<std::mutex> lock(identityMutex);
-    return peerID;
+    return getLocalIdentity()->peerIdHex;
+}
+
+PeerId BitchatData::getLocalPeerId() const
+{
+    return getLocalIdentity()->peerId;
 }
 
 void BitchatData::setNickname(const std::string &nickname)
 {
-    std::lock_guard<std::mutex> lock(identityMutex);
-    this->nickname = nickname;
+    // clang-format off
+    updateLocalIdentity([&nickname](LocalIdentity &identity) {
+        identity.nickname = nickname;
+    });
+    // clang-format on
 }
 
 std::string BitchatData::getNickname() const
 {
-    std::lock_guard<std::mutex> lock(identityMutex);
-    return nickname;
+    return getLocalIdentity()->nickname;
 }
 
 // Channel Management
 
 void BitchatData::setCurrentChannel(const std::string &channel)
 {
-    std::lock_guard<std::mutex> lock(currentChannelMutex);
-    currentChannel = channel;
+    // clang-format off
+    updateLocalIdentity([&channel](LocalIdentity &identity) {
+        identity.currentChannel = channel;
+    });
+    // clang-format on
 }
 
 std::string BitchatData::getCurrentChannel() const
 {
-    std::lock_guard<std::mutex> lock(currentChannelMutex);
-    return currentChannel;
+    return getLocalIdentity()->currentChannel;
 }
 
 // Peer Management
 
 void BitchatData::setPeers(const std::vector<BitchatPeer> &peers)
 {
-    std::lock_guard<std::mutex> lock(peersMutex);
-    this->peers = peers;
+    this->peers.assign(peers);
 }
 
 std::vector<BitchatPeer> BitchatData::getPeers() const
 {
-    std::lock_guard<std::mutex> lock(peersMutex);
-    return peers;
+    return peers.snapshot().toVector();
 }
 
-void BitchatData::addPeer(const BitchatPeer &peer)
+PeerTable::Snapshot BitchatData::getPeersSnapshot() const
 {
-    std::lock_guard<std::mutex> lock(peersMutex);
-
-    // Check if peer already exists
-    // clang-format off
-    auto it = std::find_if(peers.begin(), peers.end(), [&peer](const BitchatPeer &p) {
-        return p.getPeerID() == peer.getPeerID();
-    });
-    // clang-format on
-
-    if (it == peers.end())
-    {
-        // Add new peer
-        peers.push_back(peer);
-    }
-    else
-    {
-        // Update existing peer
-        *it = peer;
-    }
+    return peers.snapshot();
 }
 
-void BitchatData::removePeer(const std::string &peerID)
+void BitchatData::addPeer(const BitchatPeer &peer)
 {
-    std::lock_guard<std::mutex> lock(peersMutex);
+    // Add new peer or update the existing one
+    peers.upsert(peer);
+}
 
-    // clang-format off
-    peers.erase(std::remove_if(peers.begin(), peers.end(), [&peerID](const BitchatPeer &peer) {
-        return peer.getPeerID() == peerID;
-    }), peers.end());
-    // clang-format on
+void BitchatData::removePeer(PeerId peerID)
+{
+    peers.remove(peerID);
 }
 
 void BitchatData::updatePeer(const BitchatPeer &peer)
 {
-    std::lock_guard<std::mutex> lock(peersMutex);
-
-    // clang-format off
-    auto it = std::find_if(peers.begin(), peers.end(), [&peer](const BitchatPeer &p) {
-        return p.getPeerID() == peer.getPeerID();
-    });
-    // clang-format on
-
-    if (it != peers.end())
-    {
-        // Update existing peer
-        *it = peer;
-    }
-    else
-    {
-        // Add new peer if not found
-        peers.push_back(peer);
-    }
+    // Update existing peer or add it if not found
+    peers.upsert(peer);
 }
 
 size_t BitchatData::getPeersCount() const
 {
-    std::lock_guard<std::mutex> lock(peersMutex);
-    return peers.size();
+    return peers.snapshot().size();
 }
 
-bool BitchatData::isPeerOnline(const std::string &peerID) const
+bool BitchatData::isPeerOnline(PeerId peerID) const
 {
-    std::lock_guard<std::mutex> lock(peersMutex);
+    PeerPtr peer = peers.snapshot().find(peerID);
 
-    // clang-format off
-    auto it = std::find_if(peers.begin(), peers.end(), [&peerID](const BitchatPeer &peer) {
-        return peer.getPeerID() == peerID;
-    });
-    // clang-format on
-
-    if (it != peers.end())
+    if (peer)
     {
-        return !it->isStale(constants::PEER_TIMEOUT_SECONDS);
+        return !peer->isStale(constants::PEER_TIMEOUT_SECONDS);
     }
 
     return false;
 }
 
-std::optional<BitchatPeer> BitchatData::getPeerInfo(const std::string &peerID) const
+std::optional<BitchatPeer> BitchatData::getPeerInfo(PeerId peerID) const
 {
-    std::lock_guard<std::mutex> lock(peersMutex);
-
-    // clang-format off
-    auto it = std::find_if(peers.begin(), peers.end(), [&peerID](const BitchatPeer &peer) {
-        return peer.getPeerID() == peerID;
-    });
-    // clang-format on
+    PeerPtr peer = peers.snapshot().find(peerID);
 
-    if (it != peers.end())
+    if (peer)
     {
-        return *it;
+        return *peer;
     }
 
     return std::nullopt;
@@ -187,30 +157,78 @@ std::optional<BitchatPeer> BitchatData::getPeerInfo(const std::string &peerID) c
 
 void BitchatData::addMessageToHistory(const BitchatMessage &message, const std::string &channel)
 {
-    std::lock_guard<std::mutex> lock(messageHistoryMutex);
+    std::string targetChannel = channel.empty() ? getCurrentChannel() : channel;
+    std::shared_ptr<MessageStore> store = getMessageStore();
+    uint64_t ordinal = 0;
 
-    std::string targetChannel = channel.empty() ? currentChannel : channel;
+    {
+        std::lock_guard<std::mutex> lock(messageHistoryMutex);
 
-    // Add message to history
-    messageHistory[targetChannel].push_back(message);
+        // Add message to history, the oldest one is evicted at MAX_HISTORY_SIZE
+        MessageHistory &history = messageHistory.try_emplace(targetChannel, constants::MAX_HISTORY_SIZE).first->second;
+        ordinal = history.getEndOrdinal();
+        history.append(message);
+    }
 
-    // Limit history size
-    if (messageHistory[targetChannel].size() > constants::MAX_HISTORY_SIZE)
+    // Disk write happens outside the history lock
+    persistMessage(store, targetChannel, ordinal, message);
+}
+
+void BitchatData::addPrivateMessage(const std::string &conversation, const BitchatMessage &message, bool incoming)
+{
+    std::shared_ptr<MessageStore> store = getMessageStore();
+    PrivateConversations::AddResult result = privateConversations.add(conversation, message, incoming);
+
+    // Without a store the index only covers memory, and a conversation added again starts its ordinals over
+    if (result.evicted && !store)
     {
-        messageHistory[targetChannel].erase(messageHistory[targetChannel].begin());
+        searchIndex.clear(constants::PRIVATE_CONVERSATION_PREFIX + *result.evicted);
     }
+
+    persistMessage(store, constants::PRIVATE_CONVERSATION_PREFIX + conversation, result.ordinal, message);
+}
+
+std::vector<BitchatMessage> BitchatData::getPrivateMessages(const std::string &conversation, size_t count) const
+{
+    return privateConversations.getLatest(conversation, count);
+}
+
+std::vector<ConversationSummary> BitchatData::getPrivateConversations() const
+{
+    return privateConversations.getConversations();
+}
+
+size_t BitchatData::getUnreadPrivateCount(const std::string &conversation) const
+{
+    return privateConversations.getUnreadCount(conversation);
+}
+
+size_t BitchatData::getTotalUnreadPrivateCount() const
+{
+    return privateConversations.getTotalUnreadCount();
+}
+
+void BitchatData::markPrivateConversationRead(const std::string &conversation)
+{
+    privateConversations.markRead(conversation);
 }
 
 std::vector<BitchatMessage> BitchatData::getMessageHistory(const std::string &channel) const
 {
-    std::lock_guard<std::mutex> lock(messageHistoryMutex);
+    // Copy outside the lock
+    return getMessageHistorySnapshot(channel).toVector();
+}
 
-    std::string targetChannel = channel.empty() ? currentChannel : channel;
+MessageHistory::Snapshot BitchatData::getMessageHistorySnapshot(const std::string &channel) const
+{
+    std::string targetChannel = channel.empty() ? getCurrentChannel() : channel;
+
+    std::lock_guard<std::mutex> lock(messageHistoryMutex);
 
     auto it = messageHistory.find(targetChannel);
     if (it != messageHistory.end())
     {
-        return it->second;
+        return it->second.snapshot();
     }
 
     return {};
@@ -218,52 +236,223 @@ std::vector<BitchatMessage> BitchatData::getMessageHistory(const std::string &ch
 
 void BitchatData::clearMessageHistory(const std::string &channel)
 {
-    std::lock_guard<std::mutex> lock(messageHistoryMutex);
+    std::string targetChannel = channel.empty() ? getCurrentChannel() : channel;
 
-    if (channel.empty())
     {
-        // Clear current channel history
-        messageHistory.erase(currentChannel);
+        std::lock_guard<std::mutex> lock(messageHistoryMutex);
+        messageHistory.erase(targetChannel);
     }
-    else
+
+    // Without a store the index only covers the history, and a new history starts its ordinals over
+    if (!getMessageStore())
     {
-        // Clear specific channel history
-        messageHistory.erase(channel);
+        searchIndex.clear(targetChannel);
     }
 }
 
 void BitchatData::clearAllMessageHistory()
 {
-    std::lock_guard<std::mutex> lock(messageHistoryMutex);
-    messageHistory.clear();
+    {
+        std::lock_guard<std::mutex> lock(messageHistoryMutex);
+        messageHistory.clear();
+    }
+
+    privateConversations.clear();
+
+    if (!getMessageStore())
+    {
+        searchIndex.clearAll();
+    }
 }
 
-// Processed Messages Tracking
+void BitchatData::setMessageStore(std::shared_ptr<MessageStore> store)
+{
+    std::lock_guard<std::mutex> indexLock(indexMutex);
+    std::map<std::string, MessageHistory> restored;
+
+    searchIndex.clearAll();
 
-bool BitchatData::wasMessageProcessed(const std::string &messageID) const
+    if (store)
+    {
+        PacketSerializer serializer;
+
+        std::string nickname = getNickname();
+        privateConversations.clear();
+
+        // Index every stored message and restore the latest ones of each conversation
+        for (const auto &conversation : store->getConversations())
+        {
+            bool isPrivate = conversation.starts_with(constants::PRIVATE_CONVERSATION_PREFIX);
+            std::string key = isPrivate ? conversation.substr(constants::PRIVATE_CONVERSATION_PREFIX.size()) : "";
+            size_t keep = isPrivate ? constants::MAX_PRIVATE_HISTORY_SIZE : constants::MAX_HISTORY_SIZE;
+            MessageHistory *history = isPrivate ? nullptr : &restored.try_emplace(conversation, constants::MAX_HISTORY_SIZE).first->second;
+            uint64_t latest = store->getEndSequence(conversation) - std::min<uint64_t>(keep, store->getEndSequence(conversation) - store->getFirstSequence(conversation));
+
+            // clang-format off
+            store->scanFrom(conversation, 0, [&](const StoredRecord &record) {
+                if (auto view = serializer.parseMessageView(record.payload))
+                {
+                    BitchatMessage message = view->toMessage();
+                    searchIndex.add(conversation, record.sequence, message);
+
+                    if (record.sequence < latest)
+                    {
+                        return true;
+                    }
+
+                    if (history)
+                    {
+                        history->append(std::move(message));
+                    }
+                    else
+                    {
+                        privateConversations.add(key, message, message.getSender() != nickname);
+                    }
+                }
+
+                return true;
+            });
+            // clang-format on
+
+            // Restored conversations start out read
+            if (isPrivate)
+            {
+                privateConversations.markRead(key);
+            }
+        }
+    }
+
+    struct PendingMessage
+    {
+        std::string channel;
+        uint64_t ordinal;
+        BitchatMessage message;
+    };
+
+    std::vector<PendingMessage> pending;
+
+    {
+        std::lock_guard<std::mutex> lock(messageHistoryMutex);
+
+        // Messages added before the store was set are newer, keep them after the restored ones
+        for (auto &[channel, history] : messageHistory)
+        {
+            MessageHistory &target = restored.try_emplace(channel, constants::MAX_HISTORY_SIZE).first->second;
+
+            for (auto &message : history.snapshot().toVector())
+            {
+                pending.push_back({channel, target.getEndOrdinal(), message});
+                target.append(std::move(message));
+            }
+        }
+
+        messageHistory = std::move(restored);
+    }
+
+    // Persist and index them like any later message
+    for (auto &entry : pending)
+    {
+        if (store)
+        {
+            auto sequence = store->append(entry.channel, entry.message);
+
+            if (!sequence)
+            {
+                continue;
+            }
+
+            entry.ordinal = *sequence;
+        }
+
+        searchIndex.add(entry.channel, entry.ordinal, entry.message);
+    }
+
+    std::atomic_store_explicit(&messageStore, std::move(store), std::memory_order_release);
+}
+
+std::shared_ptr<MessageStore> BitchatData::getMessageStore() const
 {
-    std::lock_guard<std::mutex> lock(processedMessagesMutex);
-    return processedMessages.find(messageID) != processedMessages.end();
+    return std::atomic_load_explicit(&messageStore, std::memory_order_acquire);
+}
+
+std::vector<BitchatMessage> BitchatData::searchMessages(const std::string &channel, const SearchQuery &query) const
+{
+    std::string targetChannel = channel.empty() ? getCurrentChannel() : channel;
+    std::vector<uint64_t> ordinals = searchIndex.search(targetChannel, query);
+    std::vector<BitchatMessage> messages;
+    messages.reserve(ordinals.size());
+
+    if (auto store = getMessageStore())
+    {
+        PacketSerializer serializer;
+
+        for (uint64_t ordinal : ordinals)
+        {
+            // clang-format off
+            store->scanFrom(targetChannel, ordinal, [&](const StoredRecord &record) {
+                if (auto view = serializer.parseMessageView(record.payload))
+                {
+                    messages.push_back(view->toMessage());
+                }
+
+                return false;
+            });
+            // clang-format on
+        }
+
+        return messages;
+    }
+
+    // Memory only, the ordinal is the position in the history
+    bool isPrivate = targetChannel.starts_with(constants::PRIVATE_CONVERSATION_PREFIX);
+    MessageHistory::Snapshot snapshot = isPrivate ? privateConversations.getSnapshot(targetChannel.substr(constants::PRIVATE_CONVERSATION_PREFIX.size())) : getMessageHistorySnapshot(targetChannel);
+
+    for (uint64_t ordinal : ordinals)
+    {
+        if (ordinal >= snapshot.getFirstOrdinal() && ordinal - snapshot.getFirstOrdinal() < snapshot.size())
+        {
+            messages.push_back(snapshot[ordinal - snapshot.getFirstOrdinal()]);
+        }
+    }
+
+    return messages;
 }
 
-void BitchatData::markMessageProcessed(const std::string &messageID)
+void BitchatData::persistMessage(const std::shared_ptr<MessageStore> &store, const std::string &conversation, uint64_t ordinal, const BitchatMessage &message)
 {
-    std::lock_guard<std::mutex> lock(processedMessagesMutex);
-    processedMessages.insert(messageID);
+    // With a store the search ordinal is the store sequence
+    std::lock_guard<std::mutex> lock(indexMutex);
 
-    // Limit processed messages size
-    if (processedMessages.size() > constants::MAX_PROCESSED_MESSAGES)
+    if (store)
     {
-        // Remove oldest entries (simple approach: clear and rebuild)
-        // In a more sophisticated implementation, you might want to use a queue
-        processedMessages.clear();
+        auto sequence = store->append(conversation, message);
+
+        if (!sequence)
+        {
+            return;
+        }
+
+        ordinal = *sequence;
     }
+
+    searchIndex.add(conversation, ordinal, message);
 }
 
-void BitchatData::clearProcessedMessages()
+// Processed Messages Tracking
+
+bool BitchatData::wasPacketProcessed(uint64_t key) const
 {
-    std::lock_guard<std::mutex> lock(processedMessagesMutex);
-    processedMessages.clear();
+    return processedPackets.contains(key);
+}
+
+bool BitchatData::markPacketProcessed(uint64_t key)
+{
+    return processedPackets.insert(key);
+}
+
+void BitchatData::clearProcessedPackets()
+{
+    processedPackets.clear();
 }
 
 // Utility Methods
@@ -278,13 +467,7 @@ std::string BitchatData::generateMessageID() const
 
 void BitchatData::cleanupStalePeers()
 {
-    std::lock_guard<std::mutex> lock(peersMutex);
-
-    // clang-format off
-    peers.erase(std::remove_if(peers.begin(), peers.end(), [](const BitchatPeer &peer) {
-        return peer.isStale(constants::PEER_TIMEOUT_SECONDS);
-    }), peers.end());
-    // clang-format on
+    peers.removeStale(constants::PEER_TIMEOUT_SECONDS);
 }
 
 void BitchatData::cleanupOldMessages(size_t maxHistorySize)
@@ -293,24 +476,44 @@ void BitchatData::cleanupOldMessages(size_t maxHistorySize)
 
     for (auto &[channel, messages] : messageHistory)
     {
-        if (messages.size() > maxHistorySize)
-        {
-            // Remove oldest messages
-            size_t toRemove = messages.size() - maxHistorySize;
-            messages.erase(messages.begin(), messages.begin() + toRemove);
-        }
+        // Remove oldest messages
+        messages.trim(maxHistorySize);
     }
 }
 
-void BitchatData::cleanupOldProcessedMessages(size_t maxProcessedSize)
+void BitchatData::cleanupSearchIndex()
 {
-    std::lock_guard<std::mutex> lock(processedMessagesMutex);
+    std::shared_ptr<MessageStore> store = getMessageStore();
+    std::vector<std::pair<std::string, uint64_t>> firstOrdinals;
+
+    {
+        std::lock_guard<std::mutex> lock(messageHistoryMutex);
+
+        for (const auto &[channel, history] : messageHistory)
+        {
+            firstOrdinals.emplace_back(channel, history.getEndOrdinal() - history.size());
+        }
+    }
+
+    for (const auto &summary : privateConversations.getConversations())
+    {
+        firstOrdinals.emplace_back(constants::PRIVATE_CONVERSATION_PREFIX + summary.key, privateConversations.getSnapshot(summary.key).getFirstOrdinal());
+    }
+
+    // Retention only removes the oldest stored messages, so everything before the first one goes
+    if (store)
+    {
+        firstOrdinals.clear();
+
+        for (const auto &conversation : store->getConversations())
+        {
+            firstOrdinals.emplace_back(conversation, store->getFirstSequence(conversation));
+        }
+    }
 
-    if (processedMessages.size() > maxProcessedSize)
+    for (const auto &[channel, first] : firstOrdinals)
     {
-        // Simple approach: clear all and start fresh
-        // In a more sophisticated implementation, you might want to use a queue with timestamps
-        processedMessages.clear();
+        searchIndex.removeBefore(channel, first);
     }
 }
 
@@ -0,0 +1,406 @@
+#include "bitchat/core/history_block.h"
+#include "bitchat/helpers/compression_helper.h"
+#include <optional>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <unordered_map>
+
+namespace bitchat
+{
+
+namespace
+{
+
+// Column writer, integers are LEB128 varints
+class ColumnWriter
+{
+public:
+    void writeVarint(uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            buffer.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+
+        buffer.push_back(static_cast<uint8_t>(value));
+    }
+
+    void writeBytes(std::span<const uint8_t> data)
+    {
+        writeVarint(data.size());
+        buffer.insert(buffer.end(), data.begin(), data.end());
+    }
+
+    void writeString(const std::string &value)
+    {
+        writeBytes(std::span<const uint8_t>(reinterpret_cast<const uint8_t *>(value.data()), value.size()));
+    }
+
+    void writeByte(uint8_t value)
+    {
+        buffer.push_back(value);
+    }
+
+    std::vector<uint8_t> buffer;
+};
+
+// Column reader, every read fails once the data is exhausted or malformed
+class ColumnReader
+{
+public:
+    explicit ColumnReader(std::span<const uint8_t> data)
+        : data(data)
+    {
+        // Pass
+    }
+
+    std::optional<uint64_t> readVarint()
+    {
+        uint64_t value = 0;
+
+        for (int shift = 0; shift < 64 && offset < data.size(); shift += 7)
+        {
+            uint8_t byte = data[offset++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+            if ((byte & 0x80) == 0)
+            {
+                return value;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<std::span<const uint8_t>> readBytes()
+    {
+        auto length = readVarint();
+
+        if (!length || *length > data.size() - offset)
+        {
+            return std::nullopt;
+        }
+
+        auto bytes = data.subspan(offset, *length);
+        offset += *length;
+
+        return bytes;
+    }
+
+    std::optional<std::string> readString()
+    {
+        auto bytes = readBytes();
+
+        if (!bytes)
+        {
+            return std::nullopt;
+        }
+
+        return std::string(bytes->begin(), bytes->end());
+    }
+
+    std::optional<uint8_t> readByte()
+    {
+        if (offset >= data.size())
+        {
+            return std::nullopt;
+        }
+
+        return data[offset++];
+    }
+
+private:
+    std::span<const uint8_t> data;
+    size_t offset = 0;
+};
+
+// Assigns indices to distinct strings in first-seen order
+class StringDictionary
+{
+public:
+    uint64_t add(const std::string &value)
+    {
+        auto [it, inserted] = indices.try_emplace(value, values.size());
+
+        if (inserted)
+        {
+            values.push_back(&it->first);
+        }
+
+        return it->second;
+    }
+
+    void write(ColumnWriter &writer) const
+    {
+        writer.writeVarint(values.size());
+
+        for (const auto *value : values)
+        {
+            writer.writeString(*value);
+        }
+    }
+
+private:
+    std::unordered_map<std::string, uint64_t> indices;
+    std::vector<const std::string *> values;
+};
+
+std::optional<std::vector<std::string>> readDictionary(ColumnReader &reader)
+{
+    auto size = reader.readVarint();
+
+    if (!size)
+    {
+        return std::nullopt;
+    }
+
+    std::vector<std::string> values;
+
+    for (uint64_t i = 0; i < *size; i++)
+    {
+        auto value = reader.readString();
+
+        if (!value)
+        {
+            return std::nullopt;
+        }
+
+        values.push_back(std::move(*value));
+    }
+
+    return values;
+}
+
+const std::string *readDictionaryEntry(ColumnReader &reader, const std::vector<std::string> &dictionary)
+{
+    auto index = reader.readVarint();
+    return index && *index < dictionary.size() ? &dictionary[*index] : nullptr;
+}
+
+// Zigzag keeps small negative deltas small
+uint64_t encodeDelta(uint64_t previous, uint64_t current)
+{
+    int64_t delta = static_cast<int64_t>(current - previous);
+    return (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+}
+
+uint64_t decodeDelta(uint64_t previous, uint64_t encoded)
+{
+    return previous + ((encoded >> 1) ^ (~(encoded & 1) + 1));
+}
+
+enum MessageFlags : uint8_t
+{
+    FLAG_RELAY = 0x01,
+    FLAG_PRIVATE = 0x02,
+    FLAG_ENCRYPTED = 0x04,
+};
+
+} // namespace
+
+std::shared_ptr<const HistoryBlock> HistoryBlock::pack(std::span<const BitchatMessage> messages, size_t skip)
+{
+    static const BitchatMessage empty;
+
+    StringDictionary strings;
+    StringDictionary contents;
+    ColumnWriter stringColumns;
+    ColumnWriter timestampColumn;
+    ColumnWriter flagColumn;
+    ColumnWriter idColumn;
+    ColumnWriter peerColumn;
+    ColumnWriter mentionColumn;
+    ColumnWriter contentColumn;
+    ColumnWriter encryptedColumn;
+    uint64_t previousTimestamp = 0;
+
+    for (size_t i = 0; i < messages.size(); i++)
+    {
+        const BitchatMessage &message = i < skip ? empty : messages[i];
+
+        stringColumns.writeVarint(strings.add(message.getSender()));
+        stringColumns.writeVarint(strings.add(message.getChannel()));
+        stringColumns.writeVarint(strings.add(message.getOriginalSender()));
+        stringColumns.writeVarint(strings.add(message.getRecipientNickname()));
+
+        timestampColumn.writeVarint(encodeDelta(previousTimestamp, message.getTimestamp()));
+        previousTimestamp = message.getTimestamp();
+
+        flagColumn.writeByte((message.isRelay() ? FLAG_RELAY : 0) | (message.isPrivate() ? FLAG_PRIVATE : 0) | (message.isEncrypted() ? FLAG_ENCRYPTED : 0));
+        idColumn.writeString(message.getId());
+        peerColumn.writeBytes(message.getSenderPeerID());
+
+        mentionColumn.writeVarint(message.getMentions().size());
+
+        for (const auto &mention : message.getMentions())
+        {
+            mentionColumn.writeVarint(strings.add(mention));
+        }
+
+        contentColumn.writeVarint(contents.add(message.getContent()));
+        encryptedColumn.writeBytes(message.getEncryptedContent());
+    }
+
+    // Dictionaries first, then one column after the other
+    ColumnWriter writer;
+    writer.writeVarint(messages.size());
+    strings.write(writer);
+    contents.write(writer);
+
+    for (const auto *column : {&stringColumns, &timestampColumn, &flagColumn, &idColumn, &peerColumn, &mentionColumn, &contentColumn, &encryptedColumn})
+    {
+        writer.buffer.insert(writer.buffer.end(), column->buffer.begin(), column->buffer.end());
+    }
+
+    std::vector<uint8_t> compressed(static_cast<size_t>(CompressionHelper::calculateCompressionBound(writer.buffer.size())));
+    size_t compressedSize = CompressionHelper::compressInto(writer.buffer, compressed.data(), compressed.size());
+
+    if (compressedSize == 0)
+    {
+        return nullptr;
+    }
+
+    compressed.resize(compressedSize);
+    compressed.shrink_to_fit();
+
+    std::shared_ptr<HistoryBlock> block(new HistoryBlock());
+    block->compressed = std::move(compressed);
+    block->originalSize = writer.buffer.size();
+    block->count = messages.size();
+
+    return block;
+}
+
+std::vector<BitchatMessage> HistoryBlock::unpack() const
+{
+    std::vector<uint8_t> data = CompressionHelper::decompressData(compressed, originalSize);
+    ColumnReader reader(data);
+
+    auto messageCount = reader.readVarint();
+    auto strings = readDictionary(reader);
+    auto contents = readDictionary(reader);
+
+    if (data.size() != originalSize || messageCount != count || !strings || !contents)
+    {
+        spdlog::error("Corrupt history block header");
+        return {};
+    }
+
+    std::vector<BitchatMessage> messages(count);
+    bool valid = true;
+
+    // Columns are read in the order they were written
+    for (auto &message : messages)
+    {
+        const std::string *sender = readDictionaryEntry(reader, *strings);
+        const std::string *channel = readDictionaryEntry(reader, *strings);
+        const std::string *originalSender = readDictionaryEntry(reader, *strings);
+        const std::string *recipient = readDictionaryEntry(reader, *strings);
+
+        if (!sender || !channel || !originalSender || !recipient)
+        {
+            valid = false;
+            break;
+        }
+
+        message.setSender(*sender);
+        message.setChannel(*channel);
+        message.setOriginalSender(*originalSender);
+        message.setRecipientNickname(*recipient);
+    }
+
+    uint64_t previousTimestamp = 0;
+
+    for (size_t i = 0; valid && i < count; i++)
+    {
+        auto delta = reader.readVarint();
+        valid = delta.has_value();
+        previousTimestamp = valid ? decodeDelta(previousTimestamp, *delta) : 0;
+        messages[i].setTimestamp(previousTimestamp);
+    }
+
+    for (size_t i = 0; valid && i < count; i++)
+    {
+        auto flags = reader.readByte();
+        valid = flags.has_value();
+
+        if (valid)
+        {
+            messages[i].setRelay(*flags & FLAG_RELAY);
+            messages[i].setPrivate(*flags & FLAG_PRIVATE);
+            messages[i].setEncrypted(*flags & FLAG_ENCRYPTED);
+        }
+    }
+
+    for (size_t i = 0; valid && i < count; i++)
+    {
+        auto id = reader.readString();
+        valid = id.has_value();
+
+        if (valid)
+        {
+            messages[i].setId(std::move(*id));
+        }
+    }
+
+    for (size_t i = 0; valid && i < count; i++)
+    {
+        auto peerID = reader.readBytes();
+        valid = peerID.has_value();
+
+        if (valid)
+        {
+            messages[i].setSenderPeerID(std::vector<uint8_t>(peerID->begin(), peerID->end()));
+        }
+    }
+
+    for (size_t i = 0; valid && i < count; i++)
+    {
+        auto mentionCount = reader.readVarint();
+        valid = mentionCount.has_value();
+
+        for (uint64_t j = 0; valid && j < *mentionCount; j++)
+        {
+            const std::string *mention = readDictionaryEntry(reader, *strings);
+            valid = mention != nullptr;
+
+            if (valid)
+            {
+                messages[i].addMention(*mention);
+            }
+        }
+    }
+
+    for (size_t i = 0; valid && i < count; i++)
+    {
+        const std::string *content = readDictionaryEntry(reader, *contents);
+        valid = content != nullptr;
+
+        if (valid)
+        {
+            messages[i].setContent(*content);
+        }
+    }
+
+    for (size_t i = 0; valid && i < count; i++)
+    {
+        auto encrypted = reader.readBytes();
+        valid = encrypted.has_value();
+
+        if (valid && !encrypted->empty())
+        {
+            messages[i].setEncryptedContent(std::vector<uint8_t>(encrypted->begin(), encrypted->end()));
+        }
+    }
+
+    if (!valid)
+    {
+        spdlog::error("Corrupt history block column");
+        return {};
+    }
+
+    return messages;
+}
+
+} // namespace bitchat
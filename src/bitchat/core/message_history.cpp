@@ -0,0 +1,236 @@
+#include "bitchat/core/message_history.h"
+#include <algorithm>
+#include <string>
+
+namespace bitchat
+{
+
+constexpr size_t SEGMENT_SIZE = constants::HISTORY_SEGMENT_SIZE;
+
+namespace
+{
+
+// Heap bytes a decoded message holds besides the slot itself
+size_t getMessageHeapBytes(const BitchatMessage &message)
+{
+    size_t bytes = message.getId().size() + message.getSender().size() + message.getContent().size() + message.getOriginalSender().size() + message.getRecipientNickname().size() + message.getChannel().size() + message.getSenderPeerID().size() + message.getEncryptedContent().size();
+
+    for (const auto &mention : message.getMentions())
+    {
+        bytes += sizeof(std::string) + mention.size();
+    }
+
+    return bytes;
+}
+
+} // namespace
+
+// Snapshot
+
+std::shared_ptr<const MessageHistory::Segment> MessageHistory::Snapshot::loadSegment(size_t index) const
+{
+    const Chunk &chunk = chunks[index];
+
+    if (chunk.hot)
+    {
+        return chunk.hot;
+    }
+
+    auto messages = chunk.cold->unpack();
+    auto segment = std::make_shared<Segment>();
+    std::move(messages.begin(), messages.begin() + std::min(messages.size(), SEGMENT_SIZE), segment->messages.begin());
+
+    return segment;
+}
+
+BitchatMessage MessageHistory::Snapshot::operator[](size_t index) const
+{
+    size_t position = headOffset + index;
+    return loadSegment(position / SEGMENT_SIZE)->messages[position % SEGMENT_SIZE];
+}
+
+MessageHistory::Snapshot::Page MessageHistory::Snapshot::getPage(size_t offset, size_t limit) const
+{
+    Page page;
+
+    if (offset >= count)
+    {
+        return page;
+    }
+
+    size_t position = headOffset + offset;
+    size_t remaining = std::min(limit, count - offset);
+
+    while (remaining > 0)
+    {
+        size_t slot = position % SEGMENT_SIZE;
+        size_t length = std::min(remaining, SEGMENT_SIZE - slot);
+
+        page.segments.push_back(loadSegment(position / SEGMENT_SIZE));
+        page.runs.emplace_back(page.segments.back()->messages.data() + slot, length);
+
+        position += length;
+        remaining -= length;
+    }
+
+    return page;
+}
+
+std::vector<BitchatMessage> MessageHistory::Snapshot::toVector() const
+{
+    std::vector<BitchatMessage> messages;
+    messages.reserve(count);
+
+    for (const auto &run : getPage(0, count))
+    {
+        messages.insert(messages.end(), run.begin(), run.end());
+    }
+
+    return messages;
+}
+
+// MessageHistory
+
+MessageHistory::MessageHistory(size_t capacity, size_t hotCapacity)
+    : capacity(std::max<size_t>(capacity, 1))
+    , hotSegments((hotCapacity + SEGMENT_SIZE - 1) / SEGMENT_SIZE + 1)
+{
+    // Pass
+}
+
+void MessageHistory::append(BitchatMessage message)
+{
+    if (count == capacity)
+    {
+        evictOldest();
+    }
+
+    // Slots are never rewritten, a full segment stays as it is for the snapshots holding it
+    if (segments.empty() || tailCount == SEGMENT_SIZE)
+    {
+        segments.push_back(std::make_shared<Segment>());
+        tailCount = 0;
+
+        if (segments.size() > hotSegments)
+        {
+            compressOldestHot();
+        }
+    }
+
+    segments.back()->messages[tailCount] = std::move(message);
+    tailCount++;
+    count++;
+    endOrdinal++;
+}
+
+void MessageHistory::trim(size_t maxSize)
+{
+    while (count > maxSize)
+    {
+        evictOldest();
+    }
+}
+
+void MessageHistory::clear()
+{
+    blocks.clear();
+    segments.clear();
+    headOffset = 0;
+    tailCount = 0;
+    count = 0;
+}
+
+size_t MessageHistory::getMemoryUsage() const
+{
+    size_t bytes = 0;
+
+    for (const auto &block : blocks)
+    {
+        bytes += block->getMemoryUsage();
+    }
+
+    for (size_t i = 0; i < segments.size(); i++)
+    {
+        size_t begin = blocks.empty() && i == 0 ? headOffset : 0;
+        size_t end = i + 1 == segments.size() ? tailCount : SEGMENT_SIZE;
+
+        bytes += sizeof(Segment);
+
+        for (size_t slot = begin; slot < end; slot++)
+        {
+            bytes += getMessageHeapBytes(segments[i]->messages[slot]);
+        }
+    }
+
+    return bytes;
+}
+
+MessageHistory::Snapshot MessageHistory::snapshot() const
+{
+    Snapshot snapshot;
+    snapshot.chunks.reserve(blocks.size() + segments.size());
+
+    for (const auto &block : blocks)
+    {
+        snapshot.chunks.push_back({nullptr, block});
+    }
+
+    for (const auto &segment : segments)
+    {
+        snapshot.chunks.push_back({segment, nullptr});
+    }
+
+    snapshot.headOffset = headOffset;
+    snapshot.count = count;
+    snapshot.firstOrdinal = endOrdinal - count;
+
+    return snapshot;
+}
+
+void MessageHistory::evictOldest()
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    headOffset++;
+    count--;
+
+    // The front chunk is released once no snapshot references it
+    if (count == 0)
+    {
+        clear();
+    }
+    else if (headOffset == SEGMENT_SIZE)
+    {
+        if (!blocks.empty())
+        {
+            blocks.pop_front();
+        }
+        else
+        {
+            segments.pop_front();
+        }
+
+        headOffset = 0;
+    }
+}
+
+void MessageHistory::compressOldestHot()
+{
+    // Evicted slots of the front segment are packed empty, they are never read again
+    const Segment &oldest = *segments.front();
+    auto block = HistoryBlock::pack(oldest.messages, blocks.empty() ? headOffset : 0);
+
+    // Stays hot when packing fails, it is retried with the next segment
+    if (!block)
+    {
+        return;
+    }
+
+    blocks.push_back(std::move(block));
+    segments.pop_front();
+}
+
+} // namespace bitchat
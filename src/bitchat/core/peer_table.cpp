@@ -0,0 +1,217 @@
+#include "bitchat/core/peer_table.h"
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+
+namespace bitchat
+{
+
+// Snapshot
+
+PeerTable::Snapshot::Snapshot()
+{
+    // All empty snapshots share one state
+    static const std::shared_ptr<const State> emptyState = std::make_shared<const State>();
+    state = emptyState;
+}
+
+PeerTable::Snapshot::Snapshot(std::shared_ptr<const State> state)
+    : state(std::move(state))
+{
+    // Pass
+}
+
+PeerPtr PeerTable::Snapshot::find(PeerId peerID) const
+{
+    auto it = state->byId.find(peerID);
+
+    if (it != state->byId.end())
+    {
+        return state->peers[it->second];
+    }
+
+    return nullptr;
+}
+
+std::vector<PeerPtr> PeerTable::Snapshot::findByPeripheral(const std::string &peripheralID) const
+{
+    std::vector<size_t> indexes;
+    auto [begin, end] = state->byPeripheral.equal_range(peripheralID);
+
+    for (auto it = begin; it != end; ++it)
+    {
+        indexes.push_back(it->second);
+    }
+
+    // Keep insertion order, the multimap does not
+    std::sort(indexes.begin(), indexes.end());
+
+    std::vector<PeerPtr> result;
+    result.reserve(indexes.size());
+
+    for (size_t index : indexes)
+    {
+        result.push_back(state->peers[index]);
+    }
+
+    return result;
+}
+
+std::vector<BitchatPeer> PeerTable::Snapshot::toVector() const
+{
+    std::vector<BitchatPeer> result;
+    result.reserve(state->peers.size());
+
+    for (const auto &peer : state->peers)
+    {
+        result.push_back(*peer);
+    }
+
+    return result;
+}
+
+// PeerTable
+
+PeerTable::PeerTable()
+    : current(std::make_shared<const State>())
+{
+    // Pass
+}
+
+PeerTable::Snapshot PeerTable::snapshot() const
+{
+    return Snapshot(std::atomic_load_explicit(&current, std::memory_order_acquire));
+}
+
+void PeerTable::upsert(const BitchatPeer &peer)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+
+    auto next = std::make_shared<State>(*current);
+    auto stored = std::make_shared<const BitchatPeer>(peer);
+    auto it = next->byId.find(peer.getId());
+
+    if (it == next->byId.end())
+    {
+        // Add new peer
+        size_t index = next->peers.size();
+        next->peers.push_back(stored);
+        next->byId.emplace(peer.getId(), index);
+        next->byPeripheral.emplace(peer.getPeripheralID(), index);
+    }
+    else
+    {
+        // Update existing peer, moving its peripheral entry if that changed
+        size_t index = it->second;
+        const std::string &previousPeripheral = next->peers[index]->getPeripheralID();
+
+        if (previousPeripheral != peer.getPeripheralID())
+        {
+            auto [begin, end] = next->byPeripheral.equal_range(previousPeripheral);
+            // clang-format off
+            auto entry = std::find_if(begin, end, [index](const auto &item) {
+                return item.second == index;
+            });
+            // clang-format on
+
+            if (entry != end)
+            {
+                next->byPeripheral.erase(entry);
+            }
+
+            next->byPeripheral.emplace(peer.getPeripheralID(), index);
+        }
+
+        next->peers[index] = stored;
+    }
+
+    std::atomic_store_explicit(&current, std::shared_ptr<const State>(std::move(next)), std::memory_order_release);
+}
+
+bool PeerTable::remove(PeerId peerID)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+
+    auto it = current->byId.find(peerID);
+
+    if (it == current->byId.end())
+    {
+        return false;
+    }
+
+    auto next = std::make_shared<State>();
+    next->peers = current->peers;
+    next->peers.erase(next->peers.begin() + static_cast<std::ptrdiff_t>(it->second));
+    rebuildIndexes(*next);
+
+    std::atomic_store_explicit(&current, std::shared_ptr<const State>(std::move(next)), std::memory_order_release);
+
+    return true;
+}
+
+size_t PeerTable::removeStale(time_t timeout)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+
+    auto next = std::make_shared<State>();
+    next->peers.reserve(current->peers.size());
+
+    // clang-format off
+    std::copy_if(current->peers.begin(), current->peers.end(), std::back_inserter(next->peers), [timeout](const PeerPtr &peer) {
+        return !peer->isStale(timeout);
+    });
+    // clang-format on
+
+    size_t removed = current->peers.size() - next->peers.size();
+
+    if (removed > 0)
+    {
+        rebuildIndexes(*next);
+        std::atomic_store_explicit(&current, std::shared_ptr<const State>(std::move(next)), std::memory_order_release);
+    }
+
+    return removed;
+}
+
+void PeerTable::assign(const std::vector<BitchatPeer> &peers)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+
+    auto next = std::make_shared<State>();
+    next->peers.reserve(peers.size());
+
+    // Later duplicates replace earlier ones, as upsert would
+    for (const auto &peer : peers)
+    {
+        auto [it, inserted] = next->byId.emplace(peer.getId(), next->peers.size());
+
+        if (inserted)
+        {
+            next->peers.push_back(std::make_shared<const BitchatPeer>(peer));
+        }
+        else
+        {
+            next->peers[it->second] = std::make_shared<const BitchatPeer>(peer);
+        }
+    }
+
+    rebuildIndexes(*next);
+
+    std::atomic_store_explicit(&current, std::shared_ptr<const State>(std::move(next)), std::memory_order_release);
+}
+
+void PeerTable::rebuildIndexes(State &state)
+{
+    state.byId.clear();
+    state.byPeripheral.clear();
+    state.byId.reserve(state.peers.size());
+    state.byPeripheral.reserve(state.peers.size());
+
+    for (size_t i = 0; i < state.peers.size(); i++)
+    {
+        state.byId.emplace(state.peers[i]->getId(), i);
+        state.byPeripheral.emplace(state.peers[i]->getPeripheralID(), i);
+    }
+}
+
+} // namespace bitchat
@@ -0,0 +1,165 @@
+#include "bitchat/core/private_conversations.h"
+#include <algorithm>
+
+namespace bitchat
+{
+
+PrivateConversations::PrivateConversations(size_t maxConversations, size_t maxMessages)
+    : maxConversations(std::max<size_t>(maxConversations, 1))
+    , maxMessages(maxMessages)
+{
+    // Pass
+}
+
+PrivateConversations::AddResult PrivateConversations::add(const std::string &key, const BitchatMessage &message, bool incoming)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    AddResult result;
+    auto it = byKey.find(key);
+
+    if (it == byKey.end())
+    {
+        if (conversations.size() == maxConversations)
+        {
+            result.evicted = conversations.back().key;
+            eraseConversation(std::prev(conversations.end()));
+        }
+
+        conversations.push_front({key, "", MessageHistory(maxMessages), 0, 0});
+        it = byKey.emplace(key, conversations.begin()).first;
+    }
+    else if (it->second != conversations.begin())
+    {
+        // Most recently active moves to the front, the iterator stays valid
+        conversations.splice(conversations.begin(), conversations, it->second);
+    }
+
+    Conversation &conversation = *it->second;
+    result.ordinal = conversation.history.getEndOrdinal();
+
+    const std::string &nickname = incoming ? message.getSender() : message.getRecipientNickname();
+
+    if (!nickname.empty())
+    {
+        conversation.nickname = nickname;
+    }
+
+    conversation.lastTimestamp = std::max(conversation.lastTimestamp, message.getTimestamp());
+    conversation.history.append(message);
+
+    if (incoming)
+    {
+        conversation.unread++;
+        totalUnread++;
+    }
+
+    return result;
+}
+
+std::vector<BitchatMessage> PrivateConversations::getLatest(const std::string &key, size_t count) const
+{
+    MessageHistory::Snapshot snapshot = getSnapshot(key);
+    size_t offset = snapshot.size() - std::min(count, snapshot.size());
+
+    // Copied outside the lock
+    std::vector<BitchatMessage> messages;
+    messages.reserve(snapshot.size() - offset);
+
+    for (const auto &run : snapshot.getPage(offset, count))
+    {
+        messages.insert(messages.end(), run.begin(), run.end());
+    }
+
+    return messages;
+}
+
+MessageHistory::Snapshot PrivateConversations::getSnapshot(const std::string &key) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = byKey.find(key);
+    return it != byKey.end() ? it->second->history.snapshot() : MessageHistory::Snapshot();
+}
+
+std::vector<ConversationSummary> PrivateConversations::getConversations() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<ConversationSummary> summaries;
+    summaries.reserve(conversations.size());
+
+    for (const auto &conversation : conversations)
+    {
+        summaries.push_back({conversation.key, conversation.nickname, conversation.lastTimestamp, conversation.history.size(), conversation.unread});
+    }
+
+    return summaries;
+}
+
+size_t PrivateConversations::getUnreadCount(const std::string &key) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = byKey.find(key);
+    return it != byKey.end() ? it->second->unread : 0;
+}
+
+size_t PrivateConversations::getTotalUnreadCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return totalUnread;
+}
+
+void PrivateConversations::markRead(const std::string &key)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = byKey.find(key);
+
+    if (it != byKey.end())
+    {
+        totalUnread -= it->second->unread;
+        it->second->unread = 0;
+    }
+}
+
+bool PrivateConversations::remove(const std::string &key)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = byKey.find(key);
+
+    if (it == byKey.end())
+    {
+        return false;
+    }
+
+    eraseConversation(it->second);
+
+    return true;
+}
+
+void PrivateConversations::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    byKey.clear();
+    conversations.clear();
+    totalUnread = 0;
+}
+
+size_t PrivateConversations::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return conversations.size();
+}
+
+void PrivateConversations::eraseConversation(ConversationList::iterator it)
+{
+    totalUnread -= it->unread;
+    byKey.erase(it->key);
+    conversations.erase(it);
+}
+
+} // namespace bitchat
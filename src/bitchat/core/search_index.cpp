@@ -0,0 +1,379 @@
+#include "bitchat/core/search_index.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <optional>
+
+namespace bitchat
+{
+
+namespace
+{
+
+constexpr size_t MAX_TOKEN_LENGTH = 32;
+
+bool isTokenCharacter(unsigned char c)
+{
+    return std::isalnum(c) || c >= 0x80;
+}
+
+std::string toLower(std::string_view text)
+{
+    std::string lower(text);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    return lower;
+}
+
+// "30m" in milliseconds
+std::optional<uint64_t> parseDuration(std::string_view text)
+{
+    uint64_t value = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+
+    if (error != std::errc() || end != text.data() + text.size() - 1)
+    {
+        return std::nullopt;
+    }
+
+    switch (text.back())
+    {
+    case 's':
+        return value * 1000;
+    case 'm':
+        return value * 60 * 1000;
+    case 'h':
+        return value * 60 * 60 * 1000;
+    case 'd':
+        return value * 24 * 60 * 60 * 1000;
+    default:
+        return std::nullopt;
+    }
+}
+
+} // namespace
+
+// SearchQuery
+
+SearchQuery SearchQuery::parse(std::string_view text, uint64_t now)
+{
+    SearchQuery query;
+    size_t position = 0;
+
+    while (position < text.size())
+    {
+        size_t end = text.find(' ', position);
+        end = end == std::string_view::npos ? text.size() : end;
+        std::string_view word = text.substr(position, end - position);
+        position = end + 1;
+
+        if (word.empty())
+        {
+            continue;
+        }
+
+        if (word.starts_with("from:") && word.size() > 5)
+        {
+            std::string_view sender = word.substr(5);
+            query.sender = toLower(sender.starts_with('@') ? sender.substr(1) : sender);
+            continue;
+        }
+
+        if (word.starts_with("since:") || word.starts_with("until:"))
+        {
+            if (auto duration = parseDuration(word.substr(6)))
+            {
+                uint64_t timestamp = now - std::min(now, *duration);
+                (word[0] == 's' ? query.from : query.to) = timestamp;
+                continue;
+            }
+        }
+
+        for (auto &token : SearchIndex::tokenize(word))
+        {
+            query.keywords.push_back(std::move(token));
+        }
+    }
+
+    return query;
+}
+
+// SearchIndex
+
+void SearchIndex::add(const std::string &channel, uint64_t ordinal, const BitchatMessage &message)
+{
+    // Tokenize before taking the lock
+    std::vector<std::string> tokens = tokenize(message.getContent());
+    std::sort(tokens.begin(), tokens.end());
+    tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+
+    std::string sender = toLower(message.getSender());
+    uint64_t timestamp = message.getTimestamp();
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    ChannelIndex &index = channels[channel];
+
+    if (index.timestamps.empty())
+    {
+        index.firstOrdinal = ordinal;
+    }
+    else if (ordinal < index.firstOrdinal + index.timestamps.size())
+    {
+        return;
+    }
+
+    // Ordinals without a message keep timestamp 0 and appear in no posting list
+    index.timestamps.resize(ordinal - index.firstOrdinal, 0);
+    index.timestamps.push_back(timestamp);
+
+    for (auto &token : tokens)
+    {
+        index.tokens[std::move(token)].push_back(ordinal);
+    }
+
+    index.senders[sender].push_back(ordinal);
+
+    // Messages mostly arrive in time order, so the end is the usual position. Remote
+    // clocks differ, and a late message still costs O(log n) instead of a vector shift.
+    index.byTime.emplace_hint(index.byTime.end(), timestamp, ordinal);
+    index.count++;
+}
+
+std::vector<uint64_t> SearchIndex::search(const std::string &channel, const SearchQuery &query) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = channels.find(channel);
+
+    if (it == channels.end() || query.limit == 0 || query.from > query.to)
+    {
+        return {};
+    }
+
+    const ChannelIndex &index = it->second;
+    std::vector<const PostingList *> lists;
+
+    for (const auto &keyword : query.keywords)
+    {
+        auto posting = index.tokens.find(toLower(keyword));
+
+        if (posting == index.tokens.end())
+        {
+            return {};
+        }
+
+        lists.push_back(&posting->second);
+    }
+
+    if (!query.sender.empty())
+    {
+        auto posting = index.senders.find(toLower(query.sender));
+
+        if (posting == index.senders.end())
+        {
+            return {};
+        }
+
+        lists.push_back(&posting->second);
+    }
+
+    if (lists.empty())
+    {
+        return searchTimeRange(index, query);
+    }
+
+    return intersect(index, std::move(lists), query);
+}
+
+void SearchIndex::removeBefore(const std::string &channel, uint64_t first)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = channels.find(channel);
+
+    if (it == channels.end() || first <= it->second.firstOrdinal)
+    {
+        return;
+    }
+
+    ChannelIndex &index = it->second;
+    size_t removed = std::min<size_t>(first - index.firstOrdinal, index.timestamps.size());
+
+    index.timestamps.erase(index.timestamps.begin(), index.timestamps.begin() + static_cast<std::ptrdiff_t>(removed));
+    index.firstOrdinal = first;
+
+    trimPostings(index.tokens, first);
+    trimPostings(index.senders, first);
+
+    // clang-format off
+    std::erase_if(index.byTime, [first](const auto &entry) {
+        return entry.second < first;
+    });
+    // clang-format on
+
+    index.count = index.byTime.size();
+}
+
+void SearchIndex::clear(const std::string &channel)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    channels.erase(channel);
+}
+
+void SearchIndex::clearAll()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    channels.clear();
+}
+
+size_t SearchIndex::size(const std::string &channel) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = channels.find(channel);
+    return it != channels.end() ? it->second.count : 0;
+}
+
+std::vector<std::string> SearchIndex::tokenize(std::string_view text)
+{
+    std::vector<std::string> tokens;
+    size_t position = 0;
+
+    while (position < text.size())
+    {
+        while (position < text.size() && !isTokenCharacter(static_cast<unsigned char>(text[position])))
+        {
+            position++;
+        }
+
+        size_t start = position;
+
+        while (position < text.size() && isTokenCharacter(static_cast<unsigned char>(text[position])))
+        {
+            position++;
+        }
+
+        if (position > start)
+        {
+            tokens.push_back(toLower(text.substr(start, std::min(position - start, MAX_TOKEN_LENGTH))));
+        }
+    }
+
+    return tokens;
+}
+
+std::vector<uint64_t> SearchIndex::searchTimeRange(const ChannelIndex &index, const SearchQuery &query)
+{
+    std::vector<uint64_t> results;
+
+    auto begin = index.byTime.lower_bound(query.from);
+    auto end = index.byTime.upper_bound(query.to);
+
+    for (auto it = end; it != begin && results.size() < query.limit;)
+    {
+        results.push_back((--it)->second);
+    }
+
+    return results;
+}
+
+std::vector<uint64_t> SearchIndex::intersect(const ChannelIndex &index, std::vector<const PostingList *> lists, const SearchQuery &query)
+{
+    std::vector<uint64_t> results;
+
+    // clang-format off
+    std::sort(lists.begin(), lists.end(), [](const PostingList *a, const PostingList *b) {
+        return a->size() < b->size();
+    });
+    // clang-format on
+
+    // clang-format off
+    auto matchesAll = [&](uint64_t ordinal, size_t skip) {
+        for (size_t i = 0; i < lists.size(); i++)
+        {
+            if (i != skip && !std::binary_search(lists[i]->begin(), lists[i]->end(), ordinal))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    };
+    // clang-format on
+
+    // A narrow time window can be shorter than every posting list, walk it instead
+    bool hasTimeRange = query.from > 0 || query.to < std::numeric_limits<uint64_t>::max();
+
+    if (hasTimeRange)
+    {
+        auto begin = index.byTime.lower_bound(query.from);
+        auto end = index.byTime.upper_bound(query.to);
+
+        // Counted only up to the length of the shortest list, the window may be long
+        size_t windowSize = 0;
+
+        for (auto it = begin; it != end && windowSize < lists.front()->size(); ++it)
+        {
+            windowSize++;
+        }
+
+        if (windowSize < lists.front()->size())
+        {
+            for (auto it = end; it != begin && results.size() < query.limit;)
+            {
+                uint64_t ordinal = (--it)->second;
+
+                if (matchesAll(ordinal, lists.size()))
+                {
+                    results.push_back(ordinal);
+                }
+            }
+
+            return results;
+        }
+    }
+
+    const PostingList &shortest = *lists.front();
+
+    for (auto it = shortest.rbegin(); it != shortest.rend() && results.size() < query.limit; ++it)
+    {
+        if (isInTimeRange(index, *it, query) && matchesAll(*it, 0))
+        {
+            results.push_back(*it);
+        }
+    }
+
+    return results;
+}
+
+bool SearchIndex::isInTimeRange(const ChannelIndex &index, uint64_t ordinal, const SearchQuery &query)
+{
+    if (ordinal < index.firstOrdinal || ordinal - index.firstOrdinal >= index.timestamps.size())
+    {
+        return false;
+    }
+
+    uint64_t timestamp = index.timestamps[ordinal - index.firstOrdinal];
+    return timestamp >= query.from && timestamp <= query.to;
+}
+
+void SearchIndex::trimPostings(std::unordered_map<std::string, PostingList> &postings, uint64_t first)
+{
+    for (auto it = postings.begin(); it != postings.end();)
+    {
+        PostingList &list = it->second;
+        list.erase(list.begin(), std::lower_bound(list.begin(), list.end(), first));
+
+        if (list.empty())
+        {
+            it = postings.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+} // namespace bitchat
@@ -1,6 +1,8 @@
 #include "bitchat/helpers/compression_helper.h"
 #include "lz4.h"
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <spdlog/spdlog.h>
 
 namespace bitchat
@@ -8,7 +10,7 @@ namespace bitchat
 
 std::vector<uint8_t> CompressionHelper::compressData(const std::vector<uint8_t> &data)
 {
-    // Skip compression for small data
+    // Skip compression for small or incompressible data
     if (!shouldCompress(data))
     {
         return data;
@@ -40,7 +42,65 @@ std::vector<uint8_t> CompressionHelper::compressData(const std::vector<uint8_t>
     return compressedData;
 }
 
-std::vector<uint8_t> CompressionHelper::decompressData(const std::vector<uint8_t> &compressedData, size_t originalSize)
+size_t CompressionHelper::compressInto(std::span<const uint8_t> data, uint8_t *output, size_t outputCapacity)
+{
+    int compressedSize = LZ4_compress_default(
+        reinterpret_cast<const char *>(data.data()),
+        reinterpret_cast<char *>(output),
+        static_cast<int>(data.size()),
+        static_cast<int>(outputCapacity));
+
+    if (compressedSize <= 0)
+    {
+        spdlog::error("Compression failed");
+        return 0;
+    }
+
+    return static_cast<size_t>(compressedSize);
+}
+
+size_t CompressionHelper::compressInto(std::span<const uint8_t> data, uint8_t *output, size_t outputCapacity, std::span<const uint8_t> dictionary)
+{
+    // Hashing the dictionary costs more than compressing a short payload, so each
+    // thread loads it once and compresses with a copy of the loaded stream
+    struct DictionaryStream
+    {
+        const uint8_t *dictionary = nullptr;
+        size_t dictionarySize = 0;
+        LZ4_stream_t loaded;
+        LZ4_stream_t working;
+    };
+
+    thread_local DictionaryStream stream;
+
+    if (stream.dictionary != dictionary.data() || stream.dictionarySize != dictionary.size())
+    {
+        LZ4_initStream(&stream.loaded, sizeof(stream.loaded));
+        LZ4_loadDict(&stream.loaded, reinterpret_cast<const char *>(dictionary.data()), static_cast<int>(dictionary.size()));
+        stream.dictionary = dictionary.data();
+        stream.dictionarySize = dictionary.size();
+    }
+
+    stream.working = stream.loaded;
+
+    int compressedSize = LZ4_compress_fast_continue(
+        &stream.working,
+        reinterpret_cast<const char *>(data.data()),
+        reinterpret_cast<char *>(output),
+        static_cast<int>(data.size()),
+        static_cast<int>(outputCapacity),
+        1);
+
+    if (compressedSize <= 0)
+    {
+        spdlog::error("Dictionary compression failed");
+        return 0;
+    }
+
+    return static_cast<size_t>(compressedSize);
+}
+
+std::vector<uint8_t> CompressionHelper::decompressData(std::span<const uint8_t> compressedData, size_t originalSize)
 {
     // Allocate buffer for decompressed data
     std::vector<uint8_t> decompressedData(originalSize);
@@ -67,10 +127,87 @@ std::vector<uint8_t> CompressionHelper::decompressData(const std::vector<uint8_t
     return decompressedData;
 }
 
-bool CompressionHelper::shouldCompress(const std::vector<uint8_t> &data)
+std::vector<uint8_t> CompressionHelper::decompressData(std::span<const uint8_t> compressedData, size_t originalSize, std::span<const uint8_t> dictionary)
+{
+    std::vector<uint8_t> decompressedData(originalSize);
+
+    int decompressedSize = LZ4_decompress_safe_usingDict(
+        reinterpret_cast<const char *>(compressedData.data()),
+        reinterpret_cast<char *>(decompressedData.data()),
+        static_cast<int>(compressedData.size()),
+        static_cast<int>(originalSize),
+        reinterpret_cast<const char *>(dictionary.data()),
+        static_cast<int>(dictionary.size()));
+
+    if (decompressedSize < 0)
+    {
+        spdlog::error("Dictionary decompression failed");
+        return std::vector<uint8_t>();
+    }
+
+    decompressedData.resize(decompressedSize);
+
+    return decompressedData;
+}
+
+bool CompressionHelper::shouldCompress(std::span<const uint8_t> data, bool withDictionary)
 {
     // Don't compress if data is too small
-    return data.size() > COMPRESSION_THRESHOLD;
+    if (data.size() <= (withDictionary ? DICTIONARY_COMPRESSION_THRESHOLD : COMPRESSION_THRESHOLD))
+    {
+        return false;
+    }
+
+    // Too short for a meaningful entropy estimate, a failed attempt is cheap at this size
+    if (data.size() <= COMPRESSION_THRESHOLD)
+    {
+        return true;
+    }
+
+    // Encrypted or already compressed data looks random, LZ4 would only add overhead.
+    // A sample of n bytes can show at most log2(n) bits, so small payloads get a lower limit.
+    size_t sampleSize = std::min(data.size(), ENTROPY_SAMPLE_SIZE);
+    double limit = std::min(ENTROPY_MAX_BITS, std::log2(static_cast<double>(sampleSize)) - 1.0);
+    double entropy = estimateEntropy(data);
+
+    if (entropy > limit)
+    {
+        spdlog::debug("Skipping compression of {} bytes (entropy {:.2f} > {:.2f} bits/byte)", data.size(), entropy, limit);
+        return false;
+    }
+
+    return true;
+}
+
+double CompressionHelper::estimateEntropy(std::span<const uint8_t> data)
+{
+    if (data.empty())
+    {
+        return 0.0;
+    }
+
+    // Sample evenly spaced bytes so large payloads cost the same as small ones
+    size_t sampleSize = std::min(data.size(), ENTROPY_SAMPLE_SIZE);
+    size_t stride = data.size() / sampleSize;
+    std::array<uint32_t, 256> histogram{};
+
+    for (size_t i = 0; i < sampleSize; i++)
+    {
+        histogram[data[i * stride]]++;
+    }
+
+    double entropy = 0.0;
+
+    for (uint32_t count : histogram)
+    {
+        if (count > 0)
+        {
+            double probability = static_cast<double>(count) / sampleSize;
+            entropy -= probability * std::log2(probability);
+        }
+    }
+
+    return entropy;
 }
 
 int CompressionHelper::calculateCompressionBound(size_t dataSize)
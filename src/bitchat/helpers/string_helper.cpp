@@ -1,27 +1,347 @@
 #include "bitchat/helpers/string_helper.h"
 #include "uuid-v4/uuid-v4.h"
 #include <algorithm>
+#include <array>
 #include <cstring>
-#include <iomanip>
 #include <random>
-#include <sstream>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BITCHAT_HEX_SSE2
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BITCHAT_HEX_AVX2
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define BITCHAT_HEX_NEON
+#endif
 
 namespace bitchat
 {
 
-std::string StringHelper::toHex(const std::vector<uint8_t> &data)
+namespace
+{
+
+// Two output characters per byte value
+constexpr std::array<char, 512> HEX_ENCODE_TABLE = []()
+{
+    constexpr char digits[] = "0123456789abcdef";
+    std::array<char, 512> table{};
+
+    for (size_t i = 0; i < 256; i++)
+    {
+        table[i * 2] = digits[i >> 4];
+        table[i * 2 + 1] = digits[i & 0x0F];
+    }
+
+    return table;
+}();
+
+// Nibble value per character, 0xFF for anything that is not a hex digit
+constexpr std::array<uint8_t, 256> HEX_DECODE_TABLE = []()
 {
-    std::stringstream ss;
+    std::array<uint8_t, 256> table{};
+    table.fill(0xFF);
 
-    for (uint8_t byte : data)
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        table['0' + i] = i;
+    }
+
+    for (uint8_t i = 0; i < 6; i++)
+    {
+        table['a' + i] = 10 + i;
+        table['A' + i] = 10 + i;
+    }
+
+    return table;
+}();
+
+void encodeHexScalar(const uint8_t *data, size_t size, char *output)
+{
+    for (size_t i = 0; i < size; i++)
     {
-        ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
+        std::memcpy(output + i * 2, &HEX_ENCODE_TABLE[data[i] * 2], 2);
     }
+}
+
+bool decodeHexScalar(const char *str, size_t size, uint8_t *output)
+{
+    // Invalid characters set the high bits, checked once at the end
+    uint8_t invalid = 0;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        uint8_t high = HEX_DECODE_TABLE[static_cast<uint8_t>(str[i * 2])];
+        uint8_t low = HEX_DECODE_TABLE[static_cast<uint8_t>(str[i * 2 + 1])];
+        invalid |= high | low;
+        output[i] = static_cast<uint8_t>((high << 4) | low);
+    }
+
+    return (invalid & 0xF0) == 0;
+}
+
+#if defined(BITCHAT_HEX_SSE2)
+
+// Nibbles (0-15) to lowercase ASCII: '0' + n, plus 39 more for n > 9 ('a' - '0' - 10)
+inline __m128i nibblesToAscii(__m128i nibbles)
+{
+    __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8(39));
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+
+// ASCII to nibbles, valid is set to all ones for hex digits
+inline __m128i asciiToNibbles(__m128i chars, __m128i &valid)
+{
+    __m128i digits = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    __m128i letters = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+
+    // Unsigned x <= limit, as min(x, limit) == x
+    __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+    __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letters, _mm_set1_epi8(5)), letters);
+
+    valid = _mm_or_si128(isDigit, isLetter);
 
-    return ss.str();
+    return _mm_or_si128(_mm_and_si128(isDigit, digits), _mm_and_si128(isLetter, _mm_add_epi8(letters, _mm_set1_epi8(10))));
 }
 
-std::vector<uint8_t> StringHelper::stringToVector(const std::string &str)
+// 16 characters (high, low pairs) to 8 bytes in the low half of each 16 bit lane
+inline __m128i packNibblePairs(__m128i nibbles)
+{
+    __m128i high = _mm_and_si128(nibbles, _mm_set1_epi16(0x00FF));
+    __m128i low = _mm_srli_epi16(nibbles, 8);
+    return _mm_or_si128(_mm_slli_epi16(high, 4), low);
+}
+
+#endif
+
+#if defined(BITCHAT_HEX_AVX2)
+
+inline __m256i nibblesToAscii256(__m256i nibbles)
+{
+    __m256i letters = _mm256_and_si256(_mm256_cmpgt_epi8(nibbles, _mm256_set1_epi8(9)), _mm256_set1_epi8(39));
+    return _mm256_add_epi8(_mm256_add_epi8(nibbles, _mm256_set1_epi8('0')), letters);
+}
+
+inline __m256i asciiToNibbles256(__m256i chars, __m256i &valid)
+{
+    __m256i digits = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+    __m256i letters = _mm256_sub_epi8(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digits, _mm256_set1_epi8(9)), digits);
+    __m256i isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letters, _mm256_set1_epi8(5)), letters);
+
+    valid = _mm256_or_si256(isDigit, isLetter);
+
+    return _mm256_or_si256(_mm256_and_si256(isDigit, digits), _mm256_and_si256(isLetter, _mm256_add_epi8(letters, _mm256_set1_epi8(10))));
+}
+
+inline __m256i packNibblePairs256(__m256i nibbles)
+{
+    __m256i high = _mm256_and_si256(nibbles, _mm256_set1_epi16(0x00FF));
+    __m256i low = _mm256_srli_epi16(nibbles, 8);
+    return _mm256_or_si256(_mm256_slli_epi16(high, 4), low);
+}
+
+#endif
+
+void encodeHex(const uint8_t *data, size_t size, char *output)
+{
+    size_t i = 0;
+
+#if defined(BITCHAT_HEX_AVX2)
+    for (; i + 32 <= size; i += 32)
+    {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        __m256i high = nibblesToAscii256(_mm256_and_si256(_mm256_srli_epi16(bytes, 4), _mm256_set1_epi8(0x0F)));
+        __m256i low = nibblesToAscii256(_mm256_and_si256(bytes, _mm256_set1_epi8(0x0F)));
+
+        // Unpack interleaves within 128 bit lanes, so the lanes are reordered on store
+        __m256i first = _mm256_unpacklo_epi8(high, low);
+        __m256i second = _mm256_unpackhi_epi8(high, low);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + i * 2), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + i * 2 + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+#endif
+
+#if defined(BITCHAT_HEX_SSE2)
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        __m128i high = nibblesToAscii(_mm_and_si128(_mm_srli_epi16(bytes, 4), _mm_set1_epi8(0x0F)));
+        __m128i low = nibblesToAscii(_mm_and_si128(bytes, _mm_set1_epi8(0x0F)));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i * 2), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i * 2 + 16), _mm_unpackhi_epi8(high, low));
+    }
+
+    // Peer IDs are 8 bytes, handle them with a half width load
+    if (i + 8 <= size)
+    {
+        __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(data + i));
+        __m128i high = nibblesToAscii(_mm_and_si128(_mm_srli_epi16(bytes, 4), _mm_set1_epi8(0x0F)));
+        __m128i low = nibblesToAscii(_mm_and_si128(bytes, _mm_set1_epi8(0x0F)));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i * 2), _mm_unpacklo_epi8(high, low));
+        i += 8;
+    }
+#elif defined(BITCHAT_HEX_NEON)
+    for (; i + 16 <= size; i += 16)
+    {
+        uint8x16_t bytes = vld1q_u8(data + i);
+        uint8x16_t high = vshrq_n_u8(bytes, 4);
+        uint8x16_t low = vandq_u8(bytes, vdupq_n_u8(0x0F));
+
+        uint8x16x2_t chars;
+        chars.val[0] = vaddq_u8(vaddq_u8(high, vdupq_n_u8('0')), vandq_u8(vcgtq_u8(high, vdupq_n_u8(9)), vdupq_n_u8(39)));
+        chars.val[1] = vaddq_u8(vaddq_u8(low, vdupq_n_u8('0')), vandq_u8(vcgtq_u8(low, vdupq_n_u8(9)), vdupq_n_u8(39)));
+
+        // Interleaving store writes high, low pairs
+        vst2q_u8(reinterpret_cast<uint8_t *>(output + i * 2), chars);
+    }
+#endif
+
+    encodeHexScalar(data + i, size - i, output + i * 2);
+}
+
+bool decodeHex(const char *str, size_t size, uint8_t *output)
+{
+    size_t i = 0;
+
+#if defined(BITCHAT_HEX_AVX2)
+    for (; i + 32 <= size; i += 32)
+    {
+        __m256i validFirst;
+        __m256i validSecond;
+        __m256i first = asciiToNibbles256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + i * 2)), validFirst);
+        __m256i second = asciiToNibbles256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + i * 2 + 32)), validSecond);
+
+        if (_mm256_movemask_epi8(_mm256_and_si256(validFirst, validSecond)) != -1)
+        {
+            return false;
+        }
+
+        // Pack works within 128 bit lanes, restore the byte order with a 64 bit permute
+        __m256i bytes = _mm256_packus_epi16(packNibblePairs256(first), packNibblePairs256(second));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + i), _mm256_permute4x64_epi64(bytes, 0xD8));
+    }
+#endif
+
+#if defined(BITCHAT_HEX_SSE2)
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i validFirst;
+        __m128i validSecond;
+        __m128i first = asciiToNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i *>(str + i * 2)), validFirst);
+        __m128i second = asciiToNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i *>(str + i * 2 + 16)), validSecond);
+
+        if (_mm_movemask_epi8(_mm_and_si128(validFirst, validSecond)) != 0xFFFF)
+        {
+            return false;
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), _mm_packus_epi16(packNibblePairs(first), packNibblePairs(second)));
+    }
+
+    if (i + 8 <= size)
+    {
+        __m128i valid;
+        __m128i nibbles = asciiToNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i *>(str + i * 2)), valid);
+
+        if (_mm_movemask_epi8(valid) != 0xFFFF)
+        {
+            return false;
+        }
+
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(output + i), _mm_packus_epi16(packNibblePairs(nibbles), _mm_setzero_si128()));
+        i += 8;
+    }
+#elif defined(BITCHAT_HEX_NEON)
+    for (; i + 16 <= size; i += 16)
+    {
+        // De-interleaving load splits high and low characters
+        uint8x16x2_t chars = vld2q_u8(reinterpret_cast<const uint8_t *>(str + i * 2));
+        uint8x16_t nibbles[2];
+        uint8x16_t valid = vdupq_n_u8(0xFF);
+
+        for (int j = 0; j < 2; j++)
+        {
+            uint8x16_t digits = vsubq_u8(chars.val[j], vdupq_n_u8('0'));
+            uint8x16_t letters = vsubq_u8(vorrq_u8(chars.val[j], vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+            uint8x16_t isDigit = vcleq_u8(digits, vdupq_n_u8(9));
+            uint8x16_t isLetter = vcleq_u8(letters, vdupq_n_u8(5));
+
+            valid = vandq_u8(valid, vorrq_u8(isDigit, isLetter));
+            nibbles[j] = vbslq_u8(isDigit, digits, vaddq_u8(letters, vdupq_n_u8(10)));
+        }
+
+        if (vminvq_u8(valid) != 0xFF)
+        {
+            return false;
+        }
+
+        vst1q_u8(output + i, vorrq_u8(vshlq_n_u8(nibbles[0], 4), nibbles[1]));
+    }
+#endif
+
+    return decodeHexScalar(str + i * 2, size - i, output + i);
+}
+
+} // namespace
+
+std::string StringHelper::toHex(std::span<const uint8_t> data)
+{
+    std::string result(data.size() * 2, '\0');
+    encodeHex(data.data(), data.size(), result.data());
+
+    return result;
+}
+
+bool StringHelper::toHex(std::span<const uint8_t> data, std::span<char> output)
+{
+    if (output.size() < data.size() * 2)
+    {
+        return false;
+    }
+
+    encodeHex(data.data(), data.size(), output.data());
+
+    return true;
+}
+
+void StringHelper::appendHex(std::string &output, std::span<const uint8_t> data)
+{
+    size_t offset = output.size();
+    output.resize(offset + data.size() * 2);
+    encodeHex(data.data(), data.size(), output.data() + offset);
+}
+
+bool StringHelper::fromHex(std::string_view str, std::span<uint8_t> output)
+{
+    if (str.size() % 2 != 0 || output.size() != str.size() / 2)
+    {
+        return false;
+    }
+
+    return decodeHex(str.data(), output.size(), output.data());
+}
+
+bool StringHelper::isHex(std::string_view str)
+{
+    if (str.size() % 2 != 0)
+    {
+        return false;
+    }
+
+    // clang-format off
+    return std::all_of(str.begin(), str.end(), [](char c) {
+        return HEX_DECODE_TABLE[static_cast<uint8_t>(c)] != 0xFF;
+    });
+    // clang-format on
+}
+
+std::vector<uint8_t> StringHelper::stringToVector(std::string_view str)
 {
     // Convert hex string to bytes
     if (str.length() % 2 != 0)
@@ -29,12 +349,11 @@ std::vector<uint8_t> StringHelper::stringToVector(const std::string &str)
         return std::vector<uint8_t>();
     }
 
-    std::vector<uint8_t> result;
-    for (size_t i = 0; i < str.length(); i += 2)
+    std::vector<uint8_t> result(str.length() / 2);
+
+    if (!decodeHex(str.data(), result.size(), result.data()))
     {
-        std::string byteString = str.substr(i, 2);
-        uint8_t byte = static_cast<uint8_t>(std::stoi(byteString, nullptr, 16));
-        result.push_back(byte);
+        return std::vector<uint8_t>();
     }
 
     return result;
@@ -65,13 +384,7 @@ std::string StringHelper::randomPeerID()
         byte = static_cast<uint8_t>(dis(gen));
     }
 
-    std::stringstream ss;
-    for (uint8_t byte : peerID)
-    {
-        ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
-    }
-
-    return ss.str();
+    return toHex(peerID);
 }
 
 std::string StringHelper::createUUID()
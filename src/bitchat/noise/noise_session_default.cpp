@@ -1,47 +1,169 @@
 #include "bitchat/noise/noise_session_default.h"
 #include "bitchat/core/constants.h"
+#include <algorithm>
+#include <noise/protocol.h>
 #include <spdlog/spdlog.h>
+#include <stdexcept>
 
 namespace bitchat
 {
 
+namespace
+{
+
+constexpr const char *PROTOCOL_NAME = "Noise_XX_25519_ChaChaPoly_SHA256";
+constexpr size_t MAX_TRANSPORT_MESSAGE_SIZE = NOISE_MAX_PAYLOAD_LEN;
+
+void initializeNoise()
+{
+    static std::once_flag once;
+
+    // clang-format off
+    std::call_once(once, []() {
+        if (noise_init() != NOISE_ERROR_NONE)
+        {
+            throw std::runtime_error("Failed to initialize noise-c");
+        }
+    });
+    // clang-format on
+}
+
+std::string noiseErrorToString(int error)
+{
+    char buffer[64];
+    noise_strerror(error, buffer, sizeof(buffer));
+
+    return buffer;
+}
+
+} // namespace
+
 NoiseSessionDefault::NoiseSessionDefault(const std::string &peerID, NoiseRole role, const NoisePrivateKey &localStaticKey)
     : peerID(peerID)
     , role(role)
     , localStaticKey(localStaticKey)
+    , handshakeState(nullptr)
+    , sendCipher(nullptr)
+    , receiveCipher(nullptr)
     , sessionEstablished(false)
     , messageCount(0)
     , lastActivityTime(std::chrono::system_clock::now())
     , creationTime(std::chrono::system_clock::now())
 {
+    initializeNoise();
+
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    resetHandshake();
+
+    if (!handshakeState)
+    {
+        throw std::runtime_error("Failed to create Noise handshake state for peer: " + peerID);
+    }
+}
+
+NoiseSessionDefault::~NoiseSessionDefault()
+{
+    freeStates();
 }
 
 std::vector<uint8_t> NoiseSessionDefault::encrypt(const std::vector<uint8_t> &plaintext)
 {
+    std::vector<uint8_t> buffer(plaintext.size() + TAG_SIZE);
+    std::copy(plaintext.begin(), plaintext.end(), buffer.begin());
+
+    std::optional<size_t> length = encryptInPlace(buffer, plaintext.size());
+
+    if (!length)
+    {
+        return {};
+    }
+
+    buffer.resize(*length);
+
+    return buffer;
+}
+
+std::vector<uint8_t> NoiseSessionDefault::decrypt(const std::vector<uint8_t> &ciphertext)
+{
+    std::vector<uint8_t> buffer = ciphertext;
+    std::optional<size_t> length = decryptInPlace(buffer);
+
+    if (!length)
+    {
+        return {};
+    }
+
+    buffer.resize(*length);
+
+    return buffer;
+}
+
+std::optional<size_t> NoiseSessionDefault::encryptInPlace(std::span<uint8_t> buffer, size_t length)
+{
+    std::lock_guard<std::mutex> lock(sessionMutex);
+
     if (!sessionEstablished)
     {
         throw std::runtime_error("Session not established");
     }
 
+    if (length > MAX_TRANSPORT_MESSAGE_SIZE - TAG_SIZE || buffer.size() < length + TAG_SIZE)
+    {
+        spdlog::error("No room to encrypt {} bytes in a buffer of {} for peer: {}", length, buffer.size(), peerID);
+        return std::nullopt;
+    }
+
+    NoiseBuffer noiseBuffer;
+    noise_buffer_set_inout(noiseBuffer, buffer.data(), length, buffer.size());
+
+    int error = noise_cipherstate_encrypt(static_cast<NoiseCipherState *>(sendCipher), &noiseBuffer);
+
+    if (error != NOISE_ERROR_NONE)
+    {
+        spdlog::error("Noise encryption failed for peer {}: {}", peerID, noiseErrorToString(error));
+        return std::nullopt;
+    }
+
     messageCount++;
     lastActivityTime = std::chrono::system_clock::now();
-    return plaintext;
+
+    return noiseBuffer.size;
 }
 
-std::vector<uint8_t> NoiseSessionDefault::decrypt(const std::vector<uint8_t> &ciphertext)
+std::optional<size_t> NoiseSessionDefault::decryptInPlace(std::span<uint8_t> buffer)
 {
+    std::lock_guard<std::mutex> lock(sessionMutex);
+
     if (!sessionEstablished)
     {
         throw std::runtime_error("Session not established");
     }
 
+    if (buffer.size() < TAG_SIZE || buffer.size() > MAX_TRANSPORT_MESSAGE_SIZE)
+    {
+        return std::nullopt;
+    }
+
+    NoiseBuffer noiseBuffer;
+    noise_buffer_set_input(noiseBuffer, buffer.data(), buffer.size());
+
+    int error = noise_cipherstate_decrypt(static_cast<NoiseCipherState *>(receiveCipher), &noiseBuffer);
+
+    if (error != NOISE_ERROR_NONE)
+    {
+        spdlog::warn("Noise decryption failed for peer {}: {}", peerID, noiseErrorToString(error));
+        return std::nullopt;
+    }
+
     messageCount++;
     lastActivityTime = std::chrono::system_clock::now();
-    return ciphertext;
+
+    return noiseBuffer.size;
 }
 
 bool NoiseSessionDefault::isSessionEstablished() const
 {
+    std::lock_guard<std::mutex> lock(sessionMutex);
     return sessionEstablished;
 }
 
@@ -52,35 +174,46 @@ std::string NoiseSessionDefault::getPeerID() const
 
 std::optional<NoisePublicKey> NoiseSessionDefault::getRemoteStaticPublicKey() const
 {
+    std::lock_guard<std::mutex> lock(sessionMutex);
     return remoteStaticKey;
 }
 
 std::optional<std::vector<uint8_t>> NoiseSessionDefault::getHandshakeHash() const
 {
+    std::lock_guard<std::mutex> lock(sessionMutex);
     return handshakeHash;
 }
 
 std::optional<std::vector<uint8_t>> NoiseSessionDefault::startHandshake()
 {
+    std::lock_guard<std::mutex> lock(sessionMutex);
+
     if (sessionEstablished)
     {
         throw std::runtime_error("Session already established");
     }
 
-    sessionEstablished = true;
-    handshakeHash = std::vector<uint8_t>(32, 0);
+    if (role != NoiseRole::Initiator)
+    {
+        spdlog::warn("Only the initiator starts a handshake, waiting for peer: {}", peerID);
+        return std::nullopt;
+    }
 
-    spdlog::info("Simple handshake completed for peer: {} (role: {})", peerID,
-                 role == NoiseRole::Initiator ? "Initiator" : "Responder");
+    // Start over if an earlier attempt was left half way
+    if (noise_handshakestate_get_action(static_cast<NoiseHandshakeState *>(handshakeState)) != NOISE_ACTION_WRITE_MESSAGE)
+    {
+        resetHandshake();
+    }
 
-    std::vector<uint8_t> handshakeMsg = {0x01, 0x02, 0x03};
-    handshakeMsg.insert(handshakeMsg.end(), localStaticKey.begin(), localStaticKey.begin() + 3);
+    spdlog::info("Starting Noise handshake with peer: {}", peerID);
 
-    return handshakeMsg;
+    return writeHandshakeMessage();
 }
 
 bool NoiseSessionDefault::needsRenegotiation() const
 {
+    std::lock_guard<std::mutex> lock(sessionMutex);
+
     auto now = std::chrono::system_clock::now();
     auto timeSinceCreation = now - creationTime;
 
@@ -100,36 +233,215 @@ bool NoiseSessionDefault::needsRenegotiation() const
 
 uint64_t NoiseSessionDefault::getMessageCount() const
 {
+    std::lock_guard<std::mutex> lock(sessionMutex);
     return messageCount;
 }
 
 std::chrono::system_clock::time_point NoiseSessionDefault::getLastActivityTime() const
 {
+    std::lock_guard<std::mutex> lock(sessionMutex);
     return lastActivityTime;
 }
 
 bool NoiseSessionDefault::handshakeInProgress() const
 {
+    std::lock_guard<std::mutex> lock(sessionMutex);
     return !sessionEstablished;
 }
 
-std::optional<std::vector<uint8_t>> NoiseSessionDefault::processHandshakeMessage([[maybe_unused]] const std::vector<uint8_t> &message)
+std::optional<std::vector<uint8_t>> NoiseSessionDefault::processHandshakeMessage(const std::vector<uint8_t> &message)
 {
+    std::lock_guard<std::mutex> lock(sessionMutex);
+
     if (sessionEstablished)
     {
         throw std::runtime_error("Session already established");
     }
 
+    if (message.size() > constants::NOISE_MAX_HANDSHAKE_MESSAGE_SIZE)
+    {
+        spdlog::warn("Handshake message of {} bytes from peer {} is too large", message.size(), peerID);
+        return std::nullopt;
+    }
+
+    if (!readHandshakeMessage(message))
+    {
+        // A failed message ends the handshake; a responder also accepts a
+        // restarted initiator, whose first message arrives on a fresh state
+        resetHandshake();
+
+        if (role != NoiseRole::Responder || !readHandshakeMessage(message))
+        {
+            resetHandshake();
+            return std::nullopt;
+        }
+    }
+
+    completeHandshakeIfReady();
+
+    if (sessionEstablished)
+    {
+        return std::nullopt;
+    }
+
+    return writeHandshakeMessage();
+}
+
+void NoiseSessionDefault::resetHandshake()
+{
+    if (handshakeState)
+    {
+        noise_handshakestate_free(static_cast<NoiseHandshakeState *>(handshakeState));
+        handshakeState = nullptr;
+    }
+
+    NoiseHandshakeState *state = nullptr;
+    int noiseRole = role == NoiseRole::Initiator ? NOISE_ROLE_INITIATOR : NOISE_ROLE_RESPONDER;
+    int error = noise_handshakestate_new_by_name(&state, PROTOCOL_NAME, noiseRole);
+
+    if (error != NOISE_ERROR_NONE)
+    {
+        spdlog::error("Failed to create {} for peer {}: {}", PROTOCOL_NAME, peerID, noiseErrorToString(error));
+        return;
+    }
+
+    NoiseDHState *localKeyPair = noise_handshakestate_get_local_keypair_dh(state);
+    error = noise_dhstate_set_keypair_private(localKeyPair, localStaticKey.data(), localStaticKey.size());
+
+    if (error == NOISE_ERROR_NONE)
+    {
+        error = noise_handshakestate_start(state);
+    }
+
+    if (error != NOISE_ERROR_NONE)
+    {
+        spdlog::error("Failed to start Noise handshake for peer {}: {}", peerID, noiseErrorToString(error));
+        noise_handshakestate_free(state);
+        return;
+    }
+
+    handshakeState = state;
+}
+
+bool NoiseSessionDefault::readHandshakeMessage(const std::vector<uint8_t> &message)
+{
+    NoiseHandshakeState *state = static_cast<NoiseHandshakeState *>(handshakeState);
+
+    if (!state || noise_handshakestate_get_action(state) != NOISE_ACTION_READ_MESSAGE)
+    {
+        spdlog::warn("Unexpected handshake message from peer: {}", peerID);
+        return false;
+    }
+
+    // noise-c decrypts in place, so it reads from a copy
+    std::vector<uint8_t> copy = message;
+    NoiseBuffer noiseBuffer;
+    noise_buffer_set_input(noiseBuffer, copy.data(), copy.size());
+
+    int error = noise_handshakestate_read_message(state, &noiseBuffer, nullptr);
+
+    if (error != NOISE_ERROR_NONE)
+    {
+        spdlog::warn("Rejected handshake message from peer {}: {}", peerID, noiseErrorToString(error));
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<std::vector<uint8_t>> NoiseSessionDefault::writeHandshakeMessage()
+{
+    NoiseHandshakeState *state = static_cast<NoiseHandshakeState *>(handshakeState);
+
+    if (!state || noise_handshakestate_get_action(state) != NOISE_ACTION_WRITE_MESSAGE)
+    {
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> message(constants::NOISE_MAX_HANDSHAKE_MESSAGE_SIZE);
+    NoiseBuffer noiseBuffer;
+    noise_buffer_set_output(noiseBuffer, message.data(), message.size());
+
+    int error = noise_handshakestate_write_message(state, &noiseBuffer, nullptr);
+
+    if (error != NOISE_ERROR_NONE)
+    {
+        spdlog::error("Failed to write handshake message for peer {}: {}", peerID, noiseErrorToString(error));
+        resetHandshake();
+        return std::nullopt;
+    }
+
+    message.resize(noiseBuffer.size);
+
+    // The initiator is done once its last message is written
+    completeHandshakeIfReady();
+
+    return message;
+}
+
+void NoiseSessionDefault::completeHandshakeIfReady()
+{
+    NoiseHandshakeState *state = static_cast<NoiseHandshakeState *>(handshakeState);
+
+    if (!state || noise_handshakestate_get_action(state) != NOISE_ACTION_SPLIT)
+    {
+        return;
+    }
+
+    std::vector<uint8_t> hash(32);
+    noise_handshakestate_get_handshake_hash(state, hash.data(), hash.size());
+
+    NoisePublicKey remoteKey{};
+    NoiseDHState *remoteDH = noise_handshakestate_get_remote_public_key_dh(state);
+
+    if (remoteDH && noise_dhstate_get_public_key(remoteDH, remoteKey.data(), remoteKey.size()) == NOISE_ERROR_NONE)
+    {
+        remoteStaticKey = remoteKey;
+    }
+
+    NoiseCipherState *send = nullptr;
+    NoiseCipherState *receive = nullptr;
+    int error = noise_handshakestate_split(state, &send, &receive);
+
+    if (error != NOISE_ERROR_NONE)
+    {
+        spdlog::error("Failed to split Noise handshake for peer {}: {}", peerID, noiseErrorToString(error));
+        resetHandshake();
+        return;
+    }
+
+    // Ephemeral keys are no longer needed
+    noise_handshakestate_free(state);
+    handshakeState = nullptr;
+
+    sendCipher = send;
+    receiveCipher = receive;
+    handshakeHash = std::move(hash);
     sessionEstablished = true;
-    handshakeHash = std::vector<uint8_t>(32, 0);
+    lastActivityTime = std::chrono::system_clock::now();
 
-    spdlog::info("Simple handshake processed for peer: {} (role: {})", peerID,
-                 role == NoiseRole::Initiator ? "Initiator" : "Responder");
+    spdlog::info("Noise handshake completed for peer: {} (role: {})", peerID, role == NoiseRole::Initiator ? "Initiator" : "Responder");
+}
 
-    std::vector<uint8_t> response = {0x04, 0x05, 0x06};
-    response.insert(response.end(), localStaticKey.begin() + 3, localStaticKey.begin() + 6);
+void NoiseSessionDefault::freeStates()
+{
+    if (handshakeState)
+    {
+        noise_handshakestate_free(static_cast<NoiseHandshakeState *>(handshakeState));
+        handshakeState = nullptr;
+    }
 
-    return response;
+    if (sendCipher)
+    {
+        noise_cipherstate_free(static_cast<NoiseCipherState *>(sendCipher));
+        sendCipher = nullptr;
+    }
+
+    if (receiveCipher)
+    {
+        noise_cipherstate_free(static_cast<NoiseCipherState *>(receiveCipher));
+        receiveCipher = nullptr;
+    }
 }
 
 } // namespace bitchat
@@ -0,0 +1,376 @@
+#include "bitchat/noise/sender_key_store.h"
+#include "bitchat/core/constants.h"
+#include <algorithm>
+#include <noise/protocol.h>
+#include <openssl/rand.h>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+
+namespace bitchat
+{
+
+namespace
+{
+
+// HKDF input, separates sender key chains from any other use of the hash
+constexpr uint8_t CHAIN_LABEL[] = {'b', 'i', 't', 'c', 'h', 'a', 't', '-', 's', 'e', 'n', 'd', 'e', 'r', '-', 'k', 'e', 'y'};
+
+} // namespace
+
+SenderKeyStore::SenderKeyStore()
+    : SenderKeyStore(Config{constants::SENDER_KEY_MAX_SENDERS, constants::SENDER_KEY_MAX_SKIP, constants::SENDER_KEY_ROTATION_MESSAGES})
+{
+    // Pass
+}
+
+SenderKeyStore::SenderKeyStore(const Config &config)
+    : config(config)
+    , hashState(nullptr)
+    , cipherState(nullptr)
+{
+    this->config.maxSenders = std::max<size_t>(config.maxSenders, 1);
+
+    if (noise_init() != NOISE_ERROR_NONE)
+    {
+        throw std::runtime_error("Failed to initialize noise-c");
+    }
+
+    NoiseHashState *hash = nullptr;
+    NoiseCipherState *cipher = nullptr;
+
+    if (noise_hashstate_new_by_id(&hash, NOISE_HASH_SHA256) != NOISE_ERROR_NONE || noise_cipherstate_new_by_id(&cipher, NOISE_CIPHER_CHACHAPOLY) != NOISE_ERROR_NONE)
+    {
+        noise_hashstate_free(hash);
+        throw std::runtime_error("Failed to create sender key cipher");
+    }
+
+    hashState = hash;
+    cipherState = cipher;
+
+    newLocalChain();
+}
+
+SenderKeyStore::~SenderKeyStore()
+{
+    noise_cipherstate_free(static_cast<NoiseCipherState *>(cipherState));
+    noise_hashstate_free(static_cast<NoiseHashState *>(hashState));
+}
+
+std::vector<uint8_t> SenderKeyStore::getDistributionMessage() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<uint8_t> message(DISTRIBUTION_SIZE);
+    writeHeader(message.data(), localChain.keyID, localChain.iteration);
+    std::copy(localChain.chainKey.begin(), localChain.chainKey.end(), message.begin() + HEADER_SIZE);
+
+    return message;
+}
+
+bool SenderKeyStore::processDistributionMessage(PeerId sender, std::span<const uint8_t> message)
+{
+    if (message.size() != DISTRIBUTION_SIZE)
+    {
+        spdlog::warn("Ignoring sender key of {} bytes from {}", message.size(), sender);
+        return false;
+    }
+
+    SenderChain state;
+    readHeader(message.data(), state.chain.keyID, state.chain.iteration);
+    uint32_t keyID = state.chain.keyID;
+    std::copy(message.begin() + HEADER_SIZE, message.end(), state.chain.chainKey.begin());
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = senders.find(sender);
+
+    if (it != senders.end())
+    {
+        // A distribution of the chain in use is a resend or a replay, taking
+        // it could rewind the chain and accept old messages again
+        if (it->second.chain.keyID == keyID)
+        {
+            spdlog::debug("Keeping sender key {:08x} of {}, already in use", keyID, sender);
+            return true;
+        }
+
+        // A rotated chain replaces the old one in place
+        it->second = std::move(state);
+    }
+    else
+    {
+        if (senders.size() >= config.maxSenders)
+        {
+            senders.erase(senderOrder.front());
+            senderOrder.pop_front();
+        }
+
+        senders.emplace(sender, std::move(state));
+        senderOrder.push_back(sender);
+    }
+
+    spdlog::debug("Learned sender key {:08x} for {}", keyID, sender);
+
+    return true;
+}
+
+bool SenderKeyStore::hasSenderKey(PeerId sender) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return senders.count(sender) > 0;
+}
+
+void SenderKeyStore::removeSenderKey(PeerId sender)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (senders.erase(sender) > 0)
+    {
+        senderOrder.erase(std::find(senderOrder.begin(), senderOrder.end(), sender));
+    }
+}
+
+void SenderKeyStore::rotate()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    newLocalChain();
+}
+
+bool SenderKeyStore::needsRotation() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return localChain.iteration >= config.rotateAfter;
+}
+
+std::optional<std::vector<uint8_t>> SenderKeyStore::encrypt(PeerId localPeerID, std::span<const uint8_t> plaintext)
+{
+    if (plaintext.size() > NOISE_MAX_PAYLOAD_LEN - TAG_SIZE)
+    {
+        spdlog::error("Broadcast of {} bytes is too large to encrypt", plaintext.size());
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> output(HEADER_SIZE + plaintext.size() + TAG_SIZE);
+    std::copy(plaintext.begin(), plaintext.end(), output.begin() + HEADER_SIZE);
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Key messageKey;
+
+    if (!step(localChain.chainKey, messageKey))
+    {
+        return std::nullopt;
+    }
+
+    writeHeader(output.data(), localChain.keyID, localChain.iteration);
+    localChain.iteration++;
+
+    std::span<const uint8_t> header(output.data(), HEADER_SIZE);
+    std::span<uint8_t> body(output.data() + HEADER_SIZE, output.size() - HEADER_SIZE);
+
+    if (!seal(localPeerID, messageKey, header, body, plaintext.size()))
+    {
+        return std::nullopt;
+    }
+
+    return output;
+}
+
+std::optional<std::vector<uint8_t>> SenderKeyStore::decrypt(PeerId sender, std::span<const uint8_t> message)
+{
+    if (message.size() < HEADER_SIZE + TAG_SIZE || message.size() > HEADER_SIZE + NOISE_MAX_PAYLOAD_LEN)
+    {
+        return std::nullopt;
+    }
+
+    uint32_t keyID;
+    uint32_t iteration;
+    readHeader(message.data(), keyID, iteration);
+
+    std::span<const uint8_t> header = message.first(HEADER_SIZE);
+    std::vector<uint8_t> output(message.begin() + HEADER_SIZE, message.end());
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = senders.find(sender);
+
+    if (it == senders.end() || it->second.chain.keyID != keyID)
+    {
+        spdlog::debug("No sender key {:08x} for {}", keyID, sender);
+        return std::nullopt;
+    }
+
+    SenderChain &state = it->second;
+
+    // Behind the chain: only a skipped iteration can still be opened, and only once
+    if (iteration < state.chain.iteration)
+    {
+        // clang-format off
+        auto skipped = std::find_if(state.skipped.begin(), state.skipped.end(), [iteration](const auto &entry) {
+            return entry.first == iteration;
+        });
+        // clang-format on
+
+        if (skipped == state.skipped.end())
+        {
+            spdlog::debug("Dropping replayed or stale broadcast {} from {}", iteration, sender);
+            return std::nullopt;
+        }
+
+        std::optional<size_t> length = open(sender, skipped->second, header, output);
+
+        if (!length)
+        {
+            return std::nullopt;
+        }
+
+        state.skipped.erase(skipped);
+        output.resize(*length);
+
+        return output;
+    }
+
+    if (iteration - state.chain.iteration > config.maxSkip || iteration == UINT32_MAX)
+    {
+        spdlog::warn("Broadcast {} from {} is too far ahead of its chain", iteration, sender);
+        return std::nullopt;
+    }
+
+    // Walk a copy of the chain, committed only once the message authenticates,
+    // so a forged header cannot move the chain
+    Key chainKey = state.chain.chainKey;
+    Key messageKey;
+    std::vector<std::pair<uint32_t, Key>> skipped;
+
+    for (uint32_t i = state.chain.iteration; i <= iteration; i++)
+    {
+        if (!step(chainKey, messageKey))
+        {
+            return std::nullopt;
+        }
+
+        if (i < iteration)
+        {
+            skipped.emplace_back(i, messageKey);
+        }
+    }
+
+    std::optional<size_t> length = open(sender, messageKey, header, output);
+
+    if (!length)
+    {
+        spdlog::warn("Broadcast {} from {} failed authentication", iteration, sender);
+        return std::nullopt;
+    }
+
+    state.chain.chainKey = chainKey;
+    state.chain.iteration = iteration + 1;
+    state.skipped.insert(state.skipped.end(), skipped.begin(), skipped.end());
+
+    while (state.skipped.size() > config.maxSkip)
+    {
+        state.skipped.pop_front();
+    }
+
+    output.resize(*length);
+
+    return output;
+}
+
+bool SenderKeyStore::step(Key &chainKey, Key &messageKey)
+{
+    Key nextChainKey;
+
+    if (noise_hashstate_hkdf(static_cast<NoiseHashState *>(hashState), chainKey.data(), chainKey.size(), CHAIN_LABEL, sizeof(CHAIN_LABEL), nextChainKey.data(), nextChainKey.size(), messageKey.data(), messageKey.size()) != NOISE_ERROR_NONE)
+    {
+        spdlog::error("Failed to step sender key chain");
+        return false;
+    }
+
+    chainKey = nextChainKey;
+
+    return true;
+}
+
+bool SenderKeyStore::seal(PeerId sender, const Key &messageKey, std::span<const uint8_t> header, std::span<uint8_t> buffer, size_t length)
+{
+    NoiseCipherState *cipher = static_cast<NoiseCipherState *>(cipherState);
+    AssociatedData ad = makeAssociatedData(sender, header);
+
+    NoiseBuffer noiseBuffer;
+    noise_buffer_set_inout(noiseBuffer, buffer.data(), length, buffer.size());
+
+    // Every message key is used once, so the nonce can start from zero
+    if (noise_cipherstate_init_key(cipher, messageKey.data(), messageKey.size()) != NOISE_ERROR_NONE || noise_cipherstate_encrypt_with_ad(cipher, ad.data(), ad.size(), &noiseBuffer) != NOISE_ERROR_NONE)
+    {
+        spdlog::error("Failed to encrypt broadcast");
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<size_t> SenderKeyStore::open(PeerId sender, const Key &messageKey, std::span<const uint8_t> header, std::span<uint8_t> buffer)
+{
+    NoiseCipherState *cipher = static_cast<NoiseCipherState *>(cipherState);
+    AssociatedData ad = makeAssociatedData(sender, header);
+
+    NoiseBuffer noiseBuffer;
+    noise_buffer_set_input(noiseBuffer, buffer.data(), buffer.size());
+
+    if (noise_cipherstate_init_key(cipher, messageKey.data(), messageKey.size()) != NOISE_ERROR_NONE || noise_cipherstate_decrypt_with_ad(cipher, ad.data(), ad.size(), &noiseBuffer) != NOISE_ERROR_NONE)
+    {
+        return std::nullopt;
+    }
+
+    return noiseBuffer.size;
+}
+
+void SenderKeyStore::newLocalChain()
+{
+    Chain chain;
+
+    if (RAND_bytes(reinterpret_cast<uint8_t *>(&chain.keyID), sizeof(chain.keyID)) != 1 || RAND_bytes(chain.chainKey.data(), static_cast<int>(chain.chainKey.size())) != 1)
+    {
+        throw std::runtime_error("Failed to generate sender key");
+    }
+
+    localChain = chain;
+
+    spdlog::debug("Started sender key {:08x}", localChain.keyID);
+}
+
+SenderKeyStore::AssociatedData SenderKeyStore::makeAssociatedData(PeerId sender, std::span<const uint8_t> header)
+{
+    // The sender and header are authenticated, so a message cannot be passed
+    // off under another sender or iteration
+    AssociatedData ad;
+    std::array<uint8_t, PeerId::SIZE> senderBytes = sender.toBytes();
+    std::copy(senderBytes.begin(), senderBytes.end(), ad.begin());
+    std::copy(header.begin(), header.end(), ad.begin() + PeerId::SIZE);
+
+    return ad;
+}
+
+void SenderKeyStore::writeHeader(uint8_t *output, uint32_t keyID, uint32_t iteration)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        output[i] = static_cast<uint8_t>(keyID >> (24 - 8 * i));
+        output[4 + i] = static_cast<uint8_t>(iteration >> (24 - 8 * i));
+    }
+}
+
+void SenderKeyStore::readHeader(const uint8_t *input, uint32_t &keyID, uint32_t &iteration)
+{
+    keyID = 0;
+    iteration = 0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        keyID = (keyID << 8) | input[i];
+        iteration = (iteration << 8) | input[4 + i];
+    }
+}
+
+} // namespace bitchat
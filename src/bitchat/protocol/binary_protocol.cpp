@@ -0,0 +1,1001 @@
+#include "bitchat/protocol/binary_protocol.h"
+#include <algorithm>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BITCHAT_FLETCHER_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define BITCHAT_FLETCHER_NEON
+#endif
+
+namespace bitchat
+{
+namespace protocol
+{
+
+namespace
+{
+
+// Bytes summed before reducing modulo 255. Both sums stay below 2^32 for
+// blocks up to 5802 bytes, so the modulo is paid once per block, not per byte.
+constexpr size_t FLETCHER_BLOCK_SIZE = 4096;
+
+#if defined(BITCHAT_FLETCHER_SSE2)
+
+uint32_t horizontalSum(__m128i value)
+{
+    alignas(16) uint32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), value);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+// Accumulate size bytes (a multiple of 16) into the running sums.
+// For a 16 byte chunk b: sum2 += 16 * sum1 + sum((16 - i) * b[i]), sum1 += sum(b[i])
+void accumulateFletcher16(const uint8_t *data, size_t size, uint64_t &sum1, uint64_t &sum2)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i weightsLow = _mm_setr_epi16(16, 15, 14, 13, 12, 11, 10, 9);
+    const __m128i weightsHigh = _mm_setr_epi16(8, 7, 6, 5, 4, 3, 2, 1);
+
+    __m128i chunkSums = zero;  // sum of all bytes so far
+    __m128i prefixSums = zero; // sum of chunkSums before each chunk
+    __m128i weightedSums = zero;
+
+    for (size_t i = 0; i < size; i += 16)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+
+        prefixSums = _mm_add_epi32(prefixSums, chunkSums);
+        chunkSums = _mm_add_epi32(chunkSums, _mm_sad_epu8(bytes, zero));
+        weightedSums = _mm_add_epi32(weightedSums, _mm_madd_epi16(_mm_unpacklo_epi8(bytes, zero), weightsLow));
+        weightedSums = _mm_add_epi32(weightedSums, _mm_madd_epi16(_mm_unpackhi_epi8(bytes, zero), weightsHigh));
+    }
+
+    sum2 += size * sum1 + 16 * static_cast<uint64_t>(horizontalSum(prefixSums)) + horizontalSum(weightedSums);
+    sum1 += horizontalSum(chunkSums);
+}
+
+#elif defined(BITCHAT_FLETCHER_NEON)
+
+// Same decomposition as the SSE2 path, see above
+void accumulateFletcher16(const uint8_t *data, size_t size, uint64_t &sum1, uint64_t &sum2)
+{
+    static const uint8_t weights[16] = {16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1};
+    const uint8x8_t weightsLow = vld1_u8(weights);
+    const uint8x8_t weightsHigh = vld1_u8(weights + 8);
+
+    uint32x4_t chunkSums = vdupq_n_u32(0);
+    uint32x4_t prefixSums = vdupq_n_u32(0);
+    uint32x4_t weightedSums = vdupq_n_u32(0);
+
+    for (size_t i = 0; i < size; i += 16)
+    {
+        uint8x16_t bytes = vld1q_u8(data + i);
+
+        prefixSums = vaddq_u32(prefixSums, chunkSums);
+        chunkSums = vpadalq_u16(chunkSums, vpaddlq_u8(bytes));
+
+        uint16x8_t weighted = vmull_u8(vget_low_u8(bytes), weightsLow);
+        weighted = vmlal_u8(weighted, vget_high_u8(bytes), weightsHigh);
+        weightedSums = vpadalq_u16(weightedSums, weighted);
+    }
+
+    sum2 += size * sum1 + 16 * static_cast<uint64_t>(vaddvq_u32(prefixSums)) + vaddvq_u32(weightedSums);
+    sum1 += vaddvq_u32(chunkSums);
+}
+
+#endif
+
+uint16_t fletcher16(std::span<const uint8_t> data)
+{
+    uint64_t sum1 = 0;
+    uint64_t sum2 = 0;
+
+    for (size_t offset = 0; offset < data.size(); offset += FLETCHER_BLOCK_SIZE)
+    {
+        size_t blockSize = std::min(FLETCHER_BLOCK_SIZE, data.size() - offset);
+        const uint8_t *block = data.data() + offset;
+        size_t i = 0;
+
+#if defined(BITCHAT_FLETCHER_SSE2) || defined(BITCHAT_FLETCHER_NEON)
+        i = blockSize & ~static_cast<size_t>(15);
+        accumulateFletcher16(block, i, sum1, sum2);
+#endif
+
+        for (; i < blockSize; i++)
+        {
+            sum1 += block[i];
+            sum2 += sum1;
+        }
+
+        sum1 %= 255;
+        sum2 %= 255;
+    }
+
+    return static_cast<uint16_t>((sum2 << 8) | sum1);
+}
+
+void checkReadable(std::span<const uint8_t> data, size_t offset, size_t size)
+{
+    if (offset > data.size() || size > data.size() - offset)
+    {
+        throw std::out_of_range("Binary payload truncated");
+    }
+}
+
+void checkLength(size_t size)
+{
+    if (size > 0xFFFF)
+    {
+        throw std::length_error("Binary field too long");
+    }
+}
+
+} // namespace
+
+// Binary Packet Header
+
+bool BinaryPacketHeader::isValid() const
+{
+    return BinaryProtocol::validateHeader(*this);
+}
+
+uint16_t BinaryPacketHeader::computeChecksum(std::span<const uint8_t> payload) const
+{
+    return BinaryProtocol::computeChecksum(payload);
+}
+
+std::vector<uint8_t> BinaryPacketHeader::serialize() const
+{
+    std::vector<uint8_t> data(BinaryProtocolConstants::headerSize);
+    serializeInto(data.data());
+    return data;
+}
+
+void BinaryPacketHeader::serializeInto(uint8_t *output) const
+{
+    output[0] = magic;
+    output[1] = version;
+    output[2] = static_cast<uint8_t>(payloadLength >> 8);
+    output[3] = static_cast<uint8_t>(payloadLength & 0xFF);
+    output[4] = static_cast<uint8_t>(messageType >> 8);
+    output[5] = static_cast<uint8_t>(messageType & 0xFF);
+    output[6] = static_cast<uint8_t>(checksum >> 8);
+    output[7] = static_cast<uint8_t>(checksum & 0xFF);
+}
+
+BinaryPacketHeader BinaryPacketHeader::deserialize(std::span<const uint8_t> data)
+{
+    BinaryPacketHeader header{};
+
+    if (data.size() < BinaryProtocolConstants::headerSize)
+    {
+        return header;
+    }
+
+    header.magic = data[0];
+    header.version = data[1];
+    header.payloadLength = static_cast<uint16_t>((data[2] << 8) | data[3]);
+    header.messageType = static_cast<uint16_t>((data[4] << 8) | data[5]);
+    header.checksum = static_cast<uint16_t>((data[6] << 8) | data[7]);
+
+    return header;
+}
+
+// Binary Protocol
+
+std::vector<uint8_t> BinaryProtocol::serializeMessage(const BitchatMessage &message)
+{
+    std::vector<uint8_t> output;
+
+    if (!writePacket(output, message))
+    {
+        return {};
+    }
+
+    return output;
+}
+
+std::shared_ptr<BitchatMessage> BinaryProtocol::deserializeMessage(std::span<const uint8_t> data)
+{
+    return readPacket(data);
+}
+
+std::vector<uint8_t> BinaryProtocol::serializeHandshakeMessage(const BitchatHandshakeMessage &message)
+{
+    return serializeMessage(message);
+}
+
+std::shared_ptr<BitchatHandshakeMessage> BinaryProtocol::deserializeHandshakeMessage(std::span<const uint8_t> data)
+{
+    return std::dynamic_pointer_cast<BitchatHandshakeMessage>(readPacket(data));
+}
+
+std::vector<uint8_t> BinaryProtocol::serializeHandshakeResponseMessage(const BitchatHandshakeResponseMessage &message)
+{
+    return serializeMessage(message);
+}
+
+std::shared_ptr<BitchatHandshakeResponseMessage> BinaryProtocol::deserializeHandshakeResponseMessage(std::span<const uint8_t> data)
+{
+    return std::dynamic_pointer_cast<BitchatHandshakeResponseMessage>(readPacket(data));
+}
+
+std::vector<uint8_t> BinaryProtocol::serializeChatMessage(const BitchatChatMessage &message)
+{
+    return serializeMessage(message);
+}
+
+std::shared_ptr<BitchatChatMessage> BinaryProtocol::deserializeChatMessage(std::span<const uint8_t> data)
+{
+    return std::dynamic_pointer_cast<BitchatChatMessage>(readPacket(data));
+}
+
+std::vector<uint8_t> BinaryProtocol::serializeChannelJoinMessage(const BitchatChannelJoinMessage &message)
+{
+    return serializeMessage(message);
+}
+
+std::shared_ptr<BitchatChannelJoinMessage> BinaryProtocol::deserializeChannelJoinMessage(std::span<const uint8_t> data)
+{
+    return std::dynamic_pointer_cast<BitchatChannelJoinMessage>(readPacket(data));
+}
+
+std::vector<uint8_t> BinaryProtocol::serializeChannelLeaveMessage(const BitchatChannelLeaveMessage &message)
+{
+    return serializeMessage(message);
+}
+
+std::shared_ptr<BitchatChannelLeaveMessage> BinaryProtocol::deserializeChannelLeaveMessage(std::span<const uint8_t> data)
+{
+    return std::dynamic_pointer_cast<BitchatChannelLeaveMessage>(readPacket(data));
+}
+
+std::vector<uint8_t> BinaryProtocol::serializePeerInfoMessage(const BitchatPeerInfoMessage &message)
+{
+    return serializeMessage(message);
+}
+
+std::shared_ptr<BitchatPeerInfoMessage> BinaryProtocol::deserializePeerInfoMessage(std::span<const uint8_t> data)
+{
+    return std::dynamic_pointer_cast<BitchatPeerInfoMessage>(readPacket(data));
+}
+
+std::vector<uint8_t> BinaryProtocol::serializeChannelKeyShareMessage(const BitchatChannelKeyShareMessage &message)
+{
+    return serializeMessage(message);
+}
+
+std::shared_ptr<BitchatChannelKeyShareMessage> BinaryProtocol::deserializeChannelKeyShareMessage(std::span<const uint8_t> data)
+{
+    return std::dynamic_pointer_cast<BitchatChannelKeyShareMessage>(readPacket(data));
+}
+
+std::vector<uint8_t> BinaryProtocol::serializeKeepAliveMessage(const BitchatKeepAliveMessage &message)
+{
+    return serializeMessage(message);
+}
+
+std::shared_ptr<BitchatKeepAliveMessage> BinaryProtocol::deserializeKeepAliveMessage(std::span<const uint8_t> data)
+{
+    return std::dynamic_pointer_cast<BitchatKeepAliveMessage>(readPacket(data));
+}
+
+std::vector<uint8_t> BinaryProtocol::serializeErrorMessage(const BitchatErrorMessage &message)
+{
+    return serializeMessage(message);
+}
+
+std::shared_ptr<BitchatErrorMessage> BinaryProtocol::deserializeErrorMessage(std::span<const uint8_t> data)
+{
+    return std::dynamic_pointer_cast<BitchatErrorMessage>(readPacket(data));
+}
+
+bool BinaryProtocol::validatePacket(std::span<const uint8_t> data)
+{
+    BinaryPacketHeader header = BinaryPacketHeader::deserialize(data);
+
+    if (!validateHeader(header) || data.size() < BinaryProtocolConstants::headerSize + header.payloadLength)
+    {
+        return false;
+    }
+
+    return validateChecksum(header, data.subspan(BinaryProtocolConstants::headerSize, header.payloadLength));
+}
+
+bool BinaryProtocol::validateHeader(const BinaryPacketHeader &header)
+{
+    if (header.magic != BinaryProtocolConstants::magicByte || header.version != BinaryProtocolConstants::currentVersion)
+    {
+        return false;
+    }
+
+    if (header.messageType < static_cast<uint16_t>(BitchatMessageType::Handshake) || header.messageType > static_cast<uint16_t>(BitchatMessageType::Error))
+    {
+        return false;
+    }
+
+    return validatePayloadSize(header.payloadLength);
+}
+
+bool BinaryProtocol::validatePayloadSize(size_t payloadSize)
+{
+    return payloadSize <= BinaryProtocolConstants::maxMessageSize;
+}
+
+bool BinaryProtocol::validateChecksum(const BinaryPacketHeader &header, std::span<const uint8_t> payload)
+{
+    return computeChecksum(payload) == header.checksum;
+}
+
+BitchatMessageType BinaryProtocol::getMessageType(std::span<const uint8_t> data)
+{
+    BinaryPacketHeader header = BinaryPacketHeader::deserialize(data);
+
+    if (!validateHeader(header))
+    {
+        return BitchatMessageType::Error;
+    }
+
+    return static_cast<BitchatMessageType>(header.messageType);
+}
+
+std::vector<uint8_t> BinaryProtocol::getPayload(std::span<const uint8_t> data)
+{
+    if (!validatePacket(data))
+    {
+        return {};
+    }
+
+    auto payload = data.subspan(BinaryProtocolConstants::headerSize, BinaryPacketHeader::deserialize(data).payloadLength);
+    return std::vector<uint8_t>(payload.begin(), payload.end());
+}
+
+std::vector<uint8_t> BinaryProtocol::createErrorPacket(BitchatErrorCode errorCode, const std::string &errorMessage)
+{
+    BitchatErrorMessage message;
+    message.version = BinaryProtocolConstants::currentVersion;
+    message.type = BitchatMessageType::Error;
+    message.timestamp = std::chrono::system_clock::now();
+    message.errorCode = errorCode;
+    message.errorMessage = errorMessage;
+
+    return serializeErrorMessage(message);
+}
+
+bool BinaryProtocol::writePacket(std::vector<uint8_t> &output, const BitchatMessage &message)
+{
+    size_t start = output.size();
+
+    // Reserve the header, the payload is appended right behind it
+    output.resize(start + BinaryProtocolConstants::headerSize);
+
+    if (!writePayload(output, message))
+    {
+        output.resize(start);
+        return false;
+    }
+
+    size_t payloadSize = output.size() - start - BinaryProtocolConstants::headerSize;
+
+    if (!validatePayloadSize(payloadSize))
+    {
+        spdlog::error("Binary payload too large: {} > {}", payloadSize, BinaryProtocolConstants::maxMessageSize);
+        output.resize(start);
+        return false;
+    }
+
+    BinaryPacketHeader header{};
+    header.magic = BinaryProtocolConstants::magicByte;
+    header.version = BinaryProtocolConstants::currentVersion;
+    header.payloadLength = static_cast<uint16_t>(payloadSize);
+    header.messageType = static_cast<uint16_t>(message.type);
+    header.checksum = computeChecksum(std::span<const uint8_t>(output).subspan(start + BinaryProtocolConstants::headerSize));
+    header.serializeInto(output.data() + start);
+
+    return true;
+}
+
+bool BinaryProtocol::writePayload(std::vector<uint8_t> &output, const BitchatMessage &message)
+{
+    size_t start = output.size();
+
+    try
+    {
+        // Base fields
+        serializeString(output, message.peerID);
+        serializeTimestamp(output, message.timestamp);
+        serializeBytes(output, message.payload);
+
+        switch (message.type)
+        {
+        case BitchatMessageType::Handshake:
+        {
+            if (auto handshake = dynamic_cast<const BitchatHandshakeMessage *>(&message))
+            {
+                serializeString(output, handshake->nickname);
+                serializeString(output, handshake->channel);
+                serializeBytes(output, handshake->publicKey);
+                serializeBytes(output, handshake->handshakeData);
+                return true;
+            }
+            break;
+        }
+        case BitchatMessageType::HandshakeResponse:
+        {
+            if (auto response = dynamic_cast<const BitchatHandshakeResponseMessage *>(&message))
+            {
+                serializeString(output, response->nickname);
+                serializeString(output, response->channel);
+                serializeBytes(output, response->publicKey);
+                serializeBytes(output, response->handshakeData);
+                serializeUint16(output, static_cast<uint16_t>(response->errorCode));
+                return true;
+            }
+            break;
+        }
+        case BitchatMessageType::Message:
+        {
+            if (auto chat = dynamic_cast<const BitchatChatMessage *>(&message))
+            {
+                serializeString(output, chat->nickname);
+                serializeString(output, chat->channel);
+                serializeBool(output, chat->isEncrypted);
+                serializeString(output, chat->content);
+                serializeBytes(output, chat->encryptedContent);
+                return true;
+            }
+            break;
+        }
+        case BitchatMessageType::ChannelJoin:
+        {
+            if (auto join = dynamic_cast<const BitchatChannelJoinMessage *>(&message))
+            {
+                serializeString(output, join->nickname);
+                serializeString(output, join->channel);
+                serializeBytes(output, join->channelKey);
+                return true;
+            }
+            break;
+        }
+        case BitchatMessageType::ChannelLeave:
+        {
+            if (auto leave = dynamic_cast<const BitchatChannelLeaveMessage *>(&message))
+            {
+                serializeString(output, leave->nickname);
+                serializeString(output, leave->channel);
+                return true;
+            }
+            break;
+        }
+        case BitchatMessageType::PeerInfo:
+        {
+            if (auto peerInfo = dynamic_cast<const BitchatPeerInfoMessage *>(&message))
+            {
+                serializeString(output, peerInfo->nickname);
+                serializeString(output, peerInfo->channel);
+                serializeTimestamp(output, peerInfo->lastSeen);
+                serializeInt32(output, peerInfo->rssi);
+                serializeBytes(output, peerInfo->fingerprint);
+                return true;
+            }
+            break;
+        }
+        case BitchatMessageType::ChannelKeyShare:
+        {
+            if (auto keyShare = dynamic_cast<const BitchatChannelKeyShareMessage *>(&message))
+            {
+                serializeString(output, keyShare->channel);
+                serializeBytes(output, keyShare->encryptedKeyData);
+                serializeString(output, keyShare->creatorFingerprint);
+                return true;
+            }
+            break;
+        }
+        case BitchatMessageType::KeepAlive:
+        {
+            if (auto keepAlive = dynamic_cast<const BitchatKeepAliveMessage *>(&message))
+            {
+                serializeString(output, keepAlive->nickname);
+                serializeString(output, keepAlive->channel);
+                return true;
+            }
+            break;
+        }
+        case BitchatMessageType::Error:
+        {
+            if (auto error = dynamic_cast<const BitchatErrorMessage *>(&message))
+            {
+                serializeUint16(output, static_cast<uint16_t>(error->errorCode));
+                serializeString(output, error->errorMessage);
+                serializeBool(output, error->originalMessageId.has_value());
+                serializeString(output, error->originalMessageId.value_or(""));
+                return true;
+            }
+            break;
+        }
+        }
+    }
+    catch (const std::length_error &e)
+    {
+        spdlog::error("Failed to serialize binary message: {}", e.what());
+        output.resize(start);
+        return false;
+    }
+
+    spdlog::error("Message type {} does not match its structure", static_cast<int>(message.type));
+    output.resize(start);
+
+    return false;
+}
+
+std::shared_ptr<BitchatMessage> BinaryProtocol::readPacket(std::span<const uint8_t> packet)
+{
+    BinaryPacketHeader header = BinaryPacketHeader::deserialize(packet);
+
+    if (!validateHeader(header))
+    {
+        spdlog::error("Invalid binary packet header");
+        return nullptr;
+    }
+
+    if (packet.size() < BinaryProtocolConstants::headerSize + header.payloadLength)
+    {
+        spdlog::error("Binary packet truncated: {} < {}", packet.size(), BinaryProtocolConstants::headerSize + header.payloadLength);
+        return nullptr;
+    }
+
+    std::span<const uint8_t> payload = packet.subspan(BinaryProtocolConstants::headerSize, header.payloadLength);
+
+    if (!validateChecksum(header, payload))
+    {
+        spdlog::warn("Binary packet checksum mismatch");
+        return nullptr;
+    }
+
+    try
+    {
+        return readPayload(header, payload);
+    }
+    catch (const std::out_of_range &e)
+    {
+        spdlog::error("Failed to deserialize binary message: {}", e.what());
+        return nullptr;
+    }
+}
+
+std::shared_ptr<BitchatMessage> BinaryProtocol::readPayload(const BinaryPacketHeader &header, std::span<const uint8_t> payload)
+{
+    size_t offset = 0;
+    std::shared_ptr<BitchatMessage> message;
+
+    // Base fields are decoded after the concrete type is known
+    std::string peerID = deserializeString(payload, offset);
+    auto timestamp = deserializeTimestamp(payload, offset);
+    std::vector<uint8_t> basePayload = deserializeBytes(payload, offset);
+
+    switch (static_cast<BitchatMessageType>(header.messageType))
+    {
+    case BitchatMessageType::Handshake:
+    {
+        auto handshake = std::make_shared<BitchatHandshakeMessage>();
+        handshake->nickname = deserializeString(payload, offset);
+        handshake->channel = deserializeString(payload, offset);
+        handshake->publicKey = deserializeBytes(payload, offset);
+        handshake->handshakeData = deserializeBytes(payload, offset);
+        message = handshake;
+        break;
+    }
+    case BitchatMessageType::HandshakeResponse:
+    {
+        auto response = std::make_shared<BitchatHandshakeResponseMessage>();
+        response->nickname = deserializeString(payload, offset);
+        response->channel = deserializeString(payload, offset);
+        response->publicKey = deserializeBytes(payload, offset);
+        response->handshakeData = deserializeBytes(payload, offset);
+        response->errorCode = static_cast<BitchatErrorCode>(deserializeUint16(payload, offset));
+        message = response;
+        break;
+    }
+    case BitchatMessageType::Message:
+    {
+        auto chat = std::make_shared<BitchatChatMessage>();
+        chat->nickname = deserializeString(payload, offset);
+        chat->channel = deserializeString(payload, offset);
+        chat->isEncrypted = deserializeBool(payload, offset);
+        chat->content = deserializeString(payload, offset);
+        chat->encryptedContent = deserializeBytes(payload, offset);
+        message = chat;
+        break;
+    }
+    case BitchatMessageType::ChannelJoin:
+    {
+        auto join = std::make_shared<BitchatChannelJoinMessage>();
+        join->nickname = deserializeString(payload, offset);
+        join->channel = deserializeString(payload, offset);
+        join->channelKey = deserializeBytes(payload, offset);
+        message = join;
+        break;
+    }
+    case BitchatMessageType::ChannelLeave:
+    {
+        auto leave = std::make_shared<BitchatChannelLeaveMessage>();
+        leave->nickname = deserializeString(payload, offset);
+        leave->channel = deserializeString(payload, offset);
+        message = leave;
+        break;
+    }
+    case BitchatMessageType::PeerInfo:
+    {
+        auto peerInfo = std::make_shared<BitchatPeerInfoMessage>();
+        peerInfo->nickname = deserializeString(payload, offset);
+        peerInfo->channel = deserializeString(payload, offset);
+        peerInfo->lastSeen = deserializeTimestamp(payload, offset);
+        peerInfo->rssi = deserializeInt32(payload, offset);
+        peerInfo->fingerprint = deserializeBytes(payload, offset);
+        message = peerInfo;
+        break;
+    }
+    case BitchatMessageType::ChannelKeyShare:
+    {
+        auto keyShare = std::make_shared<BitchatChannelKeyShareMessage>();
+        keyShare->channel = deserializeString(payload, offset);
+        keyShare->encryptedKeyData = deserializeBytes(payload, offset);
+        keyShare->creatorFingerprint = deserializeString(payload, offset);
+        message = keyShare;
+        break;
+    }
+    case BitchatMessageType::KeepAlive:
+    {
+        auto keepAlive = std::make_shared<BitchatKeepAliveMessage>();
+        keepAlive->nickname = deserializeString(payload, offset);
+        keepAlive->channel = deserializeString(payload, offset);
+        message = keepAlive;
+        break;
+    }
+    case BitchatMessageType::Error:
+    {
+        auto error = std::make_shared<BitchatErrorMessage>();
+        error->errorCode = static_cast<BitchatErrorCode>(deserializeUint16(payload, offset));
+        error->errorMessage = deserializeString(payload, offset);
+        bool hasOriginalMessageId = deserializeBool(payload, offset);
+        std::string originalMessageId = deserializeString(payload, offset);
+
+        if (hasOriginalMessageId)
+        {
+            error->originalMessageId = std::move(originalMessageId);
+        }
+
+        message = error;
+        break;
+    }
+    default:
+        spdlog::error("Unknown binary message type: {}", header.messageType);
+        return nullptr;
+    }
+
+    if (offset != payload.size())
+    {
+        spdlog::error("Binary payload has {} trailing bytes", payload.size() - offset);
+        return nullptr;
+    }
+
+    message->version = header.version;
+    message->type = static_cast<BitchatMessageType>(header.messageType);
+    message->peerID = std::move(peerID);
+    message->timestamp = timestamp;
+    message->payload = std::move(basePayload);
+
+    return message;
+}
+
+void BinaryProtocol::serializeString(std::vector<uint8_t> &output, const std::string &str)
+{
+    checkLength(str.size());
+    serializeUint16(output, static_cast<uint16_t>(str.size()));
+    output.insert(output.end(), str.begin(), str.end());
+}
+
+std::string BinaryProtocol::deserializeString(std::span<const uint8_t> data, size_t &offset)
+{
+    size_t length = deserializeUint16(data, offset);
+    checkReadable(data, offset, length);
+
+    std::string value(reinterpret_cast<const char *>(data.data() + offset), length);
+    offset += length;
+
+    return value;
+}
+
+void BinaryProtocol::serializeTimestamp(std::vector<uint8_t> &output, const std::chrono::system_clock::time_point &timestamp)
+{
+    auto milliseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(timestamp.time_since_epoch()).count());
+
+    for (int i = 7; i >= 0; i--)
+    {
+        output.push_back(static_cast<uint8_t>((milliseconds >> (i * 8)) & 0xFF));
+    }
+}
+
+std::chrono::system_clock::time_point BinaryProtocol::deserializeTimestamp(std::span<const uint8_t> data, size_t &offset)
+{
+    checkReadable(data, offset, 8);
+    uint64_t milliseconds = 0;
+
+    for (int i = 0; i < 8; i++)
+    {
+        milliseconds = (milliseconds << 8) | data[offset++];
+    }
+
+    return std::chrono::system_clock::time_point(std::chrono::milliseconds(static_cast<int64_t>(milliseconds)));
+}
+
+void BinaryProtocol::serializeBytes(std::vector<uint8_t> &output, const std::vector<uint8_t> &bytes)
+{
+    checkLength(bytes.size());
+    serializeUint16(output, static_cast<uint16_t>(bytes.size()));
+    output.insert(output.end(), bytes.begin(), bytes.end());
+}
+
+std::vector<uint8_t> BinaryProtocol::deserializeBytes(std::span<const uint8_t> data, size_t &offset)
+{
+    size_t length = deserializeUint16(data, offset);
+    checkReadable(data, offset, length);
+
+    std::vector<uint8_t> value(data.begin() + offset, data.begin() + offset + length);
+    offset += length;
+
+    return value;
+}
+
+void BinaryProtocol::serializeUint16(std::vector<uint8_t> &output, uint16_t value)
+{
+    output.push_back(static_cast<uint8_t>(value >> 8));
+    output.push_back(static_cast<uint8_t>(value & 0xFF));
+}
+
+uint16_t BinaryProtocol::deserializeUint16(std::span<const uint8_t> data, size_t &offset)
+{
+    checkReadable(data, offset, 2);
+    uint16_t value = static_cast<uint16_t>((data[offset] << 8) | data[offset + 1]);
+    offset += 2;
+
+    return value;
+}
+
+void BinaryProtocol::serializeUint8(std::vector<uint8_t> &output, uint8_t value)
+{
+    output.push_back(value);
+}
+
+uint8_t BinaryProtocol::deserializeUint8(std::span<const uint8_t> data, size_t &offset)
+{
+    checkReadable(data, offset, 1);
+    return data[offset++];
+}
+
+void BinaryProtocol::serializeInt32(std::vector<uint8_t> &output, int32_t value)
+{
+    auto bits = static_cast<uint32_t>(value);
+
+    for (int i = 3; i >= 0; i--)
+    {
+        output.push_back(static_cast<uint8_t>((bits >> (i * 8)) & 0xFF));
+    }
+}
+
+int32_t BinaryProtocol::deserializeInt32(std::span<const uint8_t> data, size_t &offset)
+{
+    checkReadable(data, offset, 4);
+    uint32_t bits = 0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        bits = (bits << 8) | data[offset++];
+    }
+
+    return static_cast<int32_t>(bits);
+}
+
+void BinaryProtocol::serializeBool(std::vector<uint8_t> &output, bool value)
+{
+    serializeUint8(output, value ? 1 : 0);
+}
+
+bool BinaryProtocol::deserializeBool(std::span<const uint8_t> data, size_t &offset)
+{
+    return deserializeUint8(data, offset) != 0;
+}
+
+uint16_t BinaryProtocol::computeChecksum(std::span<const uint8_t> data)
+{
+    return computeFletcher16(data);
+}
+
+uint16_t BinaryProtocol::computeFletcher16(std::span<const uint8_t> data)
+{
+    return fletcher16(data);
+}
+
+// Binary Protocol Parser
+
+BinaryProtocolParser::BinaryProtocolParser()
+{
+    // Pass
+}
+
+std::vector<std::shared_ptr<BitchatMessage>> BinaryProtocolParser::parseData(std::span<const uint8_t> data)
+{
+    std::vector<std::shared_ptr<BitchatMessage>> messages;
+
+    buffer_.insert(buffer_.end(), data.begin(), data.end());
+
+    while (resynchronize() && hasCompleteMessage())
+    {
+        if (auto message = parseNextMessage())
+        {
+            messages.push_back(std::move(message));
+        }
+    }
+
+    compact();
+
+    return messages;
+}
+
+std::vector<uint8_t> BinaryProtocolParser::getRemainingData() const
+{
+    return std::vector<uint8_t>(buffer_.begin() + readOffset_, buffer_.end());
+}
+
+void BinaryProtocolParser::clear()
+{
+    buffer_.clear();
+    readOffset_ = 0;
+}
+
+bool BinaryProtocolParser::hasIncompleteData() const
+{
+    return readOffset_ < buffer_.size();
+}
+
+std::shared_ptr<BitchatMessage> BinaryProtocolParser::parseNextMessage()
+{
+    size_t size = getNextMessageSize();
+    auto message = BinaryProtocol::readPacket(std::span<const uint8_t>(buffer_).subspan(readOffset_, size));
+
+    // A corrupt packet may have been a stray magic byte, resume the scan right after it
+    readOffset_ += message ? size : 1;
+
+    return message;
+}
+
+bool BinaryProtocolParser::hasCompleteMessage() const
+{
+    size_t available = buffer_.size() - readOffset_;
+    return available >= BinaryProtocolConstants::headerSize && available >= getNextMessageSize();
+}
+
+size_t BinaryProtocolParser::getNextMessageSize() const
+{
+    size_t payloadLength = (static_cast<size_t>(buffer_[readOffset_ + 2]) << 8) | buffer_[readOffset_ + 3];
+    return BinaryProtocolConstants::headerSize + payloadLength;
+}
+
+bool BinaryProtocolParser::resynchronize()
+{
+    while (readOffset_ < buffer_.size())
+    {
+        // Skip garbage up to the next magic byte
+        auto it = std::find(buffer_.begin() + readOffset_, buffer_.end(), BinaryProtocolConstants::magicByte);
+
+        if (it != buffer_.begin() + readOffset_)
+        {
+            spdlog::debug("Skipping {} bytes before binary packet header", std::distance(buffer_.begin() + readOffset_, it));
+        }
+
+        readOffset_ = it - buffer_.begin();
+
+        // Wait for the rest of the header
+        if (buffer_.size() - readOffset_ < BinaryProtocolConstants::headerSize)
+        {
+            return false;
+        }
+
+        if (BinaryPacketHeader::deserialize(std::span<const uint8_t>(buffer_).subspan(readOffset_)).isValid())
+        {
+            return true;
+        }
+
+        readOffset_++;
+    }
+
+    return false;
+}
+
+void BinaryProtocolParser::compact()
+{
+    if (readOffset_ == buffer_.size())
+    {
+        buffer_.clear();
+        readOffset_ = 0;
+    }
+    else if (readOffset_ > buffer_.size() / 2)
+    {
+        buffer_.erase(buffer_.begin(), buffer_.begin() + readOffset_);
+        readOffset_ = 0;
+    }
+}
+
+// Binary Protocol Builder
+
+BinaryProtocolBuilder::BinaryProtocolBuilder()
+{
+    // Pass
+}
+
+std::vector<uint8_t> BinaryProtocolBuilder::buildPacket(const BitchatMessage &message)
+{
+    std::vector<uint8_t> output;
+
+    if (!buildPacket(message, output))
+    {
+        return {};
+    }
+
+    return output;
+}
+
+bool BinaryProtocolBuilder::buildPacket(const BitchatMessage &message, std::vector<uint8_t> &output)
+{
+    return BinaryProtocol::writePacket(output, message);
+}
+
+BinaryPacketHeader BinaryProtocolBuilder::buildHeader(BitchatMessageType messageType, size_t payloadSize)
+{
+    BinaryPacketHeader header{};
+    header.magic = BinaryProtocolConstants::magicByte;
+    header.version = BinaryProtocolConstants::currentVersion;
+    header.payloadLength = static_cast<uint16_t>(std::min(payloadSize, BinaryProtocolConstants::maxMessageSize));
+    header.messageType = static_cast<uint16_t>(messageType);
+    header.checksum = 0;
+
+    return header;
+}
+
+std::vector<uint8_t> BinaryProtocolBuilder::buildPayload(const BitchatMessage &message)
+{
+    std::vector<uint8_t> payload;
+
+    if (!BinaryProtocol::writePayload(payload, message))
+    {
+        return {};
+    }
+
+    return payload;
+}
+
+std::vector<uint8_t> BinaryProtocolBuilder::finalizePacket(const BinaryPacketHeader &header, std::span<const uint8_t> payload)
+{
+    if (!BinaryProtocol::validatePayloadSize(payload.size()))
+    {
+        spdlog::error("Binary payload too large: {} > {}", payload.size(), BinaryProtocolConstants::maxMessageSize);
+        return {};
+    }
+
+    BinaryPacketHeader finalHeader = header;
+    finalHeader.payloadLength = static_cast<uint16_t>(payload.size());
+    finalHeader.checksum = BinaryProtocol::computeChecksum(payload);
+
+    std::vector<uint8_t> packet(BinaryProtocolConstants::headerSize + payload.size());
+    finalHeader.serializeInto(packet.data());
+    std::copy(payload.begin(), payload.end(), packet.begin() + BinaryProtocolConstants::headerSize);
+
+    return packet;
+}
+
+} // namespace protocol
+} // namespace bitchat
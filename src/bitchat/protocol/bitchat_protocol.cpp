@@ -0,0 +1,240 @@
+#include "bitchat/protocol/bitchat_protocol.h"
+
+namespace bitchat
+{
+namespace protocol
+{
+
+namespace
+{
+
+int64_t toMilliseconds(const std::chrono::system_clock::time_point &timestamp)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(timestamp.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point fromMilliseconds(int64_t milliseconds)
+{
+    return std::chrono::system_clock::time_point(std::chrono::milliseconds(milliseconds));
+}
+
+} // namespace
+
+// Base Message
+
+nlohmann::json BitchatMessage::toJson() const
+{
+    return {
+        {"version", version},
+        {"type", static_cast<uint8_t>(type)},
+        {"peerID", peerID},
+        {"timestamp", toMilliseconds(timestamp)},
+        {"payload", payload},
+    };
+}
+
+void BitchatMessage::fromJson(const nlohmann::json &json)
+{
+    version = json.value("version", BitchatProtocolConstants::protocolVersion);
+    type = static_cast<BitchatMessageType>(json.value("type", static_cast<uint8_t>(0)));
+    peerID = json.value("peerID", "");
+    timestamp = fromMilliseconds(json.value("timestamp", static_cast<int64_t>(0)));
+    payload = json.value("payload", std::vector<uint8_t>());
+}
+
+// Handshake Message
+
+nlohmann::json BitchatHandshakeMessage::toJson() const
+{
+    nlohmann::json json = BitchatMessage::toJson();
+    json["nickname"] = nickname;
+    json["channel"] = channel;
+    json["publicKey"] = publicKey;
+    json["handshakeData"] = handshakeData;
+    return json;
+}
+
+void BitchatHandshakeMessage::fromJson(const nlohmann::json &json)
+{
+    BitchatMessage::fromJson(json);
+    nickname = json.value("nickname", "");
+    channel = json.value("channel", "");
+    publicKey = json.value("publicKey", std::vector<uint8_t>());
+    handshakeData = json.value("handshakeData", std::vector<uint8_t>());
+}
+
+// Handshake Response Message
+
+nlohmann::json BitchatHandshakeResponseMessage::toJson() const
+{
+    nlohmann::json json = BitchatMessage::toJson();
+    json["nickname"] = nickname;
+    json["channel"] = channel;
+    json["publicKey"] = publicKey;
+    json["handshakeData"] = handshakeData;
+    json["errorCode"] = static_cast<uint16_t>(errorCode);
+    return json;
+}
+
+void BitchatHandshakeResponseMessage::fromJson(const nlohmann::json &json)
+{
+    BitchatMessage::fromJson(json);
+    nickname = json.value("nickname", "");
+    channel = json.value("channel", "");
+    publicKey = json.value("publicKey", std::vector<uint8_t>());
+    handshakeData = json.value("handshakeData", std::vector<uint8_t>());
+    errorCode = static_cast<BitchatErrorCode>(json.value("errorCode", static_cast<uint16_t>(0)));
+}
+
+// Chat Message
+
+nlohmann::json BitchatChatMessage::toJson() const
+{
+    nlohmann::json json = BitchatMessage::toJson();
+    json["nickname"] = nickname;
+    json["channel"] = channel;
+    json["content"] = content;
+    json["encryptedContent"] = encryptedContent;
+    json["isEncrypted"] = isEncrypted;
+    return json;
+}
+
+void BitchatChatMessage::fromJson(const nlohmann::json &json)
+{
+    BitchatMessage::fromJson(json);
+    nickname = json.value("nickname", "");
+    channel = json.value("channel", "");
+    content = json.value("content", "");
+    encryptedContent = json.value("encryptedContent", std::vector<uint8_t>());
+    isEncrypted = json.value("isEncrypted", false);
+}
+
+// Channel Join Message
+
+nlohmann::json BitchatChannelJoinMessage::toJson() const
+{
+    nlohmann::json json = BitchatMessage::toJson();
+    json["nickname"] = nickname;
+    json["channel"] = channel;
+    json["channelKey"] = channelKey;
+    return json;
+}
+
+void BitchatChannelJoinMessage::fromJson(const nlohmann::json &json)
+{
+    BitchatMessage::fromJson(json);
+    nickname = json.value("nickname", "");
+    channel = json.value("channel", "");
+    channelKey = json.value("channelKey", std::vector<uint8_t>());
+}
+
+// Channel Leave Message
+
+nlohmann::json BitchatChannelLeaveMessage::toJson() const
+{
+    nlohmann::json json = BitchatMessage::toJson();
+    json["nickname"] = nickname;
+    json["channel"] = channel;
+    return json;
+}
+
+void BitchatChannelLeaveMessage::fromJson(const nlohmann::json &json)
+{
+    BitchatMessage::fromJson(json);
+    nickname = json.value("nickname", "");
+    channel = json.value("channel", "");
+}
+
+// Peer Info Message
+
+nlohmann::json BitchatPeerInfoMessage::toJson() const
+{
+    nlohmann::json json = BitchatMessage::toJson();
+    json["nickname"] = nickname;
+    json["channel"] = channel;
+    json["lastSeen"] = toMilliseconds(lastSeen);
+    json["rssi"] = rssi;
+    json["fingerprint"] = fingerprint;
+    return json;
+}
+
+void BitchatPeerInfoMessage::fromJson(const nlohmann::json &json)
+{
+    BitchatMessage::fromJson(json);
+    nickname = json.value("nickname", "");
+    channel = json.value("channel", "");
+    lastSeen = fromMilliseconds(json.value("lastSeen", static_cast<int64_t>(0)));
+    rssi = json.value("rssi", 0);
+    fingerprint = json.value("fingerprint", std::vector<uint8_t>());
+}
+
+// Channel Key Share Message
+
+nlohmann::json BitchatChannelKeyShareMessage::toJson() const
+{
+    nlohmann::json json = BitchatMessage::toJson();
+    json["channel"] = channel;
+    json["encryptedKeyData"] = encryptedKeyData;
+    json["creatorFingerprint"] = creatorFingerprint;
+    return json;
+}
+
+void BitchatChannelKeyShareMessage::fromJson(const nlohmann::json &json)
+{
+    BitchatMessage::fromJson(json);
+    channel = json.value("channel", "");
+    encryptedKeyData = json.value("encryptedKeyData", std::vector<uint8_t>());
+    creatorFingerprint = json.value("creatorFingerprint", "");
+}
+
+// Keep Alive Message
+
+nlohmann::json BitchatKeepAliveMessage::toJson() const
+{
+    nlohmann::json json = BitchatMessage::toJson();
+    json["nickname"] = nickname;
+    json["channel"] = channel;
+    return json;
+}
+
+void BitchatKeepAliveMessage::fromJson(const nlohmann::json &json)
+{
+    BitchatMessage::fromJson(json);
+    nickname = json.value("nickname", "");
+    channel = json.value("channel", "");
+}
+
+// Error Message
+
+nlohmann::json BitchatErrorMessage::toJson() const
+{
+    nlohmann::json json = BitchatMessage::toJson();
+    json["errorCode"] = static_cast<uint16_t>(errorCode);
+    json["errorMessage"] = errorMessage;
+
+    if (originalMessageId)
+    {
+        json["originalMessageId"] = *originalMessageId;
+    }
+
+    return json;
+}
+
+void BitchatErrorMessage::fromJson(const nlohmann::json &json)
+{
+    BitchatMessage::fromJson(json);
+    errorCode = static_cast<BitchatErrorCode>(json.value("errorCode", static_cast<uint16_t>(0)));
+    errorMessage = json.value("errorMessage", "");
+
+    if (json.contains("originalMessageId"))
+    {
+        originalMessageId = json["originalMessageId"].get<std::string>();
+    }
+    else
+    {
+        originalMessageId.reset();
+    }
+}
+
+} // namespace protocol
+} // namespace bitchat
@@ -0,0 +1,41 @@
+#include "bitchat/protocol/compression_dictionary.h"
+#include <string_view>
+
+namespace bitchat
+{
+
+const std::string CompressionDictionary::CAPABILITY = "lz4-dict-1";
+
+namespace
+{
+
+// Assembled from representative announce, message, version hello and
+// handshake payloads. LZ4 matches need at least 4 bytes, so short tokens are
+// kept with their usual neighbours.
+constexpr std::string_view DICTIONARY =
+    // Version hello
+    "1.0cppioslinuxmacosandroidlz4-dict-1"
+    "Noise_XX_25519_ChaChaPoly_SHA256"
+    // Channels and commands
+    "#general #random #bitchat #help #mesh #local #test /join /msg /nick /who /clear "
+    // Common chat phrases
+    "hello everyone! hi there, how are you? I'm good, thanks. what's up? "
+    "is anyone here? can you hear me? yes, I can see your message. "
+    "ok thanks! sounds good. see you later. good morning good night "
+    "where are you? I'm nearby. meet at the entrance in 5 minutes. "
+    "the battery is low, signal is weak, connection lost, reconnecting "
+    "please share the password for the channel. joined left the channel "
+    // Hex peer IDs and UUIDs
+    "0123456789abcdef0123456789ABCDEF-4000-8000-9000-a000-b000-"
+    "00000000-0000-4000-8000-000000000000"
+    // Nicknames
+    "anon1anon2anon3anon4anon5anon6anon7anon8anon9anon";
+
+} // namespace
+
+std::span<const uint8_t> CompressionDictionary::get()
+{
+    return std::span<const uint8_t>(reinterpret_cast<const uint8_t *>(DICTIONARY.data()), DICTIONARY.size());
+}
+
+} // namespace bitchat
@@ -0,0 +1,61 @@
+#include "bitchat/protocol/compression_stats.h"
+
+namespace bitchat
+{
+
+CompressionStats &CompressionStats::shared()
+{
+    static CompressionStats instance;
+    return instance;
+}
+
+void CompressionStats::recordAttempt(uint8_t type, size_t bytesIn, size_t bytesOut, bool compressed, std::chrono::nanoseconds elapsed)
+{
+    Counters &entry = counters[type];
+    entry.packets.fetch_add(1, std::memory_order_relaxed);
+    entry.bytesIn.fetch_add(bytesIn, std::memory_order_relaxed);
+    entry.bytesOut.fetch_add(bytesOut, std::memory_order_relaxed);
+    entry.nanoseconds.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+
+    if (compressed)
+    {
+        entry.compressed.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void CompressionStats::recordSkipped(uint8_t type)
+{
+    Counters &entry = counters[type];
+    entry.packets.fetch_add(1, std::memory_order_relaxed);
+    entry.skipped.fetch_add(1, std::memory_order_relaxed);
+}
+
+CompressionTypeStats CompressionStats::getStats(uint8_t type) const
+{
+    const Counters &entry = counters[type];
+
+    CompressionTypeStats stats;
+    stats.packets = entry.packets.load(std::memory_order_relaxed);
+    stats.compressed = entry.compressed.load(std::memory_order_relaxed);
+    stats.skipped = entry.skipped.load(std::memory_order_relaxed);
+    stats.bytesIn = entry.bytesIn.load(std::memory_order_relaxed);
+    stats.bytesOut = entry.bytesOut.load(std::memory_order_relaxed);
+    stats.nanoseconds = entry.nanoseconds.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+void CompressionStats::reset()
+{
+    for (Counters &entry : counters)
+    {
+        entry.packets.store(0, std::memory_order_relaxed);
+        entry.compressed.store(0, std::memory_order_relaxed);
+        entry.skipped.store(0, std::memory_order_relaxed);
+        entry.bytesIn.store(0, std::memory_order_relaxed);
+        entry.bytesOut.store(0, std::memory_order_relaxed);
+        entry.nanoseconds.store(0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace bitchat
@@ -0,0 +1,223 @@
+#include "bitchat/protocol/dedup_filter.h"
+#include "bitchat/core/constants.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace bitchat
+{
+
+namespace
+{
+
+// SplitMix64 finalizer
+uint64_t mix64(uint64_t value)
+{
+    value ^= value >> 30;
+    value *= 0xBF58476D1CE4E5B9ULL;
+    value ^= value >> 27;
+    value *= 0x94D049BB133111EBULL;
+    value ^= value >> 31;
+
+    return value;
+}
+
+} // namespace
+
+DedupFilter::DedupFilter()
+    : DedupFilter(Config{constants::DEDUP_CAPACITY, constants::DEDUP_FALSE_POSITIVE_RATE, constants::DEDUP_WINDOW, constants::DEDUP_GENERATIONS, constants::DEDUP_SHARDS})
+{
+    // Pass
+}
+
+DedupFilter::DedupFilter(const Config &config)
+    : config(config)
+{
+    this->config.generations = std::max<size_t>(config.generations, 2);
+    this->config.shards = std::max<size_t>(config.shards, 1);
+    this->config.falsePositiveRate = std::clamp(config.falsePositiveRate, 1e-12, 0.5);
+
+    size_t generations = this->config.generations;
+    size_t shardCount = this->config.shards;
+
+    // All but the current generation cover one window between them
+    generationSpan = std::chrono::duration_cast<Clock::duration>(this->config.window) / (generations - 1);
+    keysPerGeneration = std::max<size_t>((std::max<size_t>(config.capacity, 1) + (generations - 1) * shardCount - 1) / ((generations - 1) * shardCount), 16);
+
+    // A lookup tests every generation, so each gets its share of the false positive rate
+    double generationRate = this->config.falsePositiveRate / static_cast<double>(generations);
+    double ln2 = std::log(2.0);
+    double bits = -static_cast<double>(keysPerGeneration) * std::log(generationRate) / (ln2 * ln2);
+
+    wordsPerGeneration = (static_cast<size_t>(std::ceil(bits)) + 63) / 64;
+    bitsPerGeneration = wordsPerGeneration * 64;
+    hashCount = std::max<size_t>(static_cast<size_t>(std::lround(static_cast<double>(bitsPerGeneration) / keysPerGeneration * ln2)), 1);
+
+    shards = std::make_unique<Shard[]>(shardCount);
+    Clock::time_point now = Clock::now();
+
+    for (size_t i = 0; i < shardCount; i++)
+    {
+        shards[i].bits.assign(generations * wordsPerGeneration, 0);
+        shards[i].counts.assign(generations, 0);
+        shards[i].currentStart = now;
+    }
+}
+
+bool DedupFilter::insert(uint64_t key)
+{
+    return insert(key, Clock::now());
+}
+
+bool DedupFilter::insert(uint64_t key, Clock::time_point now)
+{
+    uint64_t h1 = mix64(key);
+    uint64_t h2 = mix64(key ^ 0x9E3779B97F4A7C15ULL) | 1;
+
+    Shard &shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    advance(shard, now);
+
+    for (size_t generation = 0; generation < config.generations; generation++)
+    {
+        if (testGeneration(shard, generation, h1, h2))
+        {
+            return false;
+        }
+    }
+
+    if (shard.counts[shard.current] >= keysPerGeneration)
+    {
+        rotate(shard, now);
+    }
+
+    uint64_t *words = shard.bits.data() + shard.current * wordsPerGeneration;
+
+    for (size_t i = 0; i < hashCount; i++)
+    {
+        uint64_t bit = (h1 + i * h2) % bitsPerGeneration;
+        words[bit / 64] |= uint64_t{1} << (bit % 64);
+    }
+
+    shard.counts[shard.current]++;
+
+    return true;
+}
+
+bool DedupFilter::contains(uint64_t key)
+{
+    return contains(key, Clock::now());
+}
+
+bool DedupFilter::contains(uint64_t key, Clock::time_point now)
+{
+    uint64_t h1 = mix64(key);
+    uint64_t h2 = mix64(key ^ 0x9E3779B97F4A7C15ULL) | 1;
+
+    Shard &shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    advance(shard, now);
+
+    for (size_t generation = 0; generation < config.generations; generation++)
+    {
+        if (testGeneration(shard, generation, h1, h2))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void DedupFilter::clear()
+{
+    Clock::time_point now = Clock::now();
+
+    for (size_t i = 0; i < config.shards; i++)
+    {
+        std::lock_guard<std::mutex> lock(shards[i].mutex);
+        std::fill(shards[i].bits.begin(), shards[i].bits.end(), 0);
+        std::fill(shards[i].counts.begin(), shards[i].counts.end(), 0);
+        shards[i].current = 0;
+        shards[i].currentStart = now;
+    }
+}
+
+size_t DedupFilter::getMemoryUsage() const
+{
+    return config.shards * (sizeof(Shard) + config.generations * (wordsPerGeneration * sizeof(uint64_t) + sizeof(size_t)));
+}
+
+uint64_t DedupFilter::makeKey(PeerId sender, uint64_t timestamp, uint8_t type, std::span<const uint8_t> discriminator)
+{
+    uint64_t key = mix64(sender.getValue());
+    key = mix64(key ^ timestamp);
+    key = mix64(key ^ type);
+
+    for (size_t offset = 0; offset < discriminator.size(); offset += 8)
+    {
+        uint64_t word = 0;
+        std::memcpy(&word, discriminator.data() + offset, std::min<size_t>(8, discriminator.size() - offset));
+        key = mix64(key ^ word ^ (static_cast<uint64_t>(offset) << 56));
+    }
+
+    return key;
+}
+
+DedupFilter::Shard &DedupFilter::shardFor(uint64_t key)
+{
+    // High bits pick the shard, the bit positions come from a separate mix of the key
+    return shards[(key >> 40) % config.shards];
+}
+
+void DedupFilter::advance(Shard &shard, Clock::time_point now)
+{
+    // Idle shards may be several spans behind, each span retires one generation
+    for (size_t i = 0; i < config.generations && now - shard.currentStart >= generationSpan; i++)
+    {
+        rotate(shard, shard.currentStart + generationSpan);
+    }
+
+    if (now - shard.currentStart >= generationSpan)
+    {
+        // Everything has expired
+        shard.currentStart = now;
+    }
+}
+
+void DedupFilter::rotate(Shard &shard, Clock::time_point start)
+{
+    // The oldest generation becomes the new current one
+    shard.current = (shard.current + 1) % config.generations;
+    shard.counts[shard.current] = 0;
+    shard.currentStart = start;
+
+    uint64_t *words = shard.bits.data() + shard.current * wordsPerGeneration;
+    std::fill(words, words + wordsPerGeneration, 0);
+}
+
+bool DedupFilter::testGeneration(const Shard &shard, size_t generation, uint64_t h1, uint64_t h2) const
+{
+    if (shard.counts[generation] == 0)
+    {
+        return false;
+    }
+
+    const uint64_t *words = shard.bits.data() + generation * wordsPerGeneration;
+
+    for (size_t i = 0; i < hashCount; i++)
+    {
+        uint64_t bit = (h1 + i * h2) % bitsPerGeneration;
+
+        if (!(words[bit / 64] & (uint64_t{1} << (bit % 64))))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace bitchat
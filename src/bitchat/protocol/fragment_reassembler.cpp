@@ -0,0 +1,168 @@
+#include "bitchat/protocol/fragment_reassembler.h"
+#include "bitchat/protocol/packet_fragmenter.h"
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace bitchat
+{
+
+FragmentReassembler::FragmentReassembler(size_t maxBytesPerSender, size_t maxAssembliesPerSender, size_t maxTotalBytes, Clock::duration timeout)
+    : maxBytesPerSender(maxBytesPerSender)
+    , maxAssembliesPerSender(maxAssembliesPerSender)
+    , maxTotalBytes(maxTotalBytes)
+    , timeout(timeout)
+{
+    // Pass
+}
+
+std::optional<std::vector<uint8_t>> FragmentReassembler::addFragment(std::span<const uint8_t> senderID, std::span<const uint8_t> payload, Clock::time_point now)
+{
+    FragmentHeader header;
+
+    if (!FragmentHeader::parse(payload, header))
+    {
+        spdlog::warn("Dropping malformed fragment ({} bytes)", payload.size());
+        return std::nullopt;
+    }
+
+    uint64_t sender = 0;
+
+    for (uint8_t byte : senderID.first(std::min<size_t>(senderID.size(), 8)))
+    {
+        sender = (sender << 8) | byte;
+    }
+
+    std::span<const uint8_t> data = payload.subspan(FragmentHeader::SIZE);
+    std::lock_guard<std::mutex> lock(mutex);
+
+    cleanupExpiredLocked(now);
+
+    Key key{sender, header.fragmentID};
+    auto it = assemblies.find(key);
+
+    if (it == assemblies.end())
+    {
+        SenderUsage &usage = senderUsage[sender];
+
+        if (usage.assemblies >= maxAssembliesPerSender)
+        {
+            spdlog::warn("Dropping fragment from {:016x}: too many pending assemblies", sender);
+            return std::nullopt;
+        }
+
+        Assembly assembly;
+        assembly.startedAt = now;
+        assembly.originalType = header.originalType;
+        assembly.chunks.resize(header.total);
+        assembly.received.resize(header.total, false);
+
+        it = assemblies.emplace(key, std::move(assembly)).first;
+        usage.assemblies++;
+    }
+
+    Assembly &assembly = it->second;
+
+    // Every fragment of a transfer must agree on the layout
+    if (assembly.chunks.size() != header.total || assembly.originalType != header.originalType)
+    {
+        spdlog::warn("Dropping inconsistent fragment {}/{} from {:016x}", header.index, header.total, sender);
+        return std::nullopt;
+    }
+
+    // Duplicate fragment (e.g. received through another relay path)
+    if (assembly.received[header.index])
+    {
+        return std::nullopt;
+    }
+
+    // Over quota: this transfer can never complete, release what it holds
+    if (senderUsage[sender].bytes + data.size() > maxBytesPerSender || totalBytes + data.size() > maxTotalBytes)
+    {
+        spdlog::warn("Fragment quota exceeded for {:016x}, dropping transfer {:016x}", sender, header.fragmentID);
+        removeAssembly(it);
+        return std::nullopt;
+    }
+
+    assembly.chunks[header.index].assign(data.begin(), data.end());
+    assembly.received[header.index] = true;
+    assembly.receivedCount++;
+    assembly.bytes += data.size();
+    senderUsage[sender].bytes += data.size();
+    totalBytes += data.size();
+
+    if (assembly.receivedCount < assembly.chunks.size())
+    {
+        return std::nullopt;
+    }
+
+    // All fragments arrived, stitch the frame together in order
+    std::vector<uint8_t> frame;
+    frame.reserve(assembly.bytes);
+
+    for (const auto &chunk : assembly.chunks)
+    {
+        frame.insert(frame.end(), chunk.begin(), chunk.end());
+    }
+
+    removeAssembly(it);
+
+    spdlog::debug("Reassembled {} byte frame from {} fragments", frame.size(), header.total);
+
+    return frame;
+}
+
+void FragmentReassembler::cleanupExpired(Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    cleanupExpiredLocked(now);
+}
+
+size_t FragmentReassembler::getPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return assemblies.size();
+}
+
+size_t FragmentReassembler::getBufferedBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return totalBytes;
+}
+
+void FragmentReassembler::removeAssembly(std::map<Key, Assembly>::iterator it)
+{
+    auto usageIt = senderUsage.find(it->first.first);
+
+    if (usageIt != senderUsage.end())
+    {
+        usageIt->second.bytes -= it->second.bytes;
+        usageIt->second.assemblies--;
+
+        if (usageIt->second.assemblies == 0)
+        {
+            senderUsage.erase(usageIt);
+        }
+    }
+
+    totalBytes -= it->second.bytes;
+    assemblies.erase(it);
+}
+
+void FragmentReassembler::cleanupExpiredLocked(Clock::time_point now)
+{
+    for (auto it = assemblies.begin(); it != assemblies.end();)
+    {
+        if (now - it->second.startedAt > timeout)
+        {
+            spdlog::debug("Fragment transfer {:016x} timed out ({}/{} fragments)", it->first.second, it->second.receivedCount, it->second.chunks.size());
+            auto expired = it++;
+            removeAssembly(expired);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+} // namespace bitchat
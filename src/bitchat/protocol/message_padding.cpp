@@ -1,49 +1,120 @@
 #include "bitchat/protocol/message_padding.h"
 #include <algorithm>
+#include <array>
+#include <openssl/rand.h>
 #include <random>
 #include <spdlog/spdlog.h>
 
 namespace bitchat
 {
 
+namespace
+{
+
+// Per-thread pool of CSPRNG bytes, refilled in bulk so a padded packet costs a memcpy
+class RandomPool
+{
+public:
+    void fill(std::span<uint8_t> output)
+    {
+        while (!output.empty())
+        {
+            if (offset == bytes.size())
+            {
+                refill();
+            }
+
+            size_t count = std::min(output.size(), bytes.size() - offset);
+            std::copy_n(bytes.begin() + offset, count, output.begin());
+            offset += count;
+            output = output.subspan(count);
+        }
+    }
+
+private:
+    std::array<uint8_t, 4096> bytes;
+    size_t offset = bytes.size();
+
+    void refill()
+    {
+        if (RAND_bytes(bytes.data(), static_cast<int>(bytes.size())) != 1)
+        {
+            // Padding only needs to be unpredictable to observers, never stall the send path on it
+            spdlog::error("RAND_bytes failed, falling back to std::random_device for padding");
+            std::random_device rd;
+
+            for (auto &byte : bytes)
+            {
+                byte = static_cast<uint8_t>(rd());
+            }
+        }
+
+        offset = 0;
+    }
+};
+
+thread_local RandomPool randomPool;
+
+} // namespace
+
 std::vector<uint8_t> MessagePadding::pad(const std::vector<uint8_t> &data, size_t targetSize)
+{
+    std::vector<uint8_t> padded;
+    padded.reserve(std::max(data.size(), targetSize));
+    padded.assign(data.begin(), data.end());
+    padInPlace(padded, targetSize);
+
+    return padded;
+}
+
+bool MessagePadding::padInPlace(std::vector<uint8_t> &data, size_t targetSize)
 {
     if (data.size() >= targetSize)
     {
-        return data;
+        return false;
     }
 
     size_t paddingNeeded = targetSize - data.size();
 
     // PKCS#7 only supports padding up to 255 bytes
-    // If we need more padding than that, don't pad - return original data
+    // If we need more padding than that, don't pad - leave the data as it is
     if (paddingNeeded > 255)
     {
-        return data;
+        return false;
     }
 
-    std::vector<uint8_t> padded = data;
-
-    // Standard PKCS#7 padding
-    std::vector<uint8_t> randomBytes(paddingNeeded - 1);
+    size_t dataSize = data.size();
+    data.resize(targetSize);
+    fillPadding(std::span<uint8_t>(data).subspan(dataSize));
 
-    // Generate random bytes
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
+    return true;
+}
 
-    for (auto &byte : randomBytes)
+void MessagePadding::fillPadding(std::span<uint8_t> padding)
+{
+    if (padding.empty())
     {
-        byte = static_cast<uint8_t>(dis(gen));
+        return;
     }
 
-    padded.insert(padded.end(), randomBytes.begin(), randomBytes.end());
-    padded.push_back(static_cast<uint8_t>(paddingNeeded));
-
-    return padded;
+    // Standard PKCS#7 padding with random filler bytes
+    randomPool.fill(padding.first(padding.size() - 1));
+    padding.back() = static_cast<uint8_t>(padding.size());
 }
 
 std::vector<uint8_t> MessagePadding::unpad(const std::vector<uint8_t> &data)
+{
+    std::span<const uint8_t> unpadded = unpadView(data);
+
+    if (unpadded.size() == data.size())
+    {
+        return data;
+    }
+
+    return std::vector<uint8_t>(unpadded.begin(), unpadded.end());
+}
+
+std::span<const uint8_t> MessagePadding::unpadView(std::span<const uint8_t> data)
 {
     if (data.empty())
     {
@@ -55,23 +126,26 @@ std::vector<uint8_t> MessagePadding::unpad(const std::vector<uint8_t> &data)
 
     if (paddingLength == 0 || paddingLength > data.size())
     {
-        // Debug logging for 243-byte packets
-        if (data.size() == 243)
-        {
-            spdlog::debug("Invalid padding length {} for 243-byte packet", paddingLength);
-        }
+        spdlog::debug("Invalid padding length {} for {}-byte packet", paddingLength, data.size());
         return data;
     }
 
-    std::vector<uint8_t> result(data.begin(), data.begin() + data.size() - paddingLength);
+    return data.first(data.size() - paddingLength);
+}
+
+bool MessagePadding::unpadInPlace(std::vector<uint8_t> &data)
+{
+    size_t unpaddedSize = unpadView(data).size();
 
-    // Debug logging for 243-byte packets
-    if (data.size() == 243)
+    if (unpaddedSize == data.size())
     {
-        spdlog::debug("Unpadded 243-byte packet to {} bytes", result.size());
+        return false;
     }
 
-    return result;
+    // Shrinking keeps the capacity, so the buffer can be padded again without reallocating
+    data.resize(unpaddedSize);
+
+    return true;
 }
 
 size_t MessagePadding::optimalBlockSize(size_t dataSize)
@@ -93,4 +167,17 @@ size_t MessagePadding::optimalBlockSize(size_t dataSize)
     return dataSize;
 }
 
+size_t MessagePadding::paddedSize(size_t dataSize)
+{
+    size_t targetSize = optimalBlockSize(dataSize);
+
+    // Mirrors pad(): no padding when already at size or more than 255 bytes would be needed
+    if (targetSize <= dataSize || targetSize - dataSize > 255)
+    {
+        return dataSize;
+    }
+
+    return targetSize;
+}
+
 } // namespace bitchat
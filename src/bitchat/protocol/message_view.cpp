@@ -0,0 +1,212 @@
+#include "bitchat/protocol/message_view.h"
+#include "bitchat/helpers/string_helper.h"
+#include <string>
+
+namespace bitchat
+{
+
+BitchatMessageView::BitchatMessageView(std::span<const uint8_t> payload, size_t idOffset, size_t senderOffset, size_t contentOffset)
+    : payload(payload)
+    , idOffset(idOffset)
+    , idLength(payload[idOffset - 1])
+    , senderOffset(senderOffset)
+    , senderLength(payload[senderOffset - 1])
+    , contentOffset(contentOffset)
+    , contentLength(static_cast<size_t>((payload[contentOffset - 2] << 8) | payload[contentOffset - 1]))
+{
+    // Pass
+}
+
+uint64_t BitchatMessageView::getTimestamp() const
+{
+    uint64_t value = 0;
+
+    for (size_t i = 1; i < 9; i++)
+    {
+        value = (value << 8) | payload[i];
+    }
+
+    return value;
+}
+
+std::string_view BitchatMessageView::getOriginalSender() const
+{
+    return lengthPrefixedAt(locateOptionalField(MSG_FLAG_HAS_ORIGINAL_SENDER));
+}
+
+std::string_view BitchatMessageView::getRecipientNickname() const
+{
+    return lengthPrefixedAt(locateOptionalField(MSG_FLAG_HAS_RECIPIENT_NICKNAME));
+}
+
+std::string_view BitchatMessageView::getSenderPeerID() const
+{
+    return lengthPrefixedAt(locateOptionalField(MSG_FLAG_HAS_SENDER_PEER_ID));
+}
+
+size_t BitchatMessageView::getMentionCount() const
+{
+    size_t offset = locateOptionalField(MSG_FLAG_HAS_MENTIONS);
+
+    if (offset >= payload.size())
+    {
+        return 0;
+    }
+
+    return payload[offset];
+}
+
+std::string_view BitchatMessageView::getMention(size_t index) const
+{
+    size_t offset = locateOptionalField(MSG_FLAG_HAS_MENTIONS);
+
+    if (offset >= payload.size() || index >= payload[offset])
+    {
+        return {};
+    }
+
+    // Skip count byte and the mentions before index
+    offset++;
+
+    for (size_t i = 0; i < index && offset < payload.size(); i++)
+    {
+        offset += 1 + payload[offset];
+    }
+
+    return lengthPrefixedAt(offset);
+}
+
+std::string_view BitchatMessageView::getChannel() const
+{
+    return lengthPrefixedAt(locateOptionalField(MSG_FLAG_HAS_CHANNEL));
+}
+
+BitchatMessage BitchatMessageView::toMessage() const
+{
+    BitchatMessage message;
+
+    message.setRelay(isRelay());
+    message.setPrivate(isPrivate());
+    message.setEncrypted(isEncrypted());
+    message.setTimestamp(getTimestamp());
+    message.setId(std::string(getId()));
+    message.setSender(std::string(getSender()));
+
+    if (isEncrypted())
+    {
+        // Store encrypted content as bytes, content stays an empty placeholder
+        auto content = payload.subspan(contentOffset, contentLength);
+        message.setEncryptedContent(std::vector<uint8_t>(content.begin(), content.end()));
+    }
+    else
+    {
+        message.setContent(std::string(getContent()));
+    }
+
+    message.setOriginalSender(std::string(getOriginalSender()));
+    message.setRecipientNickname(std::string(getRecipientNickname()));
+
+    // Sender peer ID is sent as a hex string, convert it back to bytes (left unset when it is not valid hex)
+    std::string_view peerIDHex = getSenderPeerID();
+
+    if (!peerIDHex.empty())
+    {
+        std::vector<uint8_t> senderPeerID(peerIDHex.size() / 2);
+
+        if (StringHelper::fromHex(peerIDHex, senderPeerID))
+        {
+            message.setSenderPeerID(senderPeerID);
+        }
+    }
+
+    size_t mentionCount = getMentionCount();
+
+    if (mentionCount > 0)
+    {
+        std::vector<std::string> mentions;
+        mentions.reserve(mentionCount);
+
+        for (size_t i = 0; i < mentionCount; i++)
+        {
+            mentions.emplace_back(getMention(i));
+        }
+
+        message.setMentions(mentions);
+    }
+
+    message.setChannel(std::string(getChannel()));
+
+    return message;
+}
+
+std::string_view BitchatMessageView::stringAt(size_t offset, size_t length) const
+{
+    return std::string_view(reinterpret_cast<const char *>(payload.data() + offset), length);
+}
+
+std::string_view BitchatMessageView::lengthPrefixedAt(size_t offset) const
+{
+    if (offset >= payload.size())
+    {
+        return {};
+    }
+
+    size_t length = payload[offset];
+
+    if (offset + 1 + length > payload.size())
+    {
+        return {};
+    }
+
+    return stringAt(offset + 1, length);
+}
+
+size_t BitchatMessageView::locateOptionalField(uint8_t flag) const
+{
+    uint8_t flags = getFlags();
+
+    if (!(flags & flag))
+    {
+        return std::string_view::npos;
+    }
+
+    size_t offset = contentOffset + contentLength;
+
+    // Optional fields in wire order, each present only when its flag is set
+    for (uint8_t field : {MSG_FLAG_HAS_ORIGINAL_SENDER, MSG_FLAG_HAS_RECIPIENT_NICKNAME, MSG_FLAG_HAS_SENDER_PEER_ID, MSG_FLAG_HAS_MENTIONS, MSG_FLAG_HAS_CHANNEL})
+    {
+        if (offset >= payload.size())
+        {
+            return std::string_view::npos;
+        }
+
+        if (field == flag)
+        {
+            return offset;
+        }
+
+        if (!(flags & field))
+        {
+            continue;
+        }
+
+        if (field == MSG_FLAG_HAS_MENTIONS)
+        {
+            // Count byte followed by length-prefixed mentions
+            size_t count = payload[offset++];
+
+            for (size_t i = 0; i < count && offset < payload.size(); i++)
+            {
+                offset += 1 + payload[offset];
+            }
+        }
+        else
+        {
+            offset += 1 + payload[offset];
+        }
+    }
+
+    return std::string_view::npos;
+}
+
+} // namespace bitchat
@@ -25,7 +25,20 @@ BitchatPacket::BitchatPacket(uint8_t type, const std::vector<uint8_t> &payload)
     timestamp = DateTimeHelper::getCurrentTimestamp();
 }
 
+BitchatPacket::BitchatPacket(uint8_t type, std::vector<uint8_t> &&payload)
+    : type(type)
+    , payloadLength(static_cast<uint16_t>(payload.size()))
+    , payload(std::move(payload))
+{
+    timestamp = DateTimeHelper::getCurrentTimestamp();
+}
+
 std::string BitchatPacket::getTypeString() const
+{
+    return getTypeString(type);
+}
+
+std::string BitchatPacket::getTypeString(uint8_t type)
 {
     switch (type)
     {
@@ -65,6 +78,10 @@ std::string BitchatPacket::getTypeString() const
         return "CHANNEL_PASSWORD_UPDATE";
     case PKT_TYPE_CHANNEL_METADATA:
         return "CHANNEL_METADATA";
+    case PKT_TYPE_SENDER_KEY:
+        return "SENDER_KEY";
+    case PKT_TYPE_SENDER_KEY_MESSAGE:
+        return "SENDER_KEY_MESSAGE";
     case PKT_TYPE_VERSION_HELLO:
         return "VERSION_HELLO";
     case PKT_TYPE_VERSION_ACK:
@@ -97,8 +114,8 @@ bool BitchatPacket::isValid() const
 
 size_t BitchatPacket::getTotalSize() const
 {
-    size_t size = 13; // Header size (version + type + ttl + timestamp + flags + payloadLength)
-    size += 8;        // SenderId
+    size_t size = PKT_HEADER_SIZE; // Header size (version + type + ttl + timestamp + flags + payloadLength)
+    size += PKT_SENDER_ID_SIZE;    // SenderId
 
     if (hasRecipient())
     {
@@ -150,6 +167,7 @@ std::string BitchatMessage::getDisplayContent() const
 // BitchatPeer implementations
 BitchatPeer::BitchatPeer(const std::string &peerID, const std::string &nickname)
     : peerID(peerID)
+    , id(PeerId::fromHex(peerID).value_or(PeerId()))
     , peripheralID("")
     , nickname(nickname)
     , channel("")
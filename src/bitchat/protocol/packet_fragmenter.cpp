@@ -0,0 +1,133 @@
+#include "bitchat/protocol/packet_fragmenter.h"
+#include "bitchat/core/constants.h"
+#include "bitchat/helpers/datetime_helper.h"
+#include "bitchat/protocol/message_padding.h"
+#include <algorithm>
+#include <random>
+#include <spdlog/spdlog.h>
+
+namespace bitchat
+{
+
+bool FragmentHeader::parse(std::span<const uint8_t> payload, FragmentHeader &header)
+{
+    if (payload.size() < SIZE)
+    {
+        return false;
+    }
+
+    header.fragmentID = 0;
+
+    for (size_t i = 0; i < 8; i++)
+    {
+        header.fragmentID = (header.fragmentID << 8) | payload[i];
+    }
+
+    header.index = static_cast<uint16_t>((payload[8] << 8) | payload[9]);
+    header.total = static_cast<uint16_t>((payload[10] << 8) | payload[11]);
+    header.originalType = payload[12];
+
+    return header.total > 0 && header.total <= constants::FRAGMENT_MAX_FRAGMENTS && header.index < header.total;
+}
+
+std::vector<BitchatPacket> PacketFragmenter::fragment(const BitchatPacket &packet, std::span<const uint8_t> frame, size_t maxFrameSize)
+{
+    std::vector<BitchatPacket> fragments;
+    size_t dataSize = getFragmentDataSize(maxFrameSize, packet.hasRecipient());
+
+    if (dataSize == 0 || frame.empty())
+    {
+        spdlog::error("Cannot fragment packet: frame size {} with MTU {}", frame.size(), maxFrameSize);
+        return fragments;
+    }
+
+    size_t total = (frame.size() + dataSize - 1) / dataSize;
+
+    if (total > constants::FRAGMENT_MAX_FRAGMENTS)
+    {
+        spdlog::error("Cannot fragment packet: {} fragments needed (max {})", total, constants::FRAGMENT_MAX_FRAGMENTS);
+        return fragments;
+    }
+
+    // Random fragment ID so concurrent transfers from the same sender never collide
+    thread_local std::mt19937_64 gen(std::random_device{}());
+    uint64_t fragmentID = gen();
+    uint64_t timestamp = DateTimeHelper::getCurrentTimestamp();
+
+    fragments.reserve(total);
+
+    for (size_t index = 0; index < total; index++)
+    {
+        size_t offset = index * dataSize;
+        size_t chunkSize = std::min(dataSize, frame.size() - offset);
+
+        std::vector<uint8_t> payload(FragmentHeader::SIZE + chunkSize);
+
+        for (size_t i = 0; i < 8; i++)
+        {
+            payload[i] = static_cast<uint8_t>(fragmentID >> ((7 - i) * 8));
+        }
+
+        payload[8] = static_cast<uint8_t>(index >> 8);
+        payload[9] = static_cast<uint8_t>(index & 0xFF);
+        payload[10] = static_cast<uint8_t>(total >> 8);
+        payload[11] = static_cast<uint8_t>(total & 0xFF);
+        payload[12] = packet.getType();
+        std::copy(frame.begin() + offset, frame.begin() + offset + chunkSize, payload.begin() + FragmentHeader::SIZE);
+
+        uint8_t type = PKT_TYPE_FRAGMENT_CONTINUE;
+
+        if (index == 0)
+        {
+            type = PKT_TYPE_FRAGMENT_START;
+        }
+        else if (index == total - 1)
+        {
+            type = PKT_TYPE_FRAGMENT_END;
+        }
+
+        BitchatPacket fragmentPacket(type, std::move(payload));
+        fragmentPacket.setTTL(packet.getTTL());
+        fragmentPacket.setTimestamp(timestamp);
+        fragmentPacket.setSenderID(packet.getSenderID());
+
+        if (packet.hasRecipient())
+        {
+            fragmentPacket.setRecipientID(packet.getRecipientID());
+            fragmentPacket.setHasRecipient(true);
+        }
+
+        fragments.push_back(std::move(fragmentPacket));
+    }
+
+    spdlog::debug("Fragmented {} byte frame into {} fragments", frame.size(), total);
+
+    return fragments;
+}
+
+size_t PacketFragmenter::getFragmentDataSize(size_t maxFrameSize, bool hasRecipient)
+{
+    size_t overhead = PKT_MIN_SIZE + FragmentHeader::SIZE + (hasRecipient ? PKT_RECIPIENT_ID_SIZE : 0);
+
+    // Padding can grow a frame up to the next block size, keep the padded frame within the MTU
+    size_t frameLimit = maxFrameSize;
+
+    while (frameLimit > overhead && MessagePadding::paddedSize(frameLimit) > maxFrameSize)
+    {
+        frameLimit--;
+    }
+
+    if (frameLimit <= overhead)
+    {
+        return 0;
+    }
+
+    return frameLimit - overhead;
+}
+
+bool PacketFragmenter::isFragmentType(uint8_t type)
+{
+    return type == PKT_TYPE_FRAGMENT_START || type == PKT_TYPE_FRAGMENT_CONTINUE || type == PKT_TYPE_FRAGMENT_END;
+}
+
+} // namespace bitchat
@@ -1,195 +1,266 @@
 #include "bitchat/protocol/packet_serializer.h"
+#include "bitchat/core/constants.h"
 #include "bitchat/helpers/compression_helper.h"
 #include "bitchat/helpers/datetime_helper.h"
 #include "bitchat/helpers/string_helper.h"
+#include "bitchat/protocol/compression_dictionary.h"
+#include "bitchat/protocol/compression_stats.h"
 #include "bitchat/protocol/message_padding.h"
+#include "bitchat/protocol/packet_fragmenter.h"
 #include "bitchat/services/crypto_service.h"
 #include <algorithm>
+#include <chrono>
 #include <spdlog/spdlog.h>
 
 namespace bitchat
 {
 
+namespace
+{
+
+void storeUint16(uint8_t *dst, uint16_t value)
+{
+    dst[0] = static_cast<uint8_t>(value >> 8);
+    dst[1] = static_cast<uint8_t>(value & 0xFF);
+}
+
+void storeUint64(uint8_t *dst, uint64_t value)
+{
+    for (int i = 7; i >= 0; --i)
+    {
+        dst[7 - i] = static_cast<uint8_t>((value >> (i * 8)) & 0xFF);
+    }
+}
+
+// Copy an identifier into a fixed-size field, truncating or zero-filling as needed
+void storeID(uint8_t *dst, const std::vector<uint8_t> &id, size_t size)
+{
+    size_t count = std::min(id.size(), size);
+    std::copy(id.begin(), id.begin() + count, dst);
+    std::fill(dst + count, dst + size, 0);
+}
+
+// Encrypted payloads are indistinguishable from random and fragments carry slices of
+// an already serialized frame, LZ4 can never shrink either
+bool isCompressibleType(uint8_t type)
+{
+    switch (type)
+    {
+    case PKT_TYPE_NOISE_HANDSHAKE_INIT:
+    case PKT_TYPE_NOISE_HANDSHAKE_RESP:
+    case PKT_TYPE_NOISE_ENCRYPTED:
+    case PKT_TYPE_SENDER_KEY:
+    case PKT_TYPE_SENDER_KEY_MESSAGE:
+        return false;
+    default:
+        return !PacketFragmenter::isFragmentType(type);
+    }
+}
+
+} // namespace
+
 PacketSerializer::PacketSerializer() = default;
 
 std::vector<uint8_t> PacketSerializer::serializePacket(const BitchatPacket &packet)
 {
-    std::vector<uint8_t> data;
+    OutputBuffer output;
+    serializeInto(packet, output);
+
+    return output.release();
+}
+
+void PacketSerializer::serializeInto(const BitchatPacket &packet, OutputBuffer &output)
+{
+    const std::vector<uint8_t> &payload = packet.getPayload();
+    bool hasRecipient = (packet.getFlags() & FLAG_HAS_RECIPIENT) != 0;
+    bool hasSignature = (packet.getFlags() & FLAG_HAS_SIGNATURE) != 0;
+
+    size_t payloadOffset = PKT_MIN_SIZE + (hasRecipient ? PKT_RECIPIENT_ID_SIZE : 0);
+    size_t signatureSize = hasSignature ? PKT_SIGNATURE_SIZE : 0;
+
+    // Single compression decision per packet: type first, then size and entropy
+    bool useDictionary = packet.usesDictionary();
+    bool tryCompress = isCompressibleType(packet.getType()) && CompressionHelper::shouldCompress(payload, useDictionary);
+
+    if (!tryCompress)
+    {
+        CompressionStats::shared().recordSkipped(packet.getType());
+    }
+
+    // Reserve the worst case so compression can write straight into the frame
+    size_t compressionBound = tryCompress ? static_cast<size_t>(CompressionHelper::calculateCompressionBound(payload.size())) : 0;
+    size_t maxFrameSize = payloadOffset + std::max(payload.size(), compressionBound + 2) + signatureSize;
+    output.reserve(maxFrameSize + 255);
+    uint8_t *data = output.prepare(maxFrameSize);
 
-    // Compress payload if beneficial
-    std::vector<uint8_t> payload = packet.getPayload();
-    uint16_t originalPayloadSize = 0;
+    // Payload (with original size prepended if compressed)
+    size_t payloadDataSize = payload.size();
     bool isCompressed = false;
 
-    if (CompressionHelper::shouldCompress(packet.getPayload()))
+    if (tryCompress)
     {
-        std::vector<uint8_t> compressedPayload = CompressionHelper::compressData(packet.getPayload());
+        auto start = std::chrono::steady_clock::now();
+        size_t compressedSize = useDictionary ? CompressionHelper::compressInto(payload, data + payloadOffset + 2, compressionBound, CompressionDictionary::get()) : CompressionHelper::compressInto(payload, data + payloadOffset + 2, compressionBound);
 
-        if (compressedPayload.size() < packet.getPayload().size())
+        if (compressedSize > 0 && compressedSize + 2 < payload.size())
         {
-            originalPayloadSize = packet.getPayload().size();
-            payload = compressedPayload;
+            // Prepend original size (2 bytes, big-endian)
+            storeUint16(data + payloadOffset, static_cast<uint16_t>(payload.size()));
+            payloadDataSize = compressedSize + 2;
             isCompressed = true;
         }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        CompressionStats::shared().recordAttempt(packet.getType(), payload.size(), compressedSize, isCompressed, elapsed);
     }
 
-    // Header (13 bytes)
-    writeUint8(data, packet.getVersion());
-    writeUint8(data, packet.getType());
-    writeUint8(data, packet.getTTL());
-    writeUint64(data, packet.getTimestamp());
+    if (!isCompressed)
+    {
+        std::copy(payload.begin(), payload.end(), data + payloadOffset);
+    }
+
+    // Final sizes are known now
+    size_t frameSize = payloadOffset + payloadDataSize + signatureSize;
+    size_t paddedSize = MessagePadding::paddedSize(frameSize);
+    data = output.prepare(paddedSize);
+
+    // Header (14 bytes)
+    data[0] = packet.getVersion();
+    data[1] = packet.getType();
+    data[2] = packet.getTTL();
+    storeUint64(data + 3, packet.getTimestamp());
 
-    // Flags (include compression flag if needed)
-    uint8_t flags = packet.getFlags();
+    // Flags (compression flags describe what was actually written)
+    uint8_t flags = packet.getFlags() & ~(FLAG_IS_COMPRESSED | FLAG_USES_DICTIONARY);
 
     if (isCompressed)
     {
-        flags |= FLAG_IS_COMPRESSED;
+        flags |= useDictionary ? (FLAG_IS_COMPRESSED | FLAG_USES_DICTIONARY) : FLAG_IS_COMPRESSED;
     }
 
-    writeUint8(data, flags);
+    data[11] = flags;
 
     // Payload length (2 bytes, big-endian) - includes original size if compressed
-    uint16_t payloadDataSize = static_cast<uint16_t>(payload.size() + (isCompressed ? 2 : 0));
-    writeUint16(data, payloadDataSize);
+    storeUint16(data + 12, static_cast<uint16_t>(payloadDataSize));
 
     // SenderID (8 bytes, pad with zeros if needed)
-    std::vector<uint8_t> senderID = packet.getSenderID();
-    senderID.resize(8, 0);
-    data.insert(data.end(), senderID.begin(), senderID.end());
+    storeID(data + PKT_HEADER_SIZE, packet.getSenderID(), PKT_SENDER_ID_SIZE);
 
     // RecipientID (8 bytes, if present)
-    if (packet.getFlags() & FLAG_HAS_RECIPIENT)
-    {
-        std::vector<uint8_t> recipientID = packet.getRecipientID();
-        recipientID.resize(8, 0);
-        data.insert(data.end(), recipientID.begin(), recipientID.end());
-    }
-
-    // Payload (with original size prepended if compressed)
-    if (isCompressed)
+    if (hasRecipient)
     {
-        // Prepend original size (2 bytes, big-endian)
-        writeUint16(data, originalPayloadSize);
+        storeID(data + PKT_MIN_SIZE, packet.getRecipientID(), PKT_RECIPIENT_ID_SIZE);
     }
 
-    data.insert(data.end(), payload.begin(), payload.end());
-
     // Signature (64 bytes, if present)
-    if (packet.getFlags() & FLAG_HAS_SIGNATURE)
+    if (hasSignature)
     {
-        std::vector<uint8_t> signature = packet.getSignature();
-        signature.resize(64, 0);
-        data.insert(data.end(), signature.begin(), signature.end());
+        storeID(data + payloadOffset + payloadDataSize, packet.getSignature(), PKT_SIGNATURE_SIZE);
     }
 
     // Apply padding to standard block sizes for traffic analysis resistance
-    size_t optimalSize = MessagePadding::optimalBlockSize(data.size());
-    std::vector<uint8_t> paddedData = MessagePadding::pad(data, optimalSize);
-
-    return paddedData;
+    MessagePadding::fillPadding(std::span<uint8_t>(data + frameSize, paddedSize - frameSize));
 }
 
 BitchatPacket PacketSerializer::deserializePacket(const std::vector<uint8_t> &data)
 {
-    BitchatPacket packet;
-    size_t offset = 0;
-
-    // Remove padding first
-    std::vector<uint8_t> unpaddedData = MessagePadding::unpad(data);
+    // Parse in place, the frame length comes from the header so padding is skipped without copying
+    std::optional<PacketView> view = parsePacketView(data);
 
-    // Verify minimum size: headerSize (13) + senderIDSize (8) = 21 bytes
-    if (unpaddedData.size() < 21)
+    if (!view)
     {
-        spdlog::error("Packet too short: {} bytes (minimum 21)", unpaddedData.size());
-        return packet;
+        return BitchatPacket();
     }
 
-    // Header (13 bytes)
-    packet.setVersion(readUint8(unpaddedData, offset));
-    packet.setType(readUint8(unpaddedData, offset));
-    packet.setTTL(readUint8(unpaddedData, offset));
-    packet.setTimestamp(readUint64(unpaddedData, offset));
-
-    // Flags
-    packet.setFlags(readUint8(unpaddedData, offset));
-    bool isCompressed = (packet.getFlags() & FLAG_IS_COMPRESSED) != 0;
-
-    // Payload length (2 bytes, big-endian)
-    packet.setPayloadLength(readUint16(unpaddedData, offset));
-
-    // Calculate expected total size
-    size_t expectedSize = 21; // headerSize + senderIDSize
-    if (packet.getFlags() & FLAG_HAS_RECIPIENT)
-    {
-        expectedSize += 8; // recipientIDSize
-    }
+    return view->toPacket();
+}
 
-    if (packet.getFlags() & FLAG_HAS_SIGNATURE)
+std::optional<PacketView> PacketSerializer::parsePacketView(std::span<const uint8_t> data)
+{
+    // Verify minimum size: headerSize (14) + senderIDSize (8) = 22 bytes
+    if (data.size() < PKT_MIN_SIZE)
     {
-        expectedSize += 64; // signatureSize
+        spdlog::error("Packet too short: {} bytes (minimum {})", data.size(), PKT_MIN_SIZE);
+        return std::nullopt;
     }
 
-    expectedSize += packet.getPayloadLength();
+    size_t expectedSize = getFrameSize(data);
 
-    if (!validatePacketSize(unpaddedData, expectedSize))
+    if (!validatePacketSize(data, expectedSize))
     {
-        spdlog::error("Packet size mismatch. Expected: {}, got: {}", expectedSize, unpaddedData.size());
-        return packet;
+        spdlog::error("Packet size mismatch. Expected: {}, got: {}", expectedSize, data.size());
+        return std::nullopt;
     }
 
-    // SenderID (8 bytes)
-    std::vector<uint8_t> senderID(unpaddedData.begin() + offset, unpaddedData.begin() + offset + 8);
-    packet.setSenderID(senderID);
-    offset += 8;
+    uint8_t flags = data[11];
+    size_t offset = 12;
+    uint16_t payloadLength = readUint16(data, offset);
 
-    // RecipientID (8 bytes, if present)
-    if (packet.getFlags() & FLAG_HAS_RECIPIENT)
+    // Skip senderID and recipientID
+    offset += PKT_SENDER_ID_SIZE;
+
+    if (flags & FLAG_HAS_RECIPIENT)
     {
-        std::vector<uint8_t> recipientID(unpaddedData.begin() + offset, unpaddedData.begin() + offset + 8);
-        packet.setRecipientID(recipientID);
-        offset += 8;
+        offset += PKT_RECIPIENT_ID_SIZE;
     }
 
-    // Payload (with decompression if needed)
-    if (isCompressed)
+    size_t payloadSize = payloadLength;
+    uint16_t originalPayloadSize = payloadLength;
+
+    // Compressed payloads carry the original size in their first 2 bytes
+    if (flags & FLAG_IS_COMPRESSED)
     {
-        // First 2 bytes are original size
-        if (packet.getPayloadLength() < 2)
+        if (payloadLength < 2)
         {
             spdlog::error("Compressed payload too small for size header");
-            return packet;
+            return std::nullopt;
         }
 
-        uint16_t originalSize = readUint16(unpaddedData, offset);
+        originalPayloadSize = readUint16(data, offset);
+        payloadSize -= 2;
+    }
+
+    return PacketView(data.first(expectedSize), offset, payloadSize, originalPayloadSize);
+}
+
+std::shared_ptr<const std::vector<uint8_t>> PacketSerializer::makeRelayFrame(const PacketView &packet, uint8_t ttl)
+{
+    std::span<const uint8_t> frame = packet.getFrame();
+    auto relayFrame = std::make_shared<std::vector<uint8_t>>(MessagePadding::paddedSize(frame.size()));
 
-        // Compressed payload
-        std::vector<uint8_t> compressedPayload(unpaddedData.begin() + offset, unpaddedData.begin() + offset + packet.getPayloadLength() - 2);
-        offset += packet.getPayloadLength() - 2;
+    // Original bytes are forwarded untouched apart from the TTL (offset 2)
+    std::copy(frame.begin(), frame.end(), relayFrame->begin());
+    (*relayFrame)[2] = ttl;
 
-        // Decompress
-        std::vector<uint8_t> payload = CompressionHelper::decompressData(compressedPayload, originalSize);
-        packet.setPayload(payload);
+    MessagePadding::fillPadding(std::span<uint8_t>(*relayFrame).subspan(frame.size()));
+
+    return relayFrame;
+}
+
+size_t PacketSerializer::getFrameSize(std::span<const uint8_t> data)
+{
+    if (data.size() < PKT_HEADER_SIZE)
+    {
+        return 0;
     }
-    else
+
+    uint8_t flags = data[11];
+    uint16_t payloadLength = static_cast<uint16_t>((data[12] << 8) | data[13]);
+
+    // Calculate expected total size
+    size_t expectedSize = PKT_MIN_SIZE + payloadLength;
+
+    if (flags & FLAG_HAS_RECIPIENT)
     {
-        // Normal payload
-        if (offset + packet.getPayloadLength() <= unpaddedData.size())
-        {
-            std::vector<uint8_t> payload(unpaddedData.begin() + offset, unpaddedData.begin() + offset + packet.getPayloadLength());
-            packet.setPayload(payload);
-            offset += packet.getPayloadLength();
-        }
+        expectedSize += PKT_RECIPIENT_ID_SIZE;
     }
 
-    // Signature (64 bytes, if present)
-    if ((packet.getFlags() & FLAG_HAS_SIGNATURE) && offset + 64 <= unpaddedData.size())
+    if (flags & FLAG_HAS_SIGNATURE)
     {
-        std::vector<uint8_t> signature(unpaddedData.begin() + offset, unpaddedData.begin() + offset + 64);
-        packet.setSignature(signature);
+        expectedSize += PKT_SIGNATURE_SIZE;
     }
 
-    return packet;
+    return expectedSize;
 }
 
 std::vector<uint8_t> PacketSerializer::makeMessagePayload(const BitchatMessage &message)
@@ -303,168 +374,60 @@ std::vector<uint8_t> PacketSerializer::makeMessagePayload(const BitchatMessage &
 
 BitchatMessage PacketSerializer::parseMessagePayload(const std::vector<uint8_t> &payload)
 {
-    BitchatMessage message;
-    size_t offset = 0;
+    std::optional<BitchatMessageView> view = parseMessageView(payload);
 
+    if (!view)
+    {
+        return BitchatMessage();
+    }
+
+    return view->toMessage();
+}
+
+std::optional<BitchatMessageView> PacketSerializer::parseMessageView(std::span<const uint8_t> payload)
+{
     // Minimum size: flags(1) + timestamp(8) + id_len(1) + sender_len(1) + content_len(2) = 13 bytes
     if (payload.size() < 13)
     {
         spdlog::error("Payload too small: {} < 13", payload.size());
-        return message;
+        return std::nullopt;
     }
 
-    // Flags (1 byte)
-    uint8_t flags = readUint8(payload, offset);
-    message.setRelay((flags & 0x01) != 0);
-    message.setPrivate((flags & 0x02) != 0);
-    bool hasOriginalSender = (flags & 0x04) != 0;
-    bool hasRecipientNickname = (flags & 0x08) != 0;
-    bool hasSenderPeerID = (flags & 0x10) != 0;
-    bool hasMentions = (flags & 0x20) != 0;
-    bool hasChannel = (flags & 0x40) != 0;
-    message.setEncrypted((flags & 0x80) != 0);
-
-    // Timestamp (8 bytes, milliseconds) - big-endian
-    message.setTimestamp(readUint64(payload, offset));
+    // Flags (1 byte) + timestamp (8 bytes)
+    size_t offset = 9;
 
-    // Message ID length (1 byte)
-    auto idLen = readUint8(payload, offset);
+    // Message ID (1 byte length + variable)
+    size_t idOffset = offset + 1;
+    offset = idOffset + payload[offset];
 
-    // Message ID (variable length)
-    if (offset + idLen > payload.size())
+    if (offset + 1 > payload.size())
     {
         spdlog::error("Buffer overflow reading ID data");
-        return message;
+        return std::nullopt;
     }
 
-    message.setId(std::string(payload.begin() + offset, payload.begin() + offset + idLen));
-    offset += idLen;
+    // Sender (1 byte length + variable)
+    size_t senderOffset = offset + 1;
+    offset = senderOffset + payload[offset];
 
-    // Sender length (1 byte)
-    auto senderLen = readUint8(payload, offset);
-
-    // Sender (variable length)
-    if (offset + senderLen > payload.size())
+    if (offset + 2 > payload.size())
     {
         spdlog::error("Buffer overflow reading sender data");
-        return message;
+        return std::nullopt;
     }
 
-    message.setSender(std::string(payload.begin() + offset, payload.begin() + offset + senderLen));
-    offset += senderLen;
-
-    // Content length (2 bytes, big-endian)
-    uint16_t contentLen = readUint16(payload, offset);
+    // Content (2 bytes length, big-endian + variable)
+    size_t contentOffset = offset + 2;
+    size_t contentLength = (static_cast<size_t>(payload[offset]) << 8) | payload[offset + 1];
 
-    // Content (variable length)
-    if (offset + contentLen > payload.size())
+    if (contentOffset + contentLength > payload.size())
     {
         spdlog::error("Buffer overflow reading content data");
-        return message;
-    }
-
-    if (message.isEncrypted())
-    {
-        // Store encrypted content as bytes
-        std::vector<uint8_t> encryptedContent(payload.begin() + offset, payload.begin() + offset + contentLen);
-        message.setEncryptedContent(encryptedContent);
-
-        // Empty placeholder
-        message.setContent("");
-    }
-    else
-    {
-        // Normal string content
-        message.setContent(std::string(payload.begin() + offset, payload.begin() + offset + contentLen));
-    }
-
-    offset += contentLen;
-
-    // Optional fields based on flags
-    if (hasOriginalSender && offset < payload.size())
-    {
-        auto len = readUint8(payload, offset);
-        if (offset + len <= payload.size())
-        {
-            message.setOriginalSender(std::string(payload.begin() + offset, payload.begin() + offset + len));
-            offset += len;
-        }
-    }
-
-    if (hasRecipientNickname && offset < payload.size())
-    {
-        auto len = readUint8(payload, offset);
-        if (offset + len <= payload.size())
-        {
-            message.setRecipientNickname(std::string(payload.begin() + offset, payload.begin() + offset + len));
-            offset += len;
-        }
+        return std::nullopt;
     }
 
-    if (hasSenderPeerID && offset < payload.size())
-    {
-        auto len = readUint8(payload, offset);
-        if (offset + len <= payload.size())
-        {
-            std::string peerIDHex = std::string(payload.begin() + offset, payload.begin() + offset + len);
-
-            // Convert hex string back to bytes
-            std::vector<uint8_t> senderPeerID;
-
-            for (size_t i = 0; i < len; i += 2)
-            {
-                if (i + 1 < len)
-                {
-                    std::string byteStr = peerIDHex.substr(i, 2);
-
-                    try
-                    {
-                        senderPeerID.push_back(static_cast<uint8_t>(std::stoi(byteStr, nullptr, 16)));
-                    }
-                    catch (const std::exception &e)
-                    {
-                        // Skip invalid hex bytes
-                        continue;
-                    }
-                }
-            }
-
-            message.setSenderPeerID(senderPeerID);
-
-            offset += len;
-        }
-    }
-
-    // Mentions array
-    if (hasMentions && offset < payload.size())
-    {
-        auto mentionCount = readUint8(payload, offset);
-        std::vector<std::string> mentions;
-
-        for (uint8_t i = 0; i < mentionCount && offset < payload.size(); ++i)
-        {
-            auto len = readUint8(payload, offset);
-            if (offset + len <= payload.size())
-            {
-                mentions.push_back(std::string(payload.begin() + offset, payload.begin() + offset + len));
-                offset += len;
-            }
-        }
-
-        message.setMentions(mentions);
-    }
-
-    // Channel
-    if (hasChannel && offset < payload.size())
-    {
-        auto len = readUint8(payload, offset);
-        if (offset + len <= payload.size())
-        {
-            message.setChannel(std::string(payload.begin() + offset, payload.begin() + offset + len));
-        }
-    }
-
-    return message;
+    // Optional fields are located lazily by the view
+    return BitchatMessageView(payload, idOffset, senderOffset, contentOffset);
 }
 
 std::vector<uint8_t> PacketSerializer::makeAnnouncePayload(const std::string &nickname)
@@ -477,6 +440,23 @@ void PacketSerializer::parseAnnouncePayload(const std::vector<uint8_t> &payload,
     nickname = std::string(payload.begin(), payload.end());
 }
 
+std::vector<uint8_t> PacketSerializer::makeIdentityAnnouncePayload(const std::string &peerIdHex, const std::vector<uint8_t> &signingPublicKey)
+{
+    std::vector<uint8_t> data(peerIdHex.begin(), peerIdHex.end());
+    data.insert(data.end(), signingPublicKey.begin(), signingPublicKey.end());
+
+    return data;
+}
+
+void PacketSerializer::parseIdentityAnnouncePayload(const std::vector<uint8_t> &payload, std::string &peerIdHex, std::vector<uint8_t> &signingPublicKey)
+{
+    // Older clients send the peer ID only
+    size_t idLen = std::min(payload.size(), constants::BLE_PEER_ID_LENGTH_CHARS);
+
+    peerIdHex = std::string(payload.begin(), payload.begin() + idLen);
+    signingPublicKey.assign(payload.begin() + idLen, payload.end());
+}
+
 BitchatPacket PacketSerializer::makePacket(uint8_t type, const std::vector<uint8_t> &payload, bool hasRecipient, bool hasSignature, const std::string &senderID)
 {
     BitchatPacket packet;
@@ -533,7 +513,7 @@ void PacketSerializer::writeUint8(std::vector<uint8_t> &data, uint8_t value)
     data.push_back(value);
 }
 
-uint64_t PacketSerializer::readUint64(const std::vector<uint8_t> &data, size_t &offset)
+uint64_t PacketSerializer::readUint64(std::span<const uint8_t> data, size_t &offset)
 {
     uint64_t value = 0;
     for (int i = 0; i < 8; ++i)
@@ -543,19 +523,19 @@ uint64_t PacketSerializer::readUint64(const std::vector<uint8_t> &data, size_t &
     return value;
 }
 
-uint16_t PacketSerializer::readUint16(const std::vector<uint8_t> &data, size_t &offset)
+uint16_t PacketSerializer::readUint16(std::span<const uint8_t> data, size_t &offset)
 {
     uint16_t value = static_cast<uint16_t>((data[offset] << 8) | data[offset + 1]);
     offset += 2;
     return value;
 }
 
-uint8_t PacketSerializer::readUint8(const std::vector<uint8_t> &data, size_t &offset)
+uint8_t PacketSerializer::readUint8(std::span<const uint8_t> data, size_t &offset)
 {
     return data[offset++];
 }
 
-bool PacketSerializer::validatePacketSize(const std::vector<uint8_t> &data, size_t expectedSize)
+bool PacketSerializer::validatePacketSize(std::span<const uint8_t> data, size_t expectedSize)
 {
     return data.size() >= expectedSize;
 }
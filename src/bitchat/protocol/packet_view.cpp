@@ -0,0 +1,103 @@
+#include "bitchat/protocol/packet_view.h"
+#include "bitchat/helpers/compression_helper.h"
+#include "bitchat/protocol/compression_dictionary.h"
+#include <spdlog/spdlog.h>
+
+namespace bitchat
+{
+
+PacketView::PacketView(std::span<const uint8_t> frame, size_t payloadOffset, size_t payloadSize, uint16_t originalPayloadSize)
+    : frame(frame)
+    , payloadOffset(payloadOffset)
+    , payloadSize(payloadSize)
+    , originalPayloadSize(originalPayloadSize)
+{
+    // Pass
+}
+
+uint64_t PacketView::getTimestamp() const
+{
+    uint64_t value = 0;
+
+    for (size_t i = 3; i < 11; i++)
+    {
+        value = (value << 8) | frame[i];
+    }
+
+    return value;
+}
+
+std::span<const uint8_t> PacketView::getRecipientID() const
+{
+    if (!hasRecipient())
+    {
+        return {};
+    }
+
+    return frame.subspan(PKT_MIN_SIZE, PKT_RECIPIENT_ID_SIZE);
+}
+
+std::span<const uint8_t> PacketView::getSignature() const
+{
+    if (!hasSignature())
+    {
+        return {};
+    }
+
+    return frame.subspan(payloadOffset + payloadSize, PKT_SIGNATURE_SIZE);
+}
+
+bool PacketView::isValid() const
+{
+    return getVersion() == PKT_VERSION && getTimestamp() != 0;
+}
+
+BitchatPacket PacketView::toPacket() const
+{
+    BitchatPacket packet;
+
+    // Header
+    packet.setVersion(getVersion());
+    packet.setType(getType());
+    packet.setTTL(getTTL());
+    packet.setTimestamp(getTimestamp());
+    packet.setFlags(getFlags());
+    packet.setUsesDictionary(false);
+
+    // SenderID and RecipientID
+    auto senderID = getSenderID();
+    packet.setSenderID(std::vector<uint8_t>(senderID.begin(), senderID.end()));
+
+    if (hasRecipient())
+    {
+        auto recipientID = getRecipientID();
+        packet.setRecipientID(std::vector<uint8_t>(recipientID.begin(), recipientID.end()));
+    }
+
+    // Payload (with decompression if needed)
+    auto payload = getPayload();
+
+    if (isCompressed() && usesDictionary())
+    {
+        packet.setPayload(CompressionHelper::decompressData(payload, originalPayloadSize, CompressionDictionary::get()));
+    }
+    else if (isCompressed())
+    {
+        packet.setPayload(CompressionHelper::decompressData(payload, originalPayloadSize));
+    }
+    else
+    {
+        packet.setPayload(std::vector<uint8_t>(payload.begin(), payload.end()));
+    }
+
+    // Signature
+    if (hasSignature())
+    {
+        auto signature = getSignature();
+        packet.setSignature(std::vector<uint8_t>(signature.begin(), signature.end()));
+    }
+
+    return packet;
+}
+
+} // namespace bitchat
@@ -0,0 +1,70 @@
+#include "bitchat/protocol/peer_id.h"
+#include "bitchat/helpers/string_helper.h"
+#include <algorithm>
+
+namespace bitchat
+{
+
+PeerId PeerId::fromBytes(std::span<const uint8_t> data)
+{
+    uint64_t value = 0;
+    size_t size = std::min(data.size(), SIZE);
+
+    for (size_t i = 0; i < SIZE; i++)
+    {
+        value = (value << 8) | (i < size ? data[i] : 0);
+    }
+
+    return PeerId(value);
+}
+
+std::optional<PeerId> PeerId::fromHex(std::string_view hex)
+{
+    if (hex.size() != HEX_LENGTH)
+    {
+        return std::nullopt;
+    }
+
+    std::array<uint8_t, SIZE> bytes;
+
+    if (!StringHelper::fromHex(hex, bytes))
+    {
+        return std::nullopt;
+    }
+
+    return fromBytes(bytes);
+}
+
+std::array<uint8_t, PeerId::SIZE> PeerId::toBytes() const
+{
+    std::array<uint8_t, SIZE> bytes;
+
+    for (size_t i = 0; i < SIZE; i++)
+    {
+        bytes[i] = static_cast<uint8_t>(value >> (8 * (SIZE - 1 - i)));
+    }
+
+    return bytes;
+}
+
+std::vector<uint8_t> PeerId::toVector() const
+{
+    std::array<uint8_t, SIZE> bytes = toBytes();
+    return std::vector<uint8_t>(bytes.begin(), bytes.end());
+}
+
+std::string PeerId::toHex() const
+{
+    std::string hex(HEX_LENGTH, '\0');
+    writeHex(hex.data());
+
+    return hex;
+}
+
+void PeerId::writeHex(char *output) const
+{
+    std::array<uint8_t, SIZE> bytes = toBytes();
+    StringHelper::toHex(bytes, std::span<char>(output, HEX_LENGTH));
+}
+
+} // namespace bitchat
@@ -0,0 +1,213 @@
+#include "bitchat/protocol/rate_limiter.h"
+#include "bitchat/core/constants.h"
+#include <algorithm>
+#include <functional>
+
+namespace bitchat
+{
+
+namespace
+{
+
+// Slots a key tries in its shard before falling back to the overflow buckets
+constexpr size_t MAX_PROBES = 8;
+
+// SplitMix64 finalizer
+uint64_t mix64(uint64_t value)
+{
+    value ^= value >> 30;
+    value *= 0xBF58476D1CE4E5B9ULL;
+    value ^= value >> 27;
+    value *= 0x94D049BB133111EBULL;
+    value ^= value >> 31;
+
+    return value;
+}
+
+} // namespace
+
+RateLimiter::RateLimiter()
+    : RateLimiter(Config{
+          {constants::NOISE_MAX_HANDSHAKES_PER_MINUTE, std::chrono::minutes(1)},
+          {constants::NOISE_MAX_MESSAGES_PER_SECOND, std::chrono::seconds(1)},
+          {constants::NOISE_MAX_LINK_HANDSHAKES_PER_MINUTE, std::chrono::minutes(1)},
+          {constants::NOISE_MAX_LINK_MESSAGES_PER_SECOND, std::chrono::seconds(1)},
+          {constants::NOISE_MAX_GLOBAL_HANDSHAKES_PER_MINUTE, std::chrono::minutes(1)},
+          {constants::NOISE_MAX_GLOBAL_MESSAGES_PER_SECOND, std::chrono::seconds(1)},
+          constants::RATE_LIMIT_SHARDS,
+          constants::RATE_LIMIT_SLOTS_PER_SHARD,
+      })
+{
+    // Pass
+}
+
+RateLimiter::RateLimiter(const Config &config)
+    : config(config)
+    , peerRates{makeRate(config.peerHandshakes), makeRate(config.peerMessages)}
+    , linkRates{makeRate(config.linkHandshakes), makeRate(config.linkMessages)}
+    , globalRates{makeRate(config.globalHandshakes), makeRate(config.globalMessages)}
+{
+    this->config.shards = std::max<size_t>(config.shards, 1);
+    this->config.slotsPerShard = std::max<size_t>(config.slotsPerShard, 1);
+
+    peerTable = makeTable();
+    linkTable = makeTable();
+}
+
+bool RateLimiter::allow(const std::string &linkID, PeerId peerID, Kind kind)
+{
+    return allow(linkID, peerID, kind, Clock::now());
+}
+
+bool RateLimiter::allow(const std::string &linkID, PeerId peerID, Kind kind, Clock::time_point now)
+{
+    int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+    size_t index = static_cast<size_t>(kind);
+    uint64_t linkKey = makeLinkKey(linkID);
+
+    if (!take(bucketsFor(linkTable.get(), linkKey, nowNs)[index], linkRates[index], nowNs))
+    {
+        limitedLink.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (!take(bucketsFor(peerTable.get(), makePeerKey(linkKey, peerID), nowNs)[index], peerRates[index], nowNs))
+    {
+        limitedPeer.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (!take(global[index], globalRates[index], nowNs))
+    {
+        limitedGlobal.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    allowed.fetch_add(1, std::memory_order_relaxed);
+
+    return true;
+}
+
+RateLimiter::Stats RateLimiter::getStats() const
+{
+    Stats stats;
+    stats.allowed = allowed.load(std::memory_order_relaxed);
+    stats.limitedPeer = limitedPeer.load(std::memory_order_relaxed);
+    stats.limitedLink = limitedLink.load(std::memory_order_relaxed);
+    stats.limitedGlobal = limitedGlobal.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+RateLimiter::Rate RateLimiter::makeRate(const Limit &limit)
+{
+    int64_t count = static_cast<int64_t>(std::max<size_t>(limit.count, 1));
+    int64_t period = std::chrono::duration_cast<std::chrono::nanoseconds>(limit.period).count();
+    int64_t interval = std::max<int64_t>(period / count, 1);
+
+    return Rate{interval, interval * count};
+}
+
+bool RateLimiter::take(std::atomic<int64_t> &bucket, const Rate &rate, int64_t now)
+{
+    int64_t full = bucket.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        // Taking a token pushes the time the bucket is full again by one interval
+        int64_t next = std::max(full, now) + rate.interval;
+
+        if (next - now > rate.burst)
+        {
+            return false;
+        }
+
+        if (bucket.compare_exchange_weak(full, next, std::memory_order_relaxed))
+        {
+            return true;
+        }
+    }
+}
+
+uint64_t RateLimiter::makeLinkKey(const std::string &linkID)
+{
+    return mix64(std::hash<std::string>{}(linkID));
+}
+
+uint64_t RateLimiter::makePeerKey(uint64_t linkKey, PeerId peerID)
+{
+    // The same peer on another link is another key
+    return mix64(linkKey ^ mix64(peerID.getValue()));
+}
+
+std::unique_ptr<RateLimiter::Shard[]> RateLimiter::makeTable() const
+{
+    auto table = std::make_unique<Shard[]>(config.shards);
+
+    for (size_t i = 0; i < config.shards; i++)
+    {
+        table[i].slots = std::make_unique<Slot[]>(config.slotsPerShard);
+    }
+
+    return table;
+}
+
+RateLimiter::Buckets &RateLimiter::bucketsFor(Shard *table, uint64_t key, int64_t now)
+{
+    uint64_t hash = mix64(key);
+    Shard &shard = table[hash % config.shards];
+
+    // 0 marks a free slot
+    if (key == 0)
+    {
+        return shard.overflow;
+    }
+
+    size_t start = static_cast<size_t>(hash >> 32) % config.slotsPerShard;
+    size_t probes = std::min(MAX_PROBES, config.slotsPerShard);
+
+    // Slots are taken over but never freed, so a key is never past a free slot
+    for (size_t i = 0; i < probes; i++)
+    {
+        Slot &slot = shard.slots[(start + i) % config.slotsPerShard];
+        uint64_t current = slot.key.load(std::memory_order_relaxed);
+
+        if (current == 0 && slot.key.compare_exchange_strong(current, key, std::memory_order_relaxed))
+        {
+            return slot.buckets;
+        }
+
+        // Also covers losing the race to another thread claiming it for the same key
+        if (current == key)
+        {
+            return slot.buckets;
+        }
+    }
+
+    // A slot whose buckets have refilled is as good as new. Two threads taking
+    // over slots for the same new key can briefly give it two, which only
+    // loosens its limit until one of them is taken over again.
+    for (size_t i = 0; i < probes; i++)
+    {
+        Slot &slot = shard.slots[(start + i) % config.slotsPerShard];
+        uint64_t current = slot.key.load(std::memory_order_relaxed);
+
+        if (isIdle(slot.buckets, now) && slot.key.compare_exchange_strong(current, key, std::memory_order_relaxed))
+        {
+            return slot.buckets;
+        }
+    }
+
+    return shard.overflow;
+}
+
+bool RateLimiter::isIdle(const Buckets &buckets, int64_t now) const
+{
+    // clang-format off
+    return std::all_of(buckets.begin(), buckets.end(), [now](const std::atomic<int64_t> &bucket) {
+        return bucket.load(std::memory_order_relaxed) <= now;
+    });
+    // clang-format on
+}
+
+} // namespace bitchat
@@ -0,0 +1,375 @@
+#include "bitchat/protocol/signature_verifier.h"
+#include "bitchat/core/constants.h"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <openssl/evp.h>
+#include <spdlog/spdlog.h>
+
+namespace bitchat
+{
+
+namespace
+{
+
+constexpr size_t PUBLIC_KEY_SIZE = 32;
+constexpr size_t SIGNATURE_SIZE = 64;
+
+using DigestContextPtr = std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)>;
+
+} // namespace
+
+SignatureVerifier::SignatureVerifier()
+    : SignatureVerifier(Config{constants::SIGNATURE_VERIFY_THREADS, constants::SIGNATURE_VERIFY_BATCH_SIZE, constants::SIGNATURE_VERIFY_QUEUE_SIZE, constants::SIGNATURE_CACHE_SIZE, constants::SIGNATURE_MAX_KEYS, constants::SIGNATURE_KEY_IDLE_TIME})
+{
+    // Pass
+}
+
+SignatureVerifier::SignatureVerifier(const Config &config)
+    : config(config)
+{
+    this->config.threads = std::max<size_t>(config.threads, 1);
+    this->config.batchSize = std::max<size_t>(config.batchSize, 1);
+    this->config.maxKeys = std::max<size_t>(config.maxKeys, 1);
+
+    workers.reserve(this->config.threads);
+
+    for (size_t i = 0; i < this->config.threads; i++)
+    {
+        workers.emplace_back(&SignatureVerifier::workerLoop, this);
+    }
+}
+
+SignatureVerifier::~SignatureVerifier()
+{
+    stop();
+}
+
+bool SignatureVerifier::setPublicKey(PeerId peerID, std::span<const uint8_t> publicKey)
+{
+    return setPublicKey(peerID, publicKey, Clock::now());
+}
+
+bool SignatureVerifier::setPublicKey(PeerId peerID, std::span<const uint8_t> publicKey, Clock::time_point now)
+{
+    if (publicKey.size() != PUBLIC_KEY_SIZE)
+    {
+        spdlog::warn("Ignoring signing key of {} bytes from {}", publicKey.size(), peerID);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(keysMutex);
+
+    auto it = keys.find(peerID);
+
+    if (it != keys.end())
+    {
+        uint8_t pinned[PUBLIC_KEY_SIZE];
+        size_t pinnedLen = sizeof(pinned);
+
+        if (EVP_PKEY_get_raw_public_key(static_cast<EVP_PKEY *>(it->second.key.get()), pinned, &pinnedLen) > 0 && pinnedLen == PUBLIC_KEY_SIZE && std::memcmp(pinned, publicKey.data(), PUBLIC_KEY_SIZE) == 0)
+        {
+            it->second.lastUsed = std::max(it->second.lastUsed, now);
+            return true;
+        }
+
+        spdlog::warn("Refusing a different signing key for {}", peerID);
+        return false;
+    }
+
+    if (keys.size() >= config.maxKeys)
+    {
+        // clang-format off
+        auto idlest = std::min_element(keys.begin(), keys.end(), [](const auto &a, const auto &b) {
+            return a.second.lastUsed < b.second.lastUsed;
+        });
+        // clang-format on
+
+        if (now - idlest->second.lastUsed < config.keyIdleTime)
+        {
+            spdlog::warn("Refusing signing key for {}, all {} pinned keys are in use", peerID, keys.size());
+            return false;
+        }
+
+        spdlog::debug("Dropping idle signing key of {}", idlest->first);
+        keys.erase(idlest);
+    }
+
+    EVP_PKEY *pkey = EVP_PKEY_new_raw_public_key(EVP_PKEY_ED25519, nullptr, publicKey.data(), publicKey.size());
+
+    if (!pkey)
+    {
+        spdlog::warn("Invalid signing key from {}", peerID);
+        return false;
+    }
+
+    // clang-format off
+    KeyPtr key(pkey, [](void *key) {
+        EVP_PKEY_free(static_cast<EVP_PKEY *>(key));
+    });
+    // clang-format on
+
+    keys.emplace(peerID, PinnedKey{std::move(key), now});
+
+    spdlog::debug("Learned signing key for {}", peerID);
+
+    return true;
+}
+
+bool SignatureVerifier::hasPublicKey(PeerId peerID) const
+{
+    std::lock_guard<std::mutex> lock(keysMutex);
+    return keys.count(peerID) > 0;
+}
+
+SignatureVerifier::SubmitResult SignatureVerifier::submit(PeerId sender, std::vector<uint8_t> data, std::vector<uint8_t> signature, Callback callback)
+{
+    KeyPtr key = findKey(sender);
+
+    if (!key)
+    {
+        return SubmitResult::UnknownKey;
+    }
+
+    // Hashed before taking the lock
+    std::optional<Digest> digest = makeDigest(sender, data, signature);
+
+    if (!digest)
+    {
+        return SubmitResult::QueueFull;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto it = outcomes.find(*digest);
+
+        if (it != outcomes.end())
+        {
+            stats.cacheHits++;
+
+            switch (it->second)
+            {
+            case Outcome::Pending:
+                return SubmitResult::InFlight;
+            case Outcome::Valid:
+                return SubmitResult::Verified;
+            case Outcome::Invalid:
+                return SubmitResult::Rejected;
+            }
+        }
+
+        if (stopping || queue.size() >= config.queueCapacity)
+        {
+            stats.dropped++;
+            return SubmitResult::QueueFull;
+        }
+
+        outcomes.emplace(*digest, Outcome::Pending);
+        queue.push_back({std::move(key), *digest, std::move(data), std::move(signature), std::move(callback)});
+    }
+
+    condition.notify_one();
+
+    return SubmitResult::Queued;
+}
+
+std::optional<bool> SignatureVerifier::verify(PeerId sender, std::span<const uint8_t> data, std::span<const uint8_t> signature) const
+{
+    KeyPtr key = findKey(sender);
+
+    if (!key)
+    {
+        return std::nullopt;
+    }
+
+    DigestContextPtr context(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+    return context && verifyWith(context.get(), key.get(), data, signature);
+}
+
+void SignatureVerifier::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (stopping)
+        {
+            return;
+        }
+
+        stopping = true;
+    }
+
+    condition.notify_all();
+
+    for (auto &worker : workers)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.dropped += queue.size();
+    queue.clear();
+}
+
+SignatureVerifier::Stats SignatureVerifier::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+size_t SignatureVerifier::DigestHash::operator()(const Digest &digest) const
+{
+    // Already uniformly distributed
+    size_t hash;
+    std::memcpy(&hash, digest.data(), sizeof(hash));
+
+    return hash;
+}
+
+void SignatureVerifier::workerLoop()
+{
+    // One context per worker, reset between signatures instead of reallocated
+    DigestContextPtr context(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+
+    std::vector<Job> batch;
+    std::vector<bool> results;
+    batch.reserve(config.batchSize);
+    results.reserve(config.batchSize);
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            // clang-format off
+            condition.wait(lock, [this] {
+                return stopping || !queue.empty();
+            });
+            // clang-format on
+
+            if (stopping)
+            {
+                return;
+            }
+
+            size_t count = std::min(queue.size(), config.batchSize);
+
+            for (size_t i = 0; i < count; i++)
+            {
+                batch.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+
+            stats.batches++;
+        }
+
+        for (const auto &job : batch)
+        {
+            results.push_back(context && verifyWith(context.get(), job.key.get(), job.data, job.signature));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            for (size_t i = 0; i < batch.size(); i++)
+            {
+                setOutcome(batch[i].digest, results[i] ? Outcome::Valid : Outcome::Invalid);
+                (results[i] ? stats.verified : stats.rejected)++;
+            }
+        }
+
+        // Outside the lock, callbacks may submit again
+        for (size_t i = 0; i < batch.size(); i++)
+        {
+            if (!batch[i].callback)
+            {
+                continue;
+            }
+
+            // A throwing callback must not take the worker down with it
+            try
+            {
+                batch[i].callback(results[i]);
+            }
+            catch (const std::exception &e)
+            {
+                spdlog::error("Signature verification callback failed: {}", e.what());
+            }
+        }
+
+        batch.clear();
+        results.clear();
+    }
+}
+
+SignatureVerifier::KeyPtr SignatureVerifier::findKey(PeerId peerID) const
+{
+    std::lock_guard<std::mutex> lock(keysMutex);
+
+    auto it = keys.find(peerID);
+
+    if (it == keys.end())
+    {
+        return nullptr;
+    }
+
+    it->second.lastUsed = std::max(it->second.lastUsed, Clock::now());
+
+    return it->second.key;
+}
+
+void SignatureVerifier::setOutcome(const Digest &digest, Outcome outcome)
+{
+    outcomes[digest] = outcome;
+    outcomeOrder.push_back(digest);
+
+    // Only settled outcomes are evicted, pending ones are bounded by the queue
+    while (outcomeOrder.size() > config.cacheSize)
+    {
+        outcomes.erase(outcomeOrder.front());
+        outcomeOrder.pop_front();
+    }
+}
+
+std::optional<SignatureVerifier::Digest> SignatureVerifier::makeDigest(PeerId sender, std::span<const uint8_t> data, std::span<const uint8_t> signature)
+{
+    thread_local DigestContextPtr context(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+
+    Digest digest{};
+    std::array<uint8_t, PeerId::SIZE> senderBytes = sender.toBytes();
+    uint8_t signatureLen = static_cast<uint8_t>(std::min<size_t>(signature.size(), 0xFF));
+
+    // Signature length first, so signature and data cannot trade bytes
+    if (!context || EVP_DigestInit_ex(context.get(), EVP_sha256(), nullptr) != 1 || EVP_DigestUpdate(context.get(), senderBytes.data(), senderBytes.size()) != 1 || EVP_DigestUpdate(context.get(), &signatureLen, 1) != 1 || EVP_DigestUpdate(context.get(), signature.data(), signature.size()) != 1 || EVP_DigestUpdate(context.get(), data.data(), data.size()) != 1 || EVP_DigestFinal_ex(context.get(), digest.data(), nullptr) != 1)
+    {
+        spdlog::error("Failed to hash signature for the verification cache");
+        return std::nullopt;
+    }
+
+    return digest;
+}
+
+bool SignatureVerifier::verifyWith(void *context, void *key, std::span<const uint8_t> data, std::span<const uint8_t> signature)
+{
+    if (signature.size() != SIGNATURE_SIZE)
+    {
+        return false;
+    }
+
+    EVP_MD_CTX *ctx = static_cast<EVP_MD_CTX *>(context);
+    EVP_MD_CTX_reset(ctx);
+
+    if (EVP_DigestVerifyInit(ctx, nullptr, nullptr, nullptr, static_cast<EVP_PKEY *>(key)) <= 0)
+    {
+        spdlog::error("Failed to initialize signature verification");
+        return false;
+    }
+
+    return EVP_DigestVerify(ctx, signature.data(), signature.size(), data.data(), data.size()) == 1;
+}
+
+} // namespace bitchat
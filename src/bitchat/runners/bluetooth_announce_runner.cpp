@@ -2,7 +2,6 @@
 #include "bitchat/core/bitchat_data.h"
 #include "bitchat/core/constants.h"
 #include "bitchat/helpers/datetime_helper.h"
-#include "bitchat/helpers/string_helper.h"
 #include "bitchat/protocol/packet_serializer.h"
 #include <chrono>
 #include <spdlog/spdlog.h>
@@ -75,30 +74,30 @@ void BluetoothAnnounceRunner::runnerLoop()
     spdlog::info("BluetoothAnnounceRunner: Runner loop started");
     PacketSerializer serializer;
 
+    // Announce packet is reused between iterations and only rebuilt when our identity changes
+    BitchatPacket announcePacket(PKT_TYPE_ANNOUNCE, {});
+    std::string announcedNickname;
+    PeerId announcedPeerID;
+
     while (!shouldExit)
     {
         try
         {
             // Get data from BitchatData
-            std::string nickname = BitchatData::shared()->getNickname();
-            std::string localPeerID = BitchatData::shared()->getPeerID();
-
-            // Create announce packet with nickname
-            std::vector<uint8_t> payload = serializer.makeAnnouncePayload(nickname);
-
-            BitchatPacket announcePacket(PKT_TYPE_ANNOUNCE, payload);
+            LocalIdentityPtr identity = BitchatData::shared()->getLocalIdentity();
+            const std::string &nickname = identity->nickname;
+            PeerId localPeerID = identity->peerId;
 
-            // Convert hex string to bytes correctly
-            std::vector<uint8_t> senderID;
-
-            for (size_t i = 0; i < localPeerID.length(); i += 2)
+            if (nickname != announcedNickname || localPeerID != announcedPeerID || announcePacket.getSenderID().empty())
             {
-                std::string byteString = localPeerID.substr(i, 2);
-                uint8_t byte = static_cast<uint8_t>(std::stoi(byteString, nullptr, 16));
-                senderID.push_back(byte);
+                // Create announce packet with nickname
+                announcePacket.setPayload(serializer.makeAnnouncePayload(nickname));
+                announcePacket.setSenderID(localPeerID);
+
+                announcedNickname = nickname;
+                announcedPeerID = localPeerID;
             }
 
-            announcePacket.setSenderID(senderID);
             announcePacket.setTimestamp(DateTimeHelper::getCurrentTimestamp());
 
             // Send announce packet
@@ -81,6 +81,15 @@ void CleanupRunner::runnerLoop()
         {
             BitchatData::shared()->cleanupStalePeers();
 
+            // Persist appended messages and drop or merge old segments
+            if (auto store = BitchatData::shared()->getMessageStore())
+            {
+                store->flush();
+                store->compact();
+            }
+
+            BitchatData::shared()->cleanupSearchIndex();
+
             std::this_thread::sleep_for(std::chrono::seconds(CLEANUP_INTERVAL));
         }
         catch (const std::exception &e)
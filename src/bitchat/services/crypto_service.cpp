@@ -1,4 +1,5 @@
 #include "bitchat/services/crypto_service.h"
+#include <chrono>
 #include <fstream>
 #include <openssl/err.h>
 #include <openssl/evp.h>
@@ -10,8 +11,23 @@
 namespace bitchat
 {
 
-CryptoService::CryptoService()
-    : signingPrivateKey(nullptr)
+namespace
+{
+
+using DigestContextPtr = std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)>;
+
+// Signing context of the calling thread, initialized once for a key
+struct ThreadSigningContext
+{
+    std::shared_ptr<void> key; // keeps the key the context was prepared for alive
+    DigestContextPtr prepared{nullptr, EVP_MD_CTX_free};
+    DigestContextPtr work{nullptr, EVP_MD_CTX_free};
+};
+
+} // namespace
+
+CryptoService::CryptoService(std::string keyFile)
+    : keyFile(std::move(keyFile))
 {
     // Pass
 }
@@ -24,7 +40,7 @@ CryptoService::~CryptoService()
 bool CryptoService::initialize()
 {
     // Generate or load key pair
-    if (!generateOrLoadKeyPair("bitchat-pk.pem"))
+    if (!generateOrLoadKeyPair(keyFile))
     {
         spdlog::error("Failed to generate or load key pair");
         return false;
@@ -37,11 +53,8 @@ void CryptoService::cleanup()
 {
     std::lock_guard<std::mutex> lock(cryptoMutex);
 
-    if (signingPrivateKey)
-    {
-        EVP_PKEY_free(static_cast<EVP_PKEY *>(signingPrivateKey));
-        signingPrivateKey = nullptr;
-    }
+    // Threads still holding the key in their signing context free it on their next signature
+    setSigningKey(nullptr);
 }
 
 bool CryptoService::generateOrLoadKeyPair(const std::string &keyFile)
@@ -49,9 +62,9 @@ bool CryptoService::generateOrLoadKeyPair(const std::string &keyFile)
     std::lock_guard<std::mutex> lock(cryptoMutex);
 
     // Try to load existing key
-    signingPrivateKey = loadPrivateKey(keyFile);
-    if (signingPrivateKey)
+    if (void *loaded = loadPrivateKey(keyFile))
     {
+        setSigningKey(loaded);
         return true;
     }
 
@@ -78,11 +91,11 @@ bool CryptoService::generateOrLoadKeyPair(const std::string &keyFile)
         return false;
     }
 
-    signingPrivateKey = pkey;
+    setSigningKey(pkey);
     EVP_PKEY_CTX_free(ctx);
 
     // Save the key
-    savePrivateKey(signingPrivateKey, keyFile);
+    savePrivateKey(pkey, keyFile);
 
     return true;
 }
@@ -138,53 +151,76 @@ std::vector<uint8_t> CryptoService::sha256(const std::string &data)
 
 std::vector<uint8_t> CryptoService::signData(const std::vector<uint8_t> &data)
 {
-    std::lock_guard<std::mutex> lock(cryptoMutex);
+    auto start = std::chrono::steady_clock::now();
 
-    if (!signingPrivateKey)
+    // No lock, the key is loaded from its published pointer
+    std::shared_ptr<void> key = getSigningKey();
+
+    if (!key)
     {
         spdlog::error("No signing key available");
+        signatureFailures.fetch_add(1, std::memory_order_relaxed);
         return {};
     }
 
-    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
-    if (!ctx)
-    {
-        spdlog::error("Failed to create digest context");
-        return {};
-    }
+    thread_local ThreadSigningContext context;
 
-    if (EVP_DigestSignInit(ctx, nullptr, nullptr, nullptr, static_cast<EVP_PKEY *>(signingPrivateKey)) <= 0)
+    if (context.key != key)
     {
-        spdlog::error("Failed to initialize signing");
-        EVP_MD_CTX_free(ctx);
-        return {};
+        DigestContextPtr prepared(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+
+        if (!prepared || EVP_DigestSignInit(prepared.get(), nullptr, nullptr, nullptr, static_cast<EVP_PKEY *>(key.get())) <= 0)
+        {
+            spdlog::error("Failed to initialize signing");
+            signatureFailures.fetch_add(1, std::memory_order_relaxed);
+            return {};
+        }
+
+        if (!context.work)
+        {
+            context.work.reset(EVP_MD_CTX_new());
+        }
+
+        context.prepared = std::move(prepared);
+        context.key = key;
+        signingContextsPrepared.fetch_add(1, std::memory_order_relaxed);
     }
 
-    size_t signatureLen = 0;
-    if (EVP_DigestSign(ctx, nullptr, &signatureLen, data.data(), data.size()) <= 0)
+    // A one-shot signature finalizes its context, so each one signs with a copy of the prepared context
+    if (!context.work || EVP_MD_CTX_copy_ex(context.work.get(), context.prepared.get()) != 1)
     {
-        spdlog::error("Failed to get signature length");
-        EVP_MD_CTX_free(ctx);
+        spdlog::error("Failed to create digest context");
+        signatureFailures.fetch_add(1, std::memory_order_relaxed);
         return {};
     }
 
+    size_t signatureLen = static_cast<size_t>(EVP_PKEY_get_size(static_cast<EVP_PKEY *>(key.get())));
     std::vector<uint8_t> signature(signatureLen);
-    if (EVP_DigestSign(ctx, signature.data(), &signatureLen, data.data(), data.size()) <= 0)
+
+    if (EVP_DigestSign(context.work.get(), signature.data(), &signatureLen, data.data(), data.size()) <= 0)
     {
         spdlog::error("Failed to create signature");
-        EVP_MD_CTX_free(ctx);
+        signatureFailures.fetch_add(1, std::memory_order_relaxed);
         return {};
     }
 
-    EVP_MD_CTX_free(ctx);
+    signature.resize(signatureLen);
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    signatureCount.fetch_add(1, std::memory_order_relaxed);
+    signingNanoseconds.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+
     return signature;
 }
 
-std::vector<uint8_t> CryptoService::getCurve25519PrivateKey() const
+std::vector<uint8_t> CryptoService::getSigningPublicKey() const
 {
-    std::lock_guard<std::mutex> lock(cryptoMutex);
+    return getPublicKeyBytes(getSigningKey().get());
+}
 
-    if (!signingPrivateKey)
+std::vector<uint8_t> CryptoService::getCurve25519PrivateKey() const
+{
+    if (!getSigningKey())
     {
         return {};
     }
@@ -200,6 +236,17 @@ std::vector<uint8_t> CryptoService::getCurve25519PrivateKey() const
     return curve25519PrivateKey;
 }
 
+SigningStats CryptoService::getSigningStats() const
+{
+    SigningStats stats;
+    stats.signatures = signatureCount.load(std::memory_order_relaxed);
+    stats.failures = signatureFailures.load(std::memory_order_relaxed);
+    stats.contextsPrepared = signingContextsPrepared.load(std::memory_order_relaxed);
+    stats.nanoseconds = signingNanoseconds.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
 void *CryptoService::loadPrivateKey(const std::string &filename)
 {
     FILE *fp = fopen(filename.c_str(), "r");
@@ -268,4 +315,25 @@ std::vector<uint8_t> CryptoService::getPublicKeyBytes(void *pkey) const
     return publicKey;
 }
 
+std::shared_ptr<void> CryptoService::getSigningKey() const
+{
+    return std::atomic_load_explicit(&signingPrivateKey, std::memory_order_acquire);
+}
+
+void CryptoService::setSigningKey(void *pkey)
+{
+    std::shared_ptr<void> key;
+
+    if (pkey)
+    {
+        // clang-format off
+        key = std::shared_ptr<void>(pkey, [](void *ptr) {
+            EVP_PKEY_free(static_cast<EVP_PKEY *>(ptr));
+        });
+        // clang-format on
+    }
+
+    std::atomic_store_explicit(&signingPrivateKey, std::move(key), std::memory_order_release);
+}
+
 } // namespace bitchat
@@ -18,7 +18,7 @@ IdentityService &IdentityService::getInstance()
 
 // Identity Resolution
 
-IdentityHint IdentityService::resolveIdentity(const std::string &peerID [[maybe_unused]], const std::string &claimedNickname)
+IdentityHint IdentityService::resolveIdentity(PeerId peerID [[maybe_unused]], const std::string &claimedNickname)
 {
     std::lock_guard<std::mutex> lock(mutex);
 
@@ -202,7 +202,7 @@ void IdentityService::setBlocked(const std::string &fingerprint, bool isBlocked)
 
 // Ephemeral Session Management
 
-void IdentityService::registerEphemeralSession(const std::string &peerID, HandshakeState handshakeState)
+void IdentityService::registerEphemeralSession(PeerId peerID, HandshakeState handshakeState)
 {
     std::lock_guard<std::mutex> lock(mutex);
 
@@ -214,7 +214,7 @@ void IdentityService::registerEphemeralSession(const std::string &peerID, Handsh
     ephemeralSessions[peerID] = identity;
 }
 
-void IdentityService::updateHandshakeState(const std::string &peerID, HandshakeState state, const std::string &fingerprint, const std::string &failureReason)
+void IdentityService::updateHandshakeState(PeerId peerID, HandshakeState state, const std::string &fingerprint, const std::string &failureReason)
 {
     std::lock_guard<std::mutex> lock(mutex);
 
@@ -236,7 +236,7 @@ void IdentityService::updateHandshakeState(const std::string &peerID, HandshakeS
     }
 }
 
-HandshakeState IdentityService::getHandshakeState(const std::string &peerID)
+HandshakeState IdentityService::getHandshakeState(PeerId peerID)
 {
     std::lock_guard<std::mutex> lock(mutex);
 
@@ -246,13 +246,13 @@ HandshakeState IdentityService::getHandshakeState(const std::string &peerID)
 
 // Pending Actions
 
-void IdentityService::setPendingAction(const std::string &peerID, const PendingActions &action)
+void IdentityService::setPendingAction(PeerId peerID, const PendingActions &action)
 {
     std::lock_guard<std::mutex> lock(mutex);
     pendingActions[peerID] = action;
 }
 
-void IdentityService::applyPendingActions(const std::string &peerID, const std::string &fingerprint)
+void IdentityService::applyPendingActions(PeerId peerID, const std::string &fingerprint)
 {
     std::lock_guard<std::mutex> lock(mutex);
 
@@ -354,7 +354,7 @@ void IdentityService::clearAllIdentityData()
     // TODO: Delete from persistent storage
 }
 
-void IdentityService::removeEphemeralSession(const std::string &peerID)
+void IdentityService::removeEphemeralSession(PeerId peerID)
 {
     std::lock_guard<std::mutex> lock(mutex);
     ephemeralSessions.erase(peerID);
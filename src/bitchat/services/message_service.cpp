@@ -1,10 +1,11 @@
 #include "bitchat/services/message_service.h"
 #include "bitchat/core/bitchat_data.h"
 #include "bitchat/core/constants.h"
-#include "bitchat/helpers/compression_helper.h"
 #include "bitchat/helpers/datetime_helper.h"
 #include "bitchat/helpers/protocol_helper.h"
 #include "bitchat/helpers/string_helper.h"
+#include "bitchat/protocol/compression_dictionary.h"
+#include "bitchat/protocol/packet_fragmenter.h"
 #include "bitchat/protocol/packet_serializer.h"
 #include "bitchat/services/crypto_service.h"
 #include "bitchat/services/network_service.h"
@@ -27,9 +28,11 @@ bool MessageService::initialize(std::shared_ptr<NetworkService> networkService,
     this->cryptoService = cryptoService;
     this->noiseService = noiseService;
 
+    signatureVerifier = std::make_unique<SignatureVerifier>();
+
     // clang-format off
-    networkService->setPacketReceivedCallback([this](const BitchatPacket &packet, const std::string &peripheralID) {
-        processPacket(packet, peripheralID);
+    networkService->setPacketReceivedCallback([this](const PacketView &packet, const std::string &peripheralID) {
+        return processPacket(packet, peripheralID);
     });
     // clang-format on
 
@@ -52,8 +55,9 @@ bool MessageService::initialize(std::shared_ptr<NetworkService> networkService,
 
 bool MessageService::sendMessage(const std::string &content, const std::string &channel)
 {
-    std::string targetChannel = channel.empty() ? BitchatData::shared()->getCurrentChannel() : channel;
-    std::string senderNickname = BitchatData::shared()->getNickname();
+    LocalIdentityPtr identity = BitchatData::shared()->getLocalIdentity();
+    const std::string &targetChannel = channel.empty() ? identity->currentChannel : channel;
+    const std::string &senderNickname = identity->nickname;
 
     // Create message
     BitchatMessage message(senderNickname, content, targetChannel);
@@ -66,14 +70,7 @@ bool MessageService::sendMessage(const std::string &content, const std::string &
     if (success)
     {
         // Add to our own history
-        std::string channel = message.getChannel();
-
-        if (channel.empty() && message.isPrivate())
-        {
-            channel = "private";
-        }
-
-        BitchatData::shared()->addMessageToHistory(message, channel);
+        BitchatData::shared()->addMessageToHistory(message, message.getChannel());
 
         spdlog::debug("Message sent: {}", content);
     }
@@ -101,6 +98,8 @@ bool MessageService::sendPrivateMessage(const std::string &content, const std::s
 
     if (success)
     {
+        BitchatData::shared()->addPrivateMessage(getConversationKey(recipientNickname), message, false);
+
         spdlog::debug("Private message sent to: {}", recipientNickname);
     }
     else
@@ -178,6 +177,32 @@ void MessageService::leaveChannel()
     spdlog::info("Left channel: {}", currentChannel);
 }
 
+std::string MessageService::getConversationKey(const std::string &nickname)
+{
+    PeerTable::Snapshot peers = BitchatData::shared()->getPeersSnapshot();
+
+    for (const auto &peer : peers.getPeers())
+    {
+        if (peer->getNickname() == nickname)
+        {
+            return peer->getId().toHex();
+        }
+    }
+
+    // Not announced yet, keyed by nickname until it is
+    return "@" + nickname;
+}
+
+std::vector<BitchatMessage> MessageService::searchMessages(const std::string &text, const std::string &channel)
+{
+    SearchQuery query = SearchQuery::parse(text, DateTimeHelper::getCurrentTimestamp());
+    std::vector<BitchatMessage> results = BitchatData::shared()->searchMessages(channel, query);
+
+    spdlog::debug("Search '{}' found {} messages", text, results.size());
+
+    return results;
+}
+
 void MessageService::startIdentityAnnounce()
 {
     if (!noiseService || !cryptoService)
@@ -186,12 +211,12 @@ void MessageService::startIdentityAnnounce()
         return;
     }
 
-    // Create identity announcement payload
-    std::vector<uint8_t> payload;
-    std::string peerID = BitchatData::shared()->getPeerID();
-    payload.insert(payload.end(), peerID.begin(), peerID.end());
+    // Create identity announcement payload, carrying the key our messages are signed with
+    PacketSerializer serializer;
+    LocalIdentityPtr identity = BitchatData::shared()->getLocalIdentity();
+    std::vector<uint8_t> payload = serializer.makeIdentityAnnouncePayload(identity->peerIdHex, cryptoService->getSigningPublicKey());
     BitchatPacket packet(PKT_TYPE_NOISE_IDENTITY_ANNOUNCE, payload);
-    packet.setSenderID(StringHelper::stringToVector(BitchatData::shared()->getPeerID()));
+    packet.setSenderID(identity->peerId);
     packet.setTimestamp(DateTimeHelper::getCurrentTimestamp());
 
     networkService->sendPacket(packet);
@@ -225,48 +250,128 @@ void MessageService::peerConnected(const std::string &peripheralID)
 void MessageService::peerDisconnected(const std::string &peripheralID)
 {
     // Remove peer from data store
-    auto peers = BitchatData::shared()->getPeers();
+    std::vector<PeerPtr> peers = BitchatData::shared()->getPeersSnapshot().findByPeripheral(peripheralID);
+
+    if (!peers.empty())
+    {
+        const PeerPtr &peer = peers.front();
+        BitchatData::shared()->removePeer(peer->getId());
+
+        peerLeft(peer->getPeerID(), peer->getNickname());
+    }
+
+    if (peerDisconnectedCallback)
+    {
+        peerDisconnectedCallback(peripheralID);
+    }
+}
+
+bool MessageService::processPacket(const BitchatPacket &packet, const std::string &peripheralID)
+{
+    // Validate packet
+    if (!packet.isValid())
+    {
+        spdlog::warn("Received invalid packet from {}", packet.getSenderPeerId());
+        return false;
+    }
 
-    for (const auto &peer : peers)
+    if (mustVerifySignature(packet.getType(), packet.hasSignature(), packet.getSenderPeerId()))
     {
-        if (peer.getPeripheralID() == peripheralID)
+        if (BitchatData::shared()->wasPacketProcessed(makeProcessedKey(packet.getSenderPeerId(), packet.getTimestamp(), packet.getType(), packet.getPayload())))
         {
-            std::string peerID = peer.getPeerID();
-            std::string nickname = peer.getNickname();
-            BitchatData::shared()->removePeer(peerID);
+            return false;
+        }
 
-            peerLeft(peerID, nickname);
+        // Stripping the signature must not get a message past its pinned key
+        if (!packet.hasSignature())
+        {
+            spdlog::warn("Dropping unsigned message from {}, whose signing key is known", packet.getSenderPeerId());
+            return false;
+        }
 
-            break;
+        // Over the limit the signature is not checked and the packet is dropped, not relayed.
+        // It is still marked, so its copies are not charged again.
+        if (!isWithinRateLimit(packet.getType(), packet.getSenderPeerId(), peripheralID))
+        {
+            markPacketProcessed(packet);
+            return false;
         }
+
+        return verifyAndRoute(packet, peripheralID);
     }
 
-    if (peerDisconnectedCallback)
+    // Mark packet as processed, skipping it if it was already seen, so duplicates cost no tokens
+    if (!markPacketProcessed(packet))
     {
-        peerDisconnectedCallback(peripheralID);
+        return false;
+    }
+
+    // Flooding peers are cut off before any decoding or crypto, and their packets are not relayed
+    if (!isWithinRateLimit(packet.getType(), packet.getSenderPeerId(), peripheralID))
+    {
+        return false;
     }
+
+    routePacket(packet, peripheralID);
+
+    return true;
 }
 
-void MessageService::processPacket(const BitchatPacket &packet, const std::string &peripheralID)
+bool MessageService::processPacket(const PacketView &packet, const std::string &peripheralID)
 {
     // Validate packet
     if (!packet.isValid())
     {
-        spdlog::warn("Received invalid packet from {}", StringHelper::toHex(packet.getSenderID()));
-        return;
+        spdlog::warn("Received invalid packet from {}", packet.getSenderPeerId());
+        return false;
     }
 
-    // Check if we should process this packet
-    if (!shouldProcessPacket(packet))
+    if (mustVerifySignature(packet.getType(), packet.hasSignature(), packet.getSenderPeerId()))
     {
-        return;
+        // Duplicates are still dropped before the packet is materialized
+        if (BitchatData::shared()->wasPacketProcessed(makeProcessedKey(packet.getSenderPeerId(), packet.getTimestamp(), packet.getType(), packet.getPayload())))
+        {
+            return false;
+        }
+
+        // Stripping the signature must not get a message past its pinned key
+        if (!packet.hasSignature())
+        {
+            spdlog::warn("Dropping unsigned message from {}, whose signing key is known", packet.getSenderPeerId());
+            return false;
+        }
+
+        // Over the limit the signature is not checked and the packet is dropped, not relayed.
+        // It is still marked, so its copies are not charged again.
+        if (!isWithinRateLimit(packet.getType(), packet.getSenderPeerId(), peripheralID))
+        {
+            markPacketProcessed(packet);
+            return false;
+        }
+
+        return verifyAndRoute(packet.toPacket(), peripheralID);
     }
 
-    // Mark packet as processed
-    markPacketProcessed(packet);
+    // Mark packet as processed, skipping it if it was already seen, so duplicates cost no tokens
+    if (!markPacketProcessed(packet))
+    {
+        return false;
+    }
 
-    // Route to appropriate processor based on packet type
+    // Flooding peers are cut off before any decoding or crypto, and their packets are not relayed
+    if (!isWithinRateLimit(packet.getType(), packet.getSenderPeerId(), peripheralID))
+    {
+        return false;
+    }
+
+    routePacket(packet.toPacket(), peripheralID);
 
+    return true;
+}
+
+void MessageService::routePacket(const BitchatPacket &packet, const std::string &peripheralID)
+{
+    // Route to appropriate processor based on packet type
     switch (packet.getType())
     {
     case PKT_TYPE_VERSION_HELLO:
@@ -287,6 +392,11 @@ void MessageService::processPacket(const BitchatPacket &packet, const std::strin
     case PKT_TYPE_LEAVE:
         processLeavePacket(packet);
         break;
+    case PKT_TYPE_FRAGMENT_START:
+    case PKT_TYPE_FRAGMENT_CONTINUE:
+    case PKT_TYPE_FRAGMENT_END:
+        processFragmentPacket(packet, peripheralID);
+        break;
     case PKT_TYPE_NOISE_HANDSHAKE_INIT:
         processNoiseHandshakeInitPacket(packet);
         break;
@@ -299,15 +409,115 @@ void MessageService::processPacket(const BitchatPacket &packet, const std::strin
     case PKT_TYPE_NOISE_IDENTITY_ANNOUNCE:
         processNoiseIdentityAnnouncePacket(packet);
         break;
+    case PKT_TYPE_SENDER_KEY:
+        processSenderKeyPacket(packet);
+        break;
+    case PKT_TYPE_SENDER_KEY_MESSAGE:
+        processSenderKeyMessagePacket(packet);
+        break;
     default:
         spdlog::debug("Unhandled packet type: {}", packet.getTypeString());
         break;
     }
 }
 
+std::optional<RateLimiter::Kind> MessageService::getRateLimitKind(uint8_t type)
+{
+    switch (type)
+    {
+    case PKT_TYPE_NOISE_HANDSHAKE_INIT:
+    case PKT_TYPE_NOISE_HANDSHAKE_RESP:
+        return RateLimiter::Kind::Handshake;
+    case PKT_TYPE_MESSAGE:
+    case PKT_TYPE_NOISE_ENCRYPTED:
+    case PKT_TYPE_SENDER_KEY:
+    case PKT_TYPE_SENDER_KEY_MESSAGE:
+        return RateLimiter::Kind::Message;
+    default:
+        return std::nullopt;
+    }
+}
+
+bool MessageService::isWithinRateLimit(uint8_t type, PeerId senderID, const std::string &peripheralID)
+{
+    std::optional<RateLimiter::Kind> kind = getRateLimitKind(type);
+
+    if (!kind || rateLimiter.allow(peripheralID, senderID, *kind))
+    {
+        return true;
+    }
+
+    spdlog::debug("Rate limited {} packet from {} on {}", *kind == RateLimiter::Kind::Handshake ? "handshake" : "message", senderID, peripheralID);
+
+    return false;
+}
+
+bool MessageService::mustVerifySignature(uint8_t type, bool hasSignature, PeerId senderID) const
+{
+    // Any holder of a sender key could encrypt under it, the signature is what ties the message to its sender
+    if (type != PKT_TYPE_MESSAGE && type != PKT_TYPE_SENDER_KEY_MESSAGE)
+    {
+        return false;
+    }
+
+    // The flag is not trusted, a sender with a pinned key always signs
+    return hasSignature || (signatureVerifier && signatureVerifier->hasPublicKey(senderID));
+}
+
+bool MessageService::verifyAndRoute(const BitchatPacket &packet, const std::string &peripheralID)
+{
+    PeerId senderID = packet.getSenderPeerId();
+    SignatureVerifier::SubmitResult result = SignatureVerifier::SubmitResult::UnknownKey;
+
+    if (signatureVerifier)
+    {
+        // clang-format off
+        result = signatureVerifier->submit(senderID, packet.getPayload(), packet.getSignature(), [this, packet, peripheralID](bool valid) {
+            if (!valid)
+            {
+                spdlog::warn("Dropping message with an invalid signature from {}", packet.getSenderPeerId());
+                return;
+            }
+
+            if (markPacketProcessed(packet))
+            {
+                routePacket(packet, peripheralID);
+            }
+        });
+        // clang-format on
+    }
+
+    switch (result)
+    {
+    case SignatureVerifier::SubmitResult::Queued:
+        // Relayed right away, routed once the worker has verified it
+        return true;
+    case SignatureVerifier::SubmitResult::InFlight:
+    case SignatureVerifier::SubmitResult::Rejected:
+        spdlog::debug("Skipping copy of a signature already being checked or rejected from {}", senderID);
+        return false;
+    case SignatureVerifier::SubmitResult::QueueFull:
+        spdlog::warn("Signature verification queue full, dropping message from {}", senderID);
+        return false;
+    case SignatureVerifier::SubmitResult::Verified:
+    case SignatureVerifier::SubmitResult::UnknownKey:
+        // Verified before, or from a sender that has not announced a signing key yet
+        break;
+    }
+
+    if (!markPacketProcessed(packet))
+    {
+        return false;
+    }
+
+    routePacket(packet, peripheralID);
+
+    return true;
+}
+
 void MessageService::processVersionHelloPacket(const BitchatPacket &packet)
 {
-    std::string peerID = StringHelper::toHex(packet.getSenderID());
+    PeerId peerID = packet.getSenderPeerId();
     std::vector<uint8_t> data = packet.getPayload();
 
     spdlog::debug("Processing version hello packet from peer: {}", peerID);
@@ -323,7 +533,7 @@ void MessageService::processVersionHelloPacket(const BitchatPacket &packet)
 
 void MessageService::processVersionAckPacket(const BitchatPacket &packet)
 {
-    std::string peerID = StringHelper::toHex(packet.getSenderID());
+    PeerId peerID = packet.getSenderPeerId();
     std::vector<uint8_t> data = packet.getPayload();
 
     spdlog::debug("Processing version ack packet from peer: {}", peerID);
@@ -339,14 +549,10 @@ void MessageService::processVersionAckPacket(const BitchatPacket &packet)
 
 void MessageService::processMessagePacket(const BitchatPacket &packet)
 {
-    PacketSerializer serializer;
-    BitchatMessage message = serializer.parseMessagePayload(packet.getPayload());
-
-    spdlog::debug("Processing message packet - ID: {}, Sender: {}, Content: {}, Channel: {}, Private: {}", message.getId(), message.getSender(), message.getContent(), message.getChannel(), message.isPrivate());
-
     // Ignore messages from ourselves to prevent duplication
-    std::string senderID = StringHelper::toHex(packet.getSenderID());
-    std::string localPeerID = BitchatData::shared()->getPeerID();
+    LocalIdentityPtr identity = BitchatData::shared()->getLocalIdentity();
+    PeerId senderID = packet.getSenderPeerId();
+    PeerId localPeerID = identity->peerId;
     spdlog::debug("Message sender ID: {}, Local peer ID: {}", senderID, localPeerID);
 
     if (senderID == localPeerID)
@@ -355,54 +561,61 @@ void MessageService::processMessagePacket(const BitchatPacket &packet)
         return;
     }
 
-    // Add to history if it's for our current channel, default chat (empty channel), or a private message
-    bool shouldAddToHistory = false;
-
-    std::string currentChannel = BitchatData::shared()->getCurrentChannel();
+    PacketSerializer serializer;
+    std::optional<BitchatMessageView> view = serializer.parseMessageView(packet.getPayload());
 
-    if (message.getChannel() == currentChannel)
+    if (!view)
     {
-        spdlog::debug("Message is for current channel: '{}'", currentChannel);
-        shouldAddToHistory = true;
+        spdlog::warn("Dropping malformed message payload from: {}", senderID);
+        return;
     }
-    else if (message.getChannel().empty() && currentChannel.empty())
+
+    // Route on the view first, so messages for other channels are dropped before anything is copied
+    const std::string &currentChannel = identity->currentChannel;
+    std::string_view channel = view->getChannel();
+
+    if (channel == currentChannel)
     {
-        // Default chat - both sender and receiver have empty channel
-        spdlog::debug("Message is for default chat (empty channel)");
-        shouldAddToHistory = true;
+        // Also covers the default chat (both sides have an empty channel)
+        spdlog::debug("Message is for current channel: '{}'", currentChannel);
     }
-    else if (message.isPrivate() && message.getRecipientNickname() == BitchatData::shared()->getNickname())
+    else if (view->isPrivate() && view->getRecipientNickname() == identity->nickname)
     {
-        std::string nickname = BitchatData::shared()->getNickname();
-        spdlog::debug("Message is private for us: {}", nickname);
-        shouldAddToHistory = true;
+        spdlog::debug("Message is private for us: {}", view->getRecipientNickname());
     }
     else
     {
-        std::string nickname = BitchatData::shared()->getNickname();
-        std::string currentChannel = BitchatData::shared()->getCurrentChannel();
-        spdlog::debug("Message not for us - Channel: {} (current: {}), Private: {}, Recipient: {} (our nick: {})", message.getChannel(), currentChannel, message.isPrivate(), message.getRecipientNickname(), nickname);
+        spdlog::debug("Message not for us - Channel: {} (current: {}), Private: {}, Recipient: {}", channel, currentChannel, view->isPrivate(), view->getRecipientNickname());
+        return;
     }
 
-    if (shouldAddToHistory)
-    {
-        std::string channel = message.getChannel();
+    // Accepted, materialize the message
+    BitchatMessage message = view->toMessage();
 
-        if (channel.empty() && message.isPrivate())
-        {
-            channel = "private";
-        }
-
-        BitchatData::shared()->addMessageToHistory(message, channel);
+    spdlog::debug("Processing message packet - ID: {}, Sender: {}, Content: {}, Channel: {}, Private: {}", message.getId(), message.getSender(), message.getContent(), message.getChannel(), message.isPrivate());
 
-        if (messageReceivedCallback)
+    if (message.isPrivate())
+    {
+        // Private messages for someone else can share our channel, they are not ours to keep
+        if (message.getRecipientNickname() != identity->nickname)
         {
-            messageReceivedCallback(message);
+            spdlog::debug("Ignoring private message for: {}", message.getRecipientNickname());
+            return;
         }
 
-        spdlog::debug("Added message to history");
+        BitchatData::shared()->addPrivateMessage(senderID.toHex(), message, true);
+    }
+    else
+    {
+        BitchatData::shared()->addMessageToHistory(message, message.getChannel());
+    }
+
+    if (messageReceivedCallback)
+    {
+        messageReceivedCallback(message);
     }
 
+    spdlog::debug("Added message to history");
     spdlog::debug("Processed message from: {}", message.getSender());
 }
 
@@ -413,7 +626,7 @@ void MessageService::processChannelAnnouncePacket(const BitchatPacket &packet)
     bool joining;
     serializer.parseChannelAnnouncePayload(packet.getPayload(), channel, joining);
 
-    std::string peerID = StringHelper::toHex(packet.getSenderID());
+    PeerId peerID = packet.getSenderPeerId();
     auto peerInfo = BitchatData::shared()->getPeerInfo(peerID);
 
     if (peerInfo)
@@ -431,7 +644,7 @@ void MessageService::processAnnouncePacket(const BitchatPacket &packet, const st
     PacketSerializer serializer;
     std::string nickname;
     serializer.parseAnnouncePayload(packet.getPayload(), nickname);
-    std::string peerID = StringHelper::toHex(packet.getSenderID());
+    PeerId peerID = packet.getSenderPeerId();
 
     // Check if peer is already in the list
     auto existingPeer = BitchatData::shared()->getPeerInfo(peerID);
@@ -454,7 +667,7 @@ void MessageService::processAnnouncePacket(const BitchatPacket &packet, const st
     else
     {
         // Add new peer
-        BitchatPeer peer(peerID, nickname);
+        BitchatPeer peer(peerID.toHex(), nickname);
         peer.updateLastSeen();
         peer.setPeripheralID(peripheralID);
         peer.setHasAnnounced(true);
@@ -462,7 +675,7 @@ void MessageService::processAnnouncePacket(const BitchatPacket &packet, const st
 
         if (peerJoinedCallback)
         {
-            peerJoinedCallback(peerID, nickname);
+            peerJoinedCallback(peerID.toHex(), nickname);
         }
 
         spdlog::debug("Added new peer: {} ({})", peerID, nickname);
@@ -471,7 +684,7 @@ void MessageService::processAnnouncePacket(const BitchatPacket &packet, const st
 
 void MessageService::processLeavePacket(const BitchatPacket &packet)
 {
-    std::string peerID = StringHelper::toHex(packet.getSenderID());
+    PeerId peerID = packet.getSenderPeerId();
     auto peerInfo = BitchatData::shared()->getPeerInfo(peerID);
 
     if (peerInfo)
@@ -479,15 +692,42 @@ void MessageService::processLeavePacket(const BitchatPacket &packet)
         std::string nickname = peerInfo->getNickname();
         BitchatData::shared()->removePeer(peerID);
 
+        if (noiseService)
+        {
+            noiseService->removeSenderKey(peerID);
+        }
+
         if (peerLeftCallback)
         {
-            peerLeftCallback(peerID, nickname);
+            peerLeftCallback(peerID.toHex(), nickname);
         }
 
         spdlog::debug("Processed leave packet from {} ({})", nickname, peerID);
     }
 }
 
+void MessageService::processFragmentPacket(const BitchatPacket &packet, const std::string &peripheralID)
+{
+    std::optional<std::vector<uint8_t>> frame = fragmentReassembler.addFragment(packet.getSenderID(), packet.getPayload());
+
+    if (!frame)
+    {
+        return;
+    }
+
+    PacketSerializer serializer;
+    std::optional<PacketView> reassembled = serializer.parsePacketView(*frame);
+
+    if (!reassembled || PacketFragmenter::isFragmentType(reassembled->getType()))
+    {
+        spdlog::warn("Discarding invalid reassembled packet from {}", packet.getSenderPeerId());
+        return;
+    }
+
+    // Process the original packet as if it had arrived in one piece
+    processPacket(*reassembled, peripheralID);
+}
+
 void MessageService::processNoiseHandshakeInitPacket(const BitchatPacket &packet)
 {
     if (!noiseService)
@@ -496,44 +736,36 @@ void MessageService::processNoiseHandshakeInitPacket(const BitchatPacket &packet
         return;
     }
 
-    std::string peerID = StringHelper::toHex(packet.getSenderID());
+    // One identity snapshot for the whole packet
+    LocalIdentityPtr identity = BitchatData::shared()->getLocalIdentity();
+    PeerId peerID = packet.getSenderPeerId();
 
     // Ignore packets from ourselves to prevent echo loops
-    if (peerID == BitchatData::shared()->getPeerID())
+    if (peerID == identity->peerId)
     {
         spdlog::debug("Ignoring Noise packet from ourselves: {}", peerID);
         return;
     }
 
-    spdlog::info("=== RECEIVED NOISE_HANDSHAKE_INIT ===");
-    spdlog::info("From peerID: '{}' (size: {})", peerID, peerID.size());
-    spdlog::info("Payload size: {} bytes", packet.getPayload().size());
-    spdlog::info("Local peerID: '{}' (size: {})", BitchatData::shared()->getPeerID(), BitchatData::shared()->getPeerID().size());
-
-    // Check if session is already established
-    if (noiseService->hasEstablishedSession(peerID))
+    // Handshakes are meant for one peer, the others only relay them
+    if (!isAddressedTo(packet, identity->peerId))
     {
-        spdlog::debug("Ignoring handshake init from {} - session already established", peerID);
         return;
     }
 
-    auto response = noiseService->handleIncomingHandshake(peerID, packet.getPayload(), BitchatData::shared()->getPeerID());
-    if (response.has_value() && !response->empty())
-    {
-        spdlog::info("=== SENDING NOISE_HANDSHAKE_RESP ===");
-        spdlog::info("To peerID: '{}'", peerID);
-        spdlog::info("Response size: {} bytes", response->size());
+    spdlog::debug("Received Noise handshake init from {} ({} bytes)", peerID, packet.getPayload().size());
 
-        // Send handshake response
-        BitchatPacket responsePacket(PKT_TYPE_NOISE_HANDSHAKE_RESP, *response);
-        responsePacket.setSenderID(StringHelper::stringToVector(BitchatData::shared()->getPeerID()));
-        responsePacket.setTimestamp(DateTimeHelper::getCurrentTimestamp());
-        networkService->sendPacket(responsePacket);
-        spdlog::info("Sent Noise handshake response to {}", peerID);
+    // An init always starts over. An established session keeps working until the
+    // new handshake completes, the init alone proves nothing about its sender.
+    auto step = noiseService->handleHandshakeInit(peerID, packet.getPayload());
+    if (step.response.has_value() && !step.response->empty())
+    {
+        sendHandshakePacket(PKT_TYPE_NOISE_HANDSHAKE_RESP, *step.response, peerID, identity->peerId);
+        spdlog::debug("Sent Noise handshake response to {} ({} bytes)", peerID, step.response->size());
     }
     else
     {
-        spdlog::info("No handshake response needed for {}", peerID);
+        spdlog::debug("No handshake response needed for {}", peerID);
     }
 }
 
@@ -545,108 +777,52 @@ void MessageService::processNoiseHandshakeRespPacket(const BitchatPacket &packet
         return;
     }
 
-    std::string peerID = StringHelper::toHex(packet.getSenderID());
+    // One identity snapshot for the whole packet
+    LocalIdentityPtr identity = BitchatData::shared()->getLocalIdentity();
+    PeerId peerID = packet.getSenderPeerId();
 
     // Ignore packets from ourselves to prevent echo loops
-    if (peerID == BitchatData::shared()->getPeerID())
+    if (peerID == identity->peerId)
     {
         spdlog::debug("Ignoring Noise packet from ourselves: {}", peerID);
         return;
     }
 
-    spdlog::info("=== RECEIVED NOISE_HANDSHAKE_RESP ===");
-    spdlog::info("From peerID: '{}' (size: {})", peerID, peerID.size());
-    spdlog::info("Payload size: {} bytes", packet.getPayload().size());
-    spdlog::info("Local peerID: '{}' (size: {})", BitchatData::shared()->getPeerID(), BitchatData::shared()->getPeerID().size());
-
-    // Determine if we are initiator or responder based on peerID comparison
-    std::string localPeerID = BitchatData::shared()->getPeerID();
-    bool isInitiator = localPeerID < peerID;
-    spdlog::info("Our role: {} (localPeerID: '{}' vs remotePeerID: '{}')", isInitiator ? "INITIATOR" : "RESPONDER", localPeerID, peerID);
-
-    // Check if session is already established
-    if (noiseService->hasEstablishedSession(peerID))
+    // Handshakes are meant for one peer, the others only relay them
+    if (!isAddressedTo(packet, identity->peerId))
     {
-        spdlog::debug("Ignoring handshake response from {} - session already established", peerID);
         return;
     }
 
-    spdlog::info("=== CALLING handleIncomingHandshake ===");
-    spdlog::info("PeerID: '{}'", peerID);
-    spdlog::info("Payload size: {} bytes", packet.getPayload().size());
-
-    // Log payload hex for debugging
-    std::string payloadHex;
-    for (size_t i = 0; i < std::min(size_t(32), packet.getPayload().size()); ++i)
+    // Check if session is already established and no new handshake is running
+    if (noiseService->hasEstablishedSession(peerID) && !noiseService->hasPendingHandshake(peerID))
     {
-        char hex[3];
-        snprintf(hex, sizeof(hex), "%02x", packet.getPayload()[i]);
-        payloadHex += hex;
+        spdlog::debug("Ignoring handshake response from {} - session already established", peerID);
+        return;
     }
-    spdlog::info("Payload (first 32 bytes): {}", payloadHex);
 
-    auto response = noiseService->handleIncomingHandshake(peerID, packet.getPayload(), BitchatData::shared()->getPeerID());
-    spdlog::info("handleIncomingHandshake returned response: has_value={}, empty={}, size={}",
-                 response.has_value(), response.has_value() ? response->empty() : true,
-                 response.has_value() ? response->size() : 0);
+    std::span<const uint8_t> payload = packet.getPayload();
+    spdlog::debug("Received Noise handshake response from {} ({} bytes): {}", peerID, payload.size(), StringHelper::toHex(payload.first(std::min<size_t>(payload.size(), 32))));
+
+    auto step = noiseService->handleIncomingHandshake(peerID, packet.getPayload(), identity->peerId);
 
-    // Log the expected flow
-    if (response.has_value() && !response->empty())
+    // The initiator answers the responder's message with the final XX message
+    if (step.response.has_value() && !step.response->empty())
     {
-        if (response->size() == 96)
-        {
-            spdlog::info("CRITICAL: Received 96-byte response - this should be from responder to initiator");
-            spdlog::info("This should trigger sending 48-byte final message");
-        }
-        else if (response->size() == 48)
-        {
-            spdlog::info("CRITICAL: Received 48-byte response - this should be from initiator to responder");
-            spdlog::info("This should complete the handshake");
-        }
+        sendHandshakePacket(PKT_TYPE_NOISE_HANDSHAKE_RESP, *step.response, peerID, identity->peerId);
+        spdlog::debug("Sent Noise handshake message to {} ({} bytes)", peerID, step.response->size());
     }
 
-    if (response.has_value() && !response->empty())
+    if (step.established)
     {
-        if (response->size() == 96)
-        {
-            // responder to initiator (first response in XX handshake)
-            // (should occur on responder side, rarely here)
-            spdlog::info("=== SENDING 96-BYTE RESPONSE ===");
-            spdlog::info("To peerID: '{}'", peerID);
-            spdlog::info("This should only happen on responder side");
-            BitchatPacket responsePacket(PKT_TYPE_NOISE_HANDSHAKE_RESP, *response);
-            responsePacket.setSenderID(StringHelper::stringToVector(BitchatData::shared()->getPeerID()));
-            responsePacket.setTimestamp(DateTimeHelper::getCurrentTimestamp());
-            networkService->sendPacket(responsePacket);
-            spdlog::info("Sent 96-byte handshake response to {}", peerID);
-        }
-        else if (response->size() == 48)
-        {
-            // initiator final message to responder (this was missing!)
-            spdlog::info("=== SENDING 48-BYTE FINAL MESSAGE ===");
-            spdlog::info("To peerID: '{}'", peerID);
-            spdlog::info("This should complete the handshake on the responder side");
-            spdlog::info("This is the FINAL message from initiator to responder");
-            spdlog::info("After this, handshake should be complete on both sides");
-
-            BitchatPacket responsePacket(PKT_TYPE_NOISE_HANDSHAKE_RESP, *response);
-            responsePacket.setSenderID(StringHelper::stringToVector(BitchatData::shared()->getPeerID()));
-            responsePacket.setTimestamp(DateTimeHelper::getCurrentTimestamp());
-            networkService->sendPacket(responsePacket);
-            spdlog::info("Sent 48-byte final handshake message to {}", peerID);
-            spdlog::info("Handshake should now be complete on initiator side");
-        }
-        else
-        {
-            spdlog::warn("Unexpected handshake response size: {}, not sending further response", response->size());
-        }
+        spdlog::info("Noise session established with {}", peerID);
+
+        // The peer needs our sender key to read our channel messages
+        distributeSenderKey(peerID);
     }
-    else if (!response.has_value() || response->empty())
+    else if (!step.response.has_value())
     {
-        spdlog::info("=== NOISE SESSION ESTABLISHED ===");
-        spdlog::info("With peerID: '{}'", peerID);
-        spdlog::info("No more handshake messages needed");
-        spdlog::info("Session is now ready for encrypted communication");
+        spdlog::warn("Noise handshake with {} failed, waiting for a new attempt", peerID);
     }
 }
 
@@ -658,24 +834,21 @@ void MessageService::processNoiseEncryptedPacket(const BitchatPacket &packet)
         return;
     }
 
-    std::string peerID = StringHelper::toHex(packet.getSenderID());
+    // One identity snapshot for the whole packet
+    LocalIdentityPtr identity = BitchatData::shared()->getLocalIdentity();
+    PeerId peerID = packet.getSenderPeerId();
 
     // Ignore packets from ourselves to prevent echo loops
-    if (peerID == BitchatData::shared()->getPeerID())
+    if (peerID == identity->peerId)
     {
         spdlog::debug("Ignoring Noise packet from ourselves: {}", peerID);
         return;
     }
 
-    spdlog::info("=== RECEIVED NOISE_ENCRYPTED ===");
-    spdlog::info("From peerID: '{}' (size: {})", peerID, peerID.size());
-    spdlog::info("Payload size: {} bytes", packet.getPayload().size());
-
     auto decryptedPayload = noiseService->decrypt(packet.getPayload(), peerID);
     if (!decryptedPayload.empty())
     {
-        spdlog::info("Successfully decrypted message from {}", peerID);
-        spdlog::info("Decrypted payload size: {} bytes", decryptedPayload.size());
+        spdlog::debug("Decrypted {} byte Noise message from {}", decryptedPayload.size(), peerID);
 
         // Create a new packet with decrypted payload and process it
         BitchatPacket decryptedPacket(PKT_TYPE_MESSAGE, decryptedPayload);
@@ -692,7 +865,7 @@ void MessageService::processNoiseEncryptedPacket(const BitchatPacket &packet)
     }
 }
 
-void MessageService::processNoiseIdentityAnnouncePacket(const BitchatPacket &packet)
+void MessageService::processSenderKeyPacket(const BitchatPacket &packet)
 {
     if (!noiseService)
     {
@@ -700,37 +873,139 @@ void MessageService::processNoiseIdentityAnnouncePacket(const BitchatPacket &pac
         return;
     }
 
-    std::string peerID = StringHelper::toHex(packet.getSenderID());
+    LocalIdentityPtr identity = BitchatData::shared()->getLocalIdentity();
+    PeerId peerID = packet.getSenderPeerId();
+
+    // Sealed for one peer, the others only relay it
+    if (peerID == identity->peerId || !isAddressedTo(packet, identity->peerId))
+    {
+        return;
+    }
+
+    if (!noiseService->hasEstablishedSession(peerID))
+    {
+        spdlog::warn("Ignoring sender key from {} - no established session", peerID);
+        return;
+    }
+
+    if (noiseService->handleSenderKey(peerID, packet.getPayload()))
+    {
+        spdlog::info("Received sender key from {}", peerID);
+    }
+    else
+    {
+        spdlog::warn("Failed to read sender key from {}", peerID);
+    }
+}
+
+void MessageService::processSenderKeyMessagePacket(const BitchatPacket &packet)
+{
+    if (!noiseService)
+    {
+        spdlog::warn("Noise Service not available");
+        return;
+    }
+
+    PeerId peerID = packet.getSenderPeerId();
 
     // Ignore packets from ourselves to prevent echo loops
-    if (peerID == BitchatData::shared()->getPeerID())
+    if (peerID == BitchatData::shared()->getLocalPeerId())
+    {
+        return;
+    }
+
+    auto decryptedPayload = noiseService->decryptBroadcast(packet.getPayload(), peerID);
+
+    if (!decryptedPayload)
+    {
+        spdlog::debug("Could not decrypt channel message from {}", peerID);
+        return;
+    }
+
+    BitchatPacket decryptedPacket(PKT_TYPE_MESSAGE, std::move(*decryptedPayload));
+    decryptedPacket.setSenderID(packet.getSenderID());
+    decryptedPacket.setTimestamp(packet.getTimestamp());
+    decryptedPacket.setFlags(packet.getFlags());
+
+    processMessagePacket(decryptedPacket);
+}
+
+void MessageService::distributeSenderKey(PeerId peerID)
+{
+    std::vector<uint8_t> ciphertext = noiseService->encryptSenderKey(peerID);
+
+    if (ciphertext.empty())
+    {
+        spdlog::warn("Failed to encrypt our sender key for {}", peerID);
+        return;
+    }
+
+    BitchatPacket packet(PKT_TYPE_SENDER_KEY, std::move(ciphertext));
+    packet.setSenderID(BitchatData::shared()->getLocalPeerId());
+    packet.setRecipientID(peerID);
+    packet.setHasRecipient(true);
+    packet.setTimestamp(DateTimeHelper::getCurrentTimestamp());
+    networkService->sendPacket(packet);
+
+    spdlog::debug("Sent our sender key to {}", peerID);
+}
+
+void MessageService::rotateSenderKey()
+{
+    noiseService->rotateSenderKey();
+
+    // One message per peer, only when the chain is replaced
+    for (const PeerId &peerID : noiseService->getEstablishedSessionIDs())
+    {
+        distributeSenderKey(peerID);
+    }
+}
+
+void MessageService::processNoiseIdentityAnnouncePacket(const BitchatPacket &packet)
+{
+    // One identity snapshot for the whole packet
+    LocalIdentityPtr identity = BitchatData::shared()->getLocalIdentity();
+    PeerId peerID = packet.getSenderPeerId();
+
+    // Ignore packets from ourselves to prevent echo loops
+    if (peerID == identity->peerId)
     {
         spdlog::debug("Ignoring Noise packet from ourselves: {}", peerID);
         return;
     }
 
-    spdlog::info("=== RECEIVED NOISE IDENTITY ANNOUNCE ===");
-    spdlog::info("From peerID: '{}'", peerID);
+    // Learn the key the peer signs its messages with, pinned on first use
+    PacketSerializer serializer;
+    std::string announcedPeerID;
+    std::vector<uint8_t> signingPublicKey;
+    serializer.parseIdentityAnnouncePayload(packet.getPayload(), announcedPeerID, signingPublicKey);
+
+    if (signatureVerifier && !signingPublicKey.empty() && announcedPeerID == peerID.toHex())
+    {
+        signatureVerifier->setPublicKey(peerID, signingPublicKey);
+    }
+
+    if (!noiseService)
+    {
+        spdlog::warn("Noise Service not available");
+        return;
+    }
 
-    std::string localPeerID = BitchatData::shared()->getPeerID();
+    spdlog::debug("Received Noise identity announce from {}", peerID);
+
+    // A peer announcing again may have restarted. Its session is only replaced once
+    // the new handshake completes, so a spoofed announce cannot tear it down.
+    PeerId localPeerID = identity->peerId;
 
     // Use robust handshake strategy: prefer to initiate if we have smaller peerID
     if (localPeerID < peerID)
     {
-        spdlog::info("Preferring to initiate handshake with {} (our peerID {} < their peerID {})", peerID, localPeerID, peerID);
         // Get handshake data and send
         auto handshakeData = noiseService->initiateHandshake(peerID);
         if (!handshakeData.empty())
         {
-            spdlog::info("=== SENDING NOISE HANDSHAKE INIT ===");
-            spdlog::info("To peerID: '{}'", peerID);
-            spdlog::info("Handshake data size: {} bytes", handshakeData.size());
-
-            BitchatPacket handshakePacket(PKT_TYPE_NOISE_HANDSHAKE_INIT, handshakeData);
-            handshakePacket.setSenderID(StringHelper::stringToVector(BitchatData::shared()->getPeerID()));
-            handshakePacket.setTimestamp(DateTimeHelper::getCurrentTimestamp());
-            networkService->sendPacket(handshakePacket);
-            spdlog::info("Sent Noise handshake init to {}", peerID);
+            sendHandshakePacket(PKT_TYPE_NOISE_HANDSHAKE_INIT, handshakeData, peerID, identity->peerId);
+            spdlog::debug("Sent Noise handshake init to {} ({} bytes)", peerID, handshakeData.size());
         }
         else
         {
@@ -739,29 +1014,61 @@ void MessageService::processNoiseIdentityAnnouncePacket(const BitchatPacket &pac
     }
     else
     {
-        spdlog::info("Preferring to wait for handshake from {} (their peerID {} < our peerID {})", peerID, peerID, localPeerID);
-        // Don't wait forever - if no handshake comes, we can still initiate later
+        // The smaller peer ID initiates, wait for its handshake
+        spdlog::debug("Waiting for handshake from {}", peerID);
     }
 }
 
-bool MessageService::shouldProcessPacket(const BitchatPacket &packet) const
+void MessageService::sendHandshakePacket(uint8_t type, const std::vector<uint8_t> &data, PeerId peerID, PeerId localPeerID)
+{
+    BitchatPacket packet(type, data);
+    packet.setSenderID(localPeerID);
+    packet.setRecipientID(peerID);
+    packet.setHasRecipient(true);
+    packet.setTimestamp(DateTimeHelper::getCurrentTimestamp());
+    networkService->sendPacket(packet);
+}
+
+bool MessageService::isAddressedTo(const BitchatPacket &packet, PeerId peerID)
+{
+    return packet.hasRecipient() && packet.getRecipientPeerId() == peerID;
+}
+
+bool MessageService::markPacketProcessed(const BitchatPacket &packet)
 {
-    // Check if we've already processed this message
-    std::string messageID = StringHelper::toHex(packet.getSenderID()) + "_" + std::to_string(packet.getTimestamp());
+    uint64_t key = makeProcessedKey(packet.getSenderPeerId(), packet.getTimestamp(), packet.getType(), packet.getPayload());
 
-    if (BitchatData::shared()->wasMessageProcessed(messageID))
+    if (!BitchatData::shared()->markPacketProcessed(key))
     {
-        spdlog::debug("Packet already processed, skipping: {}", messageID);
+        spdlog::debug("Packet already processed, skipping: {:016x}", key);
         return false;
     }
 
     return true;
 }
 
-void MessageService::markPacketProcessed(const BitchatPacket &packet)
+bool MessageService::markPacketProcessed(const PacketView &packet)
 {
-    std::string messageID = StringHelper::toHex(packet.getSenderID()) + "_" + std::to_string(packet.getTimestamp());
-    BitchatData::shared()->markMessageProcessed(messageID);
+    uint64_t key = makeProcessedKey(packet.getSenderPeerId(), packet.getTimestamp(), packet.getType(), packet.getPayload());
+
+    if (!BitchatData::shared()->markPacketProcessed(key))
+    {
+        spdlog::debug("Packet already processed, skipping: {:016x}", key);
+        return false;
+    }
+
+    return true;
+}
+
+uint64_t MessageService::makeProcessedKey(PeerId senderID, uint64_t timestamp, uint8_t type, std::span<const uint8_t> payload)
+{
+    // Fragments of one transfer share sender and timestamp, tell them apart by fragment ID and index
+    if (PacketFragmenter::isFragmentType(type) && payload.size() >= 10)
+    {
+        return DedupFilter::makeKey(senderID, timestamp, type, payload.first(10));
+    }
+
+    return DedupFilter::makeKey(senderID, timestamp, type);
 }
 
 BitchatPacket MessageService::createMessagePacket(const BitchatMessage &message)
@@ -769,42 +1076,43 @@ BitchatPacket MessageService::createMessagePacket(const BitchatMessage &message)
     PacketSerializer serializer;
     std::vector<uint8_t> payload = serializer.makeMessagePayload(message);
 
-    // Compress payload if beneficial
-    if (CompressionHelper::shouldCompress(payload))
-    {
-        payload = CompressionHelper::compressData(payload);
-    }
-
     // Check if we should encrypt this message with Noise
     uint8_t packetType = PKT_TYPE_MESSAGE;
 
     if (noiseService && !message.isPrivate())
     {
-        // For channel messages, check if we have any established sessions
-        auto establishedSessionIDs = noiseService->getEstablishedSessionIDs();
-        if (!establishedSessionIDs.empty())
+        // Channel messages are encrypted once with our sender key, every peer
+        // we have a session with already holds it
+        if (noiseService->getEstablishedSessionIDs().empty())
         {
-            // Use the first established session for encryption
-            auto firstPeerId = establishedSessionIDs[0];
-
-            auto encryptedPayload = noiseService->encrypt(payload, firstPeerId);
-
-            // Use encrypted packet type
-            packetType = PKT_TYPE_NOISE_ENCRYPTED;
-            payload = encryptedPayload;
-
-            spdlog::debug("Message encrypted with Noise protocol for peer: {}", firstPeerId);
+            spdlog::debug("No established Noise sessions available, sending as plaintext");
         }
         else
         {
-            spdlog::debug("No established Noise sessions available, sending as plaintext");
+            if (noiseService->needsSenderKeyRotation())
+            {
+                rotateSenderKey();
+            }
+
+            auto encryptedPayload = noiseService->encryptBroadcast(payload, BitchatData::shared()->getLocalPeerId());
+
+            if (encryptedPayload)
+            {
+                packetType = PKT_TYPE_SENDER_KEY_MESSAGE;
+                payload = std::move(*encryptedPayload);
+
+                spdlog::debug("Message encrypted with our sender key");
+            }
+            else
+            {
+                spdlog::warn("Sender key encryption failed, sending as plaintext");
+            }
         }
     }
 
-    BitchatPacket packet(packetType, payload);
-    packet.setSenderID(StringHelper::stringToVector(BitchatData::shared()->getPeerID()));
+    BitchatPacket packet(packetType, std::move(payload));
+    packet.setSenderID(BitchatData::shared()->getLocalPeerId());
     packet.setTimestamp(DateTimeHelper::getCurrentTimestamp());
-    packet.setCompressed(CompressionHelper::shouldCompress(payload));
 
     // Set recipient ID for channel messages (broadcast)
     if (!message.isPrivate())
@@ -817,8 +1125,7 @@ BitchatPacket MessageService::createMessagePacket(const BitchatMessage &message)
     // Sign packet if crypto manager is available
     if (cryptoService)
     {
-        std::vector<uint8_t> signature = cryptoService->signData(payload);
-        packet.setSignature(signature);
+        packet.setSignature(cryptoService->signData(packet.getPayload()));
         packet.setHasSignature(true);
     }
 
@@ -828,11 +1135,11 @@ BitchatPacket MessageService::createMessagePacket(const BitchatMessage &message)
 BitchatPacket MessageService::createAnnouncePacket()
 {
     PacketSerializer serializer;
-    std::string nickname = BitchatData::shared()->getNickname();
-    std::vector<uint8_t> payload = serializer.makeAnnouncePayload(nickname);
+    LocalIdentityPtr identity = BitchatData::shared()->getLocalIdentity();
+    std::vector<uint8_t> payload = serializer.makeAnnouncePayload(identity->nickname);
 
-    BitchatPacket packet(PKT_TYPE_ANNOUNCE, payload);
-    packet.setSenderID(StringHelper::stringToVector(BitchatData::shared()->getPeerID()));
+    BitchatPacket packet(PKT_TYPE_ANNOUNCE, std::move(payload));
+    packet.setSenderID(identity->peerId);
     packet.setTimestamp(DateTimeHelper::getCurrentTimestamp());
 
     return packet;
@@ -843,7 +1150,7 @@ BitchatPacket MessageService::createChannelAnnouncePacket(const std::string &cha
     PacketSerializer serializer;
     std::vector<uint8_t> payload = serializer.makeChannelAnnouncePayload(channel, joining);
 
-    BitchatPacket packet(PKT_TYPE_CHANNEL_ANNOUNCE, payload);
+    BitchatPacket packet(PKT_TYPE_CHANNEL_ANNOUNCE, std::move(payload));
     packet.setTimestamp(DateTimeHelper::getCurrentTimestamp());
 
     return packet;
@@ -857,13 +1164,12 @@ BitchatPacket MessageService::createVersionHelloPacket()
     std::vector<uint8_t> supportedVersions = {1};
     uint8_t preferredVersion = 1;
 
-    // No capabilities for now
-    std::vector<std::string> capabilities = {};
+    std::vector<std::string> capabilities = {CompressionDictionary::CAPABILITY};
 
     std::vector<uint8_t> payload = serializer.makeVersionHelloPayload(supportedVersions, preferredVersion, constants::CLIENT_VERSION, constants::PLATFORM, capabilities);
 
-    BitchatPacket packet(PKT_TYPE_VERSION_HELLO, payload);
-    packet.setSenderID(StringHelper::stringToVector(BitchatData::shared()->getPeerID()));
+    BitchatPacket packet(PKT_TYPE_VERSION_HELLO, std::move(payload));
+    packet.setSenderID(BitchatData::shared()->getLocalPeerId());
     packet.setTimestamp(DateTimeHelper::getCurrentTimestamp());
 
     // Set TTL to 1 to ensure the packet is not cached
@@ -872,6 +1178,16 @@ BitchatPacket MessageService::createVersionHelloPacket()
     return packet;
 }
 
+SignatureVerifier::Stats MessageService::getSignatureStats() const
+{
+    return signatureVerifier ? signatureVerifier->getStats() : SignatureVerifier::Stats{};
+}
+
+RateLimiter::Stats MessageService::getRateLimitStats() const
+{
+    return rateLimiter.getStats();
+}
+
 std::string MessageService::generateMessageID() const
 {
     return StringHelper::createUUID();
@@ -912,7 +1228,7 @@ void MessageService::setPeerDisconnectedCallback(PeerDisconnectedCallback callba
     peerDisconnectedCallback = callback;
 }
 
-void MessageService::handleVersionHello(const std::string &peerID, const std::vector<uint8_t> &data)
+void MessageService::handleVersionHello(PeerId peerID, const std::vector<uint8_t> &data)
 {
     if (data.empty())
     {
@@ -976,15 +1292,25 @@ void MessageService::handleVersionHello(const std::string &peerID, const std::ve
         VersionAck ack(agreedVersion, constants::CLIENT_VERSION, constants::PLATFORM);
         sendVersionAck(ack, peerID);
 
+        // Dictionary compression is only used towards peers that have the same dictionary
+        bool supportsDictionary = std::find(capabilities.begin(), capabilities.end(), CompressionDictionary::CAPABILITY) != capabilities.end();
+
         // Check if peer exists in BitchatData, if not add it
         auto peerInfo = BitchatData::shared()->getPeerInfo(peerID);
         if (!peerInfo.has_value())
         {
             // Add peer to BitchatData with basic info
-            BitchatPeer newPeer(peerID, clientVersion); // Use clientVersion as nickname for now
+            BitchatPeer newPeer(peerID.toHex(), clientVersion); // Use clientVersion as nickname for now
+            newPeer.setSupportsCompressionDictionary(supportsDictionary);
             BitchatData::shared()->addPeer(newPeer);
             spdlog::info("Added new peer {} to BitchatData", peerID);
         }
+        else if (peerInfo->supportsCompressionDictionary() != supportsDictionary)
+        {
+            BitchatPeer updatedPeer = *peerInfo;
+            updatedPeer.setSupportsCompressionDictionary(supportsDictionary);
+            BitchatData::shared()->updatePeer(updatedPeer);
+        }
 
         spdlog::info("Version negotiation complete with {} - lazy handshake mode", peerID);
     }
@@ -1040,7 +1366,7 @@ void MessageService::handleVersionHello(const std::string &peerID, const std::ve
     }
 }
 
-void MessageService::handleVersionAck(const std::string &peerID, const std::vector<uint8_t> &data)
+void MessageService::handleVersionAck(PeerId peerID, const std::vector<uint8_t> &data)
 {
     if (data.empty())
     {
@@ -1076,7 +1402,7 @@ void MessageService::handleVersionAck(const std::string &peerID, const std::vect
         // Notify delegate about incompatible peer disconnection
         if (peerDisconnectedCallback)
         {
-            peerDisconnectedCallback(peerID);
+            peerDisconnectedCallback(peerID.toHex());
         }
     }
     else
@@ -1115,7 +1441,7 @@ void MessageService::sendVersionHello(const std::string &peripheralID)
     }
 }
 
-void MessageService::sendVersionAck(const VersionAck &ack, const std::string &peerID)
+void MessageService::sendVersionAck(const VersionAck &ack, PeerId peerID)
 {
     spdlog::debug("Sending version ack to peer: {} (agreed version: {}, rejected: {})", peerID, ack.agreedVersion, ack.rejected);
 
@@ -1125,8 +1451,8 @@ void MessageService::sendVersionAck(const VersionAck &ack, const std::string &pe
 
     // Create packet
     BitchatPacket packet(PKT_TYPE_VERSION_ACK, ackData);
-    packet.setSenderID(StringHelper::stringToVector(BitchatData::shared()->getPeerID()));
-    packet.setRecipientID(StringHelper::stringToVector(peerID));
+    packet.setSenderID(BitchatData::shared()->getLocalPeerId());
+    packet.setRecipientID(peerID);
     packet.setTimestamp(DateTimeHelper::getCurrentTimestamp());
 
     // Direct response, no relay
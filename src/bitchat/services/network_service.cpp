@@ -3,8 +3,9 @@
 #include "bitchat/core/constants.h"
 #include "bitchat/helpers/datetime_helper.h"
 #include "bitchat/helpers/protocol_helper.h"
-#include "bitchat/helpers/string_helper.h"
 #include "bitchat/platform/bluetooth_interface.h"
+#include "bitchat/protocol/message_padding.h"
+#include "bitchat/protocol/packet_fragmenter.h"
 #include "bitchat/protocol/packet_serializer.h"
 #include "bitchat/runners/bluetooth_announce_runner.h"
 #include "bitchat/runners/cleanup_runner.h"
@@ -14,11 +15,13 @@
 #include <ranges>
 #include <spdlog/spdlog.h>
 #include <thread>
+#include <unordered_set>
 
 namespace bitchat
 {
 
 NetworkService::NetworkService()
+    : maxFrameSize(constants::BLE_MAX_PACKET_SIZE_BYTES)
 {
     // Pass
 }
@@ -48,7 +51,7 @@ bool NetworkService::initialize(std::shared_ptr<IBluetoothNetwork> bluetoothNetw
 
     // Set up Bluetooth network callbacks
     // clang-format off
-    bluetoothNetworkInterface->setPacketReceivedCallback([this](const BitchatPacket &packet, const std::string &peripheralID) {
+    bluetoothNetworkInterface->setPacketReceivedCallback([this](const PacketView &packet, const std::string &peripheralID) {
         onPacketReceived(packet, peripheralID);
     });
     // clang-format on
@@ -145,17 +148,63 @@ bool NetworkService::sendPacket(const BitchatPacket &packet)
         return false;
     }
 
+    // Broadcast frames are shared by every link, so every link needs a peer with the dictionary
+    bool useDictionary = canBroadcastDictionary();
+
+    if (packet.usesDictionary() != useDictionary)
+    {
+        return sendPacket(withDictionary(packet, useDictionary));
+    }
+
+    std::vector<BitchatPacket> fragments = makeFragments(packet);
+
+    if (!fragments.empty())
+    {
+        bool sentAll = true;
+
+        for (const auto &fragment : fragments)
+        {
+            sentAll = bluetoothNetworkInterface->sendPacket(fragment) && sentAll;
+        }
+
+        return sentAll;
+    }
+
     return bluetoothNetworkInterface->sendPacket(packet);
 }
 
-bool NetworkService::sendPacketToPeer(const BitchatPacket &packet, const std::string &peerID)
+bool NetworkService::sendPacketToPeer(const BitchatPacket &packet, PeerId peerID)
 {
     if (!bluetoothNetworkInterface)
     {
         return false;
     }
 
-    return bluetoothNetworkInterface->sendPacketToPeer(packet, peerID);
+    PeerPtr peer = BitchatData::shared()->getPeersSnapshot().find(peerID);
+    bool useDictionary = peer && canUseDictionary({&peer, 1});
+
+    if (packet.usesDictionary() != useDictionary)
+    {
+        return sendPacketToPeer(withDictionary(packet, useDictionary), peerID);
+    }
+
+    // The platform layer addresses peers by their hex ID
+    std::string peerHex = peerID.toHex();
+    std::vector<BitchatPacket> fragments = makeFragments(packet);
+
+    if (!fragments.empty())
+    {
+        bool sentAll = true;
+
+        for (const auto &fragment : fragments)
+        {
+            sentAll = bluetoothNetworkInterface->sendPacketToPeer(fragment, peerHex) && sentAll;
+        }
+
+        return sentAll;
+    }
+
+    return bluetoothNetworkInterface->sendPacketToPeer(packet, peerHex);
 }
 
 bool NetworkService::sendPacketToPeripheral(const BitchatPacket &packet, const std::string &peripheralID)
@@ -165,9 +214,124 @@ bool NetworkService::sendPacketToPeripheral(const BitchatPacket &packet, const s
         return false;
     }
 
+    std::vector<PeerPtr> receivers = BitchatData::shared()->getPeersSnapshot().findByPeripheral(peripheralID);
+    bool useDictionary = canUseDictionary(receivers);
+
+    if (packet.usesDictionary() != useDictionary)
+    {
+        return sendPacketToPeripheral(withDictionary(packet, useDictionary), peripheralID);
+    }
+
+    std::vector<BitchatPacket> fragments = makeFragments(packet);
+
+    if (!fragments.empty())
+    {
+        bool sentAll = true;
+
+        for (const auto &fragment : fragments)
+        {
+            sentAll = bluetoothNetworkInterface->sendPacketToPeripheral(fragment, peripheralID) && sentAll;
+        }
+
+        return sentAll;
+    }
+
     return bluetoothNetworkInterface->sendPacketToPeripheral(packet, peripheralID);
 }
 
+void NetworkService::setMaxFrameSize(size_t size)
+{
+    maxFrameSize = size;
+}
+
+size_t NetworkService::getMaxFrameSize() const
+{
+    return maxFrameSize;
+}
+
+std::vector<BitchatPacket> NetworkService::makeFragments(const BitchatPacket &packet) const
+{
+    // Uncompressed size is an upper bound, so most packets never need serializing here
+    if (PacketFragmenter::isFragmentType(packet.getType()) || MessagePadding::paddedSize(packet.getTotalSize()) <= maxFrameSize)
+    {
+        return {};
+    }
+
+    thread_local OutputBuffer output;
+    PacketSerializer serializer;
+    serializer.serializeInto(packet, output);
+
+    std::optional<PacketView> view = serializer.parsePacketView(output.getData());
+
+    if (!view || output.size() <= maxFrameSize)
+    {
+        return {};
+    }
+
+    // Relays forward fragments as they are and cannot re-encode them for peers
+    // without the dictionary, so fragmented packets never use it
+    if (packet.usesDictionary())
+    {
+        BitchatPacket plainPacket = withDictionary(packet, false);
+        std::vector<BitchatPacket> fragments = makeFragments(plainPacket);
+
+        if (fragments.empty())
+        {
+            fragments.push_back(std::move(plainPacket));
+        }
+
+        return fragments;
+    }
+
+    return PacketFragmenter::fragment(packet, view->getFrame(), maxFrameSize);
+}
+
+bool NetworkService::canUseDictionary(std::span<const PeerPtr> receivers)
+{
+    if (receivers.empty())
+    {
+        return false;
+    }
+
+    // clang-format off
+    return std::ranges::all_of(receivers, [](const PeerPtr &peer) {
+        return peer->supportsCompressionDictionary();
+    });
+    // clang-format on
+}
+
+bool NetworkService::canBroadcastDictionary() const
+{
+    PeerTable::Snapshot snapshot = BitchatData::shared()->getPeersSnapshot();
+    std::span<const PeerPtr> peers = snapshot.getPeers();
+
+    if (!canUseDictionary(peers))
+    {
+        return false;
+    }
+
+    // A link whose peer has not announced itself yet could not decode the frame
+    std::unordered_set<std::string> links;
+
+    for (const auto &peer : peers)
+    {
+        if (!peer->getPeripheralID().empty())
+        {
+            links.insert(peer->getPeripheralID());
+        }
+    }
+
+    return links.size() >= bluetoothNetworkInterface->getConnectedPeersCount();
+}
+
+BitchatPacket NetworkService::withDictionary(const BitchatPacket &packet, bool useDictionary)
+{
+    BitchatPacket copy = packet;
+    copy.setUsesDictionary(useDictionary);
+
+    return copy;
+}
+
 void NetworkService::setPacketReceivedCallback(PacketReceivedCallback callback)
 {
     packetReceivedCallback = callback;
@@ -235,37 +399,64 @@ void NetworkService::onPeripheralDiscovered(const std::string &peripheralID)
     // clang-format on
 }
 
-void NetworkService::onPacketReceived(const BitchatPacket &packet, const std::string &peripheralID)
+void NetworkService::onPacketReceived(const PacketView &packet, const std::string &peripheralID)
 {
-    // Delegate all packet processing to MessageService via callback
+    // Delegate all packet processing to MessageService via callback, it reports duplicates and rate limited packets
+    bool isNew = true;
+
     if (packetReceivedCallback)
     {
-        packetReceivedCallback(packet, peripheralID);
+        isNew = packetReceivedCallback(packet, peripheralID);
     }
 
-    // Relay packet if needed (this is still handled by NetworkService)
-    if (packet.getTTL() > 0)
+    // Relay packet if needed (this is still handled by NetworkService), duplicates were relayed on first receipt
+    if (isNew && packet.getTTL() > 0)
     {
         relayPacket(packet);
     }
 }
 
-void NetworkService::relayPacket(const BitchatPacket &packet)
+void NetworkService::relayPacket(const PacketView &packet)
 {
-    // Create relay packet with decremented TTL
-    BitchatPacket relayPacket = packet;
-    relayPacket.setTTL(packet.getTTL() - 1);
+    // Forward the received bytes with decremented TTL, built once and shared by every peer write
+    PacketSerializer serializer;
+    SharedFrame relayFrame;
+
+    // Peers without the dictionary get one re-encoded frame, also shared
+    SharedFrame plainFrame;
 
     // Send to all connected peers except sender
-    std::string senderID = StringHelper::toHex(packet.getSenderID());
+    PeerId senderID = packet.getSenderPeerId();
 
-    auto peers = BitchatData::shared()->getPeers();
-    for (const auto &peer : peers)
+    // The snapshot stays valid while the table changes, no lock or copy is needed
+    PeerTable::Snapshot peers = BitchatData::shared()->getPeersSnapshot();
+
+    for (const auto &peer : peers.getPeers())
     {
-        if (peer.getPeerID() != senderID)
+        if (peer->getId() == senderID)
+        {
+            continue;
+        }
+
+        if (packet.usesDictionary() && !peer->supportsCompressionDictionary())
+        {
+            if (!plainFrame)
+            {
+                BitchatPacket plainPacket = packet.toPacket();
+                plainPacket.setTTL(packet.getTTL() - 1);
+                plainFrame = std::make_shared<const std::vector<uint8_t>>(serializer.serializePacket(plainPacket));
+            }
+
+            bluetoothNetworkInterface->sendFrameToPeer(plainFrame, peer->getPeerID());
+            continue;
+        }
+
+        if (!relayFrame)
         {
-            bluetoothNetworkInterface->sendPacketToPeer(relayPacket, peer.getPeerID());
+            relayFrame = serializer.makeRelayFrame(packet, packet.getTTL() - 1);
         }
+
+        bluetoothNetworkInterface->sendFrameToPeer(relayFrame, peer->getPeerID());
     }
 }
 
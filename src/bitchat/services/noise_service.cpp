@@ -16,11 +16,11 @@ NoiseService::NoiseService()
     }
 }
 
-std::shared_ptr<NoiseSession> NoiseService::createSession(const std::string &peerID, NoiseRole role)
+std::shared_ptr<NoiseSession> NoiseService::createSession(PeerId peerID, NoiseRole role)
 {
     std::lock_guard<std::mutex> lock(sessionsMutex);
 
-    auto session = std::make_shared<NoiseSessionDefault>(peerID, role, localStaticKey);
+    auto session = std::make_shared<NoiseSessionDefault>(peerID.toHex(), role, localStaticKey);
     sessions[peerID] = session;
 
     spdlog::info("Created new Noise session for peer: {} with role: {}", peerID, NoiseHelper::noiseRoleToString(role));
@@ -28,7 +28,7 @@ std::shared_ptr<NoiseSession> NoiseService::createSession(const std::string &pee
     return session;
 }
 
-std::shared_ptr<NoiseSession> NoiseService::getSession(const std::string &peerID) const
+std::shared_ptr<NoiseSession> NoiseService::getSession(PeerId peerID) const
 {
     std::lock_guard<std::mutex> lock(sessionsMutex);
 
@@ -41,10 +41,12 @@ std::shared_ptr<NoiseSession> NoiseService::getSession(const std::string &peerID
     return nullptr;
 }
 
-void NoiseService::removeSession(const std::string &peerID)
+void NoiseService::removeSession(PeerId peerID)
 {
     std::lock_guard<std::mutex> lock(sessionsMutex);
 
+    pendingSessions.erase(peerID);
+
     auto it = sessions.find(peerID);
     if (it != sessions.end())
     {
@@ -53,11 +55,11 @@ void NoiseService::removeSession(const std::string &peerID)
     }
 }
 
-std::unordered_map<std::string, std::shared_ptr<NoiseSession>> NoiseService::getEstablishedSessions() const
+std::unordered_map<PeerId, std::shared_ptr<NoiseSession>> NoiseService::getEstablishedSessions() const
 {
     std::lock_guard<std::mutex> lock(sessionsMutex);
 
-    std::unordered_map<std::string, std::shared_ptr<NoiseSession>> establishedSessions;
+    std::unordered_map<PeerId, std::shared_ptr<NoiseSession>> establishedSessions;
 
     for (const auto &pair : sessions)
     {
@@ -70,73 +72,191 @@ std::unordered_map<std::string, std::shared_ptr<NoiseSession>> NoiseService::get
     return establishedSessions;
 }
 
-std::vector<uint8_t> NoiseService::initiateHandshake(const std::string &peerID)
+std::vector<uint8_t> NoiseService::initiateHandshake(PeerId peerID)
 {
     auto session = getSession(peerID);
-    if (!session)
+    if (!session || session->isSessionEstablished())
     {
-        throw std::runtime_error("No session found for peer: " + peerID);
+        session = createHandshakeSession(peerID, NoiseRole::Initiator);
     }
 
     auto handshakeMessage = session->startHandshake();
     if (!handshakeMessage)
     {
-        throw std::runtime_error("Failed to start handshake for peer: " + peerID);
+        throw std::runtime_error("Failed to start handshake for peer: " + peerID.toHex());
     }
 
     return *handshakeMessage;
 }
 
-std::optional<std::vector<uint8_t>> NoiseService::handleIncomingHandshake(const std::string &peerID, const std::vector<uint8_t> &message, const std::string &localPeerID)
+NoiseHandshakeStep NoiseService::handleHandshakeInit(PeerId peerID, const std::vector<uint8_t> &message)
 {
-    auto session = getSession(peerID);
+    return processHandshake(peerID, createHandshakeSession(peerID, NoiseRole::Responder), message);
+}
+
+NoiseHandshakeStep NoiseService::handleIncomingHandshake(PeerId peerID, const std::vector<uint8_t> &message, PeerId localPeerID)
+{
+    std::shared_ptr<NoiseSession> session;
+
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+
+        auto pending = pendingSessions.find(peerID);
+        if (pending != pendingSessions.end())
+        {
+            session = pending->second;
+        }
+        else if (auto it = sessions.find(peerID); it != sessions.end())
+        {
+            session = it->second;
+        }
+    }
+
     if (!session)
     {
         NoiseRole role = resolveRole(localPeerID, peerID);
         session = createSession(peerID, role);
     }
 
-    return session->processHandshakeMessage(message);
+    // Late handshake messages for a finished handshake
+    if (session->isSessionEstablished())
+    {
+        return NoiseHandshakeStep{};
+    }
+
+    return processHandshake(peerID, session, message);
+}
+
+bool NoiseService::hasPendingHandshake(PeerId peerID) const
+{
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+    return pendingSessions.contains(peerID);
+}
+
+std::shared_ptr<NoiseSession> NoiseService::createHandshakeSession(PeerId peerID, NoiseRole role)
+{
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+
+        auto it = sessions.find(peerID);
+        if (it != sessions.end() && it->second->isSessionEstablished())
+        {
+            auto session = std::make_shared<NoiseSessionDefault>(peerID.toHex(), role, localStaticKey);
+            pendingSessions[peerID] = session;
+
+            spdlog::info("Started a new Noise handshake with {}, keeping its session until it completes", peerID);
+
+            return session;
+        }
+    }
+
+    return createSession(peerID, role);
+}
+
+NoiseHandshakeStep NoiseService::processHandshake(PeerId peerID, const std::shared_ptr<NoiseSession> &session, const std::vector<uint8_t> &message)
+{
+    NoiseHandshakeStep step;
+    step.response = session->processHandshakeMessage(message);
+    step.established = session->isSessionEstablished();
+
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+
+    auto pending = pendingSessions.find(peerID);
+    if (pending == pendingSessions.end() || pending->second != session)
+    {
+        return step;
+    }
+
+    // Only a finished handshake replaces the established session, a failed one is dropped
+    if (step.established)
+    {
+        sessions[peerID] = session;
+        pendingSessions.erase(pending);
+        spdlog::info("Replaced the Noise session of {} with a new one", peerID);
+    }
+    else if (!step.response)
+    {
+        pendingSessions.erase(pending);
+    }
+
+    return step;
 }
 
-std::vector<uint8_t> NoiseService::encrypt(const std::vector<uint8_t> &plaintext, const std::string &peerID)
+std::vector<uint8_t> NoiseService::encrypt(const std::vector<uint8_t> &plaintext, PeerId peerID)
 {
     auto session = getSession(peerID);
     if (!session)
     {
-        throw std::runtime_error("No session found for peer: " + peerID);
+        throw std::runtime_error("No session found for peer: " + peerID.toHex());
     }
 
     return session->encrypt(plaintext);
 }
 
-std::vector<uint8_t> NoiseService::decrypt(const std::vector<uint8_t> &ciphertext, const std::string &peerID)
+std::vector<uint8_t> NoiseService::decrypt(const std::vector<uint8_t> &ciphertext, PeerId peerID)
 {
     auto session = getSession(peerID);
     if (!session)
     {
-        throw std::runtime_error("No session found for peer: " + peerID);
+        throw std::runtime_error("No session found for peer: " + peerID.toHex());
     }
 
     return session->decrypt(ciphertext);
 }
 
-bool NoiseService::isSessionEstablished(const std::string &peerID) const
+std::vector<uint8_t> NoiseService::encryptSenderKey(PeerId peerID)
+{
+    return encrypt(senderKeys.getDistributionMessage(), peerID);
+}
+
+bool NoiseService::handleSenderKey(PeerId peerID, const std::vector<uint8_t> &ciphertext)
+{
+    std::vector<uint8_t> message = decrypt(ciphertext, peerID);
+    return !message.empty() && senderKeys.processDistributionMessage(peerID, message);
+}
+
+std::optional<std::vector<uint8_t>> NoiseService::encryptBroadcast(const std::vector<uint8_t> &plaintext, PeerId localPeerID)
+{
+    return senderKeys.encrypt(localPeerID, plaintext);
+}
+
+std::optional<std::vector<uint8_t>> NoiseService::decryptBroadcast(const std::vector<uint8_t> &ciphertext, PeerId senderID)
+{
+    return senderKeys.decrypt(senderID, ciphertext);
+}
+
+bool NoiseService::needsSenderKeyRotation() const
+{
+    return senderKeys.needsRotation();
+}
+
+void NoiseService::rotateSenderKey()
+{
+    senderKeys.rotate();
+    spdlog::info("Rotated sender key");
+}
+
+void NoiseService::removeSenderKey(PeerId peerID)
+{
+    senderKeys.removeSenderKey(peerID);
+}
+
+bool NoiseService::isSessionEstablished(PeerId peerID) const
 {
     auto session = getSession(peerID);
     return session && session->isSessionEstablished();
 }
 
-bool NoiseService::hasEstablishedSession(const std::string &peerID) const
+bool NoiseService::hasEstablishedSession(PeerId peerID) const
 {
     return isSessionEstablished(peerID);
 }
 
-std::vector<std::string> NoiseService::getEstablishedSessionIDs() const
+std::vector<PeerId> NoiseService::getEstablishedSessionIDs() const
 {
     std::lock_guard<std::mutex> lock(sessionsMutex);
 
-    std::vector<std::string> sessionIDs;
+    std::vector<PeerId> sessionIDs;
 
     for (const auto &pair : sessions)
     {
@@ -149,7 +269,7 @@ std::vector<std::string> NoiseService::getEstablishedSessionIDs() const
     return sessionIDs;
 }
 
-std::optional<NoisePublicKey> NoiseService::getRemoteStaticKey(const std::string &peerID) const
+std::optional<NoisePublicKey> NoiseService::getRemoteStaticKey(PeerId peerID) const
 {
     auto session = getSession(peerID);
     if (!session)
@@ -160,7 +280,7 @@ std::optional<NoisePublicKey> NoiseService::getRemoteStaticKey(const std::string
     return session->getRemoteStaticPublicKey();
 }
 
-std::optional<std::vector<uint8_t>> NoiseService::getHandshakeHash(const std::string &peerID) const
+std::optional<std::vector<uint8_t>> NoiseService::getHandshakeHash(PeerId peerID) const
 {
     auto session = getSession(peerID);
     if (!session)
@@ -171,11 +291,11 @@ std::optional<std::vector<uint8_t>> NoiseService::getHandshakeHash(const std::st
     return session->getHandshakeHash();
 }
 
-std::vector<std::pair<std::string, bool>> NoiseService::getSessionsNeedingRekey() const
+std::vector<std::pair<PeerId, bool>> NoiseService::getSessionsNeedingRekey() const
 {
     std::lock_guard<std::mutex> lock(sessionsMutex);
 
-    std::vector<std::pair<std::string, bool>> sessionsNeedingRekey;
+    std::vector<std::pair<PeerId, bool>> sessionsNeedingRekey;
 
     for (const auto &pair : sessions)
     {
@@ -188,17 +308,17 @@ std::vector<std::pair<std::string, bool>> NoiseService::getSessionsNeedingRekey(
     return sessionsNeedingRekey;
 }
 
-void NoiseService::initiateRekey(const std::string &peerID)
+void NoiseService::initiateRekey(PeerId peerID)
 {
     auto session = getSession(peerID);
     if (!session)
     {
-        throw std::runtime_error("No session found for peer: " + peerID);
+        throw std::runtime_error("No session found for peer: " + peerID.toHex());
     }
 
     if (!session->isSessionEstablished())
     {
-        throw std::runtime_error("Session not established for peer: " + peerID);
+        throw std::runtime_error("Session not established for peer: " + peerID.toHex());
     }
 
     spdlog::info("Initiating rekey for peer: {}", peerID);
@@ -206,21 +326,21 @@ void NoiseService::initiateRekey(const std::string &peerID)
     auto handshakeMessage = session->startHandshake();
     if (!handshakeMessage)
     {
-        throw std::runtime_error("Failed to start rekey handshake for peer: " + peerID);
+        throw std::runtime_error("Failed to start rekey handshake for peer: " + peerID.toHex());
     }
 }
 
-void NoiseService::setOnSessionEstablished(std::function<void(const std::string &, const NoisePublicKey &)> callback)
+void NoiseService::setOnSessionEstablished(std::function<void(PeerId, const NoisePublicKey &)> callback)
 {
     onSessionEstablished = callback;
 }
 
-void NoiseService::setOnSessionFailed(std::function<void(const std::string &, const std::exception &)> callback)
+void NoiseService::setOnSessionFailed(std::function<void(PeerId, const std::exception &)> callback)
 {
     onSessionFailed = callback;
 }
 
-NoiseRole NoiseService::resolveRole(const std::string &localPeerID, const std::string &remotePeerID) const
+NoiseRole NoiseService::resolveRole(PeerId localPeerID, PeerId remotePeerID) const
 {
     return localPeerID < remotePeerID ? NoiseRole::Initiator : NoiseRole::Responder;
 }
@@ -0,0 +1,187 @@
+#include "bitchat/storage/mapped_file.h"
+#include <cerrno>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+// clang-format off
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+// clang-format on
+
+namespace bitchat
+{
+
+#ifndef _WIN32
+
+// MappedFile
+
+std::shared_ptr<MappedFile> MappedFile::map(const std::filesystem::path &path, size_t length)
+{
+    if (length == 0)
+    {
+        return std::shared_ptr<MappedFile>(new MappedFile(nullptr, 0));
+    }
+
+    int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (descriptor < 0)
+    {
+        spdlog::error("Failed to open {} for mapping: {}", path.string(), std::strerror(errno));
+        return nullptr;
+    }
+
+    void *address = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+
+    if (address == MAP_FAILED)
+    {
+        spdlog::error("Failed to map {} ({} bytes): {}", path.string(), length, std::strerror(errno));
+        return nullptr;
+    }
+
+    return std::shared_ptr<MappedFile>(new MappedFile(static_cast<const uint8_t *>(address), length));
+}
+
+MappedFile::~MappedFile()
+{
+    if (address)
+    {
+        ::munmap(const_cast<uint8_t *>(address), length);
+    }
+}
+
+// SegmentFile
+
+std::unique_ptr<SegmentFile> SegmentFile::open(const std::filesystem::path &path)
+{
+    int descriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+
+    if (descriptor < 0)
+    {
+        spdlog::error("Failed to open {}: {}", path.string(), std::strerror(errno));
+        return nullptr;
+    }
+
+    return std::unique_ptr<SegmentFile>(new SegmentFile(descriptor));
+}
+
+SegmentFile::~SegmentFile()
+{
+    ::close(descriptor);
+}
+
+bool SegmentFile::write(size_t offset, std::span<const uint8_t> data)
+{
+    while (!data.empty())
+    {
+        ssize_t written = ::pwrite(descriptor, data.data(), data.size(), static_cast<off_t>(offset));
+
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            spdlog::error("Failed to write segment: {}", std::strerror(errno));
+            return false;
+        }
+
+        offset += static_cast<size_t>(written);
+        data = data.subspan(static_cast<size_t>(written));
+    }
+
+    return true;
+}
+
+bool SegmentFile::resize(size_t size)
+{
+    if (::ftruncate(descriptor, static_cast<off_t>(size)) != 0)
+    {
+        spdlog::error("Failed to resize segment to {} bytes: {}", size, std::strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+bool SegmentFile::sync()
+{
+#ifdef __APPLE__
+    return ::fsync(descriptor) == 0;
+#else
+    return ::fdatasync(descriptor) == 0;
+#endif
+}
+
+size_t SegmentFile::getSize() const
+{
+    struct stat info;
+
+    if (::fstat(descriptor, &info) != 0)
+    {
+        return 0;
+    }
+
+    return static_cast<size_t>(info.st_size);
+}
+
+#else
+
+// The message store needs POSIX mmap and pwrite, it is disabled on Windows
+
+std::shared_ptr<MappedFile> MappedFile::map([[maybe_unused]] const std::filesystem::path &path, [[maybe_unused]] size_t length)
+{
+    return nullptr;
+}
+
+MappedFile::~MappedFile() = default;
+
+std::unique_ptr<SegmentFile> SegmentFile::open([[maybe_unused]] const std::filesystem::path &path)
+{
+    spdlog::error("Segment files are not supported on this platform");
+    return nullptr;
+}
+
+SegmentFile::~SegmentFile() = default;
+
+bool SegmentFile::write([[maybe_unused]] size_t offset, [[maybe_unused]] std::span<const uint8_t> data)
+{
+    return false;
+}
+
+bool SegmentFile::resize([[maybe_unused]] size_t size)
+{
+    return false;
+}
+
+bool SegmentFile::sync()
+{
+    return false;
+}
+
+size_t SegmentFile::getSize() const
+{
+    return 0;
+}
+
+#endif
+
+MappedFile::MappedFile(const uint8_t *address, size_t length)
+    : address(address)
+    , length(length)
+{
+    // Pass
+}
+
+SegmentFile::SegmentFile(int descriptor)
+    : descriptor(descriptor)
+{
+    // Pass
+}
+
+} // namespace bitchat
@@ -0,0 +1,951 @@
+#include "bitchat/storage/message_store.h"
+#include "bitchat/helpers/datetime_helper.h"
+#include "bitchat/helpers/string_helper.h"
+#include "bitchat/protocol/packet_serializer.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <optional>
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
+
+namespace bitchat
+{
+
+namespace
+{
+
+constexpr size_t RECORD_HEADER_SIZE = 16;
+constexpr size_t MIN_SEGMENT_BYTES = 256;
+constexpr const char *SEGMENT_EXTENSION = ".seg";
+constexpr const char *TEMPORARY_EXTENSION = ".tmp";
+
+// CRC-32 (IEEE 802.3), same results as zlib's crc32
+constexpr std::array<uint32_t, 256> makeCrcTable()
+{
+    std::array<uint32_t, 256> table{};
+
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t value = i;
+
+        for (int bit = 0; bit < 8; bit++)
+        {
+            value = (value & 1) ? (0xEDB88320U ^ (value >> 1)) : (value >> 1);
+        }
+
+        table[i] = value;
+    }
+
+    return table;
+}
+
+constexpr std::array<uint32_t, 256> CRC_TABLE = makeCrcTable();
+
+uint32_t crc32(std::span<const uint8_t> data)
+{
+    uint32_t crc = 0xFFFFFFFFU;
+
+    for (uint8_t byte : data)
+    {
+        crc = CRC_TABLE[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+uint64_t readLittleEndian(const uint8_t *data, size_t size)
+{
+    uint64_t value = 0;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+
+    return value;
+}
+
+void writeLittleEndian(uint8_t *data, size_t size, uint64_t value)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        data[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+struct RecordHeader
+{
+    uint32_t length;
+    uint32_t checksum;
+    uint64_t timestamp;
+};
+
+// Header of the record at offset, std::nullopt at the end of the records
+std::optional<RecordHeader> readRecordHeader(std::span<const uint8_t> data, size_t offset)
+{
+    if (offset + RECORD_HEADER_SIZE > data.size())
+    {
+        return std::nullopt;
+    }
+
+    const uint8_t *bytes = data.data() + offset;
+    RecordHeader header;
+    header.length = static_cast<uint32_t>(readLittleEndian(bytes, 4));
+    header.checksum = static_cast<uint32_t>(readLittleEndian(bytes + 4, 4));
+    header.timestamp = readLittleEndian(bytes + 8, 8);
+
+    // Zero length marks the preallocated tail of the active segment
+    if (header.length == 0 || header.length > data.size() - offset - RECORD_HEADER_SIZE)
+    {
+        return std::nullopt;
+    }
+
+    return header;
+}
+
+// The checksum covers the timestamp and the payload, which are contiguous
+bool isRecordIntact(std::span<const uint8_t> data, size_t offset, const RecordHeader &header)
+{
+    return crc32(data.subspan(offset + 8, 8 + header.length)) == header.checksum;
+}
+
+} // namespace
+
+MessageStore::MessageStore(const Options &options)
+    : options(options)
+{
+    this->options.segmentBytes = std::max(options.segmentBytes, MIN_SEGMENT_BYTES);
+    this->options.indexInterval = std::max<size_t>(options.indexInterval, 1);
+}
+
+MessageStore::~MessageStore()
+{
+    flush();
+}
+
+std::shared_ptr<MessageStore> MessageStore::open(const std::filesystem::path &directory)
+{
+    Options options;
+    options.directory = directory;
+
+    return open(options);
+}
+
+std::shared_ptr<MessageStore> MessageStore::open(const Options &options)
+{
+    std::error_code error;
+    std::filesystem::create_directories(options.directory, error);
+
+    if (error)
+    {
+        spdlog::error("Failed to create message store directory {}: {}", options.directory.string(), error.message());
+        return nullptr;
+    }
+
+    std::shared_ptr<MessageStore> store(new MessageStore(options));
+
+    if (!store->load())
+    {
+        return nullptr;
+    }
+
+    return store;
+}
+
+// Appending
+
+std::optional<uint64_t> MessageStore::append(const std::string &conversation, const BitchatMessage &message, uint64_t timestamp)
+{
+    PacketSerializer serializer;
+    return appendPayload(conversation, serializer.makeMessagePayload(message), timestamp);
+}
+
+std::optional<uint64_t> MessageStore::appendPayload(const std::string &conversation, std::span<const uint8_t> payload, uint64_t timestamp)
+{
+    size_t recordSize = RECORD_HEADER_SIZE + payload.size();
+
+    if (payload.empty() || recordSize > options.segmentBytes)
+    {
+        spdlog::warn("Not storing message of {} bytes in {}", payload.size(), conversation);
+        return std::nullopt;
+    }
+
+    if (timestamp == 0)
+    {
+        timestamp = DateTimeHelper::getCurrentTimestamp();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Conversation *target = findConversation(conversation);
+
+    if (!target && !(target = createConversation(conversation)))
+    {
+        return std::nullopt;
+    }
+
+    // Timestamps never go backwards, range scans rely on it
+    timestamp = std::max(timestamp, target->lastTimestamp);
+
+    Segment *segment = prepareActiveSegment(*target, recordSize, timestamp);
+
+    if (!segment)
+    {
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> record(recordSize);
+    writeLittleEndian(record.data(), 4, payload.size());
+    writeLittleEndian(record.data() + 8, 8, timestamp);
+    std::memcpy(record.data() + RECORD_HEADER_SIZE, payload.data(), payload.size());
+    writeLittleEndian(record.data() + 4, 4, crc32(std::span<const uint8_t>(record).subspan(8)));
+
+    if (!segment->file->write(segment->size, record))
+    {
+        return std::nullopt;
+    }
+
+    addIndexEntry(*segment, options.indexInterval, timestamp, segment->baseSequence + segment->count, segment->size);
+
+    if (segment->count == 0)
+    {
+        segment->firstTimestamp = timestamp;
+    }
+
+    segment->lastTimestamp = timestamp;
+    segment->count++;
+    segment->size += recordSize;
+    target->lastTimestamp = timestamp;
+
+    return segment->baseSequence + segment->count - 1;
+}
+
+// Reading
+
+size_t MessageStore::scan(const std::string &conversation, uint64_t from, uint64_t to, const RecordCallback &callback) const
+{
+    std::vector<ReadRange> ranges;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        const Conversation *source = findConversation(conversation);
+
+        if (!source)
+        {
+            return 0;
+        }
+
+        for (const auto &segment : source->segments)
+        {
+            if (segment->count == 0 || segment->lastTimestamp < from)
+            {
+                continue;
+            }
+
+            if (segment->firstTimestamp > to)
+            {
+                break;
+            }
+
+            // Start at the last index entry before from, equal timestamps may span entries
+            // clang-format off
+            auto it = std::lower_bound(segment->index.begin(), segment->index.end(), from, [](const IndexEntry &entry, uint64_t value) {
+                return entry.timestamp < value;
+            });
+            // clang-format on
+
+            const IndexEntry &start = it == segment->index.begin() ? *it : *(it - 1);
+            ranges.push_back({segment->mapping, start.offset, segment->size, start.sequence});
+        }
+    }
+
+    return walk(ranges, 0, from, to, callback);
+}
+
+size_t MessageStore::scanFrom(const std::string &conversation, uint64_t sequence, const RecordCallback &callback) const
+{
+    std::vector<ReadRange> ranges;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        const Conversation *source = findConversation(conversation);
+
+        if (!source)
+        {
+            return 0;
+        }
+
+        for (const auto &segment : source->segments)
+        {
+            if (segment->count == 0 || segment->baseSequence + segment->count <= sequence)
+            {
+                continue;
+            }
+
+            // Last index entry at or before sequence
+            // clang-format off
+            auto it = std::upper_bound(segment->index.begin(), segment->index.end(), sequence, [](uint64_t value, const IndexEntry &entry) {
+                return value < entry.sequence;
+            });
+            // clang-format on
+
+            const IndexEntry &start = it == segment->index.begin() ? *it : *(it - 1);
+            ranges.push_back({segment->mapping, start.offset, segment->size, start.sequence});
+        }
+    }
+
+    return walk(ranges, sequence, 0, LATEST, callback);
+}
+
+std::vector<BitchatMessage> MessageStore::loadRange(const std::string &conversation, uint64_t from, uint64_t to) const
+{
+    PacketSerializer serializer;
+    std::vector<BitchatMessage> messages;
+
+    // clang-format off
+    scan(conversation, from, to, [&](const StoredRecord &record) {
+        if (auto view = serializer.parseMessageView(record.payload))
+        {
+            messages.push_back(view->toMessage());
+        }
+
+        return true;
+    });
+    // clang-format on
+
+    return messages;
+}
+
+std::vector<BitchatMessage> MessageStore::loadLatest(const std::string &conversation, size_t count) const
+{
+    uint64_t first = getFirstSequence(conversation);
+    uint64_t end = getEndSequence(conversation);
+    uint64_t start = end - std::min<uint64_t>(count, end - first);
+
+    PacketSerializer serializer;
+    std::vector<BitchatMessage> messages;
+    messages.reserve(end - start);
+
+    // clang-format off
+    scanFrom(conversation, start, [&](const StoredRecord &record) {
+        if (auto view = serializer.parseMessageView(record.payload))
+        {
+            messages.push_back(view->toMessage());
+        }
+
+        return messages.size() < count;
+    });
+    // clang-format on
+
+    return messages;
+}
+
+std::vector<std::string> MessageStore::getConversations() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<std::string> names;
+    names.reserve(conversations.size());
+
+    for (const auto &[name, conversation] : conversations)
+    {
+        names.push_back(name);
+    }
+
+    return names;
+}
+
+uint64_t MessageStore::getFirstSequence(const std::string &conversation) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const Conversation *source = findConversation(conversation);
+
+    if (!source || source->segments.empty())
+    {
+        return 0;
+    }
+
+    return source->segments.front()->baseSequence;
+}
+
+uint64_t MessageStore::getEndSequence(const std::string &conversation) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const Conversation *source = findConversation(conversation);
+
+    if (!source || source->segments.empty())
+    {
+        return 0;
+    }
+
+    const Segment &last = *source->segments.back();
+    return last.baseSequence + last.count;
+}
+
+size_t MessageStore::getSegmentCount(const std::string &conversation) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const Conversation *source = findConversation(conversation);
+    return source ? source->segments.size() : 0;
+}
+
+// Maintenance
+
+void MessageStore::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (auto &[name, conversation] : conversations)
+    {
+        if (!conversation.segments.empty() && conversation.segments.back()->file)
+        {
+            conversation.segments.back()->file->sync();
+        }
+    }
+}
+
+void MessageStore::compact()
+{
+    std::lock_guard<std::mutex> compactLock(compactMutex);
+
+    uint64_t now = DateTimeHelper::getCurrentTimestamp();
+    std::vector<std::string> names;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (auto &[name, conversation] : conversations)
+        {
+            applyRetention(conversation, now);
+            names.push_back(name);
+        }
+    }
+
+    // Merging copies segment data, it runs without holding the store lock
+    for (const auto &name : names)
+    {
+        mergeSegments(name);
+    }
+}
+
+void MessageStore::applyRetention(Conversation &conversation, uint64_t now)
+{
+    auto &segments = conversation.segments;
+    uint64_t retention = static_cast<uint64_t>(options.retention.count());
+
+    // An idle active segment is sealed once it is old enough, so it can expire or be merged
+    if (!segments.empty() && segments.back()->file && segments.back()->count > 0 && now - std::min(now, segments.back()->firstTimestamp) >= static_cast<uint64_t>(options.segmentDuration.count()))
+    {
+        sealSegment(*segments.back());
+    }
+
+    size_t totalBytes = 0;
+
+    for (const auto &segment : segments)
+    {
+        totalBytes += segment->size;
+    }
+
+    // Oldest sealed segments first, the active segment always stays
+    while (!segments.empty() && !segments.front()->file)
+    {
+        const Segment &oldest = *segments.front();
+        bool expired = now - std::min(now, oldest.lastTimestamp) > retention;
+        bool oversized = totalBytes > options.maxConversationBytes;
+
+        if (!expired && !oversized)
+        {
+            break;
+        }
+
+        spdlog::debug("Dropping message segment {} ({} records, {})", oldest.path.string(), oldest.count, expired ? "expired" : "over size limit");
+
+        std::error_code error;
+        std::filesystem::remove(oldest.path, error);
+        totalBytes -= oldest.size;
+        segments.erase(segments.begin());
+    }
+}
+
+void MessageStore::mergeSegments(const std::string &name)
+{
+    struct Source
+    {
+        std::filesystem::path path;
+        std::shared_ptr<MappedFile> mapping;
+        size_t size;
+    };
+
+    while (true)
+    {
+        std::vector<Source> sources;
+        uint64_t baseSequence = 0;
+        size_t totalBytes = 0;
+
+        // Find the first run of adjacent sealed segments that fits in one segment
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            Conversation *conversation = findConversation(name);
+
+            if (!conversation)
+            {
+                return;
+            }
+
+            const auto &segments = conversation->segments;
+
+            for (size_t i = 0; i < segments.size() && !segments[i]->file && sources.size() < 2; i++)
+            {
+                sources.clear();
+                totalBytes = 0;
+                baseSequence = segments[i]->baseSequence;
+
+                for (size_t j = i; j < segments.size() && !segments[j]->file && totalBytes + segments[j]->size <= options.segmentBytes; j++)
+                {
+                    sources.push_back({segments[j]->path, segments[j]->mapping, segments[j]->size});
+                    totalBytes += segments[j]->size;
+                }
+            }
+        }
+
+        if (sources.size() < 2)
+        {
+            return;
+        }
+
+        // Sealed segments never change, write the merged copy next to them and swap it in
+        std::filesystem::path mergedPath = sources.front().path;
+        std::filesystem::path temporaryPath = mergedPath;
+        temporaryPath += TEMPORARY_EXTENSION;
+
+        auto file = SegmentFile::open(temporaryPath);
+        bool written = file != nullptr;
+        size_t offset = 0;
+
+        for (const auto &source : sources)
+        {
+            written = written && file->write(offset, source.mapping->getData().first(source.size));
+            offset += source.size;
+        }
+
+        written = written && file->sync();
+        file.reset();
+
+        std::error_code error;
+
+        if (written)
+        {
+            // Atomic replace, a crash before the sources are removed leaves overlapping segments that load() drops
+            std::filesystem::rename(temporaryPath, mergedPath, error);
+        }
+
+        std::shared_ptr<MappedFile> mapping = written && !error ? MappedFile::map(mergedPath, totalBytes) : nullptr;
+
+        if (!mapping)
+        {
+            spdlog::error("Failed to merge message segments into {}", mergedPath.string());
+            std::filesystem::remove(temporaryPath, error);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            Conversation *conversation = findConversation(name);
+
+            if (!conversation)
+            {
+                return;
+            }
+
+            auto &segments = conversation->segments;
+
+            // clang-format off
+            auto first = std::find_if(segments.begin(), segments.end(), [baseSequence](const std::unique_ptr<Segment> &segment) {
+                return segment->baseSequence == baseSequence;
+            });
+            // clang-format on
+
+            auto merged = std::make_unique<Segment>();
+            merged->path = mergedPath;
+            merged->baseSequence = baseSequence;
+            merged->firstTimestamp = (*first)->firstTimestamp;
+            merged->mapping = mapping;
+
+            // Index entries keep their sequence, offsets move by the bytes merged before them
+            for (auto it = first; it != first + static_cast<std::ptrdiff_t>(sources.size()); ++it)
+            {
+                for (const auto &entry : (*it)->index)
+                {
+                    merged->index.push_back({entry.timestamp, entry.sequence, entry.offset + merged->size});
+                }
+
+                merged->count += (*it)->count;
+                merged->lastTimestamp = (*it)->lastTimestamp;
+                merged->size += (*it)->size;
+            }
+
+            *first = std::move(merged);
+            segments.erase(first + 1, first + static_cast<std::ptrdiff_t>(sources.size()));
+        }
+
+        for (size_t i = 1; i < sources.size(); i++)
+        {
+            std::filesystem::remove(sources[i].path, error);
+        }
+
+        spdlog::debug("Merged {} message segments into {}", sources.size(), mergedPath.string());
+    }
+}
+
+// Loading and recovery
+
+bool MessageStore::load()
+{
+    std::error_code error;
+
+    for (const auto &entry : std::filesystem::directory_iterator(options.directory, error))
+    {
+        std::string directory = entry.path().filename().string();
+
+        if (!entry.is_directory() || directory.empty() || directory[0] != 'c' || (directory.size() > 1 && !StringHelper::isHex(directory.substr(1))))
+        {
+            continue;
+        }
+
+        std::string name((directory.size() - 1) / 2, '\0');
+        StringHelper::fromHex(std::string_view(directory).substr(1), std::span<uint8_t>(reinterpret_cast<uint8_t *>(name.data()), name.size()));
+
+        if (!loadConversation(name, entry.path()))
+        {
+            return false;
+        }
+    }
+
+    if (error)
+    {
+        spdlog::error("Failed to read message store directory {}: {}", options.directory.string(), error.message());
+        return false;
+    }
+
+    spdlog::info("Message store opened with {} conversations", conversations.size());
+
+    return true;
+}
+
+bool MessageStore::loadConversation(const std::string &name, const std::filesystem::path &directory)
+{
+    std::vector<std::pair<uint64_t, std::filesystem::path>> files;
+    std::error_code error;
+
+    for (const auto &entry : std::filesystem::directory_iterator(directory, error))
+    {
+        const std::filesystem::path &path = entry.path();
+
+        // Leftover of an interrupted merge
+        if (path.extension() == TEMPORARY_EXTENSION)
+        {
+            std::filesystem::remove(path, error);
+            continue;
+        }
+
+        std::string stem = path.stem().string();
+        uint64_t baseSequence = 0;
+        auto [end, result] = std::from_chars(stem.data(), stem.data() + stem.size(), baseSequence);
+
+        if (path.extension() == SEGMENT_EXTENSION && result == std::errc() && end == stem.data() + stem.size())
+        {
+            files.emplace_back(baseSequence, path);
+        }
+    }
+
+    std::sort(files.begin(), files.end());
+
+    Conversation conversation;
+    conversation.directory = directory;
+
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        const auto &[baseSequence, path] = files[i];
+        bool last = i + 1 == files.size();
+
+        // A merge replaced this segment's records but was interrupted before removing it
+        if (!conversation.segments.empty() && baseSequence < conversation.segments.back()->baseSequence + conversation.segments.back()->count)
+        {
+            spdlog::warn("Removing message segment {} left over from a merge", path.string());
+            std::filesystem::remove(path, error);
+            continue;
+        }
+
+        auto segment = recoverSegment(path, baseSequence, last);
+
+        if (!segment)
+        {
+            return false;
+        }
+
+        if (segment->count == 0 && !segment->file)
+        {
+            std::filesystem::remove(path, error);
+            continue;
+        }
+
+        conversation.lastTimestamp = std::max(conversation.lastTimestamp, segment->lastTimestamp);
+        conversation.segments.push_back(std::move(segment));
+    }
+
+    conversations.emplace(name, std::move(conversation));
+
+    return true;
+}
+
+std::unique_ptr<MessageStore::Segment> MessageStore::recoverSegment(const std::filesystem::path &path, uint64_t baseSequence, bool active)
+{
+    std::error_code error;
+    size_t fileSize = std::filesystem::file_size(path, error);
+
+    if (error)
+    {
+        spdlog::error("Failed to read message segment {}: {}", path.string(), error.message());
+        return nullptr;
+    }
+
+    auto mapping = MappedFile::map(path, fileSize);
+
+    if (!mapping)
+    {
+        return nullptr;
+    }
+
+    auto segment = std::make_unique<Segment>();
+    segment->path = path;
+    segment->baseSequence = baseSequence;
+
+    // Every record is checked, the first torn or corrupt one ends the segment
+    std::span<const uint8_t> data = mapping->getData();
+    size_t offset = 0;
+
+    while (auto header = readRecordHeader(data, offset))
+    {
+        if (!isRecordIntact(data, offset, *header) || header->timestamp < segment->lastTimestamp)
+        {
+            break;
+        }
+
+        addIndexEntry(*segment, options.indexInterval, header->timestamp, baseSequence + segment->count, offset);
+
+        if (segment->count == 0)
+        {
+            segment->firstTimestamp = header->timestamp;
+        }
+
+        segment->lastTimestamp = header->timestamp;
+        segment->count++;
+        offset += RECORD_HEADER_SIZE + header->length;
+    }
+
+    segment->size = offset;
+    mapping.reset();
+
+    if (active && segment->size + RECORD_HEADER_SIZE < options.segmentBytes)
+    {
+        // Appends continue where the valid records end
+        if (activateSegment(*segment))
+        {
+            return segment;
+        }
+    }
+
+    if (fileSize != segment->size)
+    {
+        if (!active)
+        {
+            spdlog::warn("Message segment {} has {} bytes after its last valid record, truncating", path.string(), fileSize - segment->size);
+        }
+
+        auto file = SegmentFile::open(path);
+
+        if (!file || !file->resize(segment->size))
+        {
+            return nullptr;
+        }
+    }
+
+    segment->mapping = MappedFile::map(path, segment->size);
+
+    return segment->mapping ? std::move(segment) : nullptr;
+}
+
+bool MessageStore::activateSegment(Segment &segment)
+{
+    auto file = SegmentFile::open(segment.path);
+
+    // Shrinking first zeroes everything after the valid records, stale bytes there must never parse as records
+    if (!file || !file->resize(segment.size) || !file->resize(options.segmentBytes))
+    {
+        return false;
+    }
+
+    auto mapping = MappedFile::map(segment.path, options.segmentBytes);
+
+    if (!mapping)
+    {
+        return false;
+    }
+
+    segment.file = std::move(file);
+    segment.mapping = mapping;
+
+    return true;
+}
+
+void MessageStore::sealSegment(Segment &segment)
+{
+    if (!segment.file)
+    {
+        return;
+    }
+
+    // Readers only look below the valid size, so the larger mapping they may hold stays safe
+    segment.file->resize(segment.size);
+    segment.file->sync();
+    segment.file.reset();
+
+    if (auto mapping = MappedFile::map(segment.path, segment.size))
+    {
+        segment.mapping = mapping;
+    }
+}
+
+MessageStore::Segment *MessageStore::prepareActiveSegment(Conversation &conversation, size_t recordSize, uint64_t timestamp)
+{
+    Segment *last = conversation.segments.empty() ? nullptr : conversation.segments.back().get();
+
+    if (last && last->file)
+    {
+        bool full = last->size + recordSize > options.segmentBytes;
+        bool expired = last->count > 0 && timestamp - last->firstTimestamp >= static_cast<uint64_t>(options.segmentDuration.count());
+
+        if (!full && !expired)
+        {
+            return last;
+        }
+
+        sealSegment(*last);
+    }
+
+    auto segment = std::make_unique<Segment>();
+    segment->baseSequence = last ? last->baseSequence + last->count : 0;
+    segment->path = segmentPath(conversation.directory, segment->baseSequence);
+
+    if (!activateSegment(*segment))
+    {
+        spdlog::error("Failed to create message segment {}", segment->path.string());
+        return nullptr;
+    }
+
+    conversation.segments.push_back(std::move(segment));
+
+    return conversation.segments.back().get();
+}
+
+// Helpers
+
+MessageStore::Conversation *MessageStore::findConversation(const std::string &name)
+{
+    auto it = conversations.find(name);
+    return it != conversations.end() ? &it->second : nullptr;
+}
+
+const MessageStore::Conversation *MessageStore::findConversation(const std::string &name) const
+{
+    auto it = conversations.find(name);
+    return it != conversations.end() ? &it->second : nullptr;
+}
+
+MessageStore::Conversation *MessageStore::createConversation(const std::string &name)
+{
+    std::filesystem::path directory = options.directory / directoryName(name);
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    if (error)
+    {
+        spdlog::error("Failed to create conversation directory {}: {}", directory.string(), error.message());
+        return nullptr;
+    }
+
+    Conversation conversation;
+    conversation.directory = directory;
+
+    return &conversations.emplace(name, std::move(conversation)).first->second;
+}
+
+size_t MessageStore::walk(const std::vector<ReadRange> &ranges, uint64_t sequence, uint64_t from, uint64_t to, const RecordCallback &callback)
+{
+    size_t visited = 0;
+
+    for (const auto &range : ranges)
+    {
+        std::span<const uint8_t> data = range.mapping->getData().first(range.end);
+        size_t offset = range.begin;
+        uint64_t current = range.sequence;
+
+        while (auto header = readRecordHeader(data, offset))
+        {
+            std::span<const uint8_t> payload = data.subspan(offset + RECORD_HEADER_SIZE, header->length);
+            offset += RECORD_HEADER_SIZE + header->length;
+
+            if (current++ < sequence || header->timestamp < from)
+            {
+                continue;
+            }
+
+            if (header->timestamp > to)
+            {
+                return visited;
+            }
+
+            visited++;
+
+            if (!callback(StoredRecord{current - 1, header->timestamp, payload}))
+            {
+                return visited;
+            }
+        }
+    }
+
+    return visited;
+}
+
+void MessageStore::addIndexEntry(Segment &segment, size_t interval, uint64_t timestamp, uint64_t sequence, size_t offset)
+{
+    if (segment.count % interval == 0)
+    {
+        segment.index.push_back({timestamp, sequence, offset});
+    }
+}
+
+std::string MessageStore::directoryName(const std::string &conversation)
+{
+    // Channel names are not safe as file names, the hex form is
+    std::string name = "c";
+    StringHelper::appendHex(name, std::span<const uint8_t>(reinterpret_cast<const uint8_t *>(conversation.data()), conversation.size()));
+
+    return name;
+}
+
+std::filesystem::path MessageStore::segmentPath(const std::filesystem::path &directory, uint64_t baseSequence)
+{
+    return directory / fmt::format("{:020}{}", baseSequence, SEGMENT_EXTENSION);
+}
+
+} // namespace bitchat
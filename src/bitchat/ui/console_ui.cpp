@@ -1,6 +1,8 @@
 #include "bitchat/ui/console_ui.h"
 #include "bitchat/core/bitchat_data.h"
 #include "bitchat/core/bitchat_manager.h"
+#include "bitchat/helpers/datetime_helper.h"
+#include "bitchat/protocol/compression_stats.h"
 #include <chrono>
 #include <iostream>
 #include <spdlog/sinks/stdout_color_sinks.h>
@@ -140,14 +142,16 @@ void ConsoleUserInterface::onStatusUpdate(const std::string &status)
 
 void ConsoleUserInterface::showPeers()
 {
-    auto peers = BitchatData::shared()->getPeers();
+    PeerTable::Snapshot peers = BitchatData::shared()->getPeersSnapshot();
     showChatMessage("People online:");
 
     time_t now = time(nullptr);
     bool found = false;
 
-    for (const auto &peer : peers)
+    for (const auto &entry : peers.getPeers())
     {
+        const BitchatPeer &peer = *entry;
+
         // Show all peers that have been seen recently (within 3 minutes)
         if ((now - peer.getLastSeen()) < 180)
         {
@@ -193,6 +197,59 @@ void ConsoleUserInterface::showStatus()
     {
         showChatMessageInfo(fmt::format("Status: In channel '{}'", currentChannel));
     }
+
+    size_t unread = BitchatData::shared()->getTotalUnreadPrivateCount();
+
+    if (unread > 0)
+    {
+        showChatMessageInfo(fmt::format("Unread private messages: {}", unread));
+    }
+}
+
+void ConsoleUserInterface::showSearchResults(const std::string &query)
+{
+    std::vector<BitchatMessage> results = messageService->searchMessages(query);
+
+    if (results.empty())
+    {
+        showChatMessageInfo("No messages found");
+        return;
+    }
+
+    showChatMessage(fmt::format("Found {} messages:", results.size()));
+
+    // Results are newest first, show them in reading order
+    for (auto it = results.rbegin(); it != results.rend(); ++it)
+    {
+        showChatMessage(fmt::format("[{}] {}: {}", DateTimeHelper::formatTimestamp(it->getTimestamp()), it->getSender(), it->getDisplayContent()));
+    }
+}
+
+void ConsoleUserInterface::showStats()
+{
+    SigningStats signing = manager->getCryptoService()->getSigningStats();
+    showChatMessageInfo(fmt::format("Signing: {} signatures, {} failures, {:.1f} us average", signing.signatures, signing.failures, signing.getAverageMicroseconds()));
+
+    SignatureVerifier::Stats verifier = messageService->getSignatureStats();
+    showChatMessageInfo(fmt::format("Signature checks: {} verified, {} rejected, {} cached, {} dropped", verifier.verified, verifier.rejected, verifier.cacheHits, verifier.dropped));
+
+    RateLimiter::Stats rateLimit = messageService->getRateLimitStats();
+    showChatMessageInfo(fmt::format("Rate limit: {} allowed, {} limited by peer, {} by link, {} globally", rateLimit.allowed, rateLimit.limitedPeer, rateLimit.limitedLink, rateLimit.limitedGlobal));
+
+    showChatMessageInfo("Compression:");
+
+    // Only the packet types that went through the compression stage
+    for (int type = 0; type < 256; type++)
+    {
+        CompressionTypeStats compression = CompressionStats::shared().getStats(static_cast<uint8_t>(type));
+
+        if (compression.packets == 0)
+        {
+            continue;
+        }
+
+        showChatMessage(fmt::format("  {}: {} packets, {} compressed, {} skipped, ratio {:.2f}", BitchatPacket::getTypeString(static_cast<uint8_t>(type)), compression.packets, compression.compressed, compression.skipped, compression.getRatio()));
+    }
 }
 
 void ConsoleUserInterface::showHelp()
@@ -202,6 +259,8 @@ void ConsoleUserInterface::showHelp()
     showChatMessage("/nick NICK     - Change nickname");
     showChatMessage("/w             - Show people online in current channel");
     showChatMessage("/status        - Show current channel status");
+    showChatMessage("/search QUERY  - Search channel history (from:NICK, since:30m, until:1d)");
+    showChatMessage("/stats         - Show signing, compression and rate limit counters");
     showChatMessage("/clear         - Clear screen");
     showChatMessage("/help          - Show this help");
     showChatMessage("/exit          - Exit");
@@ -280,6 +339,14 @@ void ConsoleUserInterface::start()
             {
                 showStatus();
             }
+            else if (line.rfind("/search ", 0) == 0)
+            {
+                showSearchResults(line.substr(8));
+            }
+            else if (line == "/stats")
+            {
+                showStats();
+            }
             else if (line == "/clear")
             {
                 clearChat();
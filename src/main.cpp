@@ -1,3 +1,4 @@
+#include "bitchat/core/bitchat_data.h"
 #include "bitchat/core/bitchat_manager.h"
 #include "bitchat/platform/bluetooth_factory.h"
 #include "bitchat/platform/bluetooth_interface.h"
@@ -42,6 +43,16 @@ int main()
 
     spdlog::set_default_logger(logger);
 
+    // Open the message store, history stays in memory only without it
+    if (auto messageStore = bitchat::MessageStore::open(bitchat::constants::MESSAGE_STORE_DIRECTORY))
+    {
+        bitchat::BitchatData::shared()->setMessageStore(messageStore);
+    }
+    else
+    {
+        spdlog::warn("Message store unavailable, history will not be persisted");
+    }
+
     // Create bluetooth network interface
     auto bluetoothNetworkInterface = createBluetoothNetworkInterface();
 
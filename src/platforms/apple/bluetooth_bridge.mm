@@ -1,6 +1,8 @@
 #include "platforms/apple/bluetooth_bridge.h"
 #include "bitchat/protocol/packet_serializer.h"
 #include "platforms/apple/bluetooth.h"
+#include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -44,17 +46,19 @@ AppleBluetoothNetworkBridge::AppleBluetoothNetworkBridge()
         [impl setPacketReceivedCallback:^(NSData *packetData, NSString *peripheralID) {
             if (packetReceivedCallback)
             {
-                // Convert NSData to std::vector<uint8_t> for C++ processing
-                std::vector<uint8_t> data((uint8_t *)packetData.bytes,
-                                          (uint8_t *)packetData.bytes + packetData.length);
+                // Parse the packet in place, NSData stays alive for the duration of the callback
+                std::span<const uint8_t> data(static_cast<const uint8_t *>(packetData.bytes), packetData.length);
+                std::optional<PacketView> packet = serializer->parsePacketView(data);
 
-                // Deserialize the raw data into a BitchatPacket object
-                BitchatPacket packet = serializer->deserializePacket(data);
+                if (!packet)
+                {
+                    return;
+                }
 
                 // Convert NSString to std::string for C++
                 std::string cppUUID = peripheralID ? [peripheralID UTF8String] : "";
 
-                packetReceivedCallback(packet, cppUUID);
+                packetReceivedCallback(*packet, cppUUID);
             }
         }];
 
@@ -117,8 +121,9 @@ bool AppleBluetoothNetworkBridge::sendPacket(const BitchatPacket &packet)
         return false;
     }
 
-    // Serialize C++ packet to raw bytes
-    std::vector<uint8_t> data = serializer->serializePacket(packet);
+    // Serialize C++ packet into a per-thread buffer, reused across sends
+    thread_local OutputBuffer data;
+    serializer->serializeInto(packet, data);
 
     // Convert to NSData for Objective-C
     NSData *nsData = [NSData dataWithBytes:data.data() length:data.size()];
@@ -134,8 +139,9 @@ bool AppleBluetoothNetworkBridge::sendPacketToPeer(const BitchatPacket &packet,
         return false;
     }
 
-    // Serialize C++ packet to raw bytes
-    std::vector<uint8_t> data = serializer->serializePacket(packet);
+    // Serialize C++ packet into a per-thread buffer, reused across sends
+    thread_local OutputBuffer data;
+    serializer->serializeInto(packet, data);
 
     // Convert to NSData for Objective-C
     NSData *nsData = [NSData dataWithBytes:data.data() length:data.size()];
@@ -154,8 +160,9 @@ bool AppleBluetoothNetworkBridge::sendPacketToPeripheral(const BitchatPacket &pa
         return false;
     }
 
-    // Serialize C++ packet to raw bytes
-    std::vector<uint8_t> data = serializer->serializePacket(packet);
+    // Serialize C++ packet into a per-thread buffer, reused across sends
+    thread_local OutputBuffer data;
+    serializer->serializeInto(packet, data);
 
     // Convert to NSData for Objective-C
     NSData *nsData = [NSData dataWithBytes:data.data() length:data.size()];
@@ -167,6 +174,23 @@ bool AppleBluetoothNetworkBridge::sendPacketToPeripheral(const BitchatPacket &pa
     return [impl sendPacket:nsData toPeripheralID:nsPeripheralID];
 }
 
+bool AppleBluetoothNetworkBridge::sendFrameToPeer(const SharedFrame &frame, const std::string &peerID)
+{
+    if (!impl || !frame)
+    {
+        return false;
+    }
+
+    // Convert to NSData for Objective-C
+    NSData *nsData = [NSData dataWithBytes:frame->data() length:frame->size()];
+
+    // Convert std::string to NSString for Objective-C
+    NSString *nsPeerID = [NSString stringWithUTF8String:peerID.c_str()];
+
+    // Forward to Objective-C implementation
+    return [impl sendPacket:nsData toPeer:nsPeerID];
+}
+
 bool AppleBluetoothNetworkBridge::isReady() const
 {
     if (!impl)
@@ -1,4 +1,6 @@
 #include "platforms/linux/bluetooth.h"
+#include "bitchat/core/constants.h"
+#include "bitchat/protocol/message_padding.h"
 #include "bitchat/protocol/packet.h"
 #include "bitchat/protocol/packet_serializer.h"
 #include <algorithm>
@@ -8,12 +10,17 @@
 #include <bluetooth/rfcomm.h>
 #include <bluetooth/sdp.h>
 #include <bluetooth/sdp_lib.h>
+#include <cerrno>
 #include <chrono>
+#include <climits>
 #include <cstring>
 #include <iostream>
+#include <optional>
+#include <span>
 #include <spdlog/spdlog.h>
 #include <stdexcept>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 namespace bitchat
@@ -28,6 +35,8 @@ LinuxBluetoothNetwork::LinuxBluetoothNetwork()
     , peerConnectedCallback(nullptr)
     , peerDisconnectedCallback(nullptr)
     , peripheralDiscoveredCallback(nullptr)
+    , flushDeadlineMicros(constants::BLE_SEND_FLUSH_DEADLINE.count())
+    , flushByteBudget(constants::BLE_SEND_FLUSH_BYTE_BUDGET)
 {
     deviceID = hci_get_route(nullptr);
 
@@ -100,6 +109,19 @@ void LinuxBluetoothNetwork::stop()
         acceptThread.join();
     }
 
+    // Flush and join the writers before their sockets are closed
+    std::map<std::string, std::shared_ptr<PeerSendQueue>> queues;
+
+    {
+        std::lock_guard<std::mutex> lock(socketsMutex);
+        queues.swap(sendQueues);
+    }
+
+    for (auto const &[key, queue] : queues)
+    {
+        closeSendQueue(queue);
+    }
+
     std::lock_guard<std::mutex> lock(socketsMutex);
     for (auto const &[key, val] : connectedSockets)
     {
@@ -113,27 +135,31 @@ void LinuxBluetoothNetwork::stop()
 
 bool LinuxBluetoothNetwork::sendPacket(const BitchatPacket &packet)
 {
-    PacketSerializer serializer;
-    std::vector<uint8_t> data = serializer.serializePacket(packet);
-    std::lock_guard<std::mutex> lock(socketsMutex);
+    // One serialized frame is shared by every peer queue
+    SharedFrame frame = makeFrame(packet);
+    std::vector<std::pair<std::string, std::shared_ptr<PeerSendQueue>>> queues;
+
+    {
+        std::lock_guard<std::mutex> lock(socketsMutex);
+        queues.assign(sendQueues.begin(), sendQueues.end());
+    }
 
-    if (connectedSockets.empty())
+    if (queues.empty())
     {
         spdlog::warn("No connected peers to send packet to.");
         return false;
     }
 
     bool sentToAny = false;
-    for (auto const &[key, val] : connectedSockets)
+    for (auto const &[key, queue] : queues)
     {
-        if (write(val, data.data(), data.size()) < 0)
+        if (!enqueueFrame(*queue, frame))
         {
-            spdlog::error("Failed to write to socket for peer {}: {}", key, strerror(errno));
             // Don't return false here, try to send to other peers
             continue;
         }
 
-        spdlog::debug("Sent packet to peer: {}", key);
+        spdlog::debug("Queued packet for peer: {}", key);
         sentToAny = true;
     }
 
@@ -142,32 +168,58 @@ bool LinuxBluetoothNetwork::sendPacket(const BitchatPacket &packet)
 
 bool LinuxBluetoothNetwork::sendPacketToPeer(const BitchatPacket &packet, const std::string &peerID)
 {
-    PacketSerializer serializer;
-    std::vector<uint8_t> data = serializer.serializePacket(packet);
-    std::lock_guard<std::mutex> lock(socketsMutex);
-    auto it = connectedSockets.find(peerID);
+    return sendFrameToPeer(makeFrame(packet), peerID);
+}
 
-    if (it != connectedSockets.end())
+bool LinuxBluetoothNetwork::sendPacketToPeripheral(const BitchatPacket &packet, const std::string &peripheralID)
+{
+    // In Linux implementation, peripheralID is the same as peerID (device address)
+    // So we can reuse the sendPacketToPeer implementation
+    return sendPacketToPeer(packet, peripheralID);
+}
+
+bool LinuxBluetoothNetwork::sendFrameToPeer(const SharedFrame &frame, const std::string &peerID)
+{
+    if (!frame)
     {
-        if (write(it->second, data.data(), data.size()) < 0)
+        return false;
+    }
+
+    std::shared_ptr<PeerSendQueue> queue;
+
+    {
+        std::lock_guard<std::mutex> lock(socketsMutex);
+        auto it = sendQueues.find(peerID);
+
+        if (it != sendQueues.end())
         {
-            spdlog::error("Failed to write to socket for peer {}: {}", peerID, strerror(errno));
-            return false;
+            queue = it->second;
         }
-        spdlog::debug("Sent packet to specific peer: {}", peerID);
-        return true;
     }
 
-    spdlog::warn("Peer {} not found in connected sockets.", peerID);
+    if (!queue)
+    {
+        spdlog::warn("Peer {} not found in connected sockets.", peerID);
+        return false;
+    }
 
-    return false;
+    if (!enqueueFrame(*queue, frame))
+    {
+        return false;
+    }
+
+    spdlog::debug("Queued frame for specific peer: {}", peerID);
+    return true;
 }
 
-bool LinuxBluetoothNetwork::sendPacketToPeripheral(const BitchatPacket &packet, const std::string &peripheralID)
+void LinuxBluetoothNetwork::setFlushDeadline(std::chrono::microseconds deadline)
 {
-    // In Linux implementation, peripheralID is the same as peerID (device address)
-    // So we can reuse the sendPacketToPeer implementation
-    return sendPacketToPeer(packet, peripheralID);
+    flushDeadlineMicros = std::max<int64_t>(deadline.count(), 0);
+}
+
+void LinuxBluetoothNetwork::setFlushByteBudget(size_t bytes)
+{
+    flushByteBudget = bytes;
 }
 
 bool LinuxBluetoothNetwork::isReady() const
@@ -253,6 +305,7 @@ void LinuxBluetoothNetwork::scanThreadFunc()
             {
                 std::lock_guard<std::mutex> lock(socketsMutex);
                 connectedSockets[deviceID] = s;
+                openSendQueue(deviceID, s);
                 spdlog::info("Connected to device: {}", deviceID);
 
                 // Notify about peer connection
@@ -338,6 +391,7 @@ void LinuxBluetoothNetwork::acceptThreadFunc()
 
         std::lock_guard<std::mutex> lock(socketsMutex);
         connectedSockets[deviceID] = client;
+        openSendQueue(deviceID, client);
         spdlog::info("Accepted connection from device: {}", deviceID);
 
         // Notify about peer connection
@@ -365,6 +419,7 @@ void LinuxBluetoothNetwork::readerThreadFunc(const std::string &deviceID, int so
     std::vector<uint8_t> accumulatedData;
     PacketSerializer serializer;
     const size_t maxPacketSize = 65536; // 64KB max packet size
+    size_t pendingPadding = 0;
 
     spdlog::info("Reader thread started for device: {}", deviceID);
 
@@ -373,69 +428,79 @@ void LinuxBluetoothNetwork::readerThreadFunc(const std::string &deviceID, int so
         // Add received data to accumulated buffer
         accumulatedData.insert(accumulatedData.end(), buf, buf + bytesRead);
 
+        // Packets are parsed in place, consumed bytes are dropped once per read
+        size_t offset = 0;
+
         // Process complete packets from accumulated data
-        while (accumulatedData.size() >= 21) // Minimum packet size (header + senderID)
+        while (accumulatedData.size() - offset >= PKT_MIN_SIZE)
         {
-            // Read payload length from the packet header (offset 12-13)
-            uint16_t payloadLength = (accumulatedData[12] << 8) | accumulatedData[13];
-            uint8_t flags = accumulatedData[11]; // flags byte
+            std::span<const uint8_t> data(accumulatedData.data() + offset, accumulatedData.size() - offset);
 
-            // Calculate total expected packet size
-            size_t expectedSize = 21; // header + senderID
-            if (flags & FLAG_HAS_RECIPIENT)
+            // Skip the padding that follows the previous frame (last padding byte holds its length)
+            if (pendingPadding > 0)
             {
-                expectedSize += 8; // recipientID
-            }
-            expectedSize += payloadLength; // payload
-            if (flags & FLAG_HAS_SIGNATURE)
-            {
-                expectedSize += 64; // signature
+                if (data.size() < pendingPadding)
+                {
+                    break;
+                }
+
+                if (data[pendingPadding - 1] == pendingPadding)
+                {
+                    offset += pendingPadding;
+                }
+
+                pendingPadding = 0;
+                continue;
             }
 
+            // Calculate total expected packet size from the header
+            size_t expectedSize = PacketSerializer::getFrameSize(data);
+
             // Check for invalid or too large packets
-            if (expectedSize > maxPacketSize || payloadLength > maxPacketSize - 21)
+            if (expectedSize > maxPacketSize)
             {
                 spdlog::error("Invalid or too large packet from device: {} (size: {})", deviceID, expectedSize);
-                accumulatedData.clear();
+                offset = accumulatedData.size();
                 break;
             }
 
             // Check if we have enough data for the complete packet
-            if (accumulatedData.size() < expectedSize)
+            if (data.size() < expectedSize)
             {
                 // Not enough data for complete packet, wait for more
                 break;
             }
 
-            // Try to deserialize the packet
-            try
-            {
-                BitchatPacket packet = serializer.deserializePacket(accumulatedData);
+            std::optional<PacketView> packet = serializer.parsePacketView(data);
 
-                // Validate the packet
-                if (packet.getVersion() == 0 || packet.getVersion() > 1)
-                {
-                    spdlog::warn("Invalid packet version {} from device: {}", packet.getVersion(), deviceID);
-                    accumulatedData.erase(accumulatedData.begin());
-                    continue;
-                }
+            // Validate the packet
+            if (!packet || packet->getVersion() == 0 || packet->getVersion() > 1)
+            {
+                spdlog::warn("Invalid packet from device: {}", deviceID);
+                offset++;
+                continue;
+            }
 
+            try
+            {
                 if (packetReceivedCallback)
                 {
-                    packetReceivedCallback(packet, "");
+                    // The device is the link, rate limits are charged to it
+                    packetReceivedCallback(*packet, deviceID);
                     spdlog::debug("Received packet from device: {}", deviceID);
                 }
-
-                // Remove the consumed packet from accumulated data
-                accumulatedData.erase(accumulatedData.begin(), accumulatedData.begin() + expectedSize);
             }
             catch (const std::exception &e)
             {
-                spdlog::error("Failed to deserialize packet from device {}: {}", deviceID, e.what());
-                // Remove one byte and try again
-                accumulatedData.erase(accumulatedData.begin());
+                spdlog::error("Failed to process packet from device {}: {}", deviceID, e.what());
             }
+
+            // Remove the consumed packet from accumulated data
+            offset += expectedSize;
+            pendingPadding = MessagePadding::paddedSize(expectedSize) - expectedSize;
         }
+
+        accumulatedData.erase(accumulatedData.begin(), accumulatedData.begin() + std::min(offset, accumulatedData.size()));
     }
 
     if (bytesRead == 0)
@@ -447,18 +512,260 @@ void LinuxBluetoothNetwork::readerThreadFunc(const std::string &deviceID, int so
         spdlog::error("Failed to read from device {}: {}", deviceID, strerror(errno));
     }
 
-    // Notify about disconnection
-    if (peerDisconnectedCallback)
+    // A reconnect may have replaced this socket already, only its own entries are removed
+    std::shared_ptr<PeerSendQueue> queue;
+    bool replaced = false;
+
+    {
+        std::lock_guard<std::mutex> lock(socketsMutex);
+
+        auto it = connectedSockets.find(deviceID);
+
+        if (it != connectedSockets.end())
+        {
+            replaced = it->second != socket;
+
+            if (!replaced)
+            {
+                connectedSockets.erase(it);
+            }
+        }
+
+        auto queueIt = sendQueues.find(deviceID);
+
+        if (queueIt != sendQueues.end() && queueIt->second->socket == socket)
+        {
+            queue = takeSendQueue(deviceID);
+        }
+    }
+
+    // Notify about disconnection, unless the device is still connected over the new socket
+    if (peerDisconnectedCallback && !replaced)
     {
         peerDisconnectedCallback(deviceID);
         spdlog::info("Peer disconnected callback invoked for device: {}", deviceID);
     }
 
+    // Stop the writer before the socket goes away
+    closeSendQueue(queue);
+
     // Clean up socket
-    std::lock_guard<std::mutex> lock(socketsMutex);
-    connectedSockets.erase(deviceID);
     close(socket);
     spdlog::info("Reader thread for device {} finished. Socket closed and removed from map.", deviceID);
 }
 
+void LinuxBluetoothNetwork::writerThreadFunc(const std::string &deviceID, std::shared_ptr<PeerSendQueue> queue)
+{
+    std::vector<SharedFrame> batch;
+    std::vector<struct iovec> iov;
+
+    std::unique_lock<std::mutex> lock(queue->mutex);
+
+    while (true)
+    {
+        // clang-format off
+        queue->condition.wait(lock, [&queue]() {
+            return queue->closing || !queue->frames.empty();
+        });
+        // clang-format on
+
+        if (queue->frames.empty())
+        {
+            // Closing and fully drained
+            break;
+        }
+
+        // Hold the batch open until the deadline of the oldest frame or until the byte budget is queued
+        auto deadline = queue->oldestEnqueueTime + std::chrono::microseconds(flushDeadlineMicros.load());
+
+        // clang-format off
+        queue->condition.wait_until(lock, deadline, [this, &queue]() {
+            return queue->closing || queue->queuedBytes >= flushByteBudget.load();
+        });
+        // clang-format on
+
+        batch.clear();
+        size_t batchBytes = 0;
+
+        while (!queue->frames.empty() && batch.size() < IOV_MAX)
+        {
+            batchBytes += queue->frames.front()->size();
+            batch.push_back(std::move(queue->frames.front()));
+            queue->frames.pop_front();
+        }
+
+        // Frames left over (more than IOV_MAX) keep the old timestamp, so they go out right away
+        queue->queuedBytes -= batchBytes;
+        lock.unlock();
+
+        iov.resize(batch.size());
+
+        for (size_t i = 0; i < batch.size(); i++)
+        {
+            iov[i].iov_base = const_cast<uint8_t *>(batch[i]->data());
+            iov[i].iov_len = batch[i]->size();
+        }
+
+        // One sendmsg per batch, resumed after partial writes
+        size_t first = 0;
+        bool failed = false;
+
+        while (first < iov.size())
+        {
+            struct msghdr message;
+            memset(&message, 0, sizeof(message));
+            message.msg_iov = iov.data() + first;
+            message.msg_iovlen = iov.size() - first;
+
+            ssize_t written = sendmsg(queue->socket, &message, MSG_NOSIGNAL);
+
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                spdlog::error("Failed to write to socket for peer {}: {}", deviceID, strerror(errno));
+                failed = true;
+                break;
+            }
+
+            size_t remaining = static_cast<size_t>(written);
+
+            while (first < iov.size() && remaining >= iov[first].iov_len)
+            {
+                remaining -= iov[first].iov_len;
+                first++;
+            }
+
+            if (first < iov.size())
+            {
+                iov[first].iov_base = static_cast<uint8_t *>(iov[first].iov_base) + remaining;
+                iov[first].iov_len -= remaining;
+            }
+        }
+
+        if (!failed)
+        {
+            spdlog::debug("Flushed {} frames ({} bytes) to peer: {}", batch.size(), batchBytes, deviceID);
+        }
+
+        lock.lock();
+
+        if (failed)
+        {
+            // The socket is gone, the reader thread will tear the peer down
+            queue->frames.clear();
+            queue->queuedBytes = 0;
+        }
+    }
+}
+
+void LinuxBluetoothNetwork::openSendQueue(const std::string &deviceID, int socket)
+{
+    // A reconnect replaces the queue of the previous socket (its writer never takes socketsMutex)
+    closeSendQueue(takeSendQueue(deviceID));
+
+    auto queue = std::make_shared<PeerSendQueue>();
+    queue->socket = socket;
+    queue->writer = std::thread(&LinuxBluetoothNetwork::writerThreadFunc, this, deviceID, queue);
+    sendQueues[deviceID] = queue;
+}
+
+std::shared_ptr<LinuxBluetoothNetwork::PeerSendQueue> LinuxBluetoothNetwork::takeSendQueue(const std::string &deviceID)
+{
+    auto it = sendQueues.find(deviceID);
+
+    if (it == sendQueues.end())
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<PeerSendQueue> queue = std::move(it->second);
+    sendQueues.erase(it);
+
+    return queue;
+}
+
+void LinuxBluetoothNetwork::closeSendQueue(const std::shared_ptr<PeerSendQueue> &queue)
+{
+    if (!queue)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->closing = true;
+    }
+
+    queue->condition.notify_one();
+
+    if (queue->writer.joinable())
+    {
+        queue->writer.join();
+    }
+}
+
+bool LinuxBluetoothNetwork::enqueueFrame(PeerSendQueue &queue, const SharedFrame &frame)
+{
+    if (!frame || frame->empty())
+    {
+        return false;
+    }
+
+    bool wake = false;
+
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.closing)
+        {
+            return false;
+        }
+
+        if (queue.queuedBytes + frame->size() > constants::BLE_SEND_QUEUE_MAX_BYTES)
+        {
+            spdlog::warn("Send queue full ({} bytes queued), dropping frame", queue.queuedBytes);
+            return false;
+        }
+
+        if (queue.frames.empty())
+        {
+            queue.oldestEnqueueTime = std::chrono::steady_clock::now();
+            wake = true;
+        }
+
+        queue.frames.push_back(frame);
+        queue.queuedBytes += frame->size();
+        wake = wake || queue.queuedBytes >= flushByteBudget.load();
+    }
+
+    if (wake)
+    {
+        queue.condition.notify_one();
+    }
+
+    return true;
+}
+
+SharedFrame LinuxBluetoothNetwork::makeFrame(const BitchatPacket &packet)
+{
+    // Serialized into a per-thread buffer that keeps its capacity, only the
+    // shared frame handed to the link queues is allocated
+    thread_local OutputBuffer output;
+    PacketSerializer serializer;
+    serializer.serializeInto(packet, output);
+
+    if (output.empty())
+    {
+        return nullptr;
+    }
+
+    std::span<const uint8_t> data = output.getData();
+
+    return std::make_shared<const std::vector<uint8_t>>(data.begin(), data.end());
+}
+
 } // namespace bitchat
@@ -0,0 +1,96 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/core/bitchat_data.h"
+
+using namespace bitchat;
+using namespace ::testing;
+
+class BitchatDataTest : public Test
+{
+protected:
+    void SetUp() override
+    {
+        previous = BitchatData::shared()->getLocalIdentity();
+    }
+
+    void TearDown() override
+    {
+        BitchatData::shared()->setPeerID(previous->peerIdHex);
+        BitchatData::shared()->setNickname(previous->nickname);
+        BitchatData::shared()->setCurrentChannel(previous->currentChannel);
+    }
+
+    LocalIdentityPtr previous;
+};
+
+// ============================================================================
+// Tests for LocalIdentity
+// ============================================================================
+
+TEST_F(BitchatDataTest, LocalIdentity_SettersPublishNewSnapshot)
+{
+    auto data = BitchatData::shared();
+    data->setPeerID("0102030405060708");
+    data->setNickname("alice");
+    data->setCurrentChannel("#general");
+
+    LocalIdentityPtr identity = data->getLocalIdentity();
+    EXPECT_EQ(identity->peerId, PeerId(0x0102030405060708ULL));
+    EXPECT_EQ(identity->peerIdHex, "0102030405060708");
+    EXPECT_EQ(identity->nickname, "alice");
+    EXPECT_EQ(identity->currentChannel, "#general");
+
+    EXPECT_EQ(data->getLocalPeerId(), identity->peerId);
+    EXPECT_EQ(data->getPeerID(), identity->peerIdHex);
+    EXPECT_EQ(data->getNickname(), identity->nickname);
+    EXPECT_EQ(data->getCurrentChannel(), identity->currentChannel);
+}
+
+TEST_F(BitchatDataTest, LocalIdentity_HeldSnapshotDoesNotChange)
+{
+    auto data = BitchatData::shared();
+    data->setNickname("alice");
+
+    LocalIdentityPtr held = data->getLocalIdentity();
+    data->setNickname("bob");
+    data->setCurrentChannel("#other");
+
+    EXPECT_EQ(held->nickname, "alice");
+    EXPECT_EQ(data->getLocalIdentity()->nickname, "bob");
+    EXPECT_EQ(data->getLocalIdentity()->currentChannel, "#other");
+}
+
+// ============================================================================
+// Tests for Search
+// ============================================================================
+
+TEST_F(BitchatDataTest, SearchMessages_FindsHistoryMessages)
+{
+    auto data = BitchatData::shared();
+    data->clearMessageHistory("#search");
+
+    BitchatMessage first("alice", "Lunch at noon?", "#search");
+    BitchatMessage second("bob", "noon works for me", "#search");
+    BitchatMessage third("alice", "see you there", "#search");
+
+    data->addMessageToHistory(first, "#search");
+    data->addMessageToHistory(second, "#search");
+    data->addMessageToHistory(third, "#search");
+
+    SearchQuery query;
+    query.keywords = {"noon"};
+
+    auto results = data->searchMessages("#search", query);
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].getId(), second.getId());
+    EXPECT_EQ(results[1].getId(), first.getId());
+
+    query.sender = "Alice";
+    results = data->searchMessages("#search", query);
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results[0].getContent(), "Lunch at noon?");
+
+    data->clearMessageHistory("#search");
+    EXPECT_TRUE(data->searchMessages("#search", query).empty());
+}
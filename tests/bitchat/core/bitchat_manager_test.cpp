@@ -12,6 +12,7 @@
 #include "mock/bluetooth_announce_runner_mock.h"
 #include "mock/bluetooth_interface_mock.h"
 #include "mock/cleanup_runner_mock.h"
+#include <filesystem>
 
 using namespace bitchat;
 using namespace ::testing;
@@ -31,7 +32,8 @@ TEST(BitchatManagerTest, Initialize)
     // Create services
     auto networkService = std::make_shared<NetworkService>();
     auto messageService = std::make_shared<MessageService>();
-    auto cryptoService = std::make_shared<CryptoService>();
+    auto keyFile = std::filesystem::temp_directory_path() / "bitchat_key_BitchatManagerTest.pem";
+    auto cryptoService = std::make_shared<CryptoService>(keyFile.string());
     auto noiseService = std::make_shared<NoiseService>();
     auto announceRunner = std::make_shared<MockBluetoothAnnounceRunner>();
     auto cleanupRunner = std::make_shared<MockCleanupRunner>();
@@ -44,6 +46,7 @@ TEST(BitchatManagerTest, Initialize)
     ASSERT_TRUE(manager->initialize(dummyUserInterface, bluetoothNetwork, networkService, messageService, cryptoService, noiseService, announceRunner, cleanupRunner));
     ASSERT_TRUE(manager->start());
     manager->stop();
+    std::filesystem::remove(keyFile);
 
     // Allow the mock to leak since it's managed by shared ptr
     Mock::AllowLeak(bluetoothNetwork.get());
@@ -0,0 +1,79 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/core/history_block.h"
+#include <string>
+
+using namespace bitchat;
+using namespace ::testing;
+
+class HistoryBlockTest : public Test
+{
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+// ============================================================================
+// Tests for HistoryBlock
+// ============================================================================
+
+TEST_F(HistoryBlockTest, Pack_RoundTripsAllFields)
+{
+    std::vector<BitchatMessage> messages;
+
+    BitchatMessage channel("alice", "hello @bob", "#general");
+    channel.setTimestamp(1700000000000);
+    channel.addMention("bob");
+    channel.setSenderPeerID({0x01, 0x02, 0x03, 0x04});
+    messages.push_back(channel);
+
+    BitchatMessage relayed("bob", "secret", "");
+    relayed.setTimestamp(1699999999000); // older than the previous one
+    relayed.setRelay(true);
+    relayed.setOriginalSender("carol");
+    relayed.setPrivate(true);
+    relayed.setRecipientNickname("alice");
+    relayed.setEncrypted(true);
+    relayed.setEncryptedContent({0xDE, 0xAD, 0xBE, 0xEF});
+    messages.push_back(relayed);
+
+    auto block = HistoryBlock::pack(messages);
+    ASSERT_NE(block, nullptr);
+    EXPECT_EQ(block->size(), 2u);
+
+    auto unpacked = block->unpack();
+    ASSERT_EQ(unpacked.size(), 2u);
+
+    for (size_t i = 0; i < messages.size(); i++)
+    {
+        EXPECT_EQ(unpacked[i].getId(), messages[i].getId());
+        EXPECT_EQ(unpacked[i].getSender(), messages[i].getSender());
+        EXPECT_EQ(unpacked[i].getContent(), messages[i].getContent());
+        EXPECT_EQ(unpacked[i].getChannel(), messages[i].getChannel());
+        EXPECT_EQ(unpacked[i].getTimestamp(), messages[i].getTimestamp());
+        EXPECT_EQ(unpacked[i].isRelay(), messages[i].isRelay());
+        EXPECT_EQ(unpacked[i].getOriginalSender(), messages[i].getOriginalSender());
+        EXPECT_EQ(unpacked[i].isPrivate(), messages[i].isPrivate());
+        EXPECT_EQ(unpacked[i].getRecipientNickname(), messages[i].getRecipientNickname());
+        EXPECT_EQ(unpacked[i].getSenderPeerID(), messages[i].getSenderPeerID());
+        EXPECT_EQ(unpacked[i].getMentions(), messages[i].getMentions());
+        EXPECT_EQ(unpacked[i].isEncrypted(), messages[i].isEncrypted());
+        EXPECT_EQ(unpacked[i].getEncryptedContent(), messages[i].getEncryptedContent());
+    }
+}
+
+TEST_F(HistoryBlockTest, Pack_SkippedMessagesAreEmpty)
+{
+    std::vector<BitchatMessage> messages;
+
+    for (int i = 0; i < 4; i++)
+    {
+        messages.emplace_back("alice", "message " + std::to_string(i), "#general");
+    }
+
+    auto unpacked = HistoryBlock::pack(messages, 2)->unpack();
+    ASSERT_EQ(unpacked.size(), 4u);
+    EXPECT_TRUE(unpacked[1].getContent().empty());
+    EXPECT_EQ(unpacked[2].getContent(), "message 2");
+}
@@ -0,0 +1,132 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/core/message_history.h"
+#include <string>
+
+using namespace bitchat;
+using namespace ::testing;
+
+class MessageHistoryTest : public Test
+{
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+
+    static BitchatMessage makeMessage(size_t index)
+    {
+        return BitchatMessage("alice", "message " + std::to_string(index), "#general");
+    }
+
+    static std::vector<std::string> contents(const MessageHistory::Snapshot &snapshot)
+    {
+        std::vector<std::string> result;
+
+        for (const auto &message : snapshot.toVector())
+        {
+            result.push_back(message.getContent());
+        }
+
+        return result;
+    }
+};
+
+// ============================================================================
+// Tests for MessageHistory
+// ============================================================================
+
+TEST_F(MessageHistoryTest, Append_OverCapacity_KeepsNewestInOrder)
+{
+    constexpr size_t capacity = 100;
+    MessageHistory history(capacity);
+
+    for (size_t i = 0; i < 1000; i++)
+    {
+        history.append(makeMessage(i));
+    }
+
+    auto snapshot = history.snapshot();
+    ASSERT_EQ(snapshot.size(), capacity);
+    EXPECT_EQ(history.size(), capacity);
+
+    for (size_t i = 0; i < capacity; i++)
+    {
+        EXPECT_EQ(snapshot[i].getContent(), "message " + std::to_string(900 + i));
+    }
+}
+
+TEST_F(MessageHistoryTest, Snapshot_UnaffectedByLaterChanges)
+{
+    MessageHistory history(3);
+    history.append(makeMessage(0));
+    history.append(makeMessage(1));
+
+    auto snapshot = history.snapshot();
+
+    history.append(makeMessage(2));
+    history.append(makeMessage(3));
+    history.trim(1);
+
+    EXPECT_EQ(contents(snapshot), std::vector<std::string>({"message 0", "message 1"}));
+    EXPECT_EQ(contents(history.snapshot()), std::vector<std::string>({"message 3"}));
+
+    history.clear();
+
+    EXPECT_EQ(snapshot.size(), 2u);
+    EXPECT_TRUE(history.snapshot().empty());
+}
+
+TEST_F(MessageHistoryTest, GetPage_SpansSegmentBoundaries)
+{
+    constexpr size_t segment = constants::HISTORY_SEGMENT_SIZE;
+    MessageHistory history(segment * 3);
+
+    // Evict a few so the head is in the middle of a segment
+    for (size_t i = 0; i < segment * 3 + 5; i++)
+    {
+        history.append(makeMessage(i));
+    }
+
+    auto snapshot = history.snapshot();
+    auto runs = snapshot.getPage(segment - 10, 20);
+
+    ASSERT_EQ(runs.size(), 2u);
+    EXPECT_EQ(runs[0].size() + runs[1].size(), 20u);
+    EXPECT_EQ(runs[0].front().getContent(), snapshot[segment - 10].getContent());
+    EXPECT_EQ(runs[1].back().getContent(), snapshot[segment + 9].getContent());
+
+    EXPECT_TRUE(snapshot.getPage(snapshot.size(), 10).empty());
+    EXPECT_EQ(snapshot.getPage(snapshot.size() - 3, 10).back().size(), 3u);
+}
+
+TEST_F(MessageHistoryTest, ColdTier_CompressesOldSegments)
+{
+    constexpr size_t segment = constants::HISTORY_SEGMENT_SIZE;
+    MessageHistory compressed(segment * 16, segment);
+    MessageHistory decoded(segment * 16, segment * 16);
+
+    for (size_t i = 0; i < segment * 16; i++)
+    {
+        BitchatMessage message = makeMessage(i);
+        message.setContent("A fairly ordinary chat message that people tend to send " + std::to_string(i % 7));
+
+        compressed.append(message);
+        decoded.append(message);
+    }
+
+    // Old messages decode to the same content, in order, also across a page
+    auto snapshot = compressed.snapshot();
+    EXPECT_EQ(snapshot.toVector().size(), segment * 16);
+    EXPECT_EQ(snapshot[5].getContent(), decoded.snapshot()[5].getContent());
+    EXPECT_EQ(snapshot[5].getId(), decoded.snapshot()[5].getId());
+
+    auto page = snapshot.getPage(segment - 2, 4);
+    ASSERT_EQ(page.size(), 2u);
+    EXPECT_EQ(page[1].front().getId(), decoded.snapshot()[segment].getId());
+
+    EXPECT_LT(compressed.getMemoryUsage() * 3, decoded.getMemoryUsage());
+
+    // Evicting from the cold tier keeps the order
+    compressed.trim(segment * 2 + 3);
+    EXPECT_EQ(compressed.snapshot()[0].getId(), decoded.snapshot()[segment * 14 - 3].getId());
+}
@@ -0,0 +1,135 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/core/peer_table.h"
+#include <atomic>
+#include <thread>
+
+using namespace bitchat;
+using namespace ::testing;
+
+class PeerTableTest : public Test
+{
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+
+    static BitchatPeer makePeer(uint64_t id, const std::string &peripheralID)
+    {
+        BitchatPeer peer(PeerId(id).toHex(), "peer" + std::to_string(id));
+        peer.setPeripheralID(peripheralID);
+        peer.updateLastSeen();
+
+        return peer;
+    }
+};
+
+// ============================================================================
+// Tests for PeerTable
+// ============================================================================
+
+TEST_F(PeerTableTest, Upsert_IndexesByIdAndPeripheral)
+{
+    PeerTable table;
+    table.upsert(makePeer(1, "link-a"));
+    table.upsert(makePeer(2, "link-b"));
+    table.upsert(makePeer(3, "link-a"));
+
+    auto snapshot = table.snapshot();
+    ASSERT_EQ(snapshot.size(), 3u);
+    ASSERT_NE(snapshot.find(PeerId(2)), nullptr);
+    EXPECT_EQ(snapshot.find(PeerId(2))->getNickname(), "peer2");
+    EXPECT_EQ(snapshot.find(PeerId(4)), nullptr);
+
+    auto linked = snapshot.findByPeripheral("link-a");
+    ASSERT_EQ(linked.size(), 2u);
+    EXPECT_EQ(linked[0]->getId(), PeerId(1));
+    EXPECT_EQ(linked[1]->getId(), PeerId(3));
+
+    // Replacing a peer moves its peripheral entry and keeps its position
+    table.upsert(makePeer(1, "link-b"));
+    snapshot = table.snapshot();
+
+    EXPECT_EQ(snapshot.size(), 3u);
+    EXPECT_EQ(snapshot.getPeers()[0]->getPeripheralID(), "link-b");
+    EXPECT_EQ(snapshot.findByPeripheral("link-a").size(), 1u);
+    EXPECT_EQ(snapshot.findByPeripheral("link-b").size(), 2u);
+}
+
+TEST_F(PeerTableTest, Remove_KeepsOrderAndOldSnapshots)
+{
+    PeerTable table;
+
+    for (uint64_t id = 1; id <= 5; id++)
+    {
+        table.upsert(makePeer(id, "link-" + std::to_string(id)));
+    }
+
+    auto before = table.snapshot();
+
+    EXPECT_TRUE(table.remove(PeerId(2)));
+    EXPECT_FALSE(table.remove(PeerId(2)));
+
+    auto after = table.snapshot();
+    ASSERT_EQ(after.size(), 4u);
+    EXPECT_EQ(after.getPeers()[1]->getId(), PeerId(3));
+    EXPECT_EQ(after.find(PeerId(5))->getPeripheralID(), "link-5");
+    EXPECT_TRUE(after.findByPeripheral("link-2").empty());
+
+    // Earlier snapshots still see the removed peer
+    EXPECT_EQ(before.size(), 5u);
+    ASSERT_NE(before.find(PeerId(2)), nullptr);
+}
+
+TEST_F(PeerTableTest, RemoveStale_RemovesOnlyStalePeers)
+{
+    PeerTable table;
+    BitchatPeer stale = makePeer(1, "link-a");
+    stale.setLastSeen(time(nullptr) - 600);
+
+    table.assign({stale, makePeer(2, "link-b")});
+
+    EXPECT_EQ(table.removeStale(180), 1u);
+    EXPECT_EQ(table.removeStale(180), 0u);
+    EXPECT_EQ(table.snapshot().find(PeerId(1)), nullptr);
+    EXPECT_NE(table.snapshot().find(PeerId(2)), nullptr);
+}
+
+TEST_F(PeerTableTest, Snapshot_ReadersRunDuringWrites)
+{
+    PeerTable table;
+    std::atomic<bool> done{false};
+    std::atomic<size_t> reads{0};
+
+    // clang-format off
+    std::thread reader([&]() {
+        do
+        {
+            auto snapshot = table.snapshot();
+
+            for (const auto &peer : snapshot.getPeers())
+            {
+                EXPECT_EQ(snapshot.find(peer->getId()), peer);
+            }
+
+            reads++;
+        } while (!done);
+    });
+    // clang-format on
+
+    for (uint64_t id = 1; id <= 2000; id++)
+    {
+        table.upsert(makePeer(id, "link"));
+
+        if (id % 3 == 0)
+        {
+            table.remove(PeerId(id - 1));
+        }
+    }
+
+    done = true;
+    reader.join();
+
+    EXPECT_GT(reads.load(), 0u);
+    EXPECT_EQ(table.snapshot().size(), 2000u - 666u);
+}
@@ -0,0 +1,95 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/core/private_conversations.h"
+#include <string>
+
+using namespace bitchat;
+using namespace ::testing;
+
+class PrivateConversationsTest : public Test
+{
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+
+    static BitchatMessage makeMessage(const std::string &sender, const std::string &recipient, const std::string &content)
+    {
+        BitchatMessage message(sender, content, "");
+        message.setPrivate(true);
+        message.setRecipientNickname(recipient);
+
+        return message;
+    }
+};
+
+// ============================================================================
+// Tests for PrivateConversations
+// ============================================================================
+
+TEST_F(PrivateConversationsTest, Add_KeepsConversationsApartAndBounded)
+{
+    PrivateConversations conversations(8, 10);
+
+    for (int i = 0; i < 25; i++)
+    {
+        conversations.add("aaaa", makeMessage("alice", "me", "alice " + std::to_string(i)), true);
+    }
+
+    conversations.add("bbbb", makeMessage("me", "bob", "hi bob"), false);
+
+    auto latest = conversations.getLatest("aaaa", 3);
+    ASSERT_EQ(latest.size(), 3u);
+    EXPECT_EQ(latest[0].getContent(), "alice 22");
+    EXPECT_EQ(latest[2].getContent(), "alice 24");
+
+    // Each conversation is bounded on its own
+    EXPECT_EQ(conversations.getSnapshot("aaaa").size(), 10u);
+    EXPECT_EQ(conversations.getLatest("bbbb", 100).size(), 1u);
+    EXPECT_TRUE(conversations.getLatest("cccc", 5).empty());
+
+    auto summaries = conversations.getConversations();
+    ASSERT_EQ(summaries.size(), 2u);
+    EXPECT_EQ(summaries[0].key, "bbbb");
+    EXPECT_EQ(summaries[0].nickname, "bob");
+    EXPECT_EQ(summaries[1].nickname, "alice");
+    EXPECT_EQ(summaries[1].messageCount, 10u);
+}
+
+TEST_F(PrivateConversationsTest, Unread_CountsIncomingOnly)
+{
+    PrivateConversations conversations;
+    conversations.add("aaaa", makeMessage("alice", "me", "one"), true);
+    conversations.add("aaaa", makeMessage("alice", "me", "two"), true);
+    conversations.add("aaaa", makeMessage("me", "alice", "reply"), false);
+    conversations.add("bbbb", makeMessage("bob", "me", "hey"), true);
+
+    EXPECT_EQ(conversations.getUnreadCount("aaaa"), 2u);
+    EXPECT_EQ(conversations.getTotalUnreadCount(), 3u);
+
+    conversations.markRead("aaaa");
+    EXPECT_EQ(conversations.getUnreadCount("aaaa"), 0u);
+    EXPECT_EQ(conversations.getTotalUnreadCount(), 1u);
+
+    EXPECT_TRUE(conversations.remove("bbbb"));
+    EXPECT_EQ(conversations.getTotalUnreadCount(), 0u);
+}
+
+TEST_F(PrivateConversationsTest, Add_EvictsLeastRecentlyActive)
+{
+    PrivateConversations conversations(2, 10);
+    conversations.add("aaaa", makeMessage("alice", "me", "hi"), true);
+    conversations.add("bbbb", makeMessage("bob", "me", "hi"), true);
+
+    // Activity moves alice ahead of bob
+    EXPECT_FALSE(conversations.add("aaaa", makeMessage("alice", "me", "again"), true).evicted);
+
+    auto result = conversations.add("cccc", makeMessage("carol", "me", "hi"), true);
+    ASSERT_TRUE(result.evicted);
+    EXPECT_EQ(*result.evicted, "bbbb");
+    EXPECT_EQ(result.ordinal, 0u);
+
+    EXPECT_EQ(conversations.size(), 2u);
+    EXPECT_EQ(conversations.getTotalUnreadCount(), 3u);
+    EXPECT_EQ(conversations.add("aaaa", makeMessage("alice", "me", "third"), true).ordinal, 2u);
+}
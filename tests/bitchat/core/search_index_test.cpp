@@ -0,0 +1,124 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/core/search_index.h"
+#include <string>
+
+using namespace bitchat;
+using namespace ::testing;
+
+class SearchIndexTest : public Test
+{
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+
+    static BitchatMessage makeMessage(const std::string &sender, const std::string &content, uint64_t timestamp)
+    {
+        BitchatMessage message(sender, content, "#general");
+        message.setTimestamp(timestamp);
+
+        return message;
+    }
+};
+
+// ============================================================================
+// Tests for SearchIndex
+// ============================================================================
+
+TEST_F(SearchIndexTest, Tokenize_SplitsAndLowercases)
+{
+    EXPECT_THAT(SearchIndex::tokenize("Hello, World! it's 2024"), ElementsAre("hello", "world", "it", "s", "2024"));
+    EXPECT_THAT(SearchIndex::tokenize("  --  "), IsEmpty());
+}
+
+TEST_F(SearchIndexTest, Parse_ReadsFiltersAndKeywords)
+{
+    constexpr uint64_t now = 10 * 60 * 60 * 1000;
+    SearchQuery query = SearchQuery::parse("Meeting from:@Alice since:2h until:30m room-4", now);
+
+    EXPECT_THAT(query.keywords, ElementsAre("meeting", "room", "4"));
+    EXPECT_EQ(query.sender, "alice");
+    EXPECT_EQ(query.from, now - 2 * 60 * 60 * 1000);
+    EXPECT_EQ(query.to, now - 30 * 60 * 1000);
+
+    // Not a valid duration, searched as words
+    EXPECT_THAT(SearchQuery::parse("since:soon", now).keywords, ElementsAre("since", "soon"));
+}
+
+TEST_F(SearchIndexTest, Search_IntersectsKeywordsSenderAndTime)
+{
+    SearchIndex index;
+    index.add("#general", 0, makeMessage("alice", "the build is broken", 1000));
+    index.add("#general", 1, makeMessage("bob", "Build fixed", 2000));
+    index.add("#general", 2, makeMessage("alice", "thanks, build works", 3000));
+    index.add("#general", 3, makeMessage("carol", "unrelated", 4000));
+    index.add("#other", 0, makeMessage("alice", "build", 1000));
+
+    SearchQuery query;
+    query.keywords = {"build"};
+    EXPECT_THAT(index.search("#general", query), ElementsAre(2, 1, 0));
+
+    query.sender = "ALICE";
+    EXPECT_THAT(index.search("#general", query), ElementsAre(2, 0));
+
+    query.from = 1500;
+    EXPECT_THAT(index.search("#general", query), ElementsAre(2));
+
+    query.keywords = {"build", "missing"};
+    EXPECT_THAT(index.search("#general", query), IsEmpty());
+
+    // Time window only, newest first
+    SearchQuery window;
+    window.from = 2000;
+    window.to = 3500;
+    EXPECT_THAT(index.search("#general", window), ElementsAre(2, 1));
+
+    window.limit = 1;
+    EXPECT_THAT(index.search("#general", window), ElementsAre(2));
+}
+
+TEST_F(SearchIndexTest, Search_LateTimestamps_KeepTimeOrder)
+{
+    SearchIndex index;
+    index.add("#general", 0, makeMessage("alice", "first", 3000));
+    index.add("#general", 1, makeMessage("bob", "second", 1000));
+    index.add("#general", 2, makeMessage("carol", "third", 3000));
+    index.add("#general", 3, makeMessage("dave", "fourth", 2000));
+
+    // Newest first, equal timestamps by ordinal
+    SearchQuery window;
+    window.from = 1;
+    EXPECT_THAT(index.search("#general", window), ElementsAre(2, 0, 3, 1));
+
+    window.to = 2500;
+    EXPECT_THAT(index.search("#general", window), ElementsAre(3, 1));
+}
+
+TEST_F(SearchIndexTest, RemoveBefore_DropsOldOrdinals)
+{
+    SearchIndex index;
+
+    for (uint64_t i = 0; i < 100000; i++)
+    {
+        index.add("#general", i, makeMessage("user" + std::to_string(i % 50), "message number " + std::to_string(i % 1000), 1000 + i));
+    }
+
+    SearchQuery query;
+    query.keywords = {"number", "999"};
+    query.sender = "user49";
+    query.limit = 1000;
+    EXPECT_EQ(index.search("#general", query).size(), 100u);
+
+    // Narrow window walks the time index instead of the long posting lists
+    query.from = 1000 + 50000;
+    query.to = 1000 + 60000;
+    EXPECT_THAT(index.search("#general", query), ElementsAre(59999, 58999, 57999, 56999, 55999, 54999, 53999, 52999, 51999, 50999));
+
+    index.removeBefore("#general", 99000);
+    EXPECT_EQ(index.size("#general"), 1000u);
+
+    query.from = 0;
+    query.to = std::numeric_limits<uint64_t>::max();
+    EXPECT_THAT(index.search("#general", query), ElementsAre(99999));
+}
@@ -2,6 +2,9 @@
 #include <gtest/gtest.h>
 
 #include "bitchat/helpers/string_helper.h"
+#include <iomanip>
+#include <random>
+#include <sstream>
 
 using namespace bitchat;
 using namespace ::testing;
@@ -11,6 +14,19 @@ class StringHelperTest : public Test
 protected:
     void SetUp() override {}
     void TearDown() override {}
+
+    // Previous stream based implementation, kept as a reference
+    static std::string referenceToHex(std::span<const uint8_t> data)
+    {
+        std::stringstream ss;
+
+        for (uint8_t byte : data)
+        {
+            ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
+        }
+
+        return ss.str();
+    }
 };
 
 // ============================================================================
@@ -102,6 +118,101 @@ TEST_F(StringHelperTest, StringToVector_ZeroBytes_ReturnsCorrectVector)
     EXPECT_EQ(result, expected);
 }
 
+TEST_F(StringHelperTest, StringToVector_InvalidCharacter_ReturnsEmptyVector)
+{
+    EXPECT_TRUE(StringHelper::stringToVector("0g").empty());
+    EXPECT_TRUE(StringHelper::stringToVector("+1ff").empty());
+    EXPECT_TRUE(StringHelper::stringToVector(" 1").empty());
+
+    // Invalid character past the vectorized part
+    std::string str(64, 'a');
+    str[37] = 'x';
+    EXPECT_TRUE(StringHelper::stringToVector(str).empty());
+}
+
+// ============================================================================
+// Tests for hex codec
+// ============================================================================
+
+TEST_F(StringHelperTest, Hex_AllLengths_MatchReference)
+{
+    std::mt19937 gen(11);
+
+    // Covers the 32, 16 and 8 byte vector paths and the scalar tail
+    for (size_t size = 0; size <= 100; size++)
+    {
+        std::vector<uint8_t> data(size);
+
+        for (auto &byte : data)
+        {
+            byte = static_cast<uint8_t>(gen());
+        }
+
+        std::string hex = StringHelper::toHex(data);
+        EXPECT_EQ(hex, referenceToHex(data)) << "size " << size;
+        EXPECT_EQ(StringHelper::stringToVector(hex), data) << "size " << size;
+
+        std::transform(hex.begin(), hex.end(), hex.begin(), ::toupper);
+        EXPECT_EQ(StringHelper::stringToVector(hex), data) << "size " << size << " (uppercase)";
+    }
+}
+
+TEST_F(StringHelperTest, Hex_EveryByteValue_RoundTrips)
+{
+    std::vector<uint8_t> data(256);
+
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        data[i] = static_cast<uint8_t>(i);
+    }
+
+    EXPECT_EQ(StringHelper::toHex(data), referenceToHex(data));
+    EXPECT_EQ(StringHelper::stringToVector(StringHelper::toHex(data)), data);
+}
+
+TEST_F(StringHelperTest, Hex_EveryInvalidCharacter_IsRejected)
+{
+    for (int c = 0; c < 256; c++)
+    {
+        if (std::isxdigit(c))
+        {
+            continue;
+        }
+
+        // Place the character in the vector path and in the scalar tail
+        for (size_t position : {0, 31, 63, 64})
+        {
+            std::string str(66, '0');
+            str[position] = static_cast<char>(c);
+            EXPECT_TRUE(StringHelper::stringToVector(str).empty()) << "char " << c << " at " << position;
+            EXPECT_FALSE(StringHelper::isHex(str));
+        }
+    }
+}
+
+TEST_F(StringHelperTest, Hex_OutputBufferOverloads)
+{
+    std::vector<uint8_t> data = {0xDE, 0xAD, 0xBE, 0xEF};
+
+    char buffer[8];
+    EXPECT_TRUE(StringHelper::toHex(data, buffer));
+    EXPECT_EQ(std::string(buffer, sizeof(buffer)), "deadbeef");
+    EXPECT_FALSE(StringHelper::toHex(data, std::span<char>(buffer, 7)));
+
+    std::string key = "id_";
+    StringHelper::appendHex(key, data);
+    EXPECT_EQ(key, "id_deadbeef");
+
+    uint8_t bytes[4];
+    EXPECT_TRUE(StringHelper::fromHex("DEADbeef", bytes));
+    EXPECT_TRUE(std::equal(data.begin(), data.end(), bytes));
+    EXPECT_FALSE(StringHelper::fromHex("deadbe", bytes));
+    EXPECT_FALSE(StringHelper::fromHex("deadbeeg", bytes));
+
+    EXPECT_TRUE(StringHelper::isHex("00ffAB"));
+    EXPECT_FALSE(StringHelper::isHex("abc"));
+}
+
 // ============================================================================
 // Tests for vectorToString method
 // ============================================================================
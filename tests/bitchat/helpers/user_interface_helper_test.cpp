@@ -14,6 +14,7 @@
 #include "mock/cleanup_runner_mock.h"
 
 #include <chrono>
+#include <filesystem>
 #include <iostream>
 #include <memory>
 #include <sstream>
@@ -25,6 +26,7 @@ class UserInterfaceHelperTest : public Test
 {
 protected:
     std::shared_ptr<BitchatManager> manager;
+    std::filesystem::path keyFile = std::filesystem::temp_directory_path() / "bitchat_key_UserInterfaceHelperTest.pem";
 
     void SetUp() override
     {
@@ -32,7 +34,7 @@ protected:
         auto bluetoothNetwork = std::make_shared<DummyBluetoothNetwork>();
         auto networkService = std::make_shared<NetworkService>();
         auto messageService = std::make_shared<MessageService>();
-        auto cryptoService = std::make_shared<CryptoService>();
+        auto cryptoService = std::make_shared<CryptoService>(keyFile.string());
         auto noiseService = std::make_shared<NoiseService>();
         auto announceRunner = std::make_shared<MockBluetoothAnnounceRunner>();
         auto cleanupRunner = std::make_shared<MockCleanupRunner>();
@@ -48,7 +50,7 @@ protected:
 
     void TearDown() override
     {
-        // Pass
+        std::filesystem::remove(keyFile);
     }
 };
 
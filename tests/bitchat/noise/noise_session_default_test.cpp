@@ -0,0 +1,102 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/noise/noise_session_default.h"
+#include <openssl/rand.h>
+#include <string>
+#include <vector>
+
+using namespace bitchat;
+using namespace ::testing;
+
+class NoiseSessionDefaultTest : public Test
+{
+protected:
+    static NoisePrivateKey randomKey()
+    {
+        NoisePrivateKey key{};
+        RAND_bytes(key.data(), static_cast<int>(key.size()));
+
+        return key;
+    }
+
+    // Run the three XX messages between initiator and responder
+    void handshake()
+    {
+        auto message1 = initiator.startHandshake();
+        ASSERT_TRUE(message1.has_value());
+        EXPECT_EQ(message1->size(), 32u);
+
+        auto message2 = responder.processHandshakeMessage(*message1);
+        ASSERT_TRUE(message2.has_value());
+        EXPECT_EQ(message2->size(), 96u);
+
+        auto message3 = initiator.processHandshakeMessage(*message2);
+        ASSERT_TRUE(message3.has_value());
+        EXPECT_EQ(message3->size(), 64u);
+        EXPECT_TRUE(initiator.isSessionEstablished());
+
+        EXPECT_EQ(responder.processHandshakeMessage(*message3), std::nullopt);
+        EXPECT_TRUE(responder.isSessionEstablished());
+    }
+
+    NoiseSessionDefault initiator{"responder", NoiseRole::Initiator, randomKey()};
+    NoiseSessionDefault responder{"initiator", NoiseRole::Responder, randomKey()};
+};
+
+// ============================================================================
+// Tests for NoiseSessionDefault
+// ============================================================================
+
+TEST_F(NoiseSessionDefaultTest, Handshake_EstablishesBothSides)
+{
+    EXPECT_EQ(responder.startHandshake(), std::nullopt);
+    EXPECT_THROW(initiator.encrypt({1, 2, 3}), std::runtime_error);
+
+    handshake();
+
+    EXPECT_FALSE(initiator.handshakeInProgress());
+    EXPECT_FALSE(responder.handshakeInProgress());
+    ASSERT_TRUE(initiator.getHandshakeHash().has_value());
+    EXPECT_EQ(initiator.getHandshakeHash(), responder.getHandshakeHash());
+    EXPECT_TRUE(initiator.getRemoteStaticPublicKey().has_value());
+    EXPECT_TRUE(responder.getRemoteStaticPublicKey().has_value());
+}
+
+TEST_F(NoiseSessionDefaultTest, EncryptInPlace_RoundTripsBothDirections)
+{
+    handshake();
+
+    std::string text = "hello over the mesh";
+    std::vector<uint8_t> buffer(text.size() + NoiseSession::TAG_SIZE);
+    std::copy(text.begin(), text.end(), buffer.begin());
+
+    auto length = initiator.encryptInPlace(buffer, text.size());
+    ASSERT_THAT(length, Optional(text.size() + NoiseSession::TAG_SIZE));
+    EXPECT_NE(std::string(buffer.begin(), buffer.begin() + text.size()), text);
+
+    auto plainLength = responder.decryptInPlace(buffer);
+    ASSERT_THAT(plainLength, Optional(text.size()));
+    EXPECT_EQ(std::string(buffer.begin(), buffer.begin() + text.size()), text);
+
+    // Too small for the tag
+    std::vector<uint8_t> small(4);
+    EXPECT_EQ(responder.encryptInPlace(small, small.size()), std::nullopt);
+
+    std::vector<uint8_t> reply = responder.encrypt({9, 8, 7});
+    EXPECT_EQ(reply.size(), 3 + NoiseSession::TAG_SIZE);
+    EXPECT_EQ(initiator.decrypt(reply), std::vector<uint8_t>({9, 8, 7}));
+    EXPECT_EQ(initiator.getMessageCount(), 2u);
+}
+
+TEST_F(NoiseSessionDefaultTest, DecryptInPlace_RejectsTamperedMessage)
+{
+    handshake();
+
+    std::vector<uint8_t> ciphertext = initiator.encrypt({1, 2, 3, 4});
+    ASSERT_FALSE(ciphertext.empty());
+
+    ciphertext[1] ^= 0x01;
+    EXPECT_EQ(responder.decryptInPlace(ciphertext), std::nullopt);
+    EXPECT_TRUE(responder.decrypt(ciphertext).empty());
+}
@@ -0,0 +1,134 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/noise/sender_key_store.h"
+#include <string>
+#include <vector>
+
+using namespace bitchat;
+using namespace ::testing;
+
+class SenderKeyStoreTest : public Test
+{
+protected:
+    static std::vector<uint8_t> bytes(const std::string &text)
+    {
+        return std::vector<uint8_t>(text.begin(), text.end());
+    }
+
+    const PeerId alice{0x0A0A0A0A0A0A0A0AULL};
+    const PeerId bob{0x0B0B0B0B0B0B0B0BULL};
+};
+
+// ============================================================================
+// Tests for SenderKeyStore
+// ============================================================================
+
+TEST_F(SenderKeyStoreTest, Decrypt_WithDistributedKey_ReadsBroadcast)
+{
+    SenderKeyStore sender;
+    SenderKeyStore receiver;
+
+    auto message = sender.encrypt(alice, bytes("before the key"));
+    ASSERT_TRUE(message.has_value());
+    EXPECT_EQ(receiver.decrypt(alice, *message), std::nullopt);
+
+    std::vector<uint8_t> distribution = sender.getDistributionMessage();
+    EXPECT_EQ(distribution.size(), SenderKeyStore::DISTRIBUTION_SIZE);
+    EXPECT_FALSE(receiver.processDistributionMessage(alice, std::vector<uint8_t>(10)));
+    ASSERT_TRUE(receiver.processDistributionMessage(alice, distribution));
+    EXPECT_TRUE(receiver.hasSenderKey(alice));
+
+    auto broadcast = sender.encrypt(alice, bytes("hello channel"));
+    ASSERT_TRUE(broadcast.has_value());
+    EXPECT_EQ(broadcast->size(), SenderKeyStore::HEADER_SIZE + 13 + SenderKeyStore::TAG_SIZE);
+    EXPECT_THAT(receiver.decrypt(alice, *broadcast), Optional(bytes("hello channel")));
+
+    // Replays, another sender and tampering are all refused
+    EXPECT_EQ(receiver.decrypt(alice, *broadcast), std::nullopt);
+    EXPECT_EQ(receiver.decrypt(bob, *broadcast), std::nullopt);
+
+    auto tampered = sender.encrypt(alice, bytes("hello again"));
+    ASSERT_TRUE(tampered.has_value());
+    (*tampered)[SenderKeyStore::HEADER_SIZE] ^= 0x01;
+    EXPECT_EQ(receiver.decrypt(alice, *tampered), std::nullopt);
+}
+
+TEST_F(SenderKeyStoreTest, Decrypt_OutOfOrder_UsesSkippedKeys)
+{
+    SenderKeyStore sender(SenderKeyStore::Config{4, 3, 100});
+    SenderKeyStore receiver(SenderKeyStore::Config{4, 3, 100});
+    ASSERT_TRUE(receiver.processDistributionMessage(alice, sender.getDistributionMessage()));
+
+    std::vector<std::vector<uint8_t>> messages;
+
+    for (int i = 0; i < 6; i++)
+    {
+        auto message = sender.encrypt(alice, bytes("message " + std::to_string(i)));
+        ASSERT_TRUE(message.has_value());
+        messages.push_back(*message);
+    }
+
+    EXPECT_THAT(receiver.decrypt(alice, messages[2]), Optional(bytes("message 2")));
+    EXPECT_THAT(receiver.decrypt(alice, messages[0]), Optional(bytes("message 0")));
+    EXPECT_EQ(receiver.decrypt(alice, messages[0]), std::nullopt);
+    EXPECT_THAT(receiver.decrypt(alice, messages[1]), Optional(bytes("message 1")));
+
+    // More than maxSkip iterations ahead is refused and leaves the chain where it was
+    for (int i = 0; i < 20; i++)
+    {
+        ASSERT_TRUE(sender.encrypt(alice, bytes("lost")).has_value());
+    }
+
+    auto farAhead = sender.encrypt(alice, bytes("far ahead"));
+    ASSERT_TRUE(farAhead.has_value());
+    EXPECT_EQ(receiver.decrypt(alice, *farAhead), std::nullopt);
+    EXPECT_THAT(receiver.decrypt(alice, messages[5]), Optional(bytes("message 5")));
+}
+
+TEST_F(SenderKeyStoreTest, ProcessDistribution_SameKeyID_DoesNotRewindChain)
+{
+    SenderKeyStore sender;
+    SenderKeyStore receiver;
+    std::vector<uint8_t> distribution = sender.getDistributionMessage();
+    ASSERT_TRUE(receiver.processDistributionMessage(alice, distribution));
+
+    auto message = sender.encrypt(alice, bytes("once"));
+    ASSERT_TRUE(message.has_value());
+    EXPECT_THAT(receiver.decrypt(alice, *message), Optional(bytes("once")));
+
+    // Replaying the first distribution must not make the message readable again
+    EXPECT_TRUE(receiver.processDistributionMessage(alice, distribution));
+    EXPECT_EQ(receiver.decrypt(alice, *message), std::nullopt);
+
+    auto next = sender.encrypt(alice, bytes("next"));
+    ASSERT_TRUE(next.has_value());
+    EXPECT_THAT(receiver.decrypt(alice, *next), Optional(bytes("next")));
+}
+
+TEST_F(SenderKeyStoreTest, Rotate_RequiresNewDistribution)
+{
+    SenderKeyStore sender(SenderKeyStore::Config{4, 8, 2});
+    SenderKeyStore receiver;
+    ASSERT_TRUE(receiver.processDistributionMessage(alice, sender.getDistributionMessage()));
+
+    ASSERT_TRUE(sender.encrypt(alice, bytes("one")).has_value());
+    EXPECT_FALSE(sender.needsRotation());
+    ASSERT_TRUE(sender.encrypt(alice, bytes("two")).has_value());
+    EXPECT_TRUE(sender.needsRotation());
+
+    sender.rotate();
+    EXPECT_FALSE(sender.needsRotation());
+
+    auto message = sender.encrypt(alice, bytes("three"));
+    ASSERT_TRUE(message.has_value());
+    EXPECT_EQ(receiver.decrypt(alice, *message), std::nullopt);
+
+    ASSERT_TRUE(receiver.processDistributionMessage(alice, sender.getDistributionMessage()));
+    auto next = sender.encrypt(alice, bytes("four"));
+    ASSERT_TRUE(next.has_value());
+    EXPECT_THAT(receiver.decrypt(alice, *next), Optional(bytes("four")));
+
+    receiver.removeSenderKey(alice);
+    EXPECT_FALSE(receiver.hasSenderKey(alice));
+}
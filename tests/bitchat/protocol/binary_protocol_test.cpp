@@ -0,0 +1,175 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/protocol/binary_protocol.h"
+#include <chrono>
+#include <random>
+
+using namespace bitchat::protocol;
+using namespace ::testing;
+
+class BinaryProtocolTest : public Test
+{
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+
+    BitchatChatMessage createChatMessage(const std::string &content)
+    {
+        BitchatChatMessage message;
+        message.version = BinaryProtocolConstants::currentVersion;
+        message.type = BitchatMessageType::Message;
+        message.peerID = "0102030405060708";
+        message.timestamp = std::chrono::system_clock::time_point(std::chrono::milliseconds(1700000000000LL));
+        message.nickname = "alice";
+        message.channel = "#general";
+        message.content = content;
+        message.isEncrypted = false;
+
+        return message;
+    }
+
+    // Byte-at-a-time reference implementation
+    static uint16_t referenceFletcher16(const std::vector<uint8_t> &data)
+    {
+        uint16_t sum1 = 0;
+        uint16_t sum2 = 0;
+
+        for (uint8_t byte : data)
+        {
+            sum1 = (sum1 + byte) % 255;
+            sum2 = (sum2 + sum1) % 255;
+        }
+
+        return static_cast<uint16_t>((sum2 << 8) | sum1);
+    }
+};
+
+// ============================================================================
+// Tests for BinaryProtocol
+// ============================================================================
+
+TEST_F(BinaryProtocolTest, RoundTrip_ChatMessage_PreservesFields)
+{
+    BitchatChatMessage message = createChatMessage("hello world");
+    std::vector<uint8_t> data = BinaryProtocol::serializeChatMessage(message);
+
+    ASSERT_GT(data.size(), BinaryProtocolConstants::headerSize);
+    EXPECT_EQ(data[0], BinaryProtocolConstants::magicByte);
+    EXPECT_TRUE(BinaryProtocol::validatePacket(data));
+    EXPECT_EQ(BinaryProtocol::getMessageType(data), BitchatMessageType::Message);
+
+    auto parsed = BinaryProtocol::deserializeChatMessage(data);
+    ASSERT_NE(parsed, nullptr);
+    EXPECT_EQ(parsed->peerID, message.peerID);
+    EXPECT_EQ(parsed->timestamp, message.timestamp);
+    EXPECT_EQ(parsed->nickname, message.nickname);
+    EXPECT_EQ(parsed->channel, message.channel);
+    EXPECT_EQ(parsed->content, message.content);
+    EXPECT_FALSE(parsed->isEncrypted);
+}
+
+TEST_F(BinaryProtocolTest, RoundTrip_ErrorPacket_PreservesFields)
+{
+    std::vector<uint8_t> data = BinaryProtocol::createErrorPacket(BitchatErrorCode::RateLimitExceeded, "slow down");
+    auto parsed = BinaryProtocol::deserializeErrorMessage(data);
+
+    ASSERT_NE(parsed, nullptr);
+    EXPECT_EQ(parsed->errorCode, BitchatErrorCode::RateLimitExceeded);
+    EXPECT_EQ(parsed->errorMessage, "slow down");
+    EXPECT_FALSE(parsed->originalMessageId.has_value());
+}
+
+TEST_F(BinaryProtocolTest, Serialize_TypeDoesNotMatchStructure_ReturnsEmpty)
+{
+    BitchatChatMessage message = createChatMessage("hello");
+    message.type = BitchatMessageType::Handshake;
+
+    EXPECT_TRUE(BinaryProtocol::serializeMessage(message).empty());
+}
+
+TEST_F(BinaryProtocolTest, Deserialize_CorruptedPayload_ReturnsNull)
+{
+    std::vector<uint8_t> data = BinaryProtocol::serializeChatMessage(createChatMessage("hello world"));
+    data.back() ^= 0x01;
+
+    EXPECT_FALSE(BinaryProtocol::validatePacket(data));
+    EXPECT_EQ(BinaryProtocol::deserializeMessage(data), nullptr);
+}
+
+TEST_F(BinaryProtocolTest, Checksum_MatchesReferenceForAllLengths)
+{
+    std::mt19937 gen(7);
+    std::vector<uint8_t> data;
+
+    // Covers the vector and scalar paths, block boundaries and worst-case bytes
+    for (size_t size : {0, 1, 15, 16, 17, 31, 255, 4095, 4096, 4097, 10000})
+    {
+        data.resize(size);
+
+        for (auto &byte : data)
+        {
+            byte = static_cast<uint8_t>(gen());
+        }
+
+        BinaryPacketHeader header{};
+        EXPECT_EQ(header.computeChecksum(data), referenceFletcher16(data)) << "size " << size;
+
+        std::fill(data.begin(), data.end(), 0xFF);
+        EXPECT_EQ(header.computeChecksum(data), referenceFletcher16(data)) << "size " << size << " (0xFF)";
+    }
+}
+
+TEST_F(BinaryProtocolTest, Builder_FinalizePacket_MatchesBuildPacket)
+{
+    BinaryProtocolBuilder builder;
+    BitchatChatMessage message = createChatMessage("hello");
+
+    std::vector<uint8_t> payload = builder.buildPayload(message);
+    BinaryPacketHeader header = builder.buildHeader(BitchatMessageType::Message, payload.size());
+
+    EXPECT_EQ(builder.finalizePacket(header, payload), builder.buildPacket(message));
+}
+
+// ============================================================================
+// Tests for BinaryProtocolParser
+// ============================================================================
+
+TEST_F(BinaryProtocolTest, Parser_ByteByByteWithGarbage_ParsesAll)
+{
+    BinaryProtocolBuilder builder;
+    std::vector<uint8_t> stream = {0x00, 0xBC, 0x42};
+
+    for (int i = 0; i < 5; i++)
+    {
+        ASSERT_TRUE(builder.buildPacket(createChatMessage("message " + std::to_string(i)), stream));
+    }
+
+    BinaryProtocolParser parser;
+    std::vector<std::shared_ptr<BitchatMessage>> messages;
+
+    for (uint8_t byte : stream)
+    {
+        auto parsed = parser.parseData(std::vector<uint8_t>{byte});
+        messages.insert(messages.end(), parsed.begin(), parsed.end());
+    }
+
+    ASSERT_EQ(messages.size(), 5u);
+    EXPECT_EQ(std::dynamic_pointer_cast<BitchatChatMessage>(messages[4])->content, "message 4");
+    EXPECT_FALSE(parser.hasIncompleteData());
+}
+
+TEST_F(BinaryProtocolTest, Parser_PartialPacket_KeepsRemainingData)
+{
+    std::vector<uint8_t> data = BinaryProtocol::serializeChatMessage(createChatMessage("hello"));
+    std::vector<uint8_t> firstHalf(data.begin(), data.begin() + data.size() / 2);
+
+    BinaryProtocolParser parser;
+    EXPECT_TRUE(parser.parseData(firstHalf).empty());
+    EXPECT_TRUE(parser.hasIncompleteData());
+    EXPECT_EQ(parser.getRemainingData(), firstHalf);
+
+    auto messages = parser.parseData(std::span<const uint8_t>(data).subspan(data.size() / 2));
+    EXPECT_EQ(messages.size(), 1u);
+    EXPECT_FALSE(parser.hasIncompleteData());
+}
@@ -0,0 +1,158 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/protocol/dedup_filter.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace bitchat;
+using namespace ::testing;
+using namespace std::chrono_literals;
+
+class DedupFilterTest : public Test
+{
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+
+    static DedupFilter::Config makeConfig(size_t capacity, double falsePositiveRate, size_t shards = 1)
+    {
+        return DedupFilter::Config{capacity, falsePositiveRate, 1000ms, 4, shards};
+    }
+
+    static uint64_t keyAt(uint64_t index)
+    {
+        return DedupFilter::makeKey(PeerId(0x0102030405060708ULL), index, 0x04);
+    }
+};
+
+// ============================================================================
+// Tests for DedupFilter
+// ============================================================================
+
+TEST_F(DedupFilterTest, Insert_Duplicate_ReturnsFalse)
+{
+    DedupFilter filter;
+
+    EXPECT_FALSE(filter.contains(keyAt(1)));
+    EXPECT_TRUE(filter.insert(keyAt(1)));
+    EXPECT_FALSE(filter.insert(keyAt(1)));
+    EXPECT_TRUE(filter.contains(keyAt(1)));
+    EXPECT_TRUE(filter.insert(keyAt(2)));
+
+    filter.clear();
+    EXPECT_TRUE(filter.insert(keyAt(1)));
+}
+
+TEST_F(DedupFilterTest, MakeKey_DiffersByEveryField)
+{
+    PeerId sender(0x0102030405060708ULL);
+    std::vector<uint8_t> first = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    std::vector<uint8_t> second = {1, 2, 3, 4, 5, 6, 7, 8, 9, 11};
+
+    uint64_t key = DedupFilter::makeKey(sender, 100, 0x04);
+
+    EXPECT_EQ(key, DedupFilter::makeKey(sender, 100, 0x04));
+    EXPECT_NE(key, DedupFilter::makeKey(PeerId(0x0102030405060709ULL), 100, 0x04));
+    EXPECT_NE(key, DedupFilter::makeKey(sender, 101, 0x04));
+    EXPECT_NE(key, DedupFilter::makeKey(sender, 100, 0x05));
+    EXPECT_NE(DedupFilter::makeKey(sender, 100, 0x05, first), DedupFilter::makeKey(sender, 100, 0x05, second));
+}
+
+TEST_F(DedupFilterTest, Window_KeyExpiresAfterWindow)
+{
+    DedupFilter filter(makeConfig(1000, 0.001));
+    auto start = DedupFilter::Clock::now();
+
+    ASSERT_TRUE(filter.insert(keyAt(1), start));
+
+    // Remembered for the whole window, even across idle spans
+    EXPECT_TRUE(filter.contains(keyAt(1), start + 500ms));
+    EXPECT_FALSE(filter.insert(keyAt(1), start + 999ms));
+
+    // Gone once every generation holding it has rotated out
+    EXPECT_FALSE(filter.contains(keyAt(1), start + 1500ms));
+    EXPECT_TRUE(filter.insert(keyAt(1), start + 1500ms));
+}
+
+TEST_F(DedupFilterTest, Capacity_Overflow_KeepsMostRecentKeys)
+{
+    DedupFilter filter(makeConfig(1000, 0.001));
+    auto now = DedupFilter::Clock::now();
+
+    // A few inserts may report false positives, the keys are remembered either way
+    for (uint64_t i = 0; i < 5000; i++)
+    {
+        filter.insert(keyAt(i), now);
+    }
+
+    // The newest keys survive the overflow, the oldest were rotated out
+    for (uint64_t i = 4500; i < 5000; i++)
+    {
+        EXPECT_TRUE(filter.contains(keyAt(i), now)) << "key " << i;
+    }
+
+    size_t oldRemembered = 0;
+
+    for (uint64_t i = 0; i < 1000; i++)
+    {
+        oldRemembered += filter.contains(keyAt(i), now) ? 1 : 0;
+    }
+
+    EXPECT_LT(oldRemembered, 10u);
+}
+
+TEST_F(DedupFilterTest, FalsePositiveRate_NearConfigured)
+{
+    constexpr size_t capacity = 10000;
+    constexpr size_t probes = 100000;
+    DedupFilter filter(makeConfig(capacity, 0.01, 4));
+    auto now = DedupFilter::Clock::now();
+
+    for (uint64_t i = 0; i < capacity; i++)
+    {
+        filter.insert(keyAt(i), now);
+    }
+
+    size_t falsePositives = 0;
+
+    for (uint64_t i = capacity; i < capacity + probes; i++)
+    {
+        falsePositives += filter.contains(keyAt(i), now) ? 1 : 0;
+    }
+
+    EXPECT_LT(static_cast<double>(falsePositives) / probes, 0.02);
+    EXPECT_LT(filter.getMemoryUsage(), 64u * 1024u);
+}
+
+TEST_F(DedupFilterTest, Insert_Concurrent_OneWinnerPerKey)
+{
+    constexpr size_t keyCount = 20000;
+    constexpr int threadCount = 4;
+    DedupFilter filter(makeConfig(keyCount, 1e-6, 16));
+    std::atomic<size_t> inserted{0};
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < threadCount; t++)
+    {
+        // clang-format off
+        threads.emplace_back([&]() {
+            for (uint64_t i = 0; i < keyCount; i++)
+            {
+                if (filter.insert(keyAt(i)))
+                {
+                    inserted++;
+                }
+            }
+        });
+        // clang-format on
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(inserted.load(), keyCount);
+}
@@ -0,0 +1,159 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/protocol/fragment_reassembler.h"
+#include "bitchat/protocol/packet_fragmenter.h"
+#include "bitchat/protocol/packet_serializer.h"
+#include <algorithm>
+#include <random>
+
+using namespace bitchat;
+using namespace ::testing;
+
+class PacketFragmenterTest : public Test
+{
+protected:
+    void SetUp() override
+    {
+        // Random payload so compression cannot shrink the frame below the MTU
+        std::mt19937 gen(42);
+        std::vector<uint8_t> payload(4000);
+
+        for (auto &byte : payload)
+        {
+            byte = static_cast<uint8_t>(gen());
+        }
+
+        packet = BitchatPacket(PKT_TYPE_MESSAGE, payload);
+        packet.setTimestamp(1700000000000ULL);
+        packet.setSenderID({0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88});
+
+        frame = serializer.serializePacket(packet);
+        frame.resize(PacketSerializer::getFrameSize(frame));
+    }
+
+    void TearDown() override {}
+
+    std::vector<BitchatPacket> fragment(size_t mtu = 512)
+    {
+        return PacketFragmenter::fragment(packet, frame, mtu);
+    }
+
+    PacketSerializer serializer;
+    BitchatPacket packet;
+    std::vector<uint8_t> frame;
+};
+
+// ============================================================================
+// Tests for PacketFragmenter
+// ============================================================================
+
+TEST_F(PacketFragmenterTest, Fragment_LargeFrame_FragmentsFitMTU)
+{
+    std::vector<BitchatPacket> fragments = fragment();
+
+    ASSERT_GT(fragments.size(), 1u);
+    EXPECT_EQ(fragments.front().getType(), PKT_TYPE_FRAGMENT_START);
+    EXPECT_EQ(fragments.back().getType(), PKT_TYPE_FRAGMENT_END);
+
+    for (const auto &fragmentPacket : fragments)
+    {
+        EXPECT_LE(serializer.serializePacket(fragmentPacket).size(), 512u);
+        EXPECT_EQ(fragmentPacket.getSenderID(), packet.getSenderID());
+    }
+}
+
+TEST_F(PacketFragmenterTest, FragmentHeader_Parse_RejectsIndexOutOfRange)
+{
+    std::vector<uint8_t> payload(FragmentHeader::SIZE, 0);
+    payload[9] = 2;  // index 2
+    payload[11] = 2; // total 2
+
+    FragmentHeader header;
+    EXPECT_FALSE(FragmentHeader::parse(payload, header));
+}
+
+// ============================================================================
+// Tests for FragmentReassembler
+// ============================================================================
+
+TEST_F(PacketFragmenterTest, Reassemble_InOrder_RestoresFrame)
+{
+    FragmentReassembler reassembler;
+    std::optional<std::vector<uint8_t>> result;
+
+    for (const auto &fragmentPacket : fragment())
+    {
+        EXPECT_FALSE(result.has_value());
+        result = reassembler.addFragment(fragmentPacket.getSenderID(), fragmentPacket.getPayload());
+    }
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, frame);
+    EXPECT_EQ(serializer.deserializePacket(*result).getPayload(), packet.getPayload());
+    EXPECT_EQ(reassembler.getPendingCount(), 0u);
+    EXPECT_EQ(reassembler.getBufferedBytes(), 0u);
+}
+
+TEST_F(PacketFragmenterTest, Reassemble_OutOfOrderWithDuplicates_RestoresFrame)
+{
+    FragmentReassembler reassembler;
+    std::vector<BitchatPacket> fragments = fragment();
+    std::reverse(fragments.begin(), fragments.end());
+    fragments.insert(fragments.begin() + 1, fragments.front());
+
+    std::optional<std::vector<uint8_t>> result;
+
+    for (const auto &fragmentPacket : fragments)
+    {
+        auto completed = reassembler.addFragment(fragmentPacket.getSenderID(), fragmentPacket.getPayload());
+
+        if (completed)
+        {
+            result = completed;
+        }
+    }
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, frame);
+}
+
+TEST_F(PacketFragmenterTest, Reassemble_SenderQuotaExceeded_DropsTransfer)
+{
+    FragmentReassembler reassembler(1024);
+    std::vector<BitchatPacket> fragments = fragment();
+
+    for (const auto &fragmentPacket : fragments)
+    {
+        EXPECT_FALSE(reassembler.addFragment(fragmentPacket.getSenderID(), fragmentPacket.getPayload()).has_value());
+    }
+
+    EXPECT_LE(reassembler.getBufferedBytes(), 1024u);
+}
+
+TEST_F(PacketFragmenterTest, Reassemble_Timeout_DropsIncompleteTransfer)
+{
+    FragmentReassembler reassembler;
+    std::vector<BitchatPacket> fragments = fragment();
+    auto start = FragmentReassembler::Clock::now();
+
+    reassembler.addFragment(fragments[0].getSenderID(), fragments[0].getPayload(), start);
+    EXPECT_EQ(reassembler.getPendingCount(), 1u);
+
+    reassembler.cleanupExpired(start + constants::FRAGMENT_TIMEOUT + std::chrono::seconds(1));
+    EXPECT_EQ(reassembler.getPendingCount(), 0u);
+    EXPECT_EQ(reassembler.getBufferedBytes(), 0u);
+}
+
+TEST_F(PacketFragmenterTest, Reassemble_TooManyAssembliesPerSender_Rejected)
+{
+    FragmentReassembler reassembler(constants::FRAGMENT_MAX_BYTES_PER_SENDER, 2);
+
+    for (int i = 0; i < 3; i++)
+    {
+        std::vector<BitchatPacket> fragments = fragment();
+        reassembler.addFragment(fragments[0].getSenderID(), fragments[0].getPayload());
+    }
+
+    EXPECT_EQ(reassembler.getPendingCount(), 2u);
+}
@@ -0,0 +1,415 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/helpers/compression_helper.h"
+#include "bitchat/protocol/compression_stats.h"
+#include "bitchat/protocol/message_padding.h"
+#include "bitchat/protocol/packet_serializer.h"
+#include <algorithm>
+#include <random>
+
+using namespace bitchat;
+using namespace ::testing;
+
+class PacketSerializerTest : public Test
+{
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+
+    BitchatPacket createPacket(const std::vector<uint8_t> &payload, bool withRecipient = false, bool withSignature = false)
+    {
+        BitchatPacket packet(PKT_TYPE_MESSAGE, payload);
+        packet.setTimestamp(1700000000000ULL);
+        packet.setSenderID({0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08});
+
+        if (withRecipient)
+        {
+            packet.setRecipientID(std::vector<uint8_t>(8, 0xFF));
+            packet.setHasRecipient(true);
+        }
+
+        if (withSignature)
+        {
+            packet.setSignature(std::vector<uint8_t>(64, 0xAB));
+            packet.setHasSignature(true);
+        }
+
+        return packet;
+    }
+
+    PacketSerializer serializer;
+};
+
+// ============================================================================
+// Tests for serializePacket / deserializePacket round trip
+// ============================================================================
+
+TEST_F(PacketSerializerTest, RoundTrip_SimplePacket_PreservesFields)
+{
+    BitchatPacket packet = createPacket({'h', 'e', 'l', 'l', 'o'});
+
+    BitchatPacket result = serializer.deserializePacket(serializer.serializePacket(packet));
+
+    EXPECT_TRUE(result.isValid());
+    EXPECT_EQ(result.getType(), PKT_TYPE_MESSAGE);
+    EXPECT_EQ(result.getTTL(), PKT_TTL);
+    EXPECT_EQ(result.getTimestamp(), packet.getTimestamp());
+    EXPECT_EQ(result.getSenderID(), packet.getSenderID());
+    EXPECT_EQ(result.getPayload(), packet.getPayload());
+}
+
+TEST_F(PacketSerializerTest, RoundTrip_RecipientAndSignature_PreservesFields)
+{
+    BitchatPacket packet = createPacket({1, 2, 3}, true, true);
+
+    BitchatPacket result = serializer.deserializePacket(serializer.serializePacket(packet));
+
+    EXPECT_TRUE(result.hasRecipient());
+    EXPECT_TRUE(result.hasSignature());
+    EXPECT_EQ(result.getRecipientID(), packet.getRecipientID());
+    EXPECT_EQ(result.getSignature(), packet.getSignature());
+    EXPECT_EQ(result.getPayload(), packet.getPayload());
+}
+
+TEST_F(PacketSerializerTest, RoundTrip_CompressiblePayload_Decompresses)
+{
+    BitchatPacket packet = createPacket(std::vector<uint8_t>(600, 'a'));
+
+    std::vector<uint8_t> data = serializer.serializePacket(packet);
+    BitchatPacket result = serializer.deserializePacket(data);
+
+    EXPECT_LT(data.size(), packet.getPayload().size());
+    EXPECT_EQ(result.getPayload(), packet.getPayload());
+}
+
+// ============================================================================
+// Tests for parsePacketView
+// ============================================================================
+
+TEST_F(PacketSerializerTest, ParsePacketView_PaddedFrame_PointsIntoBuffer)
+{
+    BitchatPacket packet = createPacket({9, 8, 7}, true, true);
+    std::vector<uint8_t> data = serializer.serializePacket(packet);
+
+    std::optional<PacketView> view = serializer.parsePacketView(data);
+
+    ASSERT_TRUE(view.has_value());
+    EXPECT_TRUE(view->isValid());
+    EXPECT_EQ(view->getFrame().data(), data.data());
+    EXPECT_EQ(view->getFrame().size(), packet.getTotalSize());
+    EXPECT_LT(view->getFrame().size(), data.size());
+    EXPECT_EQ(view->getTimestamp(), packet.getTimestamp());
+    EXPECT_TRUE(std::ranges::equal(view->getSenderID(), packet.getSenderID()));
+    EXPECT_TRUE(std::ranges::equal(view->getRecipientID(), packet.getRecipientID()));
+    EXPECT_TRUE(std::ranges::equal(view->getPayload(), packet.getPayload()));
+    EXPECT_TRUE(std::ranges::equal(view->getSignature(), packet.getSignature()));
+}
+
+TEST_F(PacketSerializerTest, ParsePacketView_TruncatedFrame_ReturnsNullopt)
+{
+    std::vector<uint8_t> data = serializer.serializePacket(createPacket(std::vector<uint8_t>(40, 1)));
+    size_t frameSize = PacketSerializer::getFrameSize(data);
+
+    data.resize(frameSize - 1);
+
+    EXPECT_FALSE(serializer.parsePacketView(data).has_value());
+}
+
+TEST_F(PacketSerializerTest, ParsePacketView_ShortBuffer_ReturnsNullopt)
+{
+    std::vector<uint8_t> data(PKT_MIN_SIZE - 1, 0);
+    EXPECT_FALSE(serializer.parsePacketView(data).has_value());
+    EXPECT_EQ(PacketSerializer::getFrameSize(std::span<const uint8_t>(data.data(), 4)), 0u);
+}
+
+TEST_F(PacketSerializerTest, ParsePacketView_BackToBackFrames_ParsesEach)
+{
+    std::vector<uint8_t> first = serializer.serializePacket(createPacket({1}));
+    std::vector<uint8_t> second = serializer.serializePacket(createPacket({2, 2}));
+    std::vector<uint8_t> stream = first;
+    stream.insert(stream.end(), second.begin(), second.end());
+
+    std::optional<PacketView> view = serializer.parsePacketView(stream);
+    ASSERT_TRUE(view.has_value());
+    EXPECT_EQ(MessagePadding::paddedSize(view->getFrame().size()), first.size());
+
+    std::optional<PacketView> next = serializer.parsePacketView(std::span<const uint8_t>(stream).subspan(first.size()));
+    ASSERT_TRUE(next.has_value());
+    EXPECT_EQ(next->getPayload().size(), 2u);
+}
+
+// ============================================================================
+// Tests for serializeInto
+// ============================================================================
+
+TEST_F(PacketSerializerTest, SerializeInto_ProducesParsableFrame)
+{
+    BitchatPacket packet = createPacket(std::vector<uint8_t>(300, 'b'), true, true);
+    OutputBuffer output;
+
+    serializer.serializeInto(packet, output);
+    BitchatPacket result = serializer.deserializePacket(std::vector<uint8_t>(output.data(), output.data() + output.size()));
+
+    EXPECT_EQ(output.size(), serializer.serializePacket(packet).size());
+    EXPECT_EQ(result.getPayload(), packet.getPayload());
+    EXPECT_EQ(result.getRecipientID(), packet.getRecipientID());
+    EXPECT_EQ(result.getSignature(), packet.getSignature());
+}
+
+TEST_F(PacketSerializerTest, SerializeInto_ReusedBuffer_DoesNotReallocate)
+{
+    OutputBuffer output;
+    serializer.serializeInto(createPacket(std::vector<uint8_t>(500, 'c'), true, true), output);
+
+    const uint8_t *storage = output.data();
+    size_t capacity = output.capacity();
+
+    for (size_t size : {1, 50, 150, 400})
+    {
+        serializer.serializeInto(createPacket(std::vector<uint8_t>(size, 'd')), output);
+
+        EXPECT_EQ(output.data(), storage);
+        EXPECT_EQ(output.capacity(), capacity);
+        EXPECT_TRUE(serializer.parsePacketView(output.getData()).has_value());
+    }
+}
+
+TEST_F(PacketSerializerTest, SerializeInto_CompressedFlagWithoutCompression_IsCleared)
+{
+    BitchatPacket packet = createPacket({1, 2, 3});
+    packet.setCompressed(true);
+    OutputBuffer output;
+
+    serializer.serializeInto(packet, output);
+    std::optional<PacketView> view = serializer.parsePacketView(output.getData());
+
+    ASSERT_TRUE(view.has_value());
+    EXPECT_FALSE(view->isCompressed());
+    EXPECT_TRUE(std::ranges::equal(view->getPayload(), packet.getPayload()));
+}
+
+// ============================================================================
+// Tests for makeRelayFrame
+// ============================================================================
+
+TEST_F(PacketSerializerTest, MakeRelayFrame_PatchesOnlyTTL)
+{
+    BitchatPacket packet = createPacket(std::vector<uint8_t>(200, 'r'), true, true);
+    std::vector<uint8_t> data = serializer.serializePacket(packet);
+    std::optional<PacketView> view = serializer.parsePacketView(data);
+    ASSERT_TRUE(view.has_value());
+
+    auto relayFrame = serializer.makeRelayFrame(*view, view->getTTL() - 1);
+    std::optional<PacketView> relayed = serializer.parsePacketView(*relayFrame);
+
+    ASSERT_TRUE(relayed.has_value());
+    EXPECT_EQ(relayFrame->size(), data.size());
+    EXPECT_EQ(relayed->getTTL(), PKT_TTL - 1);
+    EXPECT_EQ(relayed->getFrame().size(), view->getFrame().size());
+
+    for (size_t i = 0; i < view->getFrame().size(); i++)
+    {
+        if (i != 2)
+        {
+            EXPECT_EQ(relayed->getFrame()[i], view->getFrame()[i]) << "byte " << i;
+        }
+    }
+
+    EXPECT_EQ(relayed->toPacket().getPayload(), packet.getPayload());
+}
+
+// ============================================================================
+// Tests for the compression stage
+// ============================================================================
+
+TEST_F(PacketSerializerTest, Compression_TextPayload_IsCompressedAndCounted)
+{
+    CompressionStats::shared().reset();
+
+    std::string text;
+
+    while (text.size() < 600)
+    {
+        text += "the quick brown fox jumps over the lazy dog ";
+    }
+
+    std::vector<uint8_t> data = serializer.serializePacket(createPacket(std::vector<uint8_t>(text.begin(), text.end())));
+    std::optional<PacketView> view = serializer.parsePacketView(data);
+    ASSERT_TRUE(view.has_value());
+    EXPECT_TRUE(view->isCompressed());
+
+    CompressionTypeStats stats = CompressionStats::shared().getStats(PKT_TYPE_MESSAGE);
+    EXPECT_EQ(stats.packets, 1u);
+    EXPECT_EQ(stats.compressed, 1u);
+    EXPECT_LT(stats.getRatio(), 0.5);
+}
+
+TEST_F(PacketSerializerTest, Compression_RandomPayload_SkippedByEntropyProbe)
+{
+    CompressionStats::shared().reset();
+
+    std::mt19937 gen(1);
+    std::vector<uint8_t> payload(600);
+
+    for (auto &byte : payload)
+    {
+        byte = static_cast<uint8_t>(gen());
+    }
+
+    EXPECT_FALSE(CompressionHelper::shouldCompress(payload));
+
+    std::vector<uint8_t> data = serializer.serializePacket(createPacket(payload));
+    EXPECT_FALSE(serializer.parsePacketView(data)->isCompressed());
+    EXPECT_EQ(CompressionStats::shared().getStats(PKT_TYPE_MESSAGE).skipped, 1u);
+}
+
+TEST_F(PacketSerializerTest, Compression_EncryptedType_NeverTried)
+{
+    CompressionStats::shared().reset();
+
+    BitchatPacket packet = createPacket(std::vector<uint8_t>(600, 'a'));
+    packet.setType(PKT_TYPE_NOISE_ENCRYPTED);
+
+    std::vector<uint8_t> data = serializer.serializePacket(packet);
+    EXPECT_FALSE(serializer.parsePacketView(data)->isCompressed());
+
+    CompressionTypeStats stats = CompressionStats::shared().getStats(PKT_TYPE_NOISE_ENCRYPTED);
+    EXPECT_EQ(stats.skipped, 1u);
+    EXPECT_EQ(stats.bytesIn, 0u);
+}
+
+TEST_F(PacketSerializerTest, Compression_SenderKeyTypesWithDictionary_NeverTried)
+{
+    CompressionStats::shared().reset();
+
+    for (uint8_t type : {PKT_TYPE_SENDER_KEY, PKT_TYPE_SENDER_KEY_MESSAGE})
+    {
+        // Short enough that the dictionary would skip the entropy probe
+        BitchatPacket packet = createPacket(std::vector<uint8_t>(64, 'a'));
+        packet.setType(type);
+        packet.setUsesDictionary(true);
+
+        std::vector<uint8_t> data = serializer.serializePacket(packet);
+        EXPECT_FALSE(serializer.parsePacketView(data)->isCompressed());
+        EXPECT_EQ(CompressionStats::shared().getStats(type).bytesIn, 0u);
+    }
+}
+
+TEST_F(PacketSerializerTest, Compression_ShortPayloadWithDictionary_ShrinksAndRoundTrips)
+{
+    std::string text = "hello everyone! is anyone here? see you later at #general";
+    BitchatPacket packet = createPacket(std::vector<uint8_t>(text.begin(), text.end()));
+
+    std::vector<uint8_t> plain = serializer.serializePacket(packet);
+    EXPECT_FALSE(serializer.parsePacketView(plain)->isCompressed());
+
+    packet.setUsesDictionary(true);
+    std::vector<uint8_t> data = serializer.serializePacket(packet);
+    std::optional<PacketView> view = serializer.parsePacketView(data);
+
+    ASSERT_TRUE(view.has_value());
+    EXPECT_TRUE(view->isCompressed());
+    EXPECT_TRUE(view->usesDictionary());
+    EXPECT_LT(view->getPayloadLength(), text.size());
+
+    BitchatPacket parsed = view->toPacket();
+    EXPECT_EQ(parsed.getPayload(), packet.getPayload());
+    EXPECT_FALSE(parsed.usesDictionary());
+}
+
+// ============================================================================
+// Tests for MessagePadding
+// ============================================================================
+
+TEST_F(PacketSerializerTest, Padding_PadInPlace_UsesReservedCapacity)
+{
+    std::vector<uint8_t> data(100, 0x42);
+    data.reserve(256);
+    const uint8_t *buffer = data.data();
+
+    ASSERT_TRUE(MessagePadding::padInPlace(data, 256));
+    EXPECT_EQ(data.size(), 256u);
+    EXPECT_EQ(data.data(), buffer);
+    EXPECT_EQ(data.back(), 156);
+
+    std::span<const uint8_t> unpadded = MessagePadding::unpadView(data);
+    EXPECT_EQ(unpadded.data(), data.data());
+    EXPECT_EQ(unpadded.size(), 100u);
+
+    ASSERT_TRUE(MessagePadding::unpadInPlace(data));
+    EXPECT_EQ(data, std::vector<uint8_t>(100, 0x42));
+}
+
+TEST_F(PacketSerializerTest, Padding_InvalidLength_LeavesDataUntouched)
+{
+    std::vector<uint8_t> data = {0x01, 0x02, 0x00};
+    EXPECT_EQ(MessagePadding::unpadView(data).size(), data.size());
+    EXPECT_FALSE(MessagePadding::unpadInPlace(data));
+
+    data.back() = 10;
+    EXPECT_EQ(MessagePadding::unpad(data), data);
+}
+
+TEST_F(PacketSerializerTest, Padding_FillPadding_IsRandomAcrossCalls)
+{
+    std::vector<uint8_t> first(200);
+    std::vector<uint8_t> second(200);
+
+    MessagePadding::fillPadding(first);
+    MessagePadding::fillPadding(second);
+
+    EXPECT_EQ(first.back(), 200);
+    EXPECT_NE(first, second);
+}
+
+// ============================================================================
+// Tests for BitchatMessageView
+// ============================================================================
+
+TEST_F(PacketSerializerTest, ParseMessageView_AllOptionalFields_MatchesMessage)
+{
+    BitchatMessage message;
+    message.setId("message-id");
+    message.setSender("alice");
+    message.setContent("hello");
+    message.setTimestamp(1700000000000ULL);
+    message.setPrivate(true);
+    message.setOriginalSender("bob");
+    message.setRecipientNickname("carol");
+    message.setSenderPeerID({0xAB, 0xCD, 0xEF, 0x01});
+    message.setMentions({"dave", "erin"});
+    message.setChannel("#general");
+
+    std::vector<uint8_t> payload = serializer.makeMessagePayload(message);
+    std::optional<BitchatMessageView> view = serializer.parseMessageView(payload);
+    ASSERT_TRUE(view.has_value());
+
+    EXPECT_TRUE(view->isPrivate());
+    EXPECT_EQ(view->getTimestamp(), 1700000000000ULL);
+    EXPECT_EQ(view->getId(), "message-id");
+    EXPECT_EQ(view->getSender(), "alice");
+    EXPECT_EQ(view->getContent(), "hello");
+    EXPECT_EQ(view->getRecipientNickname(), "carol");
+    EXPECT_EQ(view->getMentionCount(), 2u);
+    EXPECT_EQ(view->getMention(1), "erin");
+    EXPECT_EQ(view->getChannel(), "#general");
+
+    BitchatMessage parsed = view->toMessage();
+    EXPECT_EQ(parsed.getOriginalSender(), "bob");
+    EXPECT_EQ(parsed.getSenderPeerID(), message.getSenderPeerID());
+    EXPECT_EQ(parsed.getMentions(), message.getMentions());
+}
+
+TEST_F(PacketSerializerTest, ParseMessageView_TruncatedContent_ReturnsNullopt)
+{
+    BitchatMessage message;
+    message.setId("id");
+    message.setSender("alice");
+    message.setContent("hello world");
+
+    std::vector<uint8_t> payload = serializer.makeMessagePayload(message);
+    payload.resize(payload.size() - 4);
+
+    EXPECT_FALSE(serializer.parseMessageView(payload).has_value());
+}
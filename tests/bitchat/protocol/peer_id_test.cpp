@@ -0,0 +1,75 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/protocol/packet.h"
+#include "bitchat/protocol/peer_id.h"
+#include <unordered_set>
+
+using namespace bitchat;
+using namespace ::testing;
+
+class PeerIdTest : public Test
+{
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+// ============================================================================
+// Tests for PeerId
+// ============================================================================
+
+TEST_F(PeerIdTest, FromHex_ValidID_RoundTrips)
+{
+    auto id = PeerId::fromHex("0123456789ABCDEF");
+
+    ASSERT_TRUE(id.has_value());
+    EXPECT_EQ(id->getValue(), 0x0123456789ABCDEFULL);
+    EXPECT_EQ(id->toHex(), "0123456789abcdef");
+    EXPECT_EQ(id->toVector(), std::vector<uint8_t>({0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF}));
+}
+
+TEST_F(PeerIdTest, FromHex_InvalidID_ReturnsNullopt)
+{
+    EXPECT_FALSE(PeerId::fromHex("").has_value());
+    EXPECT_FALSE(PeerId::fromHex("0123456789abcde").has_value());
+    EXPECT_FALSE(PeerId::fromHex("0123456789abcdef00").has_value());
+    EXPECT_FALSE(PeerId::fromHex("0123456789abcdeg").has_value());
+}
+
+TEST_F(PeerIdTest, FromBytes_ShortInput_IsZeroFilled)
+{
+    std::vector<uint8_t> bytes = {0xAA, 0xBB};
+
+    EXPECT_EQ(PeerId::fromBytes(bytes).toHex(), "aabb000000000000");
+    EXPECT_TRUE(PeerId::fromBytes({}).isEmpty());
+}
+
+TEST_F(PeerIdTest, Ordering_MatchesHexOrdering)
+{
+    std::string lowHex = "7fffffffffffffff";
+    std::string highHex = "8000000000000000";
+
+    EXPECT_LT(lowHex, highHex);
+    EXPECT_LT(*PeerId::fromHex(lowHex), *PeerId::fromHex(highHex));
+}
+
+TEST_F(PeerIdTest, FormatAndHash_WorkAsKeys)
+{
+    PeerId id(0x00000000000000FFULL);
+    EXPECT_EQ(fmt::format("peer {}", id), "peer 00000000000000ff");
+
+    std::unordered_set<PeerId> ids = {id, PeerId(1), PeerId(0x00000000000000FFULL)};
+    EXPECT_EQ(ids.size(), 2u);
+    EXPECT_TRUE(ids.contains(PeerId(1)));
+}
+
+TEST_F(PeerIdTest, Packet_SetSenderID_WritesWireBytes)
+{
+    BitchatPacket packet;
+    PeerId id(0x1122334455667788ULL);
+
+    packet.setSenderID(id);
+    EXPECT_EQ(packet.getSenderID(), std::vector<uint8_t>({0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88}));
+    EXPECT_EQ(packet.getSenderPeerId(), id);
+}
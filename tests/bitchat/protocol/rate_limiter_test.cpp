@@ -0,0 +1,140 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/protocol/rate_limiter.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace bitchat;
+using namespace ::testing;
+using namespace std::chrono_literals;
+
+class RateLimiterTest : public Test
+{
+protected:
+    static RateLimiter::Config makeConfig(size_t peerMessages, size_t globalMessages, size_t slotsPerShard = 16, size_t linkMessages = 100000)
+    {
+        return RateLimiter::Config{{2, 1min}, {peerMessages, 1s}, {3, 1min}, {linkMessages, 1s}, {4, 1min}, {globalMessages, 1s}, 1, slotsPerShard};
+    }
+
+    // Allowed messages out of attempts, all at the same instant
+    static int countAllowed(RateLimiter &limiter, PeerId peerID, int attempts, RateLimiter::Clock::time_point now, const std::string &linkID = "link-a")
+    {
+        int allowed = 0;
+
+        for (int i = 0; i < attempts; i++)
+        {
+            allowed += limiter.allow(linkID, peerID, RateLimiter::Kind::Message, now) ? 1 : 0;
+        }
+
+        return allowed;
+    }
+
+    const PeerId alice{0xA1};
+    const PeerId bob{0xB2};
+    const RateLimiter::Clock::time_point start = RateLimiter::Clock::now();
+};
+
+// ============================================================================
+// Tests for RateLimiter
+// ============================================================================
+
+TEST_F(RateLimiterTest, Allow_BurstThenRefillsOverTime)
+{
+    RateLimiter limiter(makeConfig(10, 1000));
+
+    EXPECT_EQ(countAllowed(limiter, alice, 15, start), 10);
+
+    // One token per 100ms
+    EXPECT_EQ(countAllowed(limiter, alice, 5, start + 250ms), 2);
+    EXPECT_EQ(countAllowed(limiter, alice, 20, start + 5s), 10);
+
+    // Handshakes have their own buckets
+    EXPECT_TRUE(limiter.allow("link-a", alice, RateLimiter::Kind::Handshake, start));
+    EXPECT_TRUE(limiter.allow("link-a", alice, RateLimiter::Kind::Handshake, start));
+    EXPECT_FALSE(limiter.allow("link-a", alice, RateLimiter::Kind::Handshake, start));
+    EXPECT_TRUE(limiter.allow("link-a", alice, RateLimiter::Kind::Handshake, start + 30s));
+}
+
+TEST_F(RateLimiterTest, Allow_FloodingPeerDoesNotDrainGlobalBudget)
+{
+    RateLimiter limiter(makeConfig(5, 8));
+
+    EXPECT_EQ(countAllowed(limiter, alice, 100, start), 5);
+    EXPECT_EQ(countAllowed(limiter, bob, 5, start), 3);
+
+    RateLimiter::Stats stats = limiter.getStats();
+    EXPECT_EQ(stats.allowed, 8u);
+    EXPECT_EQ(stats.limitedPeer, 95u);
+    EXPECT_EQ(stats.limitedGlobal, 2u);
+}
+
+TEST_F(RateLimiterTest, Allow_SpoofedSenderOnOtherLinkDoesNotBlockPeer)
+{
+    RateLimiter limiter(makeConfig(5, 1000));
+
+    // Packets claiming to be from bob flood in on link b
+    EXPECT_EQ(countAllowed(limiter, bob, 100, start, "link-b"), 5);
+
+    // Bob's real packets arrive on link a and keep their own budget
+    EXPECT_EQ(countAllowed(limiter, bob, 5, start, "link-a"), 5);
+    EXPECT_EQ(limiter.getStats().limitedPeer, 95u);
+}
+
+TEST_F(RateLimiterTest, Allow_LinkBudgetCapsRotatingSenderIDs)
+{
+    RateLimiter limiter(makeConfig(5, 1000, 64, 20));
+
+    // A new sender ID for every packet still drains only the link bucket
+    int allowed = 0;
+
+    for (uint64_t i = 1; i <= 100; i++)
+    {
+        allowed += limiter.allow("link-b", PeerId(i), RateLimiter::Kind::Message, start) ? 1 : 0;
+    }
+
+    EXPECT_EQ(allowed, 20);
+    EXPECT_EQ(limiter.getStats().limitedLink, 80u);
+
+    // Other links are untouched
+    EXPECT_EQ(countAllowed(limiter, alice, 5, start, "link-a"), 5);
+}
+
+TEST_F(RateLimiterTest, Allow_FullTableSharesOverflowBuckets)
+{
+    RateLimiter limiter(makeConfig(3, 100000, 2));
+
+    EXPECT_EQ(countAllowed(limiter, PeerId(1), 3, start), 3);
+    EXPECT_EQ(countAllowed(limiter, PeerId(2), 3, start), 3);
+
+    // Both slots are busy, newcomers share one bucket
+    EXPECT_EQ(countAllowed(limiter, PeerId(3), 2, start), 2);
+    EXPECT_EQ(countAllowed(limiter, PeerId(4), 2, start), 1);
+
+    // Once refilled a slot is taken over by a new peer
+    EXPECT_EQ(countAllowed(limiter, PeerId(5), 5, start + 10s), 3);
+}
+
+TEST_F(RateLimiterTest, Allow_ConcurrentCallersNeverExceedBudget)
+{
+    RateLimiter limiter(makeConfig(1000, 1000));
+    std::atomic<int> allowed{0};
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 4; t++)
+    {
+        // clang-format off
+        threads.emplace_back([&] {
+            allowed += countAllowed(limiter, alice, 1000, start);
+        });
+        // clang-format on
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(allowed.load(), 1000);
+}
@@ -0,0 +1,189 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/protocol/signature_verifier.h"
+#include <future>
+#include <openssl/evp.h>
+#include <string>
+#include <vector>
+
+using namespace bitchat;
+using namespace ::testing;
+using namespace std::chrono_literals;
+
+class SignatureVerifierTest : public Test
+{
+protected:
+    void SetUp() override
+    {
+        EVP_PKEY_CTX *ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_ED25519, nullptr);
+        ASSERT_NE(ctx, nullptr);
+        ASSERT_GT(EVP_PKEY_keygen_init(ctx), 0);
+        ASSERT_GT(EVP_PKEY_keygen(ctx, &key), 0);
+        EVP_PKEY_CTX_free(ctx);
+
+        size_t keyLen = 32;
+        publicKey.resize(keyLen);
+        ASSERT_GT(EVP_PKEY_get_raw_public_key(key, publicKey.data(), &keyLen), 0);
+    }
+
+    void TearDown() override
+    {
+        EVP_PKEY_free(key);
+    }
+
+    std::vector<uint8_t> sign(const std::vector<uint8_t> &data) const
+    {
+        EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+        EVP_DigestSignInit(ctx, nullptr, nullptr, nullptr, key);
+
+        size_t signatureLen = 64;
+        std::vector<uint8_t> signature(signatureLen);
+        EVP_DigestSign(ctx, signature.data(), &signatureLen, data.data(), data.size());
+        EVP_MD_CTX_free(ctx);
+
+        return signature;
+    }
+
+    static std::vector<uint8_t> bytes(const std::string &text)
+    {
+        return std::vector<uint8_t>(text.begin(), text.end());
+    }
+
+    // Submit and wait for the worker, std::nullopt if it was not queued
+    static std::optional<bool> submitAndWait(SignatureVerifier &verifier, PeerId sender, const std::vector<uint8_t> &data, const std::vector<uint8_t> &signature)
+    {
+        auto promise = std::make_shared<std::promise<bool>>();
+        std::future<bool> future = promise->get_future();
+
+        // clang-format off
+        auto result = verifier.submit(sender, data, signature, [promise](bool valid) {
+            promise->set_value(valid);
+        });
+        // clang-format on
+
+        if (result != SignatureVerifier::SubmitResult::Queued || future.wait_for(5s) != std::future_status::ready)
+        {
+            return std::nullopt;
+        }
+
+        return future.get();
+    }
+
+    const PeerId sender{0x0102030405060708ULL};
+    EVP_PKEY *key = nullptr;
+    std::vector<uint8_t> publicKey;
+};
+
+// ============================================================================
+// Tests for SignatureVerifier
+// ============================================================================
+
+TEST_F(SignatureVerifierTest, Submit_VerifiesOnceAndCachesOutcome)
+{
+    SignatureVerifier verifier;
+    std::vector<uint8_t> data = bytes("hello mesh");
+    std::vector<uint8_t> signature = sign(data);
+
+    EXPECT_EQ(verifier.submit(sender, data, signature, nullptr), SignatureVerifier::SubmitResult::UnknownKey);
+    ASSERT_TRUE(verifier.setPublicKey(sender, publicKey));
+
+    EXPECT_THAT(submitAndWait(verifier, sender, data, signature), Optional(true));
+
+    // Relayed copies of the same packet hit the cache
+    EXPECT_EQ(verifier.submit(sender, data, signature, nullptr), SignatureVerifier::SubmitResult::Verified);
+    EXPECT_EQ(verifier.submit(sender, data, signature, nullptr), SignatureVerifier::SubmitResult::Verified);
+
+    // A forged copy has a different digest and fails on its own
+    std::vector<uint8_t> forged = bytes("hello mash");
+    EXPECT_THAT(submitAndWait(verifier, sender, forged, signature), Optional(false));
+    EXPECT_EQ(verifier.submit(sender, forged, signature, nullptr), SignatureVerifier::SubmitResult::Rejected);
+
+    SignatureVerifier::Stats stats = verifier.getStats();
+    EXPECT_EQ(stats.verified, 1u);
+    EXPECT_EQ(stats.rejected, 1u);
+    EXPECT_EQ(stats.cacheHits, 3u);
+}
+
+TEST_F(SignatureVerifierTest, SetPublicKey_PinsFirstKey)
+{
+    SignatureVerifier verifier(SignatureVerifier::Config{1, 8, 16, 16, 2, 1h});
+
+    EXPECT_FALSE(verifier.setPublicKey(sender, std::vector<uint8_t>(31, 1)));
+    EXPECT_FALSE(verifier.hasPublicKey(sender));
+
+    ASSERT_TRUE(verifier.setPublicKey(sender, publicKey));
+    EXPECT_TRUE(verifier.setPublicKey(sender, publicKey));
+
+    std::vector<uint8_t> other = publicKey;
+    other[0] ^= 0x01;
+    EXPECT_FALSE(verifier.setPublicKey(sender, other));
+
+    std::vector<uint8_t> data = bytes("pinned");
+    EXPECT_THAT(verifier.verify(sender, data, sign(data)), Optional(true));
+    EXPECT_EQ(verifier.verify(PeerId(0x99), data, sign(data)), std::nullopt);
+}
+
+TEST_F(SignatureVerifierTest, SetPublicKey_FullTable_OnlyDropsIdleKeys)
+{
+    SignatureVerifier verifier(SignatureVerifier::Config{1, 8, 16, 16, 2, 1h});
+    auto now = SignatureVerifier::Clock::now();
+
+    ASSERT_TRUE(verifier.setPublicKey(sender, publicKey, now));
+    ASSERT_TRUE(verifier.setPublicKey(PeerId(0x10), publicKey, now));
+
+    // New peer IDs cannot push out keys in use
+    EXPECT_FALSE(verifier.setPublicKey(PeerId(0x11), publicKey, now + 30min));
+    EXPECT_TRUE(verifier.hasPublicKey(sender));
+    EXPECT_TRUE(verifier.hasPublicKey(PeerId(0x10)));
+
+    // Announcing again keeps a key in use, the other one goes idle
+    ASSERT_TRUE(verifier.setPublicKey(sender, publicKey, now + 50min));
+    EXPECT_TRUE(verifier.setPublicKey(PeerId(0x11), publicKey, now + 70min));
+    EXPECT_TRUE(verifier.hasPublicKey(sender));
+    EXPECT_FALSE(verifier.hasPublicKey(PeerId(0x10)));
+    EXPECT_TRUE(verifier.hasPublicKey(PeerId(0x11)));
+}
+
+TEST_F(SignatureVerifierTest, Submit_ManyMessages_VerifiedInBatches)
+{
+    SignatureVerifier verifier(SignatureVerifier::Config{2, 16, 1024, 1024, 16, 1h});
+    ASSERT_TRUE(verifier.setPublicKey(sender, publicKey));
+
+    constexpr int count = 200;
+    std::atomic<int> valid{0};
+    std::atomic<int> done{0};
+    std::promise<void> finished;
+
+    for (int i = 0; i < count; i++)
+    {
+        std::vector<uint8_t> data = bytes("message " + std::to_string(i));
+        std::vector<uint8_t> signature = sign(data);
+
+        // Every tenth message is tampered with
+        if (i % 10 == 0)
+        {
+            signature[5] ^= 0xFF;
+        }
+
+        // clang-format off
+        auto result = verifier.submit(sender, data, signature, [&](bool ok) {
+            valid += ok ? 1 : 0;
+
+            if (++done == count)
+            {
+                finished.set_value();
+            }
+        });
+        // clang-format on
+
+        ASSERT_EQ(result, SignatureVerifier::SubmitResult::Queued);
+    }
+
+    ASSERT_EQ(finished.get_future().wait_for(10s), std::future_status::ready);
+    EXPECT_EQ(valid.load(), count - count / 10);
+
+    SignatureVerifier::Stats stats = verifier.getStats();
+    EXPECT_EQ(stats.verified + stats.rejected, static_cast<uint64_t>(count));
+    EXPECT_LE(stats.batches, static_cast<uint64_t>(count));
+}
@@ -0,0 +1,103 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/protocol/signature_verifier.h"
+#include "bitchat/services/crypto_service.h"
+#include <atomic>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace bitchat;
+using namespace ::testing;
+using namespace std::chrono_literals;
+
+class CryptoServiceTest : public Test
+{
+protected:
+    void SetUp() override
+    {
+        keyFile = std::filesystem::temp_directory_path() / ("bitchat_key_" + std::string(UnitTest::GetInstance()->current_test_info()->name()) + ".pem");
+        std::filesystem::remove(keyFile);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(keyFile);
+    }
+
+    std::filesystem::path keyFile;
+};
+
+// ============================================================================
+// Tests for CryptoService
+// ============================================================================
+
+TEST_F(CryptoServiceTest, SignData_ConcurrentThreads_ProduceValidSignatures)
+{
+    CryptoService crypto;
+    ASSERT_TRUE(crypto.generateOrLoadKeyPair(keyFile.string()));
+
+    SignatureVerifier verifier(SignatureVerifier::Config{1, 8, 16, 16, 4, 1h});
+    const PeerId signer(0x0102030405060708ULL);
+    ASSERT_TRUE(verifier.setPublicKey(signer, crypto.getSigningPublicKey()));
+
+    constexpr size_t threadCount = 4;
+    constexpr size_t perThread = 100;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> valid{0};
+
+    for (size_t t = 0; t < threadCount; t++)
+    {
+        // clang-format off
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < perThread; i++)
+            {
+                std::string text = "thread " + std::to_string(t) + " message " + std::to_string(i);
+                std::vector<uint8_t> data(text.begin(), text.end());
+
+                if (verifier.verify(signer, data, crypto.signData(data)) == std::optional<bool>(true))
+                {
+                    valid++;
+                }
+            }
+        });
+        // clang-format on
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(valid.load(), threadCount * perThread);
+
+    // One context per thread, reused for every signature after the first
+    SigningStats stats = crypto.getSigningStats();
+    EXPECT_EQ(stats.signatures, threadCount * perThread);
+    EXPECT_EQ(stats.contextsPrepared, threadCount);
+    EXPECT_EQ(stats.failures, 0u);
+    EXPECT_GT(stats.getAverageMicroseconds(), 0.0);
+}
+
+TEST_F(CryptoServiceTest, SignData_AfterKeyChange_UsesNewKey)
+{
+    CryptoService crypto;
+    ASSERT_TRUE(crypto.generateOrLoadKeyPair(keyFile.string()));
+    std::vector<uint8_t> data = {1, 2, 3};
+    EXPECT_EQ(crypto.signData(data).size(), 64u);
+
+    crypto.cleanup();
+    EXPECT_TRUE(crypto.signData(data).empty());
+    EXPECT_EQ(crypto.getSigningStats().failures, 1u);
+
+    // Reloading the saved key prepares a fresh context on this thread
+    ASSERT_TRUE(crypto.generateOrLoadKeyPair(keyFile.string()));
+
+    SignatureVerifier verifier(SignatureVerifier::Config{1, 8, 16, 16, 4, 1h});
+    ASSERT_TRUE(verifier.setPublicKey(PeerId(1), crypto.getSigningPublicKey()));
+    EXPECT_THAT(verifier.verify(PeerId(1), data, crypto.signData(data)), Optional(true));
+    EXPECT_EQ(crypto.getSigningStats().contextsPrepared, 2u);
+}
@@ -0,0 +1,139 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/core/constants.h"
+#include "bitchat/protocol/packet_serializer.h"
+#include "bitchat/services/crypto_service.h"
+#include "bitchat/services/message_service.h"
+#include "bitchat/services/network_service.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace bitchat;
+using namespace ::testing;
+
+class MessageServiceTest : public Test
+{
+protected:
+    void SetUp() override
+    {
+        keyFile = std::filesystem::temp_directory_path() / ("bitchat_key_" + std::string(UnitTest::GetInstance()->current_test_info()->name()) + ".pem");
+        std::filesystem::remove(keyFile);
+        ASSERT_TRUE(senderCrypto.generateOrLoadKeyPair(keyFile.string()));
+
+        ASSERT_TRUE(messageService->initialize(networkService, nullptr, nullptr));
+
+        // clang-format off
+        messageService->setMessageReceivedCallback([this](const BitchatMessage &) {
+            received++;
+        });
+        // clang-format on
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(keyFile);
+    }
+
+    BitchatPacket makeMessagePacket(const std::string &content, uint64_t timestamp)
+    {
+        BitchatMessage message;
+        message.setId(content);
+        message.setSender("alice");
+        message.setContent(content);
+
+        BitchatPacket packet(PKT_TYPE_MESSAGE, serializer.makeMessagePayload(message));
+        packet.setSenderID(sender);
+        packet.setTimestamp(timestamp);
+
+        return packet;
+    }
+
+    BitchatPacket makeHandshakePacket(uint64_t timestamp)
+    {
+        BitchatPacket packet(PKT_TYPE_NOISE_HANDSHAKE_INIT, std::vector<uint8_t>(32, 0x42));
+        packet.setSenderID(sender);
+        packet.setTimestamp(timestamp);
+
+        return packet;
+    }
+
+    // Packets accepted for routing and relay
+    int countAccepted(int count, uint64_t firstTimestamp, const std::string &linkID)
+    {
+        int accepted = 0;
+
+        for (int i = 0; i < count; i++)
+        {
+            accepted += messageService->processPacket(makeHandshakePacket(firstTimestamp + i), linkID) ? 1 : 0;
+        }
+
+        return accepted;
+    }
+
+    BitchatPacket makeIdentityAnnouncePacket()
+    {
+        BitchatPacket packet(PKT_TYPE_NOISE_IDENTITY_ANNOUNCE, serializer.makeIdentityAnnouncePayload(sender.toHex(), senderCrypto.getSigningPublicKey()));
+        packet.setSenderID(sender);
+
+        return packet;
+    }
+
+    const PeerId sender{0x0A0B0C0D0E0F1011ULL};
+
+    std::filesystem::path keyFile;
+    CryptoService senderCrypto;
+    PacketSerializer serializer;
+
+    std::shared_ptr<NetworkService> networkService = std::make_shared<NetworkService>();
+    std::shared_ptr<MessageService> messageService = std::make_shared<MessageService>();
+    int received = 0;
+};
+
+// ============================================================================
+// Tests for signature enforcement
+// ============================================================================
+
+TEST_F(MessageServiceTest, ProcessPacket_UnsignedFromUnknownSender_IsDelivered)
+{
+    EXPECT_TRUE(messageService->processPacket(makeMessagePacket("hello", 1000), ""));
+    EXPECT_EQ(received, 1);
+}
+
+TEST_F(MessageServiceTest, ProcessPacket_StrippedSignatureFromPinnedSender_IsDropped)
+{
+    EXPECT_TRUE(messageService->processPacket(makeIdentityAnnouncePacket(), ""));
+
+    // A signed message with its flag cleared looks unsigned
+    BitchatPacket packet = makeMessagePacket("forged", 2000);
+    packet.setSignature(senderCrypto.signData(packet.getPayload()));
+    packet.setHasSignature(false);
+
+    EXPECT_FALSE(messageService->processPacket(packet, ""));
+    EXPECT_FALSE(messageService->processPacket(makeMessagePacket("never signed", 3000), ""));
+    EXPECT_EQ(received, 0);
+}
+
+// ============================================================================
+// Tests for rate limiting
+// ============================================================================
+
+TEST_F(MessageServiceTest, ProcessPacket_OverLimit_IsNotRelayed)
+{
+    int limit = static_cast<int>(constants::NOISE_MAX_HANDSHAKES_PER_MINUTE);
+
+    EXPECT_EQ(countAccepted(limit + 5, 10000, "link-a"), limit);
+    EXPECT_EQ(messageService->getRateLimitStats().limitedPeer, 5u);
+}
+
+TEST_F(MessageServiceTest, ProcessPacket_FloodOnOneLink_DoesNotLimitOtherLink)
+{
+    int limit = static_cast<int>(constants::NOISE_MAX_HANDSHAKES_PER_MINUTE);
+
+    // Packets claiming to be from the sender flood in on link a
+    EXPECT_EQ(countAccepted(limit * 3, 20000, "link-a"), limit);
+
+    // The sender's packets on link b keep their own budget
+    EXPECT_EQ(countAccepted(limit, 30000, "link-b"), limit);
+}
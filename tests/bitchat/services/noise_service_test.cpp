@@ -0,0 +1,72 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/services/noise_service.h"
+#include <string>
+#include <vector>
+
+using namespace bitchat;
+using namespace ::testing;
+
+class NoiseServiceTest : public Test
+{
+protected:
+    // Runs the XX handshake with alice initiating, as the message service does
+    void handshake()
+    {
+        auto init = alice.initiateHandshake(bobID);
+        auto response = bob.handleHandshakeInit(aliceID, init);
+        ASSERT_TRUE(response.response.has_value());
+
+        auto final = alice.handleIncomingHandshake(bobID, *response.response, aliceID);
+        ASSERT_TRUE(final.established);
+        ASSERT_TRUE(final.response.has_value());
+
+        auto done = bob.handleIncomingHandshake(aliceID, *final.response, bobID);
+        ASSERT_TRUE(done.established);
+    }
+
+    bool canTalk()
+    {
+        std::vector<uint8_t> plaintext = {'h', 'i'};
+        return bob.decrypt(alice.encrypt(plaintext, bobID), aliceID) == plaintext;
+    }
+
+    const PeerId aliceID{0x0101010101010101ULL};
+    const PeerId bobID{0x0202020202020202ULL};
+
+    NoiseService alice;
+    NoiseService bob;
+};
+
+// ============================================================================
+// Tests for re-handshakes
+// ============================================================================
+
+TEST_F(NoiseServiceTest, HandleHandshakeInit_Spoofed_KeepsEstablishedSession)
+{
+    handshake();
+    ASSERT_TRUE(canTalk());
+
+    // XX starts with a bare ephemeral key, anyone can send one
+    auto step = bob.handleHandshakeInit(aliceID, std::vector<uint8_t>(32, 0x42));
+    EXPECT_TRUE(step.response.has_value());
+    EXPECT_FALSE(step.established);
+
+    EXPECT_TRUE(bob.hasEstablishedSession(aliceID));
+    EXPECT_TRUE(bob.hasPendingHandshake(aliceID));
+    EXPECT_TRUE(canTalk());
+}
+
+TEST_F(NoiseServiceTest, Rehandshake_Completed_ReplacesSession)
+{
+    handshake();
+    auto oldHash = bob.getHandshakeHash(aliceID);
+
+    handshake();
+
+    EXPECT_FALSE(alice.hasPendingHandshake(bobID));
+    EXPECT_FALSE(bob.hasPendingHandshake(aliceID));
+    EXPECT_NE(bob.getHandshakeHash(aliceID), oldHash);
+    EXPECT_TRUE(canTalk());
+}
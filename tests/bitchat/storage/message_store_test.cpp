@@ -0,0 +1,216 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "bitchat/storage/message_store.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+using namespace bitchat;
+using namespace ::testing;
+
+class MessageStoreTest : public Test
+{
+protected:
+    void SetUp() override
+    {
+        directory = std::filesystem::temp_directory_path() / ("bitchat_store_" + std::string(UnitTest::GetInstance()->current_test_info()->name()));
+        std::filesystem::remove_all(directory);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+
+    MessageStore::Options makeOptions(size_t segmentBytes = 4096) const
+    {
+        MessageStore::Options options;
+        options.directory = directory;
+        options.segmentBytes = segmentBytes;
+        options.indexInterval = 4;
+
+        return options;
+    }
+
+    static BitchatMessage makeMessage(int number)
+    {
+        BitchatMessage message("alice", "message " + std::to_string(number), "#general");
+        message.setId("id-" + std::to_string(number));
+
+        return message;
+    }
+
+    std::filesystem::path lastSegmentPath() const
+    {
+        std::vector<std::filesystem::path> paths;
+
+        for (const auto &entry : std::filesystem::recursive_directory_iterator(directory))
+        {
+            if (entry.path().extension() == ".seg")
+            {
+                paths.push_back(entry.path());
+            }
+        }
+
+        std::sort(paths.begin(), paths.end());
+
+        return paths.back();
+    }
+
+    std::filesystem::path directory;
+};
+
+// ============================================================================
+// Tests for MessageStore
+// ============================================================================
+
+TEST_F(MessageStoreTest, Append_SurvivesReopen)
+{
+    {
+        auto store = MessageStore::open(makeOptions());
+        ASSERT_NE(store, nullptr);
+
+        for (int i = 0; i < 10; i++)
+        {
+            ASSERT_TRUE(store->append("#general", makeMessage(i), 1000 + i));
+        }
+
+        ASSERT_TRUE(store->append("#other", makeMessage(100), 5000));
+    }
+
+    auto store = MessageStore::open(makeOptions());
+    ASSERT_NE(store, nullptr);
+    EXPECT_THAT(store->getConversations(), ElementsAre("#general", "#other"));
+    EXPECT_EQ(store->getEndSequence("#general"), 10u);
+
+    auto latest = store->loadLatest("#general", 3);
+    ASSERT_EQ(latest.size(), 3u);
+    EXPECT_EQ(latest[0].getContent(), "message 7");
+    EXPECT_EQ(latest[2].getContent(), "message 9");
+    EXPECT_EQ(latest[2].getId(), "id-9");
+
+    // Appends continue after the recovered records
+    ASSERT_TRUE(store->append("#general", makeMessage(10), 1010));
+    EXPECT_EQ(store->getEndSequence("#general"), 11u);
+    EXPECT_EQ(store->loadLatest("#general", 1)[0].getContent(), "message 10");
+}
+
+TEST_F(MessageStoreTest, Scan_ReturnsTimeRangeAcrossSegments)
+{
+    auto store = MessageStore::open(makeOptions(512));
+    ASSERT_NE(store, nullptr);
+
+    for (int i = 0; i < 100; i++)
+    {
+        ASSERT_TRUE(store->append("#general", makeMessage(i), 1000 + i * 10));
+    }
+
+    EXPECT_GT(store->getSegmentCount("#general"), 3u);
+
+    auto messages = store->loadRange("#general", 1250, 1400);
+    ASSERT_EQ(messages.size(), 16u);
+    EXPECT_EQ(messages.front().getContent(), "message 25");
+    EXPECT_EQ(messages.back().getContent(), "message 40");
+
+    std::vector<uint64_t> sequences;
+
+    // clang-format off
+    store->scanFrom("#general", 95, [&](const StoredRecord &record) {
+        sequences.push_back(record.sequence);
+        return true;
+    });
+    // clang-format on
+
+    EXPECT_THAT(sequences, ElementsAre(95, 96, 97, 98, 99));
+
+    // Timestamps never go backwards
+    ASSERT_TRUE(store->append("#general", makeMessage(100), 5));
+    EXPECT_EQ(store->loadRange("#general", 1990).size(), 2u);
+}
+
+TEST_F(MessageStoreTest, Open_RecoversFromTornTail)
+{
+    {
+        auto store = MessageStore::open(makeOptions());
+        ASSERT_NE(store, nullptr);
+
+        for (int i = 0; i < 5; i++)
+        {
+            ASSERT_TRUE(store->append("#general", makeMessage(i), 1000 + i));
+        }
+    }
+
+    // Corrupt the payload of the last record, as if the write was cut short
+    {
+        std::fstream file(lastSegmentPath(), std::ios::in | std::ios::out | std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        size_t position = contents.rfind("message 4");
+        ASSERT_NE(position, std::string::npos);
+
+        file.seekp(static_cast<std::streamoff>(position));
+        file.write("XXXXXXX", 7);
+    }
+
+    auto store = MessageStore::open(makeOptions());
+    ASSERT_NE(store, nullptr);
+    EXPECT_EQ(store->getEndSequence("#general"), 4u);
+
+    ASSERT_TRUE(store->append("#general", makeMessage(5), 2000));
+    store.reset();
+
+    store = MessageStore::open(makeOptions());
+    ASSERT_NE(store, nullptr);
+
+    auto messages = store->loadLatest("#general", 10);
+    ASSERT_EQ(messages.size(), 5u);
+    EXPECT_EQ(messages[3].getContent(), "message 3");
+    EXPECT_EQ(messages[4].getContent(), "message 5");
+}
+
+TEST_F(MessageStoreTest, Compact_AppliesRetentionAndMergesSegments)
+{
+    auto options = makeOptions(512);
+    auto store = MessageStore::open(options);
+    ASSERT_NE(store, nullptr);
+
+    // Old messages past retention, then recent ones in segments rolled by duration
+    uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+    uint64_t old = now - static_cast<uint64_t>(options.retention.count()) - 60000;
+    uint64_t duration = static_cast<uint64_t>(options.segmentDuration.count());
+
+    for (int i = 0; i < 20; i++)
+    {
+        ASSERT_TRUE(store->append("#general", makeMessage(i), old + i));
+    }
+
+    for (int i = 0; i < 3; i++)
+    {
+        ASSERT_TRUE(store->append("#general", makeMessage(20 + i), now - duration * 3 + duration * i));
+    }
+
+    ASSERT_TRUE(store->append("#general", makeMessage(23), now));
+
+    size_t segmentsBefore = store->getSegmentCount("#general");
+    store->compact();
+
+    EXPECT_EQ(store->getFirstSequence("#general"), 20u);
+    EXPECT_EQ(store->getEndSequence("#general"), 24u);
+    EXPECT_LT(store->getSegmentCount("#general"), segmentsBefore);
+
+    // The three single-record segments became one, the active one stays
+    EXPECT_EQ(store->getSegmentCount("#general"), 2u);
+
+    auto messages = store->loadRange("#general", 0);
+    ASSERT_EQ(messages.size(), 4u);
+    EXPECT_EQ(messages[0].getContent(), "message 20");
+    EXPECT_EQ(messages[3].getContent(), "message 23");
+
+    // The merged layout is what a reopen sees
+    store.reset();
+    store = MessageStore::open(options);
+    ASSERT_NE(store, nullptr);
+    EXPECT_EQ(store->getSegmentCount("#general"), 2u);
+    EXPECT_EQ(store->loadLatest("#general", 10).size(), 4u);
+}
@@ -38,6 +38,11 @@ bool DummyBluetoothNetwork::sendPacketToPeripheral([[maybe_unused]] const Bitcha
     return true;
 }
 
+bool DummyBluetoothNetwork::sendFrameToPeer([[maybe_unused]] const SharedFrame &frame, [[maybe_unused]] const std::string &peerID)
+{
+    return true;
+}
+
 bool DummyBluetoothNetwork::isReady() const
 {
     return true;
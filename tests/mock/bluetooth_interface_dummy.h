@@ -24,6 +24,7 @@ public:
     bool sendPacket(const BitchatPacket &packet) override;
     bool sendPacketToPeer(const BitchatPacket &packet, const std::string &peerID) override;
     bool sendPacketToPeripheral(const BitchatPacket &packet, const std::string &peripheralID) override;
+    bool sendFrameToPeer(const SharedFrame &frame, const std::string &peerID) override;
     bool isReady() const override;
 
     void setPeerConnectedCallback(PeerConnectedCallback callback) override;
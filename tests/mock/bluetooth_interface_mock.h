@@ -19,6 +19,7 @@ public:
     MOCK_METHOD(bool, sendPacket, (const BitchatPacket &packet), (override));
     MOCK_METHOD(bool, sendPacketToPeer, (const BitchatPacket &packet, const std::string &peerID), (override));
     MOCK_METHOD(bool, sendPacketToPeripheral, (const BitchatPacket &packet, const std::string &peripheralID), (override));
+    MOCK_METHOD(bool, sendFrameToPeer, (const SharedFrame &frame, const std::string &peerID), (override));
     MOCK_METHOD(bool, isReady, (), (const, override));
     MOCK_METHOD(void, setPeerConnectedCallback, (PeerConnectedCallback callback), (override));
     MOCK_METHOD(void, setPeerDisconnectedCallback, (PeerDisconnectedCallback callback), (override));